@@ -0,0 +1,431 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sun Oct 18 23:20:05 PDT 2026
+// Last Modified: Sun Oct 18 23:20:09 PDT 2026
+// Filename:      ...improv/bench/beatbench.cpp
+// Syntax:        C++; improv 2.2
+//
+// Description:   Compares tempo tracking methods on sequences of beat
+//                times.  Each method predicts the time of the next beat
+//                before it is given, and the difference between the
+//                predicted and the actual time is the tracking error.
+//                For sequences with a sudden tempo change, the latency
+//                is the number of beats after the change before the
+//                tempo estimate stays within 3% of the new tempo.
+//
+//                The methods are:
+//                   avg1..avg4: the average of the last 1 to 4 beat
+//                               intervals (MidiPerform's ONEBACK to
+//                               FOURBACK tempo methods).
+//                   kalman:     the BeatTracker class (MidiPerform's
+//                               AUTOMATIC tempo method).
+//
+//                The sequences are either generated (steady, step,
+//                stepdown, ramp, rubato) with random placement errors
+//                added to each beat, or read from a file which contains
+//                one beat time in milliseconds per line, for example
+//                beats recorded from a baton.
+//
+//                Results are printed as one line per sequence and
+//                method of space separated key=value pairs:
+//                   bench=beatbench sequence=<name> method=<name>
+//                      beats=<count> meanerr=<ms> rmserr=<ms> maxerr=<ms>
+//                      latency=<beats>
+//
+
+#include "improv.h"
+#include "BeatTracker.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <fstream>
+
+#define METHOD_COUNT     (5)
+#define SETTLE_TOLERANCE (0.03)    // tempo within 3% counts as settled
+#define SETTLE_BEATS     (4)       // for this many beats in a row
+#define WARMUP_BEATS     (3)       // beats before errors are counted
+
+// global variables for command-line options:
+Options   options;            // for command-line processing
+string    sequenceName;       // for -q option
+string    methodName;         // for -m option
+double    jitterAmount = 15.0;  // for -j option (ms standard deviation)
+int       trials     = 20;    // for -n option (random sequences averaged)
+int       seed       = 1;     // for -s option (random number seed)
+string    label;              // for -l option (tag for results line)
+
+// random number state:
+unsigned long long randomState = 1;
+
+// function declarations:
+void      checkOptions       (Options& opts);
+double    gaussian           (void);
+int       generateSequence   (const char* name, Array<double>& times,
+                              Array<double>& tempos);
+const char* getMethodName    (int method);
+void      measure            (int method, Array<double>& times,
+                              Array<double>& tempos, int changeBeat,
+                              double& sumError, double& sumSquare,
+                              double& maxError, int& count, int& latency);
+int       readSequence       (const char* filename, Array<double>& times);
+void      runSequence        (const char* name);
+void      usage              (const char* command);
+
+// a simple tempo tracker which averages the last few beat intervals:
+class AverageTracker {
+   public:
+      AverageTracker(int aCount) { count = aCount; reset(60.0); }
+      void reset(double aTempo) {
+         period = 60000.0 / aTempo; beats = 0; intervals.setSize(0);
+      }
+      void beat(double aTime) {
+         if (beats > 0) {
+            double interval = aTime - lastTime;
+            intervals.append(interval);
+            int n = intervals.getSize() < count ? intervals.getSize() : count;
+            double sum = 0.0;
+            for (int i=0; i<n; i++) {
+               sum += intervals[intervals.getSize() - 1 - i];
+            }
+            period = sum / n;
+         }
+         lastTime = aTime;
+         beats++;
+      }
+      double getNextBeat(void) { return lastTime + period; }
+      double getTempo(void)    { return 60000.0 / period; }
+   private:
+      int           count;
+      int           beats;
+      double        lastTime;
+      double        period;
+      Array<double> intervals;
+};
+
+
+///////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv) {
+   options.setOptions(argc, argv);
+   checkOptions(options);
+
+   if (options.getArgCount() > 0) {
+      for (int i=1; i<=options.getArgCount(); i++) {
+         runSequence(options.getArg(i).data());
+      }
+   } else if (sequenceName.size() > 0) {
+      runSequence(sequenceName.data());
+   } else {
+      const char* names[] = {"steady", "step", "stepdown", "ramp", "rubato"};
+      for (int i=0; i<5; i++) {
+         runSequence(names[i]);
+      }
+   }
+
+   return 0;
+}
+
+
+///////////////////////////////////////////////////////////////////////////
+
+
+//////////////////////////////
+//
+// runSequence -- measure each method on the named sequence or file, and
+//     print one results line for each method.
+//
+
+void runSequence(const char* name) {
+   Array<double> times;
+   Array<double> tempos;
+   times.setSize(0);
+   tempos.setSize(0);
+   int fileQ = strcmp(name, "steady") != 0 && strcmp(name, "step") != 0 &&
+         strcmp(name, "stepdown") != 0 && strcmp(name, "ramp") != 0 &&
+         strcmp(name, "rubato") != 0;
+   int runs = fileQ ? 1 : trials;
+
+   for (int method=0; method<METHOD_COUNT; method++) {
+      if (methodName.size() > 0 && methodName != getMethodName(method)) {
+         continue;
+      }
+      randomState = seed;
+      double sumError = 0.0;
+      double sumSquare = 0.0;
+      double maxError = 0.0;
+      int    count = 0;
+      int    latencySum = 0;
+      int    latencyCount = 0;
+      for (int run=0; run<runs; run++) {
+         int changeBeat = -1;
+         if (fileQ) {
+            if (!readSequence(name, times)) {
+               exit(1);
+            }
+            tempos.setSize(0);
+         } else {
+            changeBeat = generateSequence(name, times, tempos);
+         }
+         int latency = -1;
+         measure(method, times, tempos, changeBeat, sumError, sumSquare,
+               maxError, count, latency);
+         if (latency >= 0) {
+            latencySum += latency;
+            latencyCount++;
+         }
+      }
+
+      cout << "bench=beatbench";
+      if (label.size() > 0) {
+         cout << " label=" << label;
+      }
+      cout << " sequence=" << name
+           << " method=" << getMethodName(method)
+           << " beats=" << times.getSize()
+           << " meanerr=" << (count > 0 ? sumError / count : 0.0)
+           << " rmserr=" << (count > 0 ? sqrt(sumSquare / count) : 0.0)
+           << " maxerr=" << maxError;
+      if (latencyCount > 0) {
+         cout << " latency=" << (double)latencySum / latencyCount;
+      }
+      cout << endl;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// measure -- give the beats to a tracking method, and add the errors
+//    in its predictions of each beat to the totals.  The latency is
+//    the number of beats after changeBeat before the tempo estimate
+//    stays close to the actual tempo.
+//
+
+void measure(int method, Array<double>& times, Array<double>& tempos,
+      int changeBeat, double& sumError, double& sumSquare,
+      double& maxError, int& count, int& latency) {
+   BeatTracker kalman;
+   AverageTracker average(method < 4 ? method + 1 : 1);
+   double startTempo = tempos.getSize() > 0 ? tempos[0] : 60.0;
+   kalman.reset(startTempo);
+   average.reset(startTempo);
+
+   int settled = 0;
+   latency = -1;
+   for (int i=0; i<times.getSize(); i++) {
+      double predicted = method == 4 ? kalman.getNextBeat() :
+            average.getNextBeat();
+      if (i >= WARMUP_BEATS) {
+         double error = fabs(predicted - times[i]);
+         sumError += error;
+         sumSquare += error * error;
+         if (error > maxError) {
+            maxError = error;
+         }
+         count++;
+      }
+
+      double tempo;
+      if (method == 4) {
+         kalman.beat(times[i]);
+         tempo = kalman.getTempo();
+      } else {
+         average.beat(times[i]);
+         tempo = average.getTempo();
+      }
+
+      if (changeBeat >= 0 && i >= changeBeat && latency < 0 &&
+            i + 1 < tempos.getSize()) {
+         // tempos[i + 1] is the tempo of the interval after beat i
+         if (fabs(tempo - tempos[i+1]) < SETTLE_TOLERANCE * tempos[i+1]) {
+            settled++;
+            if (settled >= SETTLE_BEATS) {
+               latency = i - changeBeat - SETTLE_BEATS + 1;
+            }
+         } else {
+            settled = 0;
+         }
+      }
+   }
+}
+
+
+
+//////////////////////////////
+//
+// generateSequence -- make 64 beats with the named tempo shape, and
+//    add random placement errors to the times.  tempos[i] is the tempo
+//    of the interval ending at beat i.  Returns the beat at which the
+//    tempo suddenly changes, or -1.
+//
+
+int generateSequence(const char* name, Array<double>& times,
+      Array<double>& tempos) {
+   int count = 64;
+   int changeBeat = -1;
+   times.setSize(count);
+   tempos.setSize(count);
+   double time = 1000.0;
+   for (int i=0; i<count; i++) {
+      double tempo = 100.0;
+      if (strcmp(name, "step") == 0) {
+         changeBeat = 32;
+         tempo = i <= changeBeat ? 100.0 : 130.0;
+      } else if (strcmp(name, "stepdown") == 0) {
+         changeBeat = 32;
+         tempo = i <= changeBeat ? 120.0 : 80.0;
+      } else if (strcmp(name, "ramp") == 0) {
+         tempo = 80.0 + 60.0 * i / (count - 1);
+      } else if (strcmp(name, "rubato") == 0) {
+         tempo = 100.0 * (1.0 + 0.15 * sin(2.0 * M_PI * i / 16.0));
+      }
+      if (i > 0) {
+         time += 60000.0 / tempo;
+      }
+      tempos[i] = tempo;
+      times[i] = time + jitterAmount * gaussian();
+   }
+   return changeBeat;
+}
+
+
+
+//////////////////////////////
+//
+// readSequence -- read beat times in milliseconds from a file, one per
+//    line.  Lines starting with "#" are ignored.
+//
+
+int readSequence(const char* filename, Array<double>& times) {
+   ifstream input(filename);
+   if (!input.is_open()) {
+      cerr << "Error: cannot read beat file " << filename << endl;
+      return 0;
+   }
+   times.setSize(0);
+   string line;
+   while (getline(input, line)) {
+      if (line.size() == 0 || line[0] == '#') {
+         continue;
+      }
+      double value = atof(line.c_str());
+      times.append(value);
+   }
+   if (times.getSize() < 2) {
+      cerr << "Error: need at least two beats in " << filename << endl;
+      return 0;
+   }
+   return 1;
+}
+
+
+
+//////////////////////////////
+//
+// gaussian -- returns a normally distributed random number with a mean
+//    of 0 and a standard deviation of 1.
+//
+
+double gaussian(void) {
+   randomState = randomState * 6364136223846793005ULL + 1442695040888963407ULL;
+   double u1 = ((randomState >> 11) + 1.0) / 9007199254740993.0;
+   randomState = randomState * 6364136223846793005ULL + 1442695040888963407ULL;
+   double u2 = (randomState >> 11) / 9007199254740992.0;
+   return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+
+
+//////////////////////////////
+//
+// getMethodName --
+//
+
+const char* getMethodName(int method) {
+   switch (method) {
+      case 0:  return "avg1";
+      case 1:  return "avg2";
+      case 2:  return "avg3";
+      case 3:  return "avg4";
+      case 4:  return "kalman";
+   }
+   return "unknown";
+}
+
+
+
+//////////////////////////////
+//
+// checkOptions --
+//
+
+void checkOptions(Options& opts) {
+   opts.define("q|sequence=s:");       // steady, step, stepdown, ramp, rubato
+   opts.define("m|method=s:");         // avg1, avg2, avg3, avg4 or kalman
+   opts.define("j|jitter=d:15.0");     // beat placement error in ms
+   opts.define("n|trials=i:20");       // random sequences to average
+   opts.define("s|seed=i:1");          // random number seed
+   opts.define("l|label=s:");          // tag to add to the results line
+   opts.define("author=b");
+   opts.define("version=b");
+   opts.define("h|help=b");
+   opts.process();
+
+   if (opts.getBoolean("author")) {
+      cout << "Written by agent, agent@local, October 2026" << endl;
+      exit(0);
+   } else if (opts.getBoolean("version")) {
+      cout << "beatbench, version 1.0 (18 Oct 2026)\n"
+              "compiled: " << __DATE__ << endl;
+      exit(0);
+   } else if (opts.getBoolean("help")) {
+      usage(opts.getCommand().data());
+      exit(0);
+   }
+
+   sequenceName = opts.getString("sequence");
+   methodName   = opts.getString("method");
+   jitterAmount = opts.getDouble("jitter");
+   trials       = opts.getInteger("trials");
+   seed         = opts.getInteger("seed");
+   label        = opts.getString("label");
+
+   if (trials < 1) {
+      trials = 1;
+   }
+   if (seed == 0) {
+      seed = 1;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// usage --
+//
+
+void usage(const char* command) {
+   cout <<
+   "\n"
+   "Compare tempo tracking methods on sequences of beat times.\n"
+   "\n"
+   "Usage: " << command << " [-q sequence][-m method][-j ms] [beatfile ...]\n"
+   "\n"
+   "Options:\n"
+   "   -q name = steady, step, stepdown, ramp or rubato (default all)\n"
+   "   -m name = avg1, avg2, avg3, avg4 or kalman (default all)\n"
+   "   -j ms = standard deviation of the beat placement errors\n"
+   "   -n count = number of random sequences to average\n"
+   "   -s seed = random number seed\n"
+   "   -l label = tag to add to the results line\n"
+   "   --options = list all options, default values, and aliases\n"
+   "\n"
+   "Beat files contain one beat time in milliseconds per line.\n"
+   "\n"
+   << endl;
+}
+
+
+
@@ -0,0 +1,749 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sun Oct 18 11:41:27 PDT 2026
+// Last Modified: Sun Oct 18 11:41:30 PDT 2026
+// Last Modified: Sun Oct 18 16:40:02 PDT 2026 (array.append with 10^6 items)
+// Last Modified: Sun Oct 18 17:10:45 PDT 2026 (circularbuffer.window cases)
+// Last Modified: Mon Oct 19 02:58:44 PDT 2026 (gesture feature cases)
+// Last Modified: Mon Oct 19 08:26:33 PDT 2026 (window pipeline cost)
+// Filename:      ...improv/bench/microbench.cpp
+// Syntax:        C++; improv 2.2
+//
+// Description:   Microbenchmarks for the containers and scheduling
+//                primitives which are used on every MIDI input/output
+//                path: CircularBuffer, Array (SigCollection), EventBuffer,
+//                SigTimer, the MIDI input byte parser (MidiParser) and
+//                the gesture feature functions (GestureFeatures).
+//
+//                Each benchmark case prints one line of space separated
+//                key=value pairs:
+//                   bench=microbench case=<name> n=<size> iterations=<count>
+//                      nsperop=<nanoseconds> opspersec=<rate>
+//                The case names and keys are kept stable so that results
+//                from different versions of the library can be compared.
+//                Each case is run several times (-r option) and the
+//                fastest run is reported.
+//
+
+#include "improv.h"
+#include "MidiParser.h"
+#include "GestureFeatures.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+
+// global variables for command-line options:
+Options   options;            // for command-line processing
+string    filter;             // for -c option (run only matching cases)
+double    scale      = 1.0;   // for -s option (multiplier for iterations)
+int       repeat     = 5;     // for -r option (runs of each case)
+
+volatile long sink = 0;       // keeps the compiler from removing work
+
+// function declarations:
+void      benchArrayAppend         (int n);
+void      benchCircularEvent       (void);
+void      benchCircularIndex       (void);
+void      benchCircularInt         (void);
+void      benchCircularWindow      (int spansQ);
+void      benchEventBufferInsert   (int n);
+void      benchEventBufferXcheck   (int n);
+void      benchGesturePipeline     (int windowQ);
+void      benchGestureScale        (int windowQ);
+void      benchParser              (void);
+void      benchTimerExpired        (void);
+void      benchTimerRead           (void);
+void      checkOptions             (Options& opts);
+double    getSeconds               (void);
+int       iterations               (int base);
+void      report                   (const char* name, int n, long count,
+                                    double seconds);
+int       runCase                  (const char* name);
+void      usage                    (const char* command);
+
+
+///////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv) {
+   options.setOptions(argc, argv);
+   checkOptions(options);
+
+   if (runCase("circularbuffer.int"))     benchCircularInt();
+   if (runCase("circularbuffer.event"))   benchCircularEvent();
+   if (runCase("circularbuffer.index"))   benchCircularIndex();
+   if (runCase("circularbuffer.window.index")) benchCircularWindow(0);
+   if (runCase("circularbuffer.window.span"))  benchCircularWindow(1);
+   if (runCase("array.append")) {
+      benchArrayAppend(1000);
+      benchArrayAppend(10000);
+      benchArrayAppend(100000);
+      benchArrayAppend(1000000);
+   }
+   if (runCase("eventbuffer.insert")) {
+      benchEventBufferInsert(10);
+      benchEventBufferInsert(1000);
+      benchEventBufferInsert(100000);
+   }
+   if (runCase("eventbuffer.xcheck")) {
+      benchEventBufferXcheck(10);
+      benchEventBufferXcheck(1000);
+      benchEventBufferXcheck(100000);
+   }
+   if (runCase("gesture.pipeline.index"))  benchGesturePipeline(0);
+   if (runCase("gesture.pipeline.window")) benchGesturePipeline(1);
+   if (runCase("gesture.scale.index"))     benchGestureScale(0);
+   if (runCase("gesture.scale.window"))    benchGestureScale(1);
+   if (runCase("sigtimer.gettime"))       benchTimerRead();
+   if (runCase("sigtimer.expired"))       benchTimerExpired();
+   if (runCase("parser.bytes"))           benchParser();
+
+   return 0;
+}
+
+
+///////////////////////////////////////////////////////////////////////////
+
+
+
+//////////////////////////////
+//
+// benchCircularInt -- insert and extract pairs in a CircularBuffer<int>
+//    of the default MIDI input size.  One operation is one insert
+//    plus one extract.
+//
+
+void benchCircularInt(void) {
+   CircularBuffer<int> buffer(1024);
+   long count = iterations(10000000);
+   double best = 0.0;
+   int value;
+
+   for (int r=0; r<repeat; r++) {
+      double start = getSeconds();
+      for (long i=0; i<count; i++) {
+         buffer.insert((int)i);
+         buffer.extract(value);
+         sink += value;
+      }
+      double elapsed = getSeconds() - start;
+      if (r == 0 || elapsed < best) {
+         best = elapsed;
+      }
+   }
+   report("circularbuffer.int", 1024, count, best);
+}
+
+
+
+//////////////////////////////
+//
+// benchCircularEvent -- insert and extract pairs of MIDI messages,
+//    in bursts of 16, as the MIDI input thread and an application
+//    would do.
+//
+
+void benchCircularEvent(void) {
+   CircularBuffer<smf::MidiEvent> buffer(1024);
+   smf::MidiEvent message;
+   smf::MidiEvent output;
+   long count = iterations(2000000) / 16 * 16;
+   double best = 0.0;
+   int i, j;
+
+   message.setP0(0x90);
+   message.setP1(60);
+   message.setP2(64);
+
+   for (int r=0; r<repeat; r++) {
+      double start = getSeconds();
+      for (i=0; i<count; i+=16) {
+         for (j=0; j<16; j++) {
+            message.tick = i + j;
+            buffer.insert(message);
+         }
+         for (j=0; j<16; j++) {
+            buffer.extract(output);
+            sink += output.tick;
+         }
+      }
+      double elapsed = getSeconds() - start;
+      if (r == 0 || elapsed < best) {
+         best = elapsed;
+      }
+   }
+   report("circularbuffer.event", 1024, count, best);
+}
+
+
+
+//////////////////////////////
+//
+// benchCircularIndex -- read recent history with operator[], as the
+//    RadioBaton and Synthesizer classes do.
+//
+
+void benchCircularIndex(void) {
+   CircularBuffer<int> buffer(1024);
+   long count = iterations(10000000);
+   double best = 0.0;
+   int i;
+
+   for (i=0; i<1024; i++) {
+      buffer.insert(i);
+   }
+
+   for (int r=0; r<repeat; r++) {
+      double start = getSeconds();
+      for (long k=0; k<count; k++) {
+         sink += buffer[(int)(k & 0x1ff)];
+      }
+      double elapsed = getSeconds() - start;
+      if (r == 0 || elapsed < best) {
+         best = elapsed;
+      }
+   }
+   report("circularbuffer.index", 1024, count, best);
+}
+
+
+
+//////////////////////////////
+//
+// benchCircularWindow -- sum the last 64 values of a RadioBaton-style
+//    position history (128 shorts), either with operator[] for each
+//    value or by looping over the spans from getHistorySpans().
+//    One operation is one window.
+//
+
+void benchCircularWindow(int spansQ) {
+   CircularBuffer<short> buffer;
+   buffer.setPow2Size(100);
+   long count = iterations(1000000);
+   double best = 0.0;
+   short* first;
+   short* second;
+   int    firstCount;
+   int    secondCount;
+   int    i;
+
+   for (int r=0; r<repeat; r++) {
+      double start = getSeconds();
+      for (long k=0; k<count; k++) {
+         buffer.insert((short)k);
+         long sum = 0;
+         if (spansQ) {
+            buffer.getHistorySpans(64, first, firstCount, second, 
+                  secondCount);
+            for (i=0; i<firstCount; i++) {
+               sum += first[i];
+            }
+            for (i=0; i<secondCount; i++) {
+               sum += second[i];
+            }
+         } else {
+            for (i=0; i<64; i++) {
+               sum += buffer[i];
+            }
+         }
+         sink += sum;
+      }
+      double elapsed = getSeconds() - start;
+      if (r == 0 || elapsed < best) {
+         best = elapsed;
+      }
+   }
+   report(spansQ ? "circularbuffer.window.span" : 
+         "circularbuffer.window.index", 64, count, best);
+}
+
+
+
+//////////////////////////////
+//
+// benchGesturePipeline -- find the velocity peaks in the last 64
+//    positions of a RadioBaton-style history (128 shorts and their
+//    times): the velocity between each pair of positions, smoothed by
+//    a moving average of 4, then the peaks above a threshold.  Either
+//    each value is read with operator[] as the example programs do,
+//    or the window is loaded into arrays and given to GestureFeatures.
+//    The window version makes one pass over the arrays for each stage,
+//    so it is expected to be slower than the single index loop; the
+//    case measures the cost of that convenience.  One operation is one
+//    window.
+//
+
+void benchGesturePipeline(int windowQ) {
+   CircularBuffer<short> positions;
+   CircularBuffer<long>  times;
+   positions.setPow2Size(100);
+   times.setPow2Size(100);
+   short wave[1024];
+   double values[64];
+   double stamps[64];
+   double speeds[64];
+   double smooth[64];
+   int    peaks[64];
+   long   count = iterations(500000);
+   double best = 0.0;
+   int    i, j;
+
+   for (i=0; i<1024; i++) {
+      wave[i] = (short)(64 + 60 * sin(i * 0.1) + (i * 7 % 5));
+   }
+
+   for (int r=0; r<repeat; r++) {
+      double start = getSeconds();
+      for (long k=0; k<count; k++) {
+         positions.insert(wave[k & 1023]);
+         times.insert(k * 10 + (k & 3));
+         int found = 0;
+         if (windowQ) {
+            GestureFeatures::loadHistory(values, positions, 64);
+            GestureFeatures::loadHistory(stamps, times, 64);
+            int n = GestureFeatures::velocity(speeds, values, stamps, 64);
+            n = GestureFeatures::average(smooth, speeds, n, 4);
+            found = GestureFeatures::findPeaks(peaks, smooth, n, 0.5, 64);
+         } else {
+            for (i=0; i<63; i++) {
+               long dt = times[i] - times[i+1];
+               speeds[i] = (positions[i] - positions[i+1]) / 
+                     (double)(dt < 1 ? 1 : dt);
+            }
+            for (i=0; i<60; i++) {
+               double sum = 0.0;
+               for (j=0; j<4; j++) {
+                  sum += speeds[i+j];
+               }
+               smooth[i] = sum / 4.0;
+            }
+            for (i=1; i<59; i++) {
+               if (smooth[i] >= 0.5 && smooth[i] > smooth[i+1] &&
+                     smooth[i] >= smooth[i-1]) {
+                  found++;
+               }
+            }
+         }
+         sink += found;
+      }
+      double elapsed = getSeconds() - start;
+      if (r == 0 || elapsed < best) {
+         best = elapsed;
+      }
+   }
+   report(windowQ ? "gesture.pipeline.window" : "gesture.pipeline.index",
+         64, count, best);
+}
+
+
+
+//////////////////////////////
+//
+// benchGestureScale -- scale the last 64 values of a 7-bit history to
+//    the range 0.0 to 1.0, either one value at a time with operator[]
+//    as RadioBaton::x1psf() does for the current value, or with
+//    GestureFeatures::scale() on the loaded window.  One operation is
+//    one window.
+//
+
+void benchGestureScale(int windowQ) {
+   CircularBuffer<short> positions;
+   positions.setPow2Size(100);
+   double values[64];
+   long   count = iterations(1000000);
+   double best = 0.0;
+   int    i;
+
+   for (int r=0; r<repeat; r++) {
+      double start = getSeconds();
+      for (long k=0; k<count; k++) {
+         positions.insert((short)(k & 0x7f));
+         if (windowQ) {
+            GestureFeatures::loadHistory(values, positions, 64);
+            GestureFeatures::scale(values, values, 64, 0.0, 127.0, 0.0, 1.0);
+         } else {
+            for (i=0; i<64; i++) {
+               double value = positions[63 - i] / 127.0;
+               values[i] = value > 1.0 ? 1.0 : (value < 0.0 ? 0.0 : value);
+            }
+         }
+         sink += (long)(values[k & 63] * 100.0);
+      }
+      double elapsed = getSeconds() - start;
+      if (r == 0 || elapsed < best) {
+         best = elapsed;
+      }
+   }
+   report(windowQ ? "gesture.scale.window" : "gesture.scale.index",
+         64, count, best);
+}
+
+
+
+//////////////////////////////
+//
+// benchArrayAppend -- append n elements to an empty growable Array,
+//    using the default growth settings.  One operation is one append.
+//
+
+void benchArrayAppend(int n) {
+   long rounds = iterations(1000000) / n;
+   if (rounds < 1) {
+      rounds = 1;
+   }
+   double best = 0.0;
+
+   for (int r=0; r<repeat; r++) {
+      double start = getSeconds();
+      for (long k=0; k<rounds; k++) {
+         Array<int> array;
+         array.setSize(0);
+         array.allowGrowth();
+         for (int i=0; i<n; i++) {
+            array.append(i);
+         }
+         sink += array.getSize();
+      }
+      double elapsed = getSeconds() - start;
+      if (r == 0 || elapsed < best) {
+         best = elapsed;
+      }
+   }
+   report("array.append", n, rounds * n, best);
+}
+
+
+
+//////////////////////////////
+//
+// benchEventBufferInsert -- insert n future note events into an empty
+//    EventBuffer.  One operation is one insert.
+//
+
+void benchEventBufferInsert(int n) {
+   EventBuffer eventBuffer(n + 1);
+   NoteEvent note;
+   long rounds = iterations(1000000) / n;
+   if (rounds < 1) {
+      rounds = 1;
+   }
+   double best = 0.0;
+
+   note.setChannel(0);
+   note.setKeyno(60);
+   note.setVelocity(64);
+
+   for (int r=0; r<repeat; r++) {
+      double elapsed = 0.0;
+      for (long k=0; k<rounds; k++) {
+         double start = getSeconds();
+         for (int i=0; i<n; i++) {
+            note.setOnDur(1000000000 + i, 100);
+            note.setStatus(EVENT_STATUS_ACTIVE);
+            eventBuffer.insert(&note);
+         }
+         elapsed += getSeconds() - start;
+         eventBuffer.reset();
+      }
+      if (r == 0 || elapsed < best) {
+         best = elapsed;
+      }
+   }
+   report("eventbuffer.insert", n, rounds * n, best);
+}
+
+
+
+//////////////////////////////
+//
+// benchEventBufferXcheck -- check an EventBuffer containing n pending
+//    events, none of which are ready to be played.  This is the
+//    cost which is paid on every pass through an improv main loop.
+//    One operation is one call to xcheck().
+//
+
+void benchEventBufferXcheck(int n) {
+   EventBuffer eventBuffer(n + 1);
+   NoteEvent note;
+   long count = iterations(10000000) / n;
+   if (count < 10) {
+      count = 10;
+   }
+   double best = 0.0;
+   int i;
+
+   note.setChannel(0);
+   note.setKeyno(60);
+   note.setVelocity(64);
+   for (i=0; i<n; i++) {
+      note.setOnDur(1000000000 + i, 100);
+      note.setStatus(EVENT_STATUS_ACTIVE);
+      eventBuffer.insert(&note);
+   }
+
+   for (int r=0; r<repeat; r++) {
+      double start = getSeconds();
+      for (long k=0; k<count; k++) {
+         eventBuffer.xcheck(k);
+      }
+      double elapsed = getSeconds() - start;
+      if (r == 0 || elapsed < best) {
+         best = elapsed;
+      }
+   }
+   sink += eventBuffer.getFreeCount();
+   report("eventbuffer.xcheck", n, count, best);
+}
+
+
+
+//////////////////////////////
+//
+// benchTimerRead -- cost of reading the current time from a SigTimer.
+//
+
+void benchTimerRead(void) {
+   SigTimer timer;
+   long count = iterations(10000000);
+   double best = 0.0;
+
+   for (int r=0; r<repeat; r++) {
+      double start = getSeconds();
+      for (long i=0; i<count; i++) {
+         sink += timer.getTime();
+      }
+      double elapsed = getSeconds() - start;
+      if (r == 0 || elapsed < best) {
+         best = elapsed;
+      }
+   }
+   report("sigtimer.gettime", 1, count, best);
+}
+
+
+
+//////////////////////////////
+//
+// benchTimerExpired -- cost of checking a periodic SigTimer, as is done
+//    by the keyboard and poll timers in the improv main loops.
+//
+
+void benchTimerExpired(void) {
+   SigTimer timer;
+   long count = iterations(10000000);
+   double best = 0.0;
+
+   timer.setPeriod(1000000.0);
+   timer.reset();
+   for (int r=0; r<repeat; r++) {
+      double start = getSeconds();
+      for (long i=0; i<count; i++) {
+         sink += timer.expired();
+      }
+      double elapsed = getSeconds() - start;
+      if (r == 0 || elapsed < best) {
+         best = elapsed;
+      }
+   }
+   report("sigtimer.expired", 1, count, best);
+}
+
+
+
+//////////////////////////////
+//
+// benchParser -- parse a MIDI byte stream which is a mix of note
+//    messages with running status, controller messages and short
+//    sysex messages.  One operation is one byte.
+//
+
+void benchParser(void) {
+   Array<uchar> stream;
+   MidiParser parser;
+   long count;
+   double best = 0.0;
+   int i, j;
+
+   stream.setSize(0);
+   stream.allowGrowth();
+   stream.setGrowth(4096);
+   uchar byte;
+   for (i=0; i<256; i++) {
+      byte = 0x90;             stream.append(byte);
+      for (j=0; j<8; j++) {
+         byte = (i + j) & 0x7f; stream.append(byte);
+         byte = j * 8;          stream.append(byte);
+      }
+      byte = 0xb0;             stream.append(byte);
+      byte = 7;                stream.append(byte);
+      byte = i & 0x7f;         stream.append(byte);
+      if (i % 16 == 0) {
+         byte = 0xf0;          stream.append(byte);
+         for (j=0; j<30; j++) {
+            byte = j;          stream.append(byte);
+         }
+         byte = 0xf7;          stream.append(byte);
+      }
+   }
+
+   long rounds = iterations(20000000) / stream.getSize();
+   if (rounds < 1) {
+      rounds = 1;
+   }
+   count = rounds * stream.getSize();
+   uchar* data = stream.getBase();
+   int size = stream.getSize();
+
+   for (int r=0; r<repeat; r++) {
+      double start = getSeconds();
+      for (long k=0; k<rounds; k++) {
+         for (i=0; i<size; i++) {
+            if (parser.parse(data[i], i)) {
+               if (parser.isSysex()) {
+                  sink += parser.getSysexSize();
+                  parser.clearSysex();
+               } else {
+                  sink += parser.getMessage().getP1();
+               }
+               parser.getMessage().tick = 0;
+            }
+         }
+      }
+      double elapsed = getSeconds() - start;
+      if (r == 0 || elapsed < best) {
+         best = elapsed;
+      }
+   }
+   report("parser.bytes", size, count, best);
+}
+
+
+
+//////////////////////////////
+//
+// report -- print the results of a benchmark case.  Do not change
+//    the names of existing keys since they are used to compare runs
+//    over time.
+//
+
+void report(const char* name, int n, long count, double seconds) {
+   double nsperop = 0.0;
+   double opspersec = 0.0;
+   if (count > 0) {
+      nsperop = seconds * 1000000000.0 / count;
+   }
+   if (seconds > 0.0) {
+      opspersec = count / seconds;
+   }
+   cout << "bench=microbench"
+        << " case="       << name
+        << " n="          << n
+        << " iterations=" << count
+        << " nsperop="    << nsperop
+        << " opspersec="  << opspersec
+        << endl;
+}
+
+
+
+//////////////////////////////
+//
+// runCase -- returns true if the named case should be run.
+//
+
+int runCase(const char* name) {
+   if (filter.size() == 0) {
+      return 1;
+   }
+   return strstr(name, filter.c_str()) != NULL;
+}
+
+
+
+//////////////////////////////
+//
+// iterations -- scale the default iteration count of a case.
+//
+
+int iterations(int base) {
+   int value = (int)(base * scale);
+   return value < 1 ? 1 : value;
+}
+
+
+
+//////////////////////////////
+//
+// getSeconds -- return a monotonic time in seconds.
+//
+
+double getSeconds(void) {
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ts.tv_sec + ts.tv_nsec / 1000000000.0;
+}
+
+
+
+//////////////////////////////
+//
+// checkOptions -- handle command-line options.
+//
+
+void checkOptions(Options& opts) {
+   opts.define("c|case=s:");           // run only cases containing string
+   opts.define("s|scale=d:1.0");       // multiplier for iteration counts
+   opts.define("r|repeat=i:5");        // number of runs for each case
+   opts.define("author=b");
+   opts.define("version=b");
+   opts.define("h|help=b");
+   opts.process();
+
+   if (opts.getBoolean("author")) {
+      cout << "Written by agent, agent@local, October 2026" << endl;
+      exit(0);
+   } else if (opts.getBoolean("version")) {
+      cout << "microbench, version 1.0 (18 Oct 2026)\n"
+              "compiled: " << __DATE__ << endl;
+      exit(0);
+   } else if (opts.getBoolean("help")) {
+      usage(opts.getCommand().data());
+      exit(0);
+   }
+
+   filter = opts.getString("case");
+   scale  = opts.getDouble("scale");
+   repeat = opts.getInteger("repeat");
+   if (scale <= 0.0) {
+      scale = 1.0;
+   }
+   if (repeat < 1) {
+      repeat = 1;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// usage -- how to run this program from the command-line.
+//
+
+void usage(const char* command) {
+   cout <<
+   "\n"
+   "Time the core containers and scheduling primitives.\n"
+   "\n"
+   "Usage: " << command << " [-c case][-s scale][-r repeat]\n"
+   "\n"
+   "Options:\n"
+   "   -c string = run only the cases whose names contain the string\n"
+   "        (e.g. \"eventbuffer\", \"parser\" or \"gesture\")\n"
+   "   -s scale = multiply the iteration count of each case\n"
+   "   -r count = number of runs of each case (fastest is reported)\n"
+   "   --options = list all options, default values, and aliases\n"
+   "\n"
+   << endl;
+}
+
+
@@ -0,0 +1,686 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sun Oct 18 10:12:40 PDT 2026
+// Last Modified: Sun Oct 18 15:46:30 PDT 2026 (added -R option)
+// Last Modified: Mon Oct 19 06:14:08 PDT 2026 (operator new is opt-in)
+// Last Modified: Mon Oct 19 08:49:30 PDT 2026 (loopback through a parser)
+// Filename:      ...improv/bench/midibench.cpp
+// Syntax:        C++; improv 2.2
+//
+// Description:   Round-trip latency and throughput benchmark for the
+//                MIDI stack: MidiOutput -> port -> input thread ->
+//                MidiInput -> application.  Each message carries a
+//                sequence number in its data bytes so that the receiving
+//                side can match it to its send time, and detect dropped
+//                or duplicated messages.
+//
+//                Two transports are available:
+//                   loopback: in-process, a sender thread writes the
+//                             raw MIDI bytes of each message (whole
+//                             F0...F7 dumps for sysex) into a pipe, and
+//                             an input thread for each port reads them
+//                             back one byte at a time, assembles them
+//                             with MidiParser, and stores them in a
+//                             MidiInput orphan buffer, as the ALSA
+//                             input thread does.  The MIDI driver and
+//                             MidiOutput are not included.
+//                   alsa:     MidiOutput port N is looped back into
+//                             MidiInput port M, for example by connecting
+//                             a snd-virmidi device to itself:
+//                                aconnect 'Virtual Raw MIDI 1-0'
+//                                         'Virtual Raw MIDI 1-0'
+//
+//                Results are printed as one line per run of space
+//                separated key=value pairs so that they can be collected
+//                and compared across versions.  The path key tells what
+//                the messages went through, so that loopback results
+//                are not mistaken for driver results.
+//
+
+#include "improv.h"
+#include "RealtimeNew.h"
+#include "MidiParser.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MODE_LOOPBACK    (0)
+#define MODE_ALSA        (1)
+
+#define SHAPE_NOTES      (0)
+#define SHAPE_CC         (1)
+#define SHAPE_SYSEX      (2)
+
+#define MAX_SEQUENCE     (1 << 18)    // 18 bits of sequence in a message
+#define MAX_PORTS        (16)
+
+// global variables for command-line options:
+Options   options;            // for command-line processing
+int       mode       = MODE_LOOPBACK;  // for -m option
+int       shape      = SHAPE_NOTES;    // for -s option
+int       portCount  = 1;     // for -p option
+int       inport     = 0;     // for -i option
+int       outport    = 0;     // for -o option
+int       count      = 10000; // for -n option (messages per port)
+int       burst      = 1;     // for -b option (messages per burst)
+double    rate       = 0.0;   // for -r option (bursts/second, 0 = no limit)
+int       sysexSize  = 64;    // for -z option (bytes in a sysex message)
+int       timeout    = 1000;  // for -t option (drain time in milliseconds)
+string    label;              // for -l option (tag for results line)
+int       realtimeQ  = 0;     // for -R option (count heap allocations)
+
+// benchmark state:
+MidiOutput*        midiout[MAX_PORTS];
+MidiInput*         midiin[MAX_PORTS];
+int                loopbackIn[MAX_PORTS];  // read end of each loopback pipe
+int                loopbackOut[MAX_PORTS]; // write end of each pipe
+int                portIndex[MAX_PORTS];   // argument of each input thread
+pthread_t          loopbackReader[MAX_PORTS];
+pthread_mutex_t    loopbackLock = PTHREAD_MUTEX_INITIALIZER;
+double*            sendTime[MAX_PORTS];    // send time of each sequence
+char*              received[MAX_PORTS];    // receipt count of each sequence
+Array<double>      latency;                // round-trip times in usecs
+volatile int       senderDoneQ = 0;
+double             senderStart = 0.0;
+double             senderStop  = 0.0;
+long               byteCount   = 0;
+smf::MidiEvent     outMessage;             // reused by the sender thread
+smf::MidiEvent     inMessage;              // reused by the receiver
+
+// function declarations:
+void      checkOptions       (Options& opts);
+double    getMicroseconds    (void);
+int       getSequence        (int port, smf::MidiEvent& message);
+int       latencyCompare     (const void* a, const void* b);
+void*     loopbackThread     (void* arg);
+double    percentile         (Array<double>& sorted, double fraction);
+void      printResults       (ostream& out, int sent, int receivedCount,
+                              int duplicates, int unknown,
+                              double receiveStop);
+int       receiveMessages    (int& duplicates, int& unknown);
+void      sendBytes          (int port, const uchar* data, int size);
+void      sendMessage        (int port, int sequence, uchar* sysexData);
+void*     senderThread       (void* arg);
+void      usage              (const char* command);
+
+
+///////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv) {
+   options.setOptions(argc, argv);
+   checkOptions(options);
+
+   int i;
+   for (i=0; i<portCount; i++) {
+      sendTime[i] = new double[count];
+      received[i] = new char[count];
+      memset(received[i], 0, count);
+      for (int j=0; j<count; j++) {
+         sendTime[i][j] = 0.0;
+      }
+      if (mode == MODE_ALSA) {
+         midiout[i] = new MidiOutput(outport + i, 1);
+         midiin[i]  = new MidiInput(inport + i, 1);
+      } else {
+         // the pipe stands in for the MIDI device; an orphan input
+         // has its own message and sysex buffers.
+         midiout[i] = NULL;
+         midiin[i]  = new MidiInput(-1, 0);
+         midiin[i]->makeOrphanBuffer(count < 1024 ? 1024 : count);
+         int fds[2];
+         if (pipe(fds) != 0) {
+            cerr << "Error: cannot make a loopback pipe" << endl;
+            exit(1);
+         }
+         loopbackIn[i]  = fds[0];
+         loopbackOut[i] = fds[1];
+         portIndex[i]   = i;
+         if (pthread_create(&loopbackReader[i], NULL, loopbackThread,
+               &portIndex[i]) != 0) {
+            cerr << "Error: cannot create loopback input thread" << endl;
+            exit(1);
+         }
+      }
+   }
+   latency.setSize(count * portCount);
+   latency.setSize(0);
+   latency.allowGrowth();
+
+   // allocate message storage before starting to send and receive
+   outMessage.setP2(0);
+   inMessage.setP3(0);
+   if (realtimeQ) {
+      RealtimeCheck::setMode(REALTIME_COUNT);
+   }
+
+   pthread_t sender;
+   if (pthread_create(&sender, NULL, senderThread, NULL) != 0) {
+      cerr << "Error: cannot create sender thread" << endl;
+      exit(1);
+   }
+
+   int duplicates = 0;
+   int unknown = 0;
+   int total = 0;
+   int expected = count * portCount;
+   double lastArrival = getMicroseconds();
+   RealtimeCheck::enterThread();
+   while (total < expected) {
+      int newcount = receiveMessages(duplicates, unknown);
+      if (newcount > 0) {
+         total += newcount;
+         lastArrival = getMicroseconds();
+      } else if (senderDoneQ &&
+            getMicroseconds() - lastArrival > timeout * 1000.0) {
+         break;
+      }
+   }
+   RealtimeCheck::leaveThread();
+   double receiveStop = lastArrival;
+   pthread_join(sender, NULL);
+   if (mode == MODE_LOOPBACK) {
+      for (i=0; i<portCount; i++) {
+         close(loopbackOut[i]);     // the input thread then finishes
+         pthread_join(loopbackReader[i], NULL);
+         close(loopbackIn[i]);
+      }
+   }
+
+   printResults(cout, expected, total, duplicates, unknown, receiveStop);
+
+   for (i=0; i<portCount; i++) {
+      if (midiout[i] != NULL) {
+         delete midiout[i];
+      }
+      delete midiin[i];
+      delete [] sendTime[i];
+      delete [] received[i];
+   }
+
+   return 0;
+}
+
+
+///////////////////////////////////////////////////////////////////////////
+
+
+
+//////////////////////////////
+//
+// senderThread -- generate the load shape on all ports.  Messages
+//    are sent in bursts of the requested size, optionally paced
+//    to a fixed number of bursts per second.
+//
+
+void* senderThread(void* arg) {
+   uchar* sysexData = new uchar[sysexSize];
+   double period = rate > 0.0 ? 1000000.0 / rate : 0.0;
+   double nextBurst;
+   int sequence = 0;
+   int i, j;
+
+   RealtimeCheck::enterThread();
+   senderStart = getMicroseconds();
+   nextBurst = senderStart;
+   while (sequence < count) {
+      if (period > 0.0) {
+         // sleep rather than spin so that a receiver on the same CPU
+         // is not starved of time between bursts.
+         struct timespec wakeup;
+         wakeup.tv_sec  = (time_t)(nextBurst / 1000000.0);
+         wakeup.tv_nsec = (long)((nextBurst - wakeup.tv_sec * 1000000.0)
+                                 * 1000.0);
+         clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeup, NULL);
+         nextBurst += period;
+      }
+      for (i=0; i<burst && sequence < count; i++) {
+         for (j=0; j<portCount; j++) {
+            sendMessage(j, sequence, sysexData);
+         }
+         sequence++;
+      }
+   }
+   senderStop = getMicroseconds();
+   senderDoneQ = 1;
+   RealtimeCheck::leaveThread();
+
+   delete [] sysexData;
+   return NULL;
+}
+
+
+
+//////////////////////////////
+//
+// loopbackThread -- the input thread of one loopback port: read the
+//    bytes from the pipe one at a time, as the ALSA input thread reads
+//    them from the device, and store each complete message in the
+//    orphan buffer of the port.  Sysex messages are stored in the
+//    sysex buffers of the input, with a [0xf0, buffer] message in the
+//    message buffer.  Finishes when the pipe is closed.
+//
+
+void* loopbackThread(void* arg) {
+   int port = *(int*)arg;
+   MidiParser parser;
+   uchar datum;
+
+   RealtimeCheck::enterThread();
+   while (read(loopbackIn[port], &datum, 1) == 1) {
+      if (!parser.parse(datum, (int)(getMicroseconds() / 1000.0))) {
+         continue;
+      }
+      smf::MidiEvent& message = parser.getMessage();
+      pthread_mutex_lock(&loopbackLock);
+      if (parser.isSysex()) {
+         int buffer = midiin[port]->installSysex(parser.getSysexData(),
+               parser.getSysexSize());
+         message.setP0(0xf0);
+         message.setP1(buffer);
+         parser.clearSysex();
+      }
+      midiin[port]->insert(message);
+      pthread_mutex_unlock(&loopbackLock);
+      message.tick = 0;
+   }
+   RealtimeCheck::leaveThread();
+
+   return NULL;
+}
+
+
+
+//////////////////////////////
+//
+// sendBytes -- write raw MIDI bytes into the loopback pipe of a port.
+//
+
+void sendBytes(int port, const uchar* data, int size) {
+   while (size > 0) {
+      int written = (int)write(loopbackOut[port], data, size);
+      if (written <= 0) {
+         cerr << "Error: cannot write to loopback pipe" << endl;
+         exit(1);
+      }
+      data += written;
+      size -= written;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// sendMessage -- send one message carrying the given sequence number.
+//    Notes and controllers place the sequence in the channel nibble
+//    and the two data bytes.  Sysex messages carry it in the first
+//    three data bytes after a non-commercial manufacturer ID, followed
+//    by filler up to the sysex size and a final 0xf7.
+//
+
+void sendMessage(int port, int sequence, uchar* sysexData) {
+   smf::MidiEvent& message = outMessage;
+   int command;
+   int i;
+
+   switch (shape) {
+      case SHAPE_SYSEX:
+         sysexData[0] = 0xf0;
+         sysexData[1] = 0x7d;
+         sysexData[2] = sequence & 0x7f;
+         sysexData[3] = (sequence >> 7) & 0x7f;
+         sysexData[4] = (sequence >> 14) & 0x7f;
+         for (i=5; i<sysexSize-1; i++) {
+            sysexData[i] = i & 0x7f;
+         }
+         sysexData[sysexSize-1] = 0xf7;
+         sendTime[port][sequence] = getMicroseconds();
+         if (mode == MODE_ALSA) {
+            midiout[port]->sysex(sysexData, sysexSize);
+         } else {
+            sendBytes(port, sysexData, sysexSize);
+         }
+         byteCount += sysexSize;
+         return;
+
+      case SHAPE_CC:
+         command = 0xb0;
+         break;
+
+      case SHAPE_NOTES:
+      default:
+         command = 0x90;
+         break;
+   }
+
+   command |= (sequence >> 14) & 0x0f;
+   message.setP0(command);
+   message.setP1(sequence & 0x7f);
+   message.setP2((sequence >> 7) & 0x7f);
+
+   sendTime[port][sequence] = getMicroseconds();
+   if (mode == MODE_ALSA) {
+      midiout[port]->send(message);
+   } else {
+      uchar bytes[3];
+      bytes[0] = (uchar)command;
+      bytes[1] = sequence & 0x7f;
+      bytes[2] = (sequence >> 7) & 0x7f;
+      sendBytes(port, bytes, 3);
+   }
+   byteCount += 3;
+}
+
+
+
+//////////////////////////////
+//
+// receiveMessages -- extract all waiting messages from the input
+//    ports, and store their round-trip times.  Returns the number
+//    of new (non-duplicate) messages which were received.
+//
+
+int receiveMessages(int& duplicates, int& unknown) {
+   smf::MidiEvent& message = inMessage;
+   double now;
+   double roundtrip;
+   int sequence;
+   int newcount = 0;
+   int i;
+
+   for (i=0; i<portCount; i++) {
+      while (1) {
+         // the loopback input threads share the orphan buffers
+         if (mode == MODE_LOOPBACK) {
+            pthread_mutex_lock(&loopbackLock);
+         }
+         if (midiin[i]->getCount() <= 0) {
+            if (mode == MODE_LOOPBACK) {
+               pthread_mutex_unlock(&loopbackLock);
+            }
+            break;
+         }
+         midiin[i]->extract(message);
+         now = getMicroseconds();
+         sequence = getSequence(i, message);
+         if (mode == MODE_LOOPBACK) {
+            pthread_mutex_unlock(&loopbackLock);
+         }
+
+         if (sequence < 0 || sequence >= count || sendTime[i][sequence] == 0.0) {
+            unknown++;
+            continue;
+         }
+         if (received[i][sequence]) {
+            duplicates++;
+            continue;
+         }
+         received[i][sequence] = 1;
+         roundtrip = now - sendTime[i][sequence];
+         latency.append(roundtrip);
+         newcount++;
+      }
+   }
+
+   return newcount;
+}
+
+
+
+//////////////////////////////
+//
+// getSequence -- returns the sequence number carried by a received
+//    message, or -1 if a sysex message is too short to hold one.  The
+//    sysex buffer is emptied after it has been read.
+//
+
+int getSequence(int port, smf::MidiEvent& message) {
+   if (message.getP0() != 0xf0) {
+      return message.getP1() | (message.getP2() << 7) |
+            ((message.getP0() & 0x0f) << 14);
+   }
+
+   int buffer = message.getP1();
+   uchar* data = midiin[port]->getSysex(buffer);
+   if (data == NULL || midiin[port]->getSysexSize(buffer) < 5) {
+      return -1;
+   }
+   int sequence = data[2] | (data[3] << 7) | (data[4] << 14);
+   midiin[port]->clearSysex(buffer);
+   return sequence;
+}
+
+
+
+//////////////////////////////
+//
+// printResults -- print a single line of key=value pairs describing
+//    the run.  Times are in microseconds.  Do not change the names
+//    of existing keys since they are used to compare runs over time.
+//
+
+void printResults(ostream& out, int sent, int receivedCount, int duplicates,
+      int unknown, double receiveStop) {
+   const char* modenames[2]  = {"loopback", "alsa"};
+   const char* pathnames[2]  = {"pipe+parser", "driver+parser"};
+   const char* shapenames[3] = {"notes", "cc", "sysex"};
+
+   qsort(latency.getBase(), latency.getSize(), sizeof(double),
+         latencyCompare);
+
+   double elapsed = receiveStop - senderStart;
+   double throughput = 0.0;
+   if (elapsed > 0.0) {
+      throughput = receivedCount / (elapsed / 1000000.0);
+   }
+
+   out << "bench=midibench";
+   if (label.size() > 0) {
+      out << " label=" << label;
+   }
+   out << " mode="       << modenames[mode]
+       << " path="       << pathnames[mode]
+       << " shape="      << shapenames[shape]
+       << " ports="      << portCount
+       << " count="      << count
+       << " burst="      << burst
+       << " rate="       << rate;
+   if (shape == SHAPE_SYSEX) {
+      out << " sysexsize=" << sysexSize;
+   }
+   out << " sent="       << sent
+       << " received="   << receivedCount
+       << " dropped="    << sent - receivedCount
+       << " duplicates=" << duplicates
+       << " unknown="    << unknown
+       << " bytes="      << byteCount
+       << " sendtime="   << senderStop - senderStart
+       << " msgpersec="  << throughput
+       << " p50="        << percentile(latency, 0.50)
+       << " p99="        << percentile(latency, 0.99)
+       << " p999="       << percentile(latency, 0.999)
+       << " max="        << percentile(latency, 1.0);
+   if (realtimeQ) {
+      out << " rtallocs="  << RealtimeCheck::getCount();
+   }
+   out << endl;
+}
+
+
+
+//////////////////////////////
+//
+// percentile -- return the value at the given fraction of a sorted
+//    array, using the nearest-rank method.  Returns 0 if there are
+//    no values.
+//
+
+double percentile(Array<double>& sorted, double fraction) {
+   if (sorted.getSize() == 0) {
+      return 0.0;
+   }
+   int index = (int)(fraction * sorted.getSize() + 0.5) - 1;
+   if (index < 0) {
+      index = 0;
+   } else if (index >= sorted.getSize()) {
+      index = sorted.getSize() - 1;
+   }
+   return sorted[index];
+}
+
+
+
+//////////////////////////////
+//
+// latencyCompare -- for sorting the latency list with qsort.
+//
+
+int latencyCompare(const void* a, const void* b) {
+   double x = *(const double*)a;
+   double y = *(const double*)b;
+   if (x < y) {
+      return -1;
+   } else if (x > y) {
+      return 1;
+   } else {
+      return 0;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// getMicroseconds -- return a monotonic time in microseconds.
+//
+
+double getMicroseconds(void) {
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ts.tv_sec * 1000000.0 + ts.tv_nsec / 1000.0;
+}
+
+
+
+//////////////////////////////
+//
+// checkOptions -- handle command-line options.
+//
+
+void checkOptions(Options& opts) {
+   opts.define("m|mode=s:loopback");   // transport: loopback or alsa
+   opts.define("s|shape=s:notes");     // load shape: notes, cc or sysex
+   opts.define("p|ports=i:1");         // number of ports to drive at once
+   opts.define("i|inport=i:0");        // first MIDI input port (alsa mode)
+   opts.define("o|outport=i:0");       // first MIDI output port (alsa mode)
+   opts.define("n|count=i:10000");     // messages to send per port
+   opts.define("b|burst=i:1");         // messages in each burst
+   opts.define("r|rate=d:0.0");        // bursts per second (0 = no pacing)
+   opts.define("z|sysex-size=i:64");   // bytes in each sysex message
+   opts.define("t|timeout=i:1000");    // drain timeout in milliseconds
+   opts.define("l|label=s:");          // tag to add to the results line
+   opts.define("R|realtime=b");        // count allocations while running
+   opts.define("author=b");
+   opts.define("version=b");
+   opts.define("h|help=b");
+   opts.process();
+
+   if (opts.getBoolean("author")) {
+      cout << "Written by agent, agent@local, October 2026" << endl;
+      exit(0);
+   } else if (opts.getBoolean("version")) {
+      cout << "midibench, version 1.0 (18 Oct 2026)\n"
+              "compiled: " << __DATE__ << endl;
+      exit(0);
+   } else if (opts.getBoolean("help")) {
+      usage(opts.getCommand().data());
+      exit(0);
+   }
+
+   string modename = opts.getString("mode");
+   if (modename == "loopback") {
+      mode = MODE_LOOPBACK;
+   } else if (modename == "alsa") {
+      mode = MODE_ALSA;
+   } else {
+      cerr << "Error: unknown mode: " << modename << endl;
+      exit(1);
+   }
+
+   string shapename = opts.getString("shape");
+   if (shapename == "notes") {
+      shape = SHAPE_NOTES;
+   } else if (shapename == "cc") {
+      shape = SHAPE_CC;
+   } else if (shapename == "sysex") {
+      shape = SHAPE_SYSEX;
+   } else {
+      cerr << "Error: unknown load shape: " << shapename << endl;
+      exit(1);
+   }
+
+   portCount = opts.getInteger("ports");
+   inport    = opts.getInteger("inport");
+   outport   = opts.getInteger("outport");
+   count     = opts.getInteger("count");
+   burst     = opts.getInteger("burst");
+   rate      = opts.getDouble("rate");
+   sysexSize = opts.getInteger("sysex-size");
+   timeout   = opts.getInteger("timeout");
+   label     = opts.getString("label");
+   realtimeQ = opts.getBoolean("realtime");
+
+   if (portCount < 1 || portCount > MAX_PORTS) {
+      cerr << "Error: port count must be in the range from 1 to "
+           << MAX_PORTS << endl;
+      exit(1);
+   }
+   if (count < 1 || count > MAX_SEQUENCE) {
+      cerr << "Error: message count must be in the range from 1 to "
+           << MAX_SEQUENCE << endl;
+      exit(1);
+   }
+   if (burst < 1) {
+      burst = 1;
+   }
+   if (sysexSize < 6) {
+      sysexSize = 6;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// usage -- how to run this program from the command-line.
+//
+
+void usage(const char* command) {
+   cout <<
+   "\n"
+   "Measure MIDI round-trip latency and throughput.\n"
+   "\n"
+   "Usage: " << command << " [-m mode][-s shape][-p ports][-n count]\n"
+   "\n"
+   "Options:\n"
+   "   -m mode = loopback (in-process pipe and parser, no MIDI driver,\n"
+   "             default) or alsa\n"
+   "   -s shape = notes (default), cc or sysex\n"
+   "   -p ports = number of ports to drive at the same time\n"
+   "   -i port = first MIDI input port to read from in alsa mode\n"
+   "   -o port = first MIDI output port to write to in alsa mode\n"
+   "   -n count = number of messages to send on each port\n"
+   "   -b size = number of messages in each burst\n"
+   "   -r rate = bursts per second (0 = as fast as possible)\n"
+   "   -z size = number of bytes in each sysex message\n"
+   "   -t msec = time to wait for missing messages after sending\n"
+   "   -l label = tag to add to the results line\n"
+   "   -R = count heap allocations made while sending and receiving\n"
+   "   --options = list all options, default values, and aliases\n"
+   "\n"
+   << endl;
+}
+
+
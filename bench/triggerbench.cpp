@@ -0,0 +1,509 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Mon Oct 19 01:10:42 PDT 2026
+// Last Modified: Mon Oct 19 01:10:46 PDT 2026
+// Filename:      ...improv/bench/triggerbench.cpp
+// Syntax:        C++; improv 2.2
+//
+// Description:   Measures how well the TriggerPredictor class predicts
+//                baton triggers from the stick positions.  The position
+//                reports of a baton session are given to a predictor
+//                for each stick, and each pre-trigger is matched with
+//                the next trigger message of the same stick.  The error
+//                is the predicted impact time minus the time of the
+//                trigger message, and the lead is how long before the
+//                trigger message the pre-trigger was given.
+//
+//                Sessions are either recordings made with
+//                RadioBaton::recordStateStart() (lines of "time p1 x y z"
+//                and "time t1 x y w", with the same for stick 2), or are
+//                generated (strokes, feints, noisy): strokes of random
+//                length and height sampled every 20 ms, where feints
+//                also has strokes which stop before the trigger plane
+//                and noisy has more noise in the heights.
+//
+//                Results are printed as one line per session of space
+//                separated key=value pairs:
+//                   bench=triggerbench session=<name> level=<z>
+//                      triggers=<count> predicted=<count> missed=<count>
+//                      false=<count> meanerr=<ms> rmserr=<ms>
+//                      maxerr=<ms> bias=<ms> meanlead=<ms>
+//
+
+#include "improv.h"
+#include "TriggerPredictor.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <fstream>
+
+#define REPORT_PERIOD  (20.0)   // ms between generated position reports
+#define MATCH_WINDOW   (150.0)  // longest lead for a correct pre-trigger
+
+// global variables for command-line options:
+Options   options;            // for command-line processing
+string    sessionName;        // for -q option
+int       window     = 6;     // for -w option
+double    leadTime   = 50.0;  // for -t option
+double    minVelocity = 200.0;  // for -v option
+double    confidence = 0.9;   // for -c option
+double    level      = 110.0; // for -z option
+int       levelQ     = 0;     // true if -z option was given
+double    rearm      = 10.0;  // for -r option
+double    noise      = 1.0;   // for -j option
+int       strokes    = 200;   // for -n option
+int       seed       = 1;     // for -s option
+string    label;              // for -l option (tag for results line)
+
+// random number state:
+unsigned long long randomState = 1;
+
+// a session is a list of position reports and trigger messages:
+Array<double> eventTimes;     // time of each report in ms
+Array<int>    eventTypes;     // 0 = position, 1 = trigger
+Array<int>    eventSticks;    // stick number, 1 or 2
+Array<int>    eventHeights;   // height of the stick for positions
+
+// function declarations:
+void      addEvent           (double time, int type, int stick, int height);
+double    calibrateLevel     (void);
+void      checkOptions       (Options& opts);
+double    gaussian           (void);
+void      generateSession    (const char* name);
+int       readSession        (const char* filename);
+void      runSession         (const char* name);
+double    uniform            (void);
+void      usage              (const char* command);
+
+
+///////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv) {
+   options.setOptions(argc, argv);
+   checkOptions(options);
+
+   if (options.getArgCount() > 0) {
+      for (int i=1; i<=options.getArgCount(); i++) {
+         runSession(options.getArg(i).data());
+      }
+   } else if (sessionName.size() > 0) {
+      runSession(sessionName.data());
+   } else {
+      const char* names[] = {"strokes", "feints", "noisy"};
+      for (int i=0; i<3; i++) {
+         runSession(names[i]);
+      }
+   }
+
+   return 0;
+}
+
+
+///////////////////////////////////////////////////////////////////////////
+
+
+//////////////////////////////
+//
+// runSession -- give the named session to a predictor for each stick,
+//     and print the results line.
+//
+
+void runSession(const char* name) {
+   eventTimes.setSize(0);
+   eventTypes.setSize(0);
+   eventSticks.setSize(0);
+   eventHeights.setSize(0);
+   int fileQ = strcmp(name, "strokes") != 0 && strcmp(name, "feints") != 0 &&
+         strcmp(name, "noisy") != 0;
+   double sessionLevel = level;
+   if (fileQ) {
+      if (!readSession(name)) {
+         exit(1);
+      }
+      if (!levelQ) {
+         sessionLevel = calibrateLevel();
+      }
+   } else {
+      randomState = seed;
+      generateSession(name);
+   }
+
+   TriggerPredictor predictor[2];
+   for (int i=0; i<2; i++) {
+      predictor[i].setWindow(window);
+      predictor[i].setLeadTime(leadTime);
+      predictor[i].setMinVelocity(minVelocity);
+      predictor[i].setConfidence(confidence);
+      predictor[i].setTriggerLevel(sessionLevel);
+      predictor[i].setRearmDistance(rearm);
+   }
+
+   // the pre-trigger waiting for a trigger message on each stick:
+   int    pendingQ[2]   = {0, 0};
+   double fireTime[2]   = {0.0, 0.0};
+   double impactTime[2] = {0.0, 0.0};
+
+   int    triggers = 0;
+   int    predicted = 0;
+   int    falseAlarms = 0;
+   double sumError = 0.0;
+   double sumSquare = 0.0;
+   double sumSigned = 0.0;
+   double maxError = 0.0;
+   double sumLead = 0.0;
+
+   for (int i=0; i<eventTimes.getSize(); i++) {
+      int stick = eventSticks[i] - 1;
+      double time = eventTimes[i];
+      if (pendingQ[stick] && time - fireTime[stick] > MATCH_WINDOW) {
+         falseAlarms++;
+         pendingQ[stick] = 0;
+      }
+      if (eventTypes[i] == 1) {
+         triggers++;
+         predictor[stick].trigger();
+         if (pendingQ[stick]) {
+            double error = impactTime[stick] - time;
+            predicted++;
+            sumSigned += error;
+            sumError += fabs(error);
+            sumSquare += error * error;
+            if (fabs(error) > maxError) {
+               maxError = fabs(error);
+            }
+            sumLead += time - fireTime[stick];
+            pendingQ[stick] = 0;
+         }
+      } else if (predictor[stick].position((long)time, eventHeights[i])) {
+         if (pendingQ[stick]) {
+            falseAlarms++;
+         }
+         pendingQ[stick] = 1;
+         fireTime[stick] = time;
+         impactTime[stick] = predictor[stick].getImpactTime();
+      }
+   }
+   falseAlarms += pendingQ[0] + pendingQ[1];
+
+   cout << "bench=triggerbench";
+   if (label.size() > 0) {
+      cout << " label=" << label;
+   }
+   cout << " session=" << name
+        << " level=" << sessionLevel
+        << " triggers=" << triggers
+        << " predicted=" << predicted
+        << " missed=" << triggers - predicted
+        << " false=" << falseAlarms
+        << " meanerr=" << (predicted > 0 ? sumError / predicted : 0.0)
+        << " rmserr=" << (predicted > 0 ? sqrt(sumSquare / predicted) : 0.0)
+        << " maxerr=" << maxError
+        << " bias=" << (predicted > 0 ? sumSigned / predicted : 0.0)
+        << " meanlead=" << (predicted > 0 ? sumLead / predicted : 0.0)
+        << endl;
+}
+
+
+
+//////////////////////////////
+//
+// generateSession -- make strokes of random length and height for both
+//    sticks, with a height reported every 20 ms with random noise.  A
+//    stroke rises from the trigger plane and falls back along half of a
+//    sine wave, and the trigger message comes when the stick crosses the
+//    plane.  In the "feints" session a quarter of the strokes slow down
+//    and stop 15 units before the plane, and give no trigger.
+//
+
+void generateSession(const char* name) {
+   double heightNoise = noise;
+   double feintChance = 0.0;
+   if (strcmp(name, "noisy") == 0) {
+      heightNoise = 3.0 * noise;
+   } else if (strcmp(name, "feints") == 0) {
+      feintChance = 0.25;
+   }
+
+   for (int stick=1; stick<=2; stick++) {
+      double start = 1000.0 + uniform() * REPORT_PERIOD;
+      double time = start;
+      double startOffset = 0.0;
+      for (int s=0; s<strokes; s++) {
+         double length = 300.0 + 500.0 * uniform();
+         double height = 30.0 + 50.0 * uniform();
+         int    feintQ = uniform() < feintChance;
+         double endOffset = feintQ ? 15.0 : 0.0;
+         double end = start + length;
+         for ( ; time < end; time += REPORT_PERIOD) {
+            double phase = (time - start) / length;
+            double shape = sin(M_PI * phase);
+            if (feintQ) {
+               shape = shape * shape;     // no velocity at the end
+            }
+            double z = level - height * shape -
+                  startOffset * (1.0 + cos(M_PI * phase)) / 2.0 -
+                  endOffset * (1.0 - cos(M_PI * phase)) / 2.0 +
+                  heightNoise * gaussian();
+            addEvent(time, 0, stick, (int)floor(z + 0.5));
+         }
+         if (!feintQ) {
+            addEvent(end, 1, stick, 0);
+         }
+         start = end;
+         startOffset = endOffset;
+      }
+   }
+
+   // put the reports of the two sticks in time order
+   int count = eventTimes.getSize();
+   int i, j;
+   for (i=1; i<count; i++) {
+      double time = eventTimes[i];
+      int type = eventTypes[i];
+      int stick = eventSticks[i];
+      int height = eventHeights[i];
+      for (j=i; j>0 && eventTimes[j-1] > time; j--) {
+         eventTimes[j] = eventTimes[j-1];
+         eventTypes[j] = eventTypes[j-1];
+         eventSticks[j] = eventSticks[j-1];
+         eventHeights[j] = eventHeights[j-1];
+      }
+      eventTimes[j] = time;
+      eventTypes[j] = type;
+      eventSticks[j] = stick;
+      eventHeights[j] = height;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// readSession -- read the positions and triggers from a file written by
+//    RadioBaton::recordStateStart().  Other records are ignored.
+//
+
+int readSession(const char* filename) {
+   ifstream input(filename);
+   if (!input.is_open()) {
+      cerr << "Error: cannot read baton session " << filename << endl;
+      return 0;
+   }
+   string line;
+   char kind[16];
+   while (getline(input, line)) {
+      long time;
+      int a, b, c;
+      if (sscanf(line.c_str(), "%ld %15s %d %d %d", &time, kind,
+            &a, &b, &c) != 5) {
+         continue;
+      }
+      if (strcmp(kind, POSITION1RECORD) == 0) {
+         addEvent(time, 0, 1, c);
+      } else if (strcmp(kind, POSITION2RECORD) == 0) {
+         addEvent(time, 0, 2, c);
+      } else if (strcmp(kind, TRIGGER1RECORD) == 0) {
+         addEvent(time, 1, 1, 0);
+      } else if (strcmp(kind, TRIGGER2RECORD) == 0) {
+         addEvent(time, 1, 2, 0);
+      }
+   }
+   if (eventTimes.getSize() == 0) {
+      cerr << "Error: no positions or triggers in " << filename << endl;
+      return 0;
+   }
+   return 1;
+}
+
+
+
+//////////////////////////////
+//
+// calibrateLevel -- estimate the height of the trigger plane in a
+//    recorded session from the heights reported around each trigger
+//    (the median of the average of the last height before the trigger
+//    and the first height after it).
+//
+
+double calibrateLevel(void) {
+   Array<double> estimates;
+   estimates.setSize(0);
+   int count = eventTimes.getSize();
+   for (int i=0; i<count; i++) {
+      if (eventTypes[i] != 1) {
+         continue;
+      }
+      int before = -1;
+      int after = -1;
+      int j;
+      for (j=i-1; j>=0; j--) {
+         if (eventTypes[j] == 0 && eventSticks[j] == eventSticks[i]) {
+            before = j;
+            break;
+         }
+      }
+      for (j=i+1; j<count; j++) {
+         if (eventTypes[j] == 0 && eventSticks[j] == eventSticks[i]) {
+            after = j;
+            break;
+         }
+      }
+      if (before >= 0 && after >= 0) {
+         double estimate = (eventHeights[before] + eventHeights[after]) / 2.0;
+         estimates.append(estimate);
+      }
+   }
+   if (estimates.getSize() == 0) {
+      return level;
+   }
+
+   // insertion sort is fine for the number of triggers in a session
+   for (int i=1; i<estimates.getSize(); i++) {
+      double value = estimates[i];
+      int j;
+      for (j=i; j>0 && estimates[j-1] > value; j--) {
+         estimates[j] = estimates[j-1];
+      }
+      estimates[j] = value;
+   }
+   return estimates[estimates.getSize() / 2];
+}
+
+
+
+//////////////////////////////
+//
+// addEvent --
+//
+
+void addEvent(double time, int type, int stick, int height) {
+   eventTimes.append(time);
+   eventTypes.append(type);
+   eventSticks.append(stick);
+   eventHeights.append(height);
+}
+
+
+
+//////////////////////////////
+//
+// gaussian -- returns a normally distributed random number with a mean
+//    of 0 and a standard deviation of 1.
+//
+
+double gaussian(void) {
+   double u1 = uniform();
+   double u2 = uniform();
+   if (u1 <= 0.0) {
+      u1 = 1e-12;
+   }
+   return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+
+
+//////////////////////////////
+//
+// uniform -- returns a random number from 0.0 up to 1.0.
+//
+
+double uniform(void) {
+   randomState = randomState * 6364136223846793005ULL + 1442695040888963407ULL;
+   return (randomState >> 11) / 9007199254740992.0;
+}
+
+
+
+//////////////////////////////
+//
+// checkOptions --
+//
+
+void checkOptions(Options& opts) {
+   opts.define("q|session=s:");        // strokes, feints or noisy
+   opts.define("w|window=i:6");        // positions used for a prediction
+   opts.define("t|lead=d:50.0");       // longest lead time in ms
+   opts.define("v|velocity=d:200.0");  // slowest approach in units/second
+   opts.define("c|confidence=d:0.9");  // smallest fraction of fit
+   opts.define("z|level=d:110.0");     // height of the trigger plane
+   opts.define("r|rearm=d:10.0");      // distance from plane to rearm
+   opts.define("j|noise=d:1.0");       // height noise of generated sessions
+   opts.define("n|strokes=i:200");     // strokes per stick in a session
+   opts.define("s|seed=i:1");          // random number seed
+   opts.define("l|label=s:");          // tag to add to the results line
+   opts.define("author=b");
+   opts.define("version=b");
+   opts.define("h|help=b");
+   opts.process();
+
+   if (opts.getBoolean("author")) {
+      cout << "Written by agent, agent@local, October 2026" << endl;
+      exit(0);
+   } else if (opts.getBoolean("version")) {
+      cout << "triggerbench, version 1.0 (19 Oct 2026)\n"
+              "compiled: " << __DATE__ << endl;
+      exit(0);
+   } else if (opts.getBoolean("help")) {
+      usage(opts.getCommand().data());
+      exit(0);
+   }
+
+   sessionName = opts.getString("session");
+   window      = opts.getInteger("window");
+   leadTime    = opts.getDouble("lead");
+   minVelocity = opts.getDouble("velocity");
+   confidence  = opts.getDouble("confidence");
+   level       = opts.getDouble("level");
+   levelQ      = opts.getBoolean("level");
+   rearm       = opts.getDouble("rearm");
+   noise       = opts.getDouble("noise");
+   strokes     = opts.getInteger("strokes");
+   seed        = opts.getInteger("seed");
+   label       = opts.getString("label");
+
+   if (strokes < 1) {
+      strokes = 1;
+   }
+   if (seed == 0) {
+      seed = 1;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// usage --
+//
+
+void usage(const char* command) {
+   cout <<
+   "\n"
+   "Measure the prediction of baton triggers from stick positions.\n"
+   "\n"
+   "Usage: " << command << " [-q session][-w n][-t ms][-c fraction] "
+   "[sessionfile ...]\n"
+   "\n"
+   "Options:\n"
+   "   -q name = strokes, feints or noisy (default all)\n"
+   "   -w count = number of positions used for a prediction\n"
+   "   -t ms = longest time before the impact for a pre-trigger\n"
+   "   -v units = slowest approach to the plane in units per second\n"
+   "   -c fraction = smallest fraction of the height variation fitted\n"
+   "   -z height = height of the trigger plane (default: estimated\n"
+   "          from recorded sessions, 110 for generated ones)\n"
+   "   -r height = distance below the plane before the next stroke\n"
+   "   -j height = standard deviation of generated height noise\n"
+   "   -n count = number of generated strokes for each stick\n"
+   "   -s seed = random number seed\n"
+   "   -l label = tag to add to the results line\n"
+   "   --options = list all options, default values, and aliases\n"
+   "\n"
+   "Session files are recorded with RadioBaton::recordStateStart().\n"
+   "\n"
+   << endl;
+}
+
+
+
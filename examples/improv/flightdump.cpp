@@ -0,0 +1,240 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Mon Oct 19 05:31:24 PDT 2026
+// Last Modified: Mon Oct 19 05:31:28 PDT 2026
+// Last Modified: Mon Oct 19 06:31:50 PDT 2026 (read per-user file)
+// Filename:      ...improv/examples/improv/flightdump.cpp
+// Syntax:        C++
+//
+// Description:   Prints the MIDI messages kept by the flight recorder
+//                (see the --flight-recorder option of synthImprov and
+//                hciImprov), or converts them into a MIDI file with
+//                one millisecond per tick.  Without a file name, the
+//                default flight recorder file is read.
+//
+
+#include "FlightRecorder.h"
+#include "MidiFileWrite.h"
+#include "Options.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <iostream>
+
+using namespace std;
+
+// function declarations:
+void checkOptions   (Options& opts);
+int  keepEvent      (FlightEvent& event, long lastTime);
+void printEvents    (SigCollection<FlightEvent>& events,
+                     Array<uchar>& data);
+void usage          (const char* command);
+void writeMidiFile  (const char* filename,
+                     SigCollection<FlightEvent>& events,
+                     Array<uchar>& data);
+
+// command-line variables
+int    inputQ  = 1;                 // include received messages
+int    outputQ = 1;                 // include sent messages
+int    port    = -1;                // -p option
+double minutes = 0.0;               // -m option
+
+///////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv) {
+   Options options(argc, argv);
+   checkOptions(options);
+
+   SigCollection<FlightEvent> events;
+   Array<uchar> data;
+   const char* filename = options.getArgCount() > 0 ?
+         options.getArg(1).data() : FlightRecorder::getDefaultFilename();
+   if (!FlightRecorder::read(filename, events, data)) {
+      exit(1);
+   }
+
+   if (options.getArgCount() == 2) {
+      writeMidiFile(options.getArg(2).data(), events, data);
+   } else {
+      printEvents(events, data);
+   }
+
+   return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////
+
+
+//////////////////////////////
+//
+// checkOptions -- handle command-line options.
+//
+
+void checkOptions(Options& opts) {
+   opts.define("i|input=b");
+   opts.define("o|output=b");
+   opts.define("p|port=i:-1");
+   opts.define("m|minutes=d:0.0");
+   opts.define("author=b");
+   opts.define("version=b");
+   opts.define("help=b");
+   opts.process();
+
+   if (opts.getBoolean("author")) {
+      cout << "Written by agent, agent@local, Oct 2026" << endl;
+      exit(0);
+   }
+   if (opts.getBoolean("version")) {
+      cout << "flightdump version 1.0" << endl;
+      cout << "compiled: " << __DATE__ << endl;
+   }
+   if (opts.getBoolean("help")) {
+      usage(opts.getCommand().data());
+      exit(0);
+   }
+
+   if (opts.getArgCount() > 2) {
+      cout << "Error: too many files." << endl;
+      usage(opts.getCommand().data());
+      exit(1);
+   }
+
+   if (opts.getBoolean("input") || opts.getBoolean("output")) {
+      inputQ  = opts.getBoolean("input");
+      outputQ = opts.getBoolean("output");
+   }
+   port    = opts.getInteger("port");
+   minutes = opts.getDouble("minutes");
+}
+
+
+
+//////////////////////////////
+//
+// keepEvent -- returns true if the event is one which was asked for
+//    on the command line.
+//
+
+int keepEvent(FlightEvent& event, long lastTime) {
+   if (event.outputQ ? !outputQ : !inputQ) {
+      return 0;
+   }
+   if (port >= 0 && event.port != port) {
+      return 0;
+   }
+   if (minutes > 0.0 && event.time < lastTime - minutes * 60000.0) {
+      return 0;
+   }
+   return 1;
+}
+
+
+
+//////////////////////////////
+//
+// printEvents -- print one message on each line: the time in seconds,
+//    the direction, the port and the MIDI bytes in hex.
+//
+
+void printEvents(SigCollection<FlightEvent>& events, Array<uchar>& data) {
+   long lastTime = events.getSize() > 0 ?
+         events[events.getSize() - 1].time : 0;
+   char buffer[64];
+   for (int i=0; i<events.getSize(); i++) {
+      FlightEvent& event = events[i];
+      if (!keepEvent(event, lastTime)) {
+         continue;
+      }
+      snprintf(buffer, sizeof(buffer), "%10.3f\t%s\t%d\t",
+            event.time / 1000.0, event.outputQ ? "out" : "in", event.port);
+      cout << buffer;
+      for (int j=0; j<event.size; j++) {
+         snprintf(buffer, sizeof(buffer), "%s%02x", j > 0 ? " " : "",
+               data[event.offset + j]);
+         cout << buffer;
+      }
+      cout << "\n";
+   }
+   cout << flush;
+}
+
+
+
+//////////////////////////////
+//
+// writeMidiFile -- write the messages into a type 0 MIDI file.  The
+//    tempo is set so that each tick is one millisecond.  System
+//    messages other than sysex cannot go into a MIDI file and are left
+//    out.
+//
+
+void writeMidiFile(const char* filename, SigCollection<FlightEvent>& events,
+      Array<uchar>& data) {
+   long lastTime = events.getSize() > 0 ?
+         events[events.getSize() - 1].time : 0;
+   MidiFileWrite midifile(filename, 0);
+
+   // 1000 ticks per quarter note at 1,000,000 microseconds per quarter
+   midifile.writeRaw(0, 0xff, 0x51, 3);
+   midifile.writeRaw(0x0f, 0x42, 0x40);
+
+   long previous = -1;
+   for (int i=0; i<events.getSize(); i++) {
+      FlightEvent& event = events[i];
+      if (!keepEvent(event, lastTime)) {
+         continue;
+      }
+      uchar* bytes = &data[event.offset];
+      if (bytes[0] > 0xf0 || (bytes[0] == 0xf0 && event.size < 2)) {
+         continue;
+      }
+      if (previous < 0) {
+         previous = event.time;
+      }
+      int delta = (int)(event.time - previous);
+      previous = event.time;
+
+      if (bytes[0] == 0xf0) {
+         midifile.writeVLValue(delta);
+         midifile.writeRaw(0xf0);
+         midifile.writeVLValue(event.size - 1);
+         midifile.writeRaw(bytes + 1, event.size - 1);
+      } else if (event.size >= 3) {
+         midifile.writeRelative(delta, bytes[0], bytes[1], bytes[2]);
+      } else if (event.size == 2) {
+         midifile.writeRelative(delta, bytes[0], bytes[1]);
+      } else {
+         midifile.writeRelative(delta, bytes[0]);
+      }
+   }
+   midifile.close();
+}
+
+
+
+//////////////////////////////
+//
+// usage -- how to run the flightdump program on the command line.
+//
+
+void usage(const char* command) {
+   cout <<
+   "                                                                         \n"
+   "Prints the MIDI messages in a flight recorder file, or converts them     \n"
+   "into a MIDI file if an output file is given.  The default input file is  \n"
+   "$HOME/.improv.flight.                                                    \n"
+   "                                                                         \n"
+   "Usage: " << command << " [-i|-o] [-p port] [-m min] [input [output.mid]]\n"
+   "                                                                         \n"
+   "Options:                                                                 \n"
+   "   -i      = only messages received on MIDI input ports.                 \n"
+   "   -o      = only messages sent to MIDI output ports.                    \n"
+   "   -p port = only messages on the given port.                            \n"
+   "   -m min  = only the last min minutes of messages.                      \n"
+   "   --options = list of all options, aliases and default values.          \n"
+   "                                                                         \n"
+   << endl;
+}
+
+
+
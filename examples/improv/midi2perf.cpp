@@ -0,0 +1,128 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sun Oct 18 20:14:26 PDT 2026
+// Last Modified: Sun Oct 18 20:14:29 PDT 2026
+// Filename:      ...improv/examples/improv/midi2perf.cpp
+// Syntax:        C++
+//
+// Description:   Compiles a MIDI file into a performance file which
+//                midiperform can map into memory and start playing
+//                without reading and merging the MIDI tracks.
+//
+
+#include "PerformFile.h"
+#include "MidiFile.h"
+#include "Options.h"
+
+#include <stdlib.h>
+#include <iostream>
+
+using namespace std;
+
+// function declarations:
+void checkOptions(Options& opts);
+void printSummary(const char* filename);
+void usage(const char* command);
+
+// command-line variables
+int verboseQ = 0;                   // -v option
+
+///////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv) {
+   Options options(argc, argv);
+   checkOptions(options);
+
+   smf::MidiFile midifile;
+   if (!midifile.read(options.getArg(1))) {
+      cerr << "Error: cannot read MIDI file " << options.getArg(1) << endl;
+      exit(1);
+   }
+   if (!PerformFile::write(options.getArg(2).data(), midifile)) {
+      exit(1);
+   }
+   if (verboseQ) {
+      printSummary(options.getArg(2).data());
+   }
+
+   return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////
+
+
+//////////////////////////////
+//
+// checkOptions -- handle command-line options.
+//
+
+void checkOptions(Options& opts) {
+   opts.define("v|verbose=b");
+   opts.define("author=b");
+   opts.define("version=b");
+   opts.define("help=b");
+   opts.process();
+
+   if (opts.getBoolean("author")) {
+      cout << "Written by agent, agent@local, Oct 2026" << endl;
+      exit(0);
+   }
+   if (opts.getBoolean("version")) {
+      cout << "midi2perf version 1.0" << endl;
+      cout << "compiled: " << __DATE__ << endl;
+   }
+   if (opts.getBoolean("help")) {
+      usage(opts.getCommand().data());
+      exit(0);
+   }
+
+   if (opts.getArgCount() != 2) {
+      cout << "Error: need an input MIDI file and an output file." << endl;
+      usage(opts.getCommand().data());
+      exit(1);
+   }
+
+   verboseQ = opts.getBoolean("verbose");
+}
+
+
+
+//////////////////////////////
+//
+// printSummary -- print the contents of the compiled file.
+//
+
+void printSummary(const char* filename) {
+   PerformFile performance;
+   if (!performance.open(filename)) {
+      exit(1);
+   }
+   cout << "Events:    " << performance.getEventCount() << endl;
+   cout << "Beats:     " << performance.getBeatCount() << endl;
+   cout << "Measures:  " << performance.getMeasureCount() << endl;
+   cout << "Tempos:    " << performance.getTempoCount() << endl;
+}
+
+
+
+//////////////////////////////
+//
+// usage -- how to run the midi2perf program on the command line.
+//
+
+void usage(const char* command) {
+   cout <<
+   "                                                                         \n"
+   "Compiles a MIDI file into a performance file for midiperform.            \n"
+   "                                                                         \n"
+   "Usage: " << command << " input.mid output.prf                            \n"
+   "                                                                         \n"
+   "Options:                                                                 \n"
+   "   -v      = print the number of events and markers in the output file.  \n"
+   "   --options = list of all options, aliases and default values.          \n"
+   "                                                                         \n"
+   << endl;
+}
+
+
+
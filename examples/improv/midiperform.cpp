@@ -3,6 +3,8 @@
 // Creation Date: Sat Nov 27 16:15:50 PST 1999
 // Last Modified: Mon Nov 29 14:07:19 PST 1999
 // Last Modified: Tue Nov 30 17:05:16 PST 1999 (added MIDI input control)
+// Last Modified: Sun Oct 18 20:21:40 PDT 2026 (compiled performance files)
+// Last Modified: Sun Oct 18 22:31:40 PDT 2026 (added -l lookahead option)
 // Filename:      ...sig/doc/examples/all/midiperform/midiperform.cpp
 // Syntax:        C++
 // 
@@ -42,6 +44,7 @@ int tempoMethod = TEMPO_METHOD_AUTOMATIC;   // -a -c -t options
 int outport = 0;                            // -p option
 int inport  = 0;                            // -p option
 int maxamp  = 64;                           // -m option
+double lookahead = 0.0;                     // -l option
 
 ///////////////////////////////////////////////////////////////////////////
 
@@ -62,6 +65,7 @@ int main(int argc, char** argv) {
    performance.setMaxAmp(maxamp);
    performance.open();
    performance.setTempoMethod(tempoMethod);
+   performance.setLookahead(lookahead);
    performance.play();
    while (command != 'Q') {
       while (midiin.getCount() > 0) {
@@ -118,6 +122,7 @@ void checkOptions(Options& opts) {
    opts.define("p|port|out-port=i:0");
    opts.define("i|inport|in-port=i:0");
    opts.define("1|z|channel-collapse=b");
+   opts.define("l|lookahead=d:0.0");
    opts.define("author=b");
    opts.define("version=b");
    opts.define("example=b");
@@ -167,6 +172,7 @@ void checkOptions(Options& opts) {
    outport = opts.getInteger("out-port");
    inport = opts.getInteger("in-port");
    maxamp = opts.getInteger("max-amplitude");
+   lookahead = opts.getDouble("lookahead");
    performance.channelCollapse(opts.getBoolean("channel-collapse"));
 }
 
@@ -345,11 +351,13 @@ void processMidiCommand(smf::MidiEvent& message) {
 void usage(const char* command) {
    cout <<
    "                                                                         \n"
-   "Plays a MIDI file.                                                       \n"
+   "Plays a MIDI file, or a performance file compiled with midi2perf.        \n"
    "                                                                         \n"
    "Usage: " << command << " midifile                                        \n"
    "                                                                         \n"
    "Options:                                                                 \n"
+   "   -l ms   = send events from a separate thread, queued this many        \n"
+   "             milliseconds ahead (20 to 50 is good).                      \n"
    "   --options = list of all options, aliases and default values.          \n"
    "                                                                         \n"
    "                                                                         \n"
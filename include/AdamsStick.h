@@ -2,13 +2,22 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Sun Jul 16 13:39:10 PDT 2000
 // Last Modified: Mon Jul 17 11:10:46 PDT 2000
+// Last Modified: Mon Oct 19 02:20:31 PDT 2026 (stream times, adaptive poll)
+// Last Modified: Mon Oct 19 06:14:08 PDT 2026 (per-object input event)
+// Last Modified: Mon Oct 19 08:20:14 PDT 2026 (stream mode when available)
+// Last Modified: Mon Oct 19 08:43:22 PDT 2026 (added getPollWait)
 // Filename:      ...sig/code/control/AdamsStick/AdamsStick.h
 // Web Address:   http://sig.sapp.org/include/sig/AdamsStick.h
 // Syntax:        C++
 //
 // Description:   A structure for handling the Interval stick variables
 //                and the MIDI connections from the computer to 
-//                the stick.
+//                the stick.  Streaming is preferred: checkPoll() asks
+//                the stick for its version, and if it answers, the
+//                stick is switched to stream mode, unless the program
+//                has chosen a mode itself.  In poll mode, the poll
+//                period adapts to the activity on the stick (see
+//                setAdaptivePoll()) until setPollPeriod() is called.
 //
 
 #ifndef _ADAMSSTICK_H_INCLUDED
@@ -18,10 +27,15 @@
 #include "CircularBuffer.h"      /* for storage of state variables         */
 #include "SigTimer.h"            /* for the poll timer functions           */
 #include "MidiEvent.h"           /* for processing incoming MIDI messages  */
+#include "StreamClock.h"         /* for the send times of streamed frames  */
 
 #define STICK_POLL_MODE    0
 #define STICK_STREAM_MODE  1
 #define STICK_DEFAULT_POLL_PERIOD  50
+#define STICK_STREAM_PERIOD        16   /* ms between frames in stream mode */
+#define STICK_FAST_POLL_PERIOD     10   /* adaptive poll period when active */
+#define STICK_SLOW_POLL_PERIOD    100   /* adaptive poll period when idle   */
+#define STICK_ACTIVE_HOLD         250   /* ms of fast polls after activity  */
 
 // The define below is for the size of the state variable storage buffers.
 // By default, all buffers will be the size given below.  You can later
@@ -36,8 +50,10 @@ class AdamsStick : public MidiIO {
                 ~AdamsStick                 ();
 
       int        checkPoll                  (void);
+      int        getAdaptivePoll            (void);
       int        getLevel                   (int fsrnumber);
       double     getPollPeriod              (void);
+      double     getPollWait                (void);
       int        getMode                    (void);
       int        getState                   (int fsrnumber);
       int        getStateSize               (void);
@@ -48,6 +64,9 @@ class AdamsStick : public MidiIO {
       void       processIncomingMessages    (void);
       void       setLevel                   (int fsrnumber, int aValue);
       void       setLevel                   (int aValue);
+      void       setAdaptivePoll            (int aState = 1);
+      void       setAdaptivePoll            (double fastPeriod,
+                                             double slowPeriod);
       void       setMode                    (int aMode);
       void       setPollPeriod              (double aPeriod);
       void       setPollMode                (void);
@@ -156,8 +175,21 @@ class AdamsStick : public MidiIO {
 
       int         currentMode;          // 0 = poll mode, 1 = stream mode
       int         connectedQ;           // 0 = not connected, 1 = connected
+      int         modeChosenQ;          // program has set the mode
+      int         versionAskedQ;        // checkPoll() asked for version
       int         versionInfo;          // -1 = unknown version
       SigTimer    pollTimer;
+      StreamClock streamClock;          // send times of streamed frames
+      long        frameTime;            // send time of the current frame
+
+      // adaptive polling variables:
+      int         adaptivePollQ;        // true if adapting poll period
+      double      fastPollPeriod;       // poll period while FSRs are used
+      double      slowPollPeriod;       // poll period while stick is idle
+      int         idleFrames;           // frames since the last activity
+      smf::MidiEvent inputEvent;        // reused for each input message
+
+      void        adaptPollPeriod       (void);
 
       void        interpretCommand      (smf::MidiEvent& aMessage);
       void        sendVersionMessage    (void);
@@ -6,6 +6,7 @@
 // Last Modified: Wed Mar 30 13:58:18 PST 2005 Fixed for compiling in GCC 3.4
 // Last Modified: Fri Jun 12 22:58:34 PDT 2009 Renamed SigCollection class
 // Last Modified: Wed Sep  8 17:26:13 PDT 2010 Added operator<< for chars
+// Last Modified: Sun Oct 18 16:02:11 PDT 2026 Added move constructor
 // Filename:      ...sig/maint/code/base/Array/Array.cpp
 // Web Address:   http://sig.sapp.org/src/sigBase/Array.cpp
 // Syntax:        C++ 
@@ -44,6 +45,11 @@ template<class type>
 Array<type>::Array(Array<type>& anArray) : SigCollection<type>(anArray) { 
 }
 
+template<class type>
+Array<type>::Array(Array<type>&& anArray) : 
+   SigCollection<type>(std::move(anArray)) { 
+}
+
 template<class type>
 Array<type>::Array(int arraySize, type *anArray) : 
    SigCollection<type>(arraySize, anArray) { 
@@ -205,6 +211,7 @@ Array<type>& Array<type>::operator=(const Array<type>& anArray) {
       this->array = new type[this->size];
       this->allowGrowthQ = anArray.allowGrowthQ;
       this->growthAmount = anArray.growthAmount;
+      this->growthFactor = anArray.growthFactor;
       this->maxSize = anArray.maxSize;
    }
    this->size = anArray.size;
@@ -216,6 +223,21 @@ Array<type>& Array<type>::operator=(const Array<type>& anArray) {
 }
 
 
+//
+// Move version of operator=: the contents of the two arrays are
+// exchanged, so that arrays of Arrays can be rearranged (or grown)
+// without copying the contents of each element.
+//
+
+template<class type>
+Array<type>& Array<type>::operator=(Array<type>&& anArray) {
+   if (this != &anArray) {
+      this->swap(anArray);
+   }
+   return *this;
+}
+
+
 
 //////////////////////////////
 //
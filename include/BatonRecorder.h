@@ -0,0 +1,48 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Mon Oct 19 01:42:18 PDT 2026
+// Last Modified: Mon Oct 19 01:42:22 PDT 2026
+// Last Modified: Mon Oct 19 07:41:26 PDT 2026 (recorded by MidiCapture)
+// Last Modified: Mon Oct 19 08:55:41 PDT 2026 (replayed by MidiReplay)
+// Filename:      ...improv/include/BatonRecorder.h
+// Web Address:   http://sig.sapp.org/include/sig/BatonRecorder.h
+// Syntax:        C++
+//
+// Description:   Records the MIDI messages received from a Radio Baton
+//                into a session file which can be played back with
+//                RadioBaton::replaySessionStart() (see MidiReplay).
+//                The session is a MidiCapture of the baton's input
+//                port: the MIDI input thread copies each message,
+//                sysex included, into the capture ring buffer as it
+//                arrives, and the capture thread writes it to the
+//                file.  Since there is only one MidiCapture, a session
+//                cannot be recorded while the --capture option is
+//                capturing all MIDI input.
+//
+
+#ifndef _BATONRECORDER_H_INCLUDED
+#define _BATONRECORDER_H_INCLUDED
+
+#include "MidiCapture.h"
+
+
+class BatonRecorder {
+   public:
+                    BatonRecorder      (void);
+                   ~BatonRecorder      ();
+
+      long          getCount           (void) const;
+      long          getDropped         (void) const;
+      int           recordingQ         (void) const;
+      int           start              (const char* aFilename, int aPort);
+      void          stop               (void);
+
+   protected:
+      int           runningQ;          // true while the capture is ours
+};
+
+
+#endif  /* _BATONRECORDER_H_INCLUDED */
+
+
+
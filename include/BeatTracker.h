@@ -0,0 +1,61 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sun Oct 18 22:58:20 PDT 2026
+// Last Modified: Sun Oct 18 22:58:24 PDT 2026
+// Filename:      ...improv/include/BeatTracker.h
+// Web Address:   http://sig.sapp.org/include/sig/BeatTracker.h
+// Syntax:        C++
+//
+// Description:   Follows the tempo of a sequence of beats, such as
+//                the beats of a conductor's baton, and predicts when
+//                the next beat will occur.  The time of the current
+//                beat and the beat period are estimated together with
+//                a Kalman filter, so that a single late or early beat
+//                changes the tempo only a little, while a real change
+//                of tempo is followed within a few beats.  Beats which
+//                are skipped are counted, and extra beats which are
+//                too close to the predicted one are ignored.  Times
+//                are in milliseconds.
+//
+
+#ifndef _BEATTRACKER_H_INCLUDED
+#define _BEATTRACKER_H_INCLUDED
+
+
+class BeatTracker {
+   public:
+                  BeatTracker        (void);
+                 ~BeatTracker        ();
+
+      int         beat               (double aTime);
+      int         getBeatCount       (void) const;
+      double      getBeatTime        (void) const;
+      double      getNextBeat        (void) const;
+      double      getPeriod          (void) const;
+      double      getPosition        (double aTime) const;
+      double      getTempo           (void) const;
+      void        reset              (double aTempo = 60.0);
+      void        setJitter          (double milliseconds);
+      void        setTempoLimits     (double minTempo, double maxTempo);
+      void        setVariation       (double phaseVariation,
+                                      double periodVariation);
+
+   protected:
+      double      beatTime;          // estimated time of the last beat
+      double      period;            // estimated beat period
+      double      covariance[2][2];  // uncertainty of time and period
+      double      jitter;            // variance of beat placement
+      double      phaseNoise;        // variance of beat time drift
+      double      periodNoise;       // variance of tempo drift per beat
+      double      minPeriod;         // fastest tempo allowed
+      double      maxPeriod;         // slowest tempo allowed
+      int         beatCount;         // number of beats used
+
+      void        restart            (double aTime);
+};
+
+
+#endif  /* _BEATTRACKER_H_INCLUDED */
+
+
+
@@ -3,6 +3,9 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: 19 December 1997
 // Last Modified: Wed Jan 21 23:16:54 GMT-0800 1998
+// Last Modified: Sun Oct 18 15:24:50 PDT 2026 (added fill)
+// Last Modified: Sun Oct 18 16:55:38 PDT 2026 (power-of-two sizes, spans)
+// Last Modified: Mon Oct 19 08:26:33 PDT 2026 (history limited to writes)
 // Filename:      ...sig/maint/code/base/CircularBuffer/CircularBuffer.cpp
 // Web Address:   http://sig.sapp.org/src/sigBase/CircularBuffer.cpp
 // Syntax:        C++
@@ -17,7 +20,13 @@
 //                object[0] is the last value written into the
 //                buffer and object[-1] (or object[1]) is the
 //                item written just before that.
-//              
+//                If the size of the buffer is a power of two, indices
+//                are wrapped with a bit mask instead of a comparison.
+//                Blocks of elements can be accessed directly in the
+//                buffer storage as one or two contiguous spans (two
+//                when the block wraps around the end of the storage),
+//                so that analysis code can loop over a history window
+//                without calling operator[] for every element.
 //
 
 #ifndef _CIRCULARBUFFER_CPP_INCLUDED
@@ -43,6 +52,7 @@
 template<class type>
 CircularBuffer<type>::CircularBuffer(void) {
    size = 0;
+   mask = 0;
    buffer = NULL;
    reset();
 }
@@ -58,18 +68,19 @@ CircularBuffer<type>::CircularBuffer(int maxElements) {
    if (maxElements == 0) {
       size = 0;
       buffer = NULL;
-      reset();
    } else {
       size = maxElements;
       buffer = new type[maxElements];
-      reset();
    }
+   updateMask();
+   reset();
 }
 
 
 template<class type>
 CircularBuffer<type>::CircularBuffer(const CircularBuffer<type>& anotherBuffer) {
    size = anotherBuffer.size;
+   mask = anotherBuffer.mask;
    if (getSize() == 0) {
       buffer = NULL;
       reset();
@@ -78,6 +89,7 @@ CircularBuffer<type>::CircularBuffer(const CircularBuffer<type>& anotherBuffer)
       writeIndex = anotherBuffer.writeIndex;
       readIndex = anotherBuffer.readIndex;
       itemCount = anotherBuffer.itemCount;
+      historyCount = anotherBuffer.historyCount;
       for (int i=0; i<getSize(); i++) {
          buffer[i] = anotherBuffer.buffer[i];
       }
@@ -101,6 +113,56 @@ CircularBuffer<type>::~CircularBuffer() {
 
 
 
+//////////////////////////////
+//
+// CircularBuffer::advanceRead -- mark count elements as extracted,
+//    after processing them through getReadSpans().  If the buffer has
+//    overflowed, the elements which were overwritten are skipped.
+//
+
+template<class type>
+void CircularBuffer<type>::advanceRead(int count) {
+   if (itemCount > getSize()) {
+      // oldest unread elements were overwritten by newer ones
+      readIndex = writeIndex;
+      itemCount = getSize();
+   }
+   if (count > itemCount) {
+      count = itemCount;
+   }
+   if (count <= 0) {
+      return;
+   }
+   readIndex = wrap(readIndex + count);
+   itemCount -= count;
+}
+
+
+
+//////////////////////////////
+//
+// CircularBuffer::advanceWrite -- mark count elements as inserted,
+//    after storing them through getWriteSpans().
+//
+
+template<class type>
+void CircularBuffer<type>::advanceWrite(int count) {
+   if (count > getSize()) {
+      count = getSize();
+   }
+   if (count <= 0) {
+      return;
+   }
+   writeIndex = wrap(writeIndex + count);
+   itemCount += count;
+   historyCount += count;
+   if (historyCount > getSize()) {
+      historyCount = getSize();
+   }
+}
+
+
+
 //////////////////////////////
 //
 // CircularBuffer::capacity -- returns the number of items which
@@ -116,6 +178,37 @@ int CircularBuffer<type>::capacity(void) const {
 
 
 
+//////////////////////////////
+//
+// CircularBuffer::copyHistory -- copy the last count elements written
+//    into the buffer to output, oldest first, so that output[count-1]
+//    is the same as buffer[0].  The elements are not extracted.
+//    Returns the number of elements copied, which is limited to the
+//    number of elements written since the last reset and to the
+//    size of the buffer.
+//
+
+template<class type>
+int CircularBuffer<type>::copyHistory(type* output, int count) {
+   type* first;
+   type* second;
+   int   firstCount;
+   int   secondCount;
+   int   total = getHistorySpans(count, first, firstCount, 
+         second, secondCount);
+   int   i;
+   for (i=0; i<firstCount; i++) {
+      output[i] = first[i];
+   }
+   output += firstCount;
+   for (i=0; i<secondCount; i++) {
+      output[i] = second[i];
+   }
+   return total;
+}
+
+
+
 //////////////////////////////
 //
 // CircularBuffer::extract -- reads the next value from the buffer.
@@ -134,6 +227,56 @@ void CircularBuffer<type>::extract(type& item) {
 }
 
 
+//
+// Block version of extract: reads up to count elements into items.
+// Returns the number of elements which were extracted.
+//
+
+template<class type>
+int CircularBuffer<type>::extract(type* items, int count) {
+   type* first;
+   type* second;
+   int   firstCount;
+   int   secondCount;
+   int   total = getReadSpans(first, firstCount, second, secondCount);
+   if (count < total) {
+      total = count < 0 ? 0 : count;
+      if (firstCount > total) {
+         firstCount = total;
+      }
+      secondCount = total - firstCount;
+   }
+   int i;
+   for (i=0; i<firstCount; i++) {
+      items[i] = first[i];
+   }
+   items += firstCount;
+   for (i=0; i<secondCount; i++) {
+      items[i] = second[i];
+   }
+   advanceRead(total);
+   return total;
+}
+
+
+
+//////////////////////////////
+//
+// CircularBuffer::fill -- copy an item into every slot of the buffer
+//    without changing the contents seen by extract() or getCount().
+//    Used to give element types which hold heap storage (such as
+//    smf::MidiEvent) their storage before the buffer is used in a
+//    thread which should not allocate memory.
+//
+
+template<class type>
+void CircularBuffer<type>::fill(const type& anItem) {
+   for (int i=0; i<size; i++) {
+      buffer[i] = anItem;
+   }
+}
+
+
 
 //////////////////////////////
 //
@@ -148,6 +291,49 @@ int CircularBuffer<type>::getCount(void) const {
 
 
 
+//////////////////////////////
+//
+// CircularBuffer::getHistorySpans -- locate the last count elements
+//    written into the buffer (whether or not they have been extracted).
+//    The oldest elements are in first[0..firstCount-1], followed by
+//    second[0..secondCount-1] if the elements wrap around the end of
+//    the storage.  Returns the number of elements in the spans, which
+//    is limited to the number of elements written since the last
+//    reset (so that unwritten storage is never returned) and to the
+//    size of the buffer.
+//
+
+template<class type>
+int CircularBuffer<type>::getHistorySpans(int count, type*& first, 
+      int& firstCount, type*& second, int& secondCount) {
+   if (count > historyCount) {
+      count = historyCount;
+   }
+   if (count < 0) {
+      count = 0;
+   }
+   return getSpans(wrap(writeIndex - count + 1), count, first, firstCount,
+         second, secondCount);
+}
+
+
+
+//////////////////////////////
+//
+// CircularBuffer::getReadSpans -- locate the elements which have not
+//    yet been extracted, in the same way as getHistorySpans().  Call
+//    advanceRead() after processing them.
+//
+
+template<class type>
+int CircularBuffer<type>::getReadSpans(type*& first, int& firstCount,
+      type*& second, int& secondCount) {
+   return getHistorySpans(getCount(), first, firstCount, second, 
+         secondCount);
+}
+
+
+
 //////////////////////////////
 //
 // CircularBuffer::getSize -- returns the allocated size of the buffer.
@@ -160,6 +346,26 @@ int CircularBuffer<type>::getSize(void) const {
 
 
 
+//////////////////////////////
+//
+// CircularBuffer::getWriteSpans -- locate the storage for the next
+//    count elements to be inserted.  Store the elements there, then
+//    call advanceWrite().  Returns the number of elements in the spans,
+//    which is limited to the size of the buffer.
+//
+
+template<class type>
+int CircularBuffer<type>::getWriteSpans(int count, type*& first, 
+      int& firstCount, type*& second, int& secondCount) {
+   if (count > getSize()) {
+      count = getSize();
+   }
+   return getSpans(wrap(writeIndex + 1), count, first, firstCount,
+         second, secondCount);
+}
+
+
+
 //////////////////////////////
 //
 // CircularBuffer::insert -- add an element to the circular buffer
@@ -168,11 +374,42 @@ int CircularBuffer<type>::getSize(void) const {
 template<class type>
 void CircularBuffer<type>::insert(const type& anItem) {
    itemCount++;
+   if (historyCount < size) {
+      historyCount++;
+   }
    increment(writeIndex);
    buffer[writeIndex] = anItem;
 }
 
 
+//
+// Block version of insert: add count elements to the buffer.  If
+// count is larger than the size of the buffer, only the last elements
+// are stored.  Returns the number of elements stored.
+//
+
+template<class type>
+int CircularBuffer<type>::insert(const type* items, int count) {
+   type* first;
+   type* second;
+   int   firstCount;
+   int   secondCount;
+   int   total = getWriteSpans(count, first, firstCount, second,
+         secondCount);
+   items += count - total;
+   int i;
+   for (i=0; i<firstCount; i++) {
+      first[i] = items[i];
+   }
+   items += firstCount;
+   for (i=0; i<secondCount; i++) {
+      second[i] = items[i];
+   }
+   advanceWrite(total);
+   return total;
+}
+
+
 
 //////////////////////////////
 //
@@ -192,14 +429,7 @@ type& CircularBuffer<type>::operator[](int index) {
            << getSize()-1 << endl;
       exit(1);
    }
-   realIndex = writeIndex - realIndex;
-
-   // should need to go through this loop a max of one time:
-   while (realIndex < 0) {
-      realIndex += getSize();
-   }
-   
-   return buffer[realIndex];
+   return buffer[wrap(writeIndex - realIndex)];
 }
 
 
@@ -228,10 +458,29 @@ template<class type>
 void CircularBuffer<type>::reset(void) {
    readIndex = writeIndex = getSize() - 1;
    itemCount = 0;
+   historyCount = 0;
 }
  
   
 
+//////////////////////////////
+//
+// CircularBuffer::setPow2Size -- set the size of the buffer to the
+//    smallest power of two which is at least aSize, so that indices
+//    can be wrapped with a bit mask.  Throws out all previous data.
+//
+
+template<class type>
+void CircularBuffer<type>::setPow2Size(int aSize) {
+   int newSize = 1;
+   while (newSize < aSize) {
+      newSize <<= 1;
+   }
+   setSize(aSize <= 0 ? aSize : newSize);
+}
+
+
+
 //////////////////////////////
 //
 // CircularBuffer::setSize -- warning: will throw out all previous data 
@@ -251,12 +500,12 @@ void CircularBuffer<type>::setSize(int aSize) {
    if (aSize == 0) {
       size = aSize;
       buffer = NULL;
-      reset();
    } else {
       size = aSize;
       buffer = new type[aSize];
-      reset();
    }
+   updateMask();
+   reset();
 }   
 
 
@@ -285,10 +534,77 @@ void CircularBuffer<type>::write(const type& anElement) {
 
 template<class type>
 void CircularBuffer<type>::increment(int& index) {
-   index++;
-   if (index >= getSize()) {
-      index = 0;
+   if (mask != 0) {
+      index = (index + 1) & mask;
+   } else {
+      index++;
+      if (index >= getSize()) {
+         index = 0;
+      }
+   }
+}
+
+
+
+//////////////////////////////
+//
+// CircularBuffer::getSpans -- split count elements starting at the
+//    storage index start into at most two contiguous spans.
+//
+
+template<class type>
+int CircularBuffer<type>::getSpans(int start, int count, type*& first,
+      int& firstCount, type*& second, int& secondCount) {
+   first  = second = NULL;
+   firstCount = secondCount = 0;
+   if (count <= 0 || buffer == NULL) {
+      return 0;
+   }
+   first = buffer + start;
+   firstCount = getSize() - start;
+   if (firstCount > count) {
+      firstCount = count;
+   }
+   secondCount = count - firstCount;
+   second = secondCount > 0 ? buffer : NULL;
+   return count;
+}
+
+
+
+//////////////////////////////
+//
+// CircularBuffer::updateMask -- set the index mask after the size of
+//    the buffer has changed.
+//
+
+template<class type>
+void CircularBuffer<type>::updateMask(void) {
+   if (size > 1 && (size & (size - 1)) == 0) {
+      mask = size - 1;
+   } else {
+      mask = 0;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// CircularBuffer::wrap -- convert an index in the range from -size
+//    to 2*size-1 into a storage index.
+//
+
+template<class type>
+int CircularBuffer<type>::wrap(int index) const {
+   if (mask != 0) {
+      return index & mask;
+   } else if (index < 0) {
+      return index + size;
+   } else if (index >= size) {
+      return index - size;
    }
+   return index;
 }
 
 
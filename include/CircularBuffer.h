@@ -3,6 +3,9 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: 19 December 1997
 // Last Modified: Wed Jan 21 23:08:13 GMT-0800 1998
+// Last Modified: Sun Oct 18 15:24:50 PDT 2026 (added fill)
+// Last Modified: Sun Oct 18 16:55:38 PDT 2026 (power-of-two sizes, spans)
+// Last Modified: Mon Oct 19 08:26:33 PDT 2026 (history limited to writes)
 // Filename:      ...sig/maint/code/base/CircularBuffer/CircularBuffer.h
 // Web Address:   http://sig.sapp.org/include/sigBase/CircularBuffer.cpp
 // Documentation: http://sig.sapp.org/doc/classes/CircularBuffer
@@ -18,6 +21,9 @@
 //                object[0] is the last value written into the
 //                buffer and object[-1] (or object[1]) is the
 //                item written just before that.
+//                Blocks of elements can be accessed directly in the
+//                buffer storage as one or two contiguous spans (two
+//                when the block wraps around the end of the storage).
 //
 
 #ifndef _CIRCULARBUFFER_H_INCLUDED
@@ -33,25 +39,47 @@ class CircularBuffer {
                                            anotherBuffer);
                    ~CircularBuffer     ();
 
+      void          advanceRead        (int count);
+      void          advanceWrite       (int count);
       int           capacity           (void) const;
+      int           copyHistory        (type* output, int count);
       void          extract            (type& item);
+      int           extract            (type* items, int count);
+      void          fill               (const type& anItem);
       int           getCount           (void) const;
+      int           getHistorySpans    (int count, type*& first, 
+                                           int& firstCount, type*& second,
+                                           int& secondCount);
+      int           getReadSpans       (type*& first, int& firstCount,
+                                           type*& second, int& secondCount);
       int           getSize            (void) const;
+      int           getWriteSpans      (int count, type*& first, 
+                                           int& firstCount, type*& second,
+                                           int& secondCount);
       void          insert             (const type& aMessage);
+      int           insert             (const type* items, int count);
       type&         operator[]         (int index);
       void          read               (type& item);
       void          reset              (void);
+      void          setPow2Size        (int aSize);
       void          setSize            (int aSize);
       void          write              (const type& aMessage);
 
    protected:
       type*         buffer;
       int           size;
+      int           mask;          // size-1 if size is a power of two, else 0
       int           writeIndex;
       int           readIndex;
       int           itemCount;
+      int           historyCount;  // elements written, up to size
 
       void          increment          (int& index);
+      int           getSpans           (int start, int count, type*& first,
+                                           int& firstCount, type*& second,
+                                           int& secondCount);
+      void          updateMask         (void);
+      int           wrap               (int index) const;
 };
 
 
@@ -5,6 +5,8 @@
 // Last Modified: Mon Feb 16 22:17:30 GMT-0800 1998
 // Last Modified: Wed Sep 30 13:48:15 PDT 1998
 // Last Modified: Sat Jun 13 21:16:29 PDT 2009 (check --> xcheck for OSX)
+// Last Modified: Sun Oct 18 14:31:12 PDT 2026 (added getWaitTime)
+// Last Modified: Mon Oct 19 08:43:22 PDT 2026 (earliest time kept up to date)
 // Filename:      ...sig/src/control/EventBuffer/EventBuffer.h
 // Web Address:   http://sig.sapp.org/include/sig/EventBuffer.h
 // Syntax:        C++ 
@@ -44,6 +46,7 @@ class EventBuffer : public MidiOutput {
       int       getBufferSize      (void) const;
       int       getFreeCount       (void) const;
       int       getPollPeriod      (void) const; 
+      double    getWaitTime        (void) const;
       int       insert             (const Event* anEvent);
       int       insert             (const Event& anEvent);
       void      off                (void);
@@ -53,6 +56,8 @@ class EventBuffer : public MidiOutput {
       void      setBufferSize      (int);
       void      setPollPeriod      (double aPeriod);
 
+      static double getNextWaitTime (void);
+
 
    protected:
       Event*              eventStorage;     // ptr to Event storage location
@@ -61,6 +66,11 @@ class EventBuffer : public MidiOutput {
       CircularBuffer<int> freeSlots;        // free event spaces in storage
       SigTimer            pollTimer;        // for period checking of poll
       SigTimer            timer;            // for getting current time
+      EventBuffer*        nextBuffer;       // for list of all EventBuffers
+      int                 earliestTime;     // earliest action time in list
+      int                 earliestQ;        // true if earliestTime is valid
+
+      static EventBuffer* firstBuffer;      // start of list of EventBuffers
 
 
    // private functions:
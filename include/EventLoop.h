@@ -0,0 +1,66 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sun Oct 18 14:20:31 PDT 2026
+// Last Modified: Sun Oct 18 14:20:35 PDT 2026
+// Filename:      ...improv/include/EventLoop.h
+// Web Address:   http://sig.sapp.org/include/sig/EventLoop.h
+// Syntax:        C++
+//
+// Description:   Blocks the event loop of the improv environments
+//                until there is something to do, as an alternative to
+//                sleeping for a fixed time with the Idler class.
+//                The wait() function returns when a key is pressed,
+//                when a MIDI input thread has received a message, when
+//                the next event in any EventBuffer is due, or when an
+//                optional periodic tick for polling code has arrived.
+//                Uses epoll, timerfd and eventfd on Linux; on other
+//                systems activate() fails and the Idler should be used.
+//
+
+#ifndef _EVENTLOOP_H_INCLUDED
+#define _EVENTLOOP_H_INCLUDED
+
+// bit values returned by EventLoop::wait():
+#define EVENTLOOP_KEYBOARD   (1)    /* a key is ready to be read        */
+#define EVENTLOOP_MIDI       (2)    /* MIDI input has arrived           */
+#define EVENTLOOP_TIMER      (4)    /* EventBuffer or user deadline     */
+#define EVENTLOOP_TICK       (8)    /* periodic tick for polling code   */
+
+
+class EventLoop {
+   public:
+                  EventLoop          (void);
+                 ~EventLoop          ();
+
+      int         activate           (void);
+      void        deactivate         (void);
+      int         getReady           (void) const;
+      double      getTick            (void) const;
+      int         isActive           (void) const;
+      void        setTick            (double aPeriod);
+      void        wakeAfter          (double milliseconds);
+      int         wait               (void);
+
+      static void signalInput        (void);
+
+   protected:
+      int         epollFd;           // epoll instance, -1 if inactive
+      int         deadlineFd;        // timerfd for the next deadline
+      int         tickFd;            // timerfd for the periodic tick
+      int         keyboardQ;         // true if stdin is being watched
+      double      tickPeriod;        // tick period in ms, 0 for none
+      double      userWait;          // from wakeAfter(), -1 for none
+      int         ready;             // result of the last wait()
+
+      static int  inputFd;           // eventfd written by input threads
+
+   // protected functions
+      void        armTimer           (int fd, double milliseconds,
+                                      int repeatQ);
+};
+
+
+#endif  /* _EVENTLOOP_H_INCLUDED */
+
+
+
@@ -0,0 +1,140 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Mon Oct 19 05:31:24 PDT 2026
+// Last Modified: Mon Oct 19 05:31:28 PDT 2026
+// Last Modified: Mon Oct 19 06:31:50 PDT 2026 (per-user file, silences)
+// Last Modified: Mon Oct 19 08:37:05 PDT 2026 (reserve records without a lock)
+// Filename:      ...improv/include/FlightRecorder.h
+// Web Address:   http://sig.sapp.org/include/sig/FlightRecorder.h
+// Syntax:        C++
+//
+// Description:   Keeps the most recent MIDI traffic on all input and
+//                output ports in a ring of fixed-size records inside a
+//                file which is mapped into memory.  Each message costs
+//                one copy of an eight-byte record into the mapping, and
+//                since the operating system owns the mapped pages, the
+//                records are still in the file if the program crashes.
+//                Use the flightdump program to print the ring or to
+//                convert it into a MIDI file.
+//
+//                Each record holds the low 16 bits of its time in
+//                milliseconds, the port and direction, and up to three
+//                MIDI bytes.  Longer messages (system exclusive) take
+//                several records in a row.  Each message reserves its
+//                records with one atomic addition to the record count,
+//                so threads never wait for each other, and messages
+//                from different threads may be a few milliseconds out
+//                of time order in the ring.  About every
+//                FLIGHT_MARK_SPACING records, a mark record gives the
+//                full time, so that the times can be rebuilt after the
+//                start of the ring has been written over.  A silence
+//                longer than FLIGHT_MAX_SILENCE is written as two
+//                marks: the time of the record before the silence, and
+//                the time after it.
+//
+
+#ifndef _FLIGHTRECORDER_H_INCLUDED
+#define _FLIGHTRECORDER_H_INCLUDED
+
+#include "SigTimer.h"
+#include "MidiEvent.h"
+#include "SigCollection.h"
+#include "Array.h"
+
+#include <stdint.h>
+
+typedef unsigned char uchar;
+
+#define FLIGHT_MAGIC         "IFLR"
+#define FLIGHT_VERSION       (2)
+#define FLIGHT_DEFAULT_SIZE  (1048576)  /* records in the ring (8 MB) */
+#define FLIGHT_MARK_SPACING  (1024)     /* records between time marks */
+#define FLIGHT_MAX_SILENCE   (16384)    /* ms without a record before marks */
+#define FLIGHT_MAX_PORTS     (32)
+
+// bits of FlightRecord::info:
+#define FLIGHT_PORT_MASK     (0x1f)
+#define FLIGHT_KIND_MASK     (0x60)
+#define FLIGHT_MESSAGE       (0x00)     // last (or only) part of a message
+#define FLIGHT_PART          (0x20)     // message continues in next record
+#define FLIGHT_MARK          (0x40)     // data holds the time
+#define FLIGHT_OUTPUT        (0x80)     // sent rather than received
+
+// FlightRecord::time of a mark record:
+#define FLIGHT_AFTER_SILENCE (1)        // earlier records are not timed by it
+
+// FlightRecorderHeader: the start of a flight recorder file, followed
+// by the ring of FlightRecords.
+typedef struct {
+   char     magic[4];          // "IFLR"
+   int32_t  byteOrder;         // 0x01020304 in the writer's byte order
+   int32_t  version;           // FLIGHT_VERSION
+   int32_t  capacity;          // number of records in the ring
+   int64_t  count;             // number of records ever reserved
+   int64_t  startSeconds;      // time(NULL) when the recorder started
+   int32_t  reserved[6];
+} FlightRecorderHeader;
+
+// FlightRecord: one entry in the ring.  Record n is stored at
+// n % capacity, with a lap number of (n / capacity) % 255 + 1 so
+// that records which were never written or only partly written
+// can be recognized.
+typedef struct {
+   uint16_t time;              // low 16 bits of the time in milliseconds,
+                               //    or FLIGHT_AFTER_SILENCE in a mark
+   uchar    info;              // port, kind and direction
+   uchar    lap;               // pass through the ring
+   uchar    data[4];           // MIDI bytes and their count in data[3],
+                               //    or the int32 time of a mark
+} FlightRecord;
+
+// FlightEvent: a message read back from a flight recorder file.
+typedef struct {
+   long     time;              // milliseconds after the recorder started
+   int      port;              // MIDI port number
+   int      outputQ;           // true if sent, false if received
+   int      offset;            // location of the bytes in the data array
+   int      size;              // number of MIDI bytes
+} FlightEvent;
+
+
+class FlightRecorder {
+   public:
+      static const char* getDefaultFilename (void);
+      static void      input              (int port,
+                                           const smf::MidiEvent& aMessage);
+      static void      input              (int port, const uchar* data,
+                                           int size);
+      static void      output             (int port, const uchar* data,
+                                           int size);
+      static int       read               (const char* aFilename,
+                                           SigCollection<FlightEvent>& events,
+                                           Array<uchar>& data);
+      static int       recordingQ         (void);
+      static int       start              (const char* aFilename = NULL,
+                                           int recordCount =
+                                                 FLIGHT_DEFAULT_SIZE);
+      static void      stop               (void);
+
+   protected:
+      static FlightRecorderHeader* header;   // start of the mapped file
+      static FlightRecord* ring;          // the records after the header
+      static long      mappingSize;       // bytes in the mapped file
+      static uint64_t  mask;              // capacity - 1
+      static int       shift;             // log2 of the capacity
+      static volatile long lastTime;      // time of a recent record
+      static volatile int64_t nextMark;   // record number of the next mark
+      static volatile int writers;        // write() calls in progress
+      static SigTimer  clock;             // time since start()
+
+      static void      write              (int info, const uchar* data,
+                                           int size);
+      static void      writeRecord        (uint64_t number,
+                                           FlightRecord& record);
+};
+
+
+#endif  /* _FLIGHTRECORDER_H_INCLUDED */
+
+
+
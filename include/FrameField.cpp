@@ -0,0 +1,159 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sun Oct 18 23:52:06 PDT 2026
+// Last Modified: Sun Oct 18 23:52:10 PDT 2026
+// Last Modified: Mon Oct 19 08:26:33 PDT 2026 (copy into any number type)
+// Filename:      ...improv/include/FrameField.cpp
+// Web Address:   http://sig.sapp.org/src/sigBase/FrameField.cpp
+// Syntax:        C++
+//
+// Description:   A view of one field in a CircularBuffer of frames
+//                (structures which hold a complete set of values
+//                received at the same time).  The view is indexed
+//                in the same way as a CircularBuffer of the field's
+//                type, so that view[0] is the field in the last frame
+//                written and view[1] is the field in the frame before
+//                that.
+//
+
+#ifndef _FRAMEFIELD_CPP_INCLUDED
+#define _FRAMEFIELD_CPP_INCLUDED
+
+#include "FrameField.h"
+
+#include <stdlib.h>
+
+#ifndef OLDCPP
+   #include <iostream>
+   using namespace std;
+#else
+   #include <iostream.h>
+#endif
+
+
+//////////////////////////////
+//
+// FrameField::FrameField -- Constructor.
+//
+
+template<class frame, class type>
+FrameField<frame, type>::FrameField(void) {
+   frames = NULL;
+   field = NULL;
+}
+
+
+template<class frame, class type>
+FrameField<frame, type>::FrameField(CircularBuffer<frame>& aBuffer,
+      type frame::*aField) {
+   attach(aBuffer, aField);
+}
+
+
+
+//////////////////////////////
+//
+// FrameField::~FrameField -- The frames belong to the CircularBuffer,
+//    so there is nothing to delete.
+//
+
+template<class frame, class type>
+FrameField<frame, type>::~FrameField() {
+   // do nothing
+}
+
+
+
+//////////////////////////////
+//
+// FrameField::attach -- set the buffer of frames and the field in each
+//    frame which the view will access.
+//
+
+template<class frame, class type>
+void FrameField<frame, type>::attach(CircularBuffer<frame>& aBuffer,
+      type frame::*aField) {
+   frames = &aBuffer;
+   field = aField;
+}
+
+
+
+//////////////////////////////
+//
+// FrameField::copyHistory -- copy the field from the last count frames
+//    written, oldest first, so that output[count-1] is the same as
+//    view[0].  The output may be of any type which the field can be
+//    assigned to (such as double for a short field).  Returns the
+//    number of values copied, which is limited to the number of frames
+//    written and to the size of the buffer of frames.
+//
+
+template<class frame, class type>
+template<class target>
+int FrameField<frame, type>::copyHistory(target* output, int count) {
+   frame* first;
+   frame* second;
+   int    firstCount;
+   int    secondCount;
+   int    total = frames->getHistorySpans(count, first, firstCount,
+         second, secondCount);
+   int    i;
+   for (i=0; i<firstCount; i++) {
+      output[i] = first[i].*field;
+   }
+   output += firstCount;
+   for (i=0; i<secondCount; i++) {
+      output[i] = second[i].*field;
+   }
+   return total;
+}
+
+
+
+//////////////////////////////
+//
+// FrameField::getCount -- returns the number of frames which have not
+//    been extracted from the buffer of frames.
+//
+
+template<class frame, class type>
+int FrameField<frame, type>::getCount(void) const {
+   return frames->getCount();
+}
+
+
+
+//////////////////////////////
+//
+// FrameField::getSize -- returns the number of frames which the buffer
+//    of frames can hold.
+//
+
+template<class frame, class type>
+int FrameField<frame, type>::getSize(void) const {
+   return frames->getSize();
+}
+
+
+
+//////////////////////////////
+//
+// FrameField::operator[] -- access the field in a frame relative to the
+//    last frame written.
+//
+
+template<class frame, class type>
+type& FrameField<frame, type>::operator[](int index) {
+   if (frames == NULL) {
+      cerr << "Error: frame field is not attached to a buffer" << endl;
+      exit(1);
+   }
+   return (*frames)[index].*field;
+}
+
+
+#endif  /* _FRAMEFIELD_CPP_INCLUDED */
+
+
+
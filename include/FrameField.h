@@ -0,0 +1,56 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sun Oct 18 23:52:06 PDT 2026
+// Last Modified: Sun Oct 18 23:52:10 PDT 2026
+// Last Modified: Mon Oct 19 08:26:33 PDT 2026 (copy into any number type)
+// Filename:      ...improv/include/FrameField.h
+// Web Address:   http://sig.sapp.org/include/sigBase/FrameField.h
+// Syntax:        C++
+//
+// Description:   A view of one field in a CircularBuffer of frames
+//                (structures which hold a complete set of values
+//                received at the same time).  The view is indexed
+//                in the same way as a CircularBuffer of the field's
+//                type, so that view[0] is the field in the last frame
+//                written and view[1] is the field in the frame before
+//                that.  Since all of the views of one CircularBuffer
+//                read the same frames, their indices always refer to
+//                the same set of values.
+//
+
+#ifndef _FRAMEFIELD_H_INCLUDED
+#define _FRAMEFIELD_H_INCLUDED
+
+#include "CircularBuffer.h"
+
+
+template<class frame, class type>
+class FrameField {
+   public:
+                    FrameField         (void);
+                    FrameField         (CircularBuffer<frame>& aBuffer,
+                                           type frame::*aField);
+                   ~FrameField         ();
+
+      void          attach             (CircularBuffer<frame>& aBuffer,
+                                           type frame::*aField);
+      template<class target>
+      int           copyHistory        (target* output, int count);
+      int           getCount           (void) const;
+      int           getSize            (void) const;
+      type&         operator[]         (int index);
+
+   protected:
+      CircularBuffer<frame>*  frames;  // storage for the frames
+      type frame::*           field;   // the field in each frame
+};
+
+
+#include "FrameField.cpp"
+
+
+
+#endif  /* _FRAMEFIELD_H_INCLUDED */
+
+
+
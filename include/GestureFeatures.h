@@ -0,0 +1,115 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Mon Oct 19 02:58:44 PDT 2026
+// Last Modified: Mon Oct 19 02:58:48 PDT 2026
+// Last Modified: Mon Oct 19 08:26:33 PDT 2026 (load frames by spans)
+// Filename:      ...improv/include/GestureFeatures.h
+// Web Address:   http://sig.sapp.org/include/sig/GestureFeatures.h
+// Syntax:        C++
+//
+// Description:   Feature extraction for gestures from the baton, the
+//                stick or MIDI controllers.  A window of the recent
+//                history of a sensor is copied into an array with
+//                loadHistory() (oldest value first), and the other
+//                functions then work on the whole array at once:
+//                smoothing, velocity and acceleration, scaling to a
+//                new range, and finding peaks and onsets.  Each
+//                function is a separate pass over the window, so a
+//                chain of them is a convenience rather than a speedup:
+//                a short chain (such as velocity, average and peaks
+//                over 64 values) is slower than one hand-written loop
+//                over the history with operator[].  A single pass
+//                such as scale() is where they can be faster, since
+//                the loops have no dependencies between elements
+//                (except for lowpass()) and can be vectorized by the
+//                compiler.
+//
+
+#ifndef _GESTUREFEATURES_H_INCLUDED
+#define _GESTUREFEATURES_H_INCLUDED
+
+#include "CircularBuffer.h"
+#include "FrameField.h"
+
+
+class GestureFeatures {
+   public:
+      static int    acceleration       (double* output, const double* values,
+                                           const double* times, int count);
+      static int    average            (double* output, const double* input,
+                                           int count, int width);
+      static int    difference         (double* output, const double* input,
+                                           int count, double aScale = 1.0);
+      static int    findOnsets         (int* indices, const double* input,
+                                           int count, double threshold,
+                                           int minSpacing, int maxCount);
+      static int    findPeaks          (int* indices, const double* input,
+                                           int count, double threshold,
+                                           int maxCount);
+      static void   lowpass            (double* output, const double* input,
+                                           int count, double gain);
+      static void   scale              (double* output, const double* input,
+                                           int count, double inMin,
+                                           double inMax, double outMin,
+                                           double outMax);
+      static int    velocity           (double* output, const double* values,
+                                           const double* times, int count);
+
+      template<class type>
+      static int    loadHistory        (double* output,
+                                           CircularBuffer<type>& buffer,
+                                           int count);
+      template<class frame, class type>
+      static int    loadHistory        (double* output,
+                                           FrameField<frame, type>& field,
+                                           int count);
+};
+
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// template functions
+//
+
+//////////////////////////////
+//
+// GestureFeatures::loadHistory -- copy the last count values written
+//    into a CircularBuffer, or into the field of a frame buffer, into
+//    output with the oldest value first.  Returns the number of values
+//    copied, which is limited to the number of values written and to
+//    the size of the buffer.
+//
+
+template<class type>
+int GestureFeatures::loadHistory(double* output, CircularBuffer<type>& buffer,
+      int count) {
+   type* first;
+   type* second;
+   int   firstCount;
+   int   secondCount;
+   int   total = buffer.getHistorySpans(count, first, firstCount,
+         second, secondCount);
+   int   i;
+   for (i=0; i<firstCount; i++) {
+      output[i] = first[i];
+   }
+   output += firstCount;
+   for (i=0; i<secondCount; i++) {
+      output[i] = second[i];
+   }
+   return total;
+}
+
+
+template<class frame, class type>
+int GestureFeatures::loadHistory(double* output,
+      FrameField<frame, type>& field, int count) {
+   return field.copyHistory(output, count);
+}
+
+
+#endif  /* _GESTUREFEATURES_H_INCLUDED */
+
+
+
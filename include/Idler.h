@@ -2,6 +2,7 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Sat Jan 16 03:35:40 PST 1999
 // Last Modified: Sat Jan 16 03:35:48 PST 1999
+// Last Modified: Mon Oct 19 03:35:12 PDT 2026 (jump ahead on virtual clock)
 // Filename:      ...sig/maint/code/control/Idler/Idler.h
 // Web Address:   http://www-ccrma.stanford.edu/~craig/improv/include/Idler.h
 // Syntax:        C++
@@ -13,7 +14,9 @@
 //                variable-sleep time, where the period between
 //                sleep times is fixed (useful for variable duration
 //                event loop iterations.  The class is useful in Unix
-//                MIDI event loops to allow multiprocessing.
+//                MIDI event loops to allow multiprocessing.  When the
+//                VirtualClock is active, the Idler does not sleep but
+//                advances the clock to the next EventBuffer deadline.
 //
 
 #ifndef _IDLER_H_INCLUDED
@@ -37,6 +40,7 @@ class Idler {
       int         getSaturation  (void) const;
       static void millisleep     (double aTime);
       void        reset          (void);
+      void        setJumpLimit   (double aLimit);
       void        setHardSleep   (double aPeriod = -1);
       void        setPeriod      (double aPeriod);
       void        setSoftSleep   (double aPeriod = -1);
@@ -53,6 +57,9 @@ class Idler {
       double      lastAdjust;    // for hard sleep period determination
       double      lastTime;      // for hard sleep period determination
       double      currTime;      // for hard sleep period determination
+      double      jumpLimit;     // longest step of the virtual clock
+
+      void        jump           (void);
 };
 
 
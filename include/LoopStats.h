@@ -0,0 +1,98 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sun Oct 18 13:05:11 PDT 2026
+// Last Modified: Sun Oct 18 13:05:14 PDT 2026
+// Filename:      ...improv/include/LoopStats.h
+// Web Address:   http://sig.sapp.org/include/sig/LoopStats.h
+// Syntax:        C++
+//
+// Description:   Timing statistics for the event loop of the improv
+//                environments.  The time spent in each phase of a
+//                loop pass (MIDI input, user algorithms, keyboard
+//                checking and idling) is collected into a histogram
+//                with power-of-two microsecond buckets, along with
+//                the loop rate, the number of phases which took longer
+//                than an overrun limit, and samples of the MIDI input
+//                queue depth.  Statistics can be printed on request
+//                and/or written periodically to a file.
+//
+
+#ifndef _LOOPSTATS_H_INCLUDED
+#define _LOOPSTATS_H_INCLUDED
+
+#include "SigTimer.h"
+
+#ifndef OLDCPP
+   #include <iostream>
+   #include <fstream>
+   using namespace std;
+#else
+   #include <iostream.h>
+   #include <fstream.h>
+#endif
+
+#define LOOP_PHASE_INPUT      (0)   /* reading MIDI input           */
+#define LOOP_PHASE_ALGORITHM  (1)   /* mainloopalgorithms()         */
+#define LOOP_PHASE_KEYBOARD   (2)   /* keyboard checking/commands   */
+#define LOOP_PHASE_IDLE       (3)   /* sleeping in the Idler        */
+#define LOOP_PHASE_COUNT      (4)
+#define LOOP_PHASE_BUSY       (4)   /* whole pass except for idling */
+
+#define LOOP_HISTOGRAM_SIZE   (24)  /* bucket i: < 2^i microseconds */
+
+
+class LoopStats {
+   public:
+                  LoopStats          (void);
+                 ~LoopStats          ();
+
+      void        begin              (void);
+      void        closeDumpFile      (void);
+      void        disable            (void);
+      void        dump               (void);
+      void        enable             (void);
+      double      getOverrunTime     (void) const;
+      int         isEnabled          (void) const;
+      void        mark               (int phase);
+      void        print              (ostream& out);
+      void        printRecord        (ostream& out);
+      void        reset              (void);
+      void        sampleQueue        (int count);
+      int         setDumpFile        (const char* filename,
+                                      double aPeriod = 10.0);
+      void        setOverrunTime     (double milliseconds);
+
+   protected:
+      int         enabledQ;          // true if collecting statistics
+      int64bits   startCycles;       // clock at time of reset
+      int64bits   lastMark;          // clock at end of last phase
+      int64bits   passStart;         // clock at start of loop pass
+      double      cyclesPerMicrosecond;
+      double      overrunLimit;      // overrun time in microseconds
+
+      long        loopCount;         // number of loop passes
+      long        count[LOOP_PHASE_COUNT+1];
+      long        overruns[LOOP_PHASE_COUNT+1];
+      double      total[LOOP_PHASE_COUNT+1];     // microseconds
+      double      maximum[LOOP_PHASE_COUNT+1];   // microseconds
+      long        histogram[LOOP_PHASE_COUNT+1][LOOP_HISTOGRAM_SIZE];
+
+      long        queueSamples;      // number of queue depth samples
+      double      queueTotal;        // sum of queue depth samples
+      int         queueMax;          // largest queue depth seen
+
+      int         dumpQ;             // true if writing to a dump file
+      fstream     dumpFile;          // for periodic dumps of statistics
+      SigTimer    dumpTimer;         // for timing periodic dumps
+
+   // protected functions
+      double      getPercentile      (int phase, double fraction) const;
+      double      getSeconds         (void) const;
+      void        store              (int phase, double microseconds);
+};
+
+
+#endif  /* _LOOPSTATS_H_INCLUDED */
+
+
+
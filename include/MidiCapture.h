@@ -0,0 +1,99 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Mon Oct 19 04:12:40 PDT 2026
+// Last Modified: Mon Oct 19 04:12:44 PDT 2026
+// Last Modified: Mon Oct 19 07:41:26 PDT 2026 (port filter, read())
+// Filename:      ...improv/include/MidiCapture.h
+// Web Address:   http://sig.sapp.org/include/sig/MidiCapture.h
+// Syntax:        C++
+//
+// Description:   Records every MIDI message which arrives on any MIDI
+//                input port, with its time and port number, into a
+//                binary capture file which can be fed back into a
+//                MidiInput with MidiReplay.  The MIDI input threads
+//                only copy each message into a ring buffer for their
+//                port; a background thread writes the ring buffers to
+//                the file, so capturing does not slow down the input.
+//                The capture can be limited to a single input port.
+//
+//                Capture file format: the four characters "MIDC", then
+//                a four-byte version number, then one record for each
+//                message: the message time in milliseconds (four
+//                bytes), the input port (one byte), the number of MIDI
+//                bytes (two bytes), and the MIDI bytes.  A sysex
+//                message is stored with all of its bytes from 0xf0 to
+//                0xf7.  Numbers are stored least significant byte first.
+//                Records from different ports are not always in time
+//                order in the file.
+//
+
+#ifndef _MIDICAPTURE_H_INCLUDED
+#define _MIDICAPTURE_H_INCLUDED
+
+#include "MidiEvent.h"
+#include "SigCollection.h"
+#include "Array.h"
+
+#include <stdio.h>
+
+#ifndef VISUAL
+   #include <pthread.h>
+#endif
+
+typedef unsigned char uchar;
+
+#define MIDI_CAPTURE_MAGIC        "MIDC"
+#define MIDI_CAPTURE_VERSION      (1)
+#define MIDI_CAPTURE_HEADER_SIZE  (8)
+#define MIDI_CAPTURE_RECORD_SIZE  (7)      /* bytes before the MIDI bytes */
+#define MIDI_CAPTURE_MAX_PORTS    (16)
+#define MIDI_CAPTURE_RING_SIZE    (65536)  /* bytes per port; power of two */
+
+// MidiCaptureRecord: a message read back from a capture file.
+typedef struct {
+   long          time;          // captured time of the message
+   int           port;          // input port which received the message
+   int           offset;        // location of the MIDI bytes in data
+   int           length;        // number of MIDI bytes
+} MidiCaptureRecord;
+
+
+class MidiCapture {
+   public:
+      static long      getCount           (void);
+      static long      getDropped         (void);
+      static void      record             (int port,
+                                           const smf::MidiEvent& aMessage,
+                                           const uchar* sysex = NULL,
+                                           int sysexSize = 0);
+      static int       read               (const char* aFilename,
+                                     SigCollection<MidiCaptureRecord>& records,
+                                     Array<uchar>& data);
+      static int       recordingQ         (void);
+      static int       start              (const char* aFilename,
+                                           int aPort = -1);
+      static void      stop               (void);
+
+   protected:
+      static FILE*     output;            // the capture file
+      static uchar*    ring;              // records waiting to be written
+      static volatile unsigned int writeCount[MIDI_CAPTURE_MAX_PORTS];
+      static volatile unsigned int readCount[MIDI_CAPTURE_MAX_PORTS];
+      static long      count[MIDI_CAPTURE_MAX_PORTS];   // records accepted
+      static long      dropped[MIDI_CAPTURE_MAX_PORTS]; // records lost
+      static volatile int runningQ;       // true while capturing
+      static int       onlyPort;          // port to capture, or -1 for all
+
+      static void      writeRecords       (void);
+
+   #ifndef VISUAL
+      static pthread_t writer;            // background writing thread
+      static void*     writeLoop          (void*);
+   #endif
+};
+
+
+#endif  /* _MIDICAPTURE_H_INCLUDED */
+
+
+
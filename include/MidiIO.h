@@ -2,6 +2,7 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: 21 December 1997
 // Last Modified: Sun Jan 25 15:44:35 GMT-0800 1998
+// Last Modified: Mon Oct 19 05:02:36 PDT 2026 (added getStats)
 // Filename:      ...sig/code/control/MidiIO/MidiIO.h
 // Web Address:   http://www-ccrma.stanford.edu/~craig/improv/include/MidiIO.h
 // Syntax:        C++
@@ -35,6 +36,8 @@ class MidiIO : public MidiOutput, public MidiInput {
       int        getNumOutputPorts   (void);
       int        getOutputPort       (void);
       int        getOutputTrace      (void);
+      void       getStats            (MidiPortStats& stats,
+                                        int resetQ = 0);
       int        open                (void);
       int        openInput           (void);
       int        openOutput          (void);
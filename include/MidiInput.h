@@ -3,6 +3,8 @@
 // Creation Date: 18 December 1997
 // Last Modified: Sun Jan 25 15:27:02 GMT-0800 1998
 // Last Modified: Thu Apr 20 16:23:24 PDT 2000 (added scale function)
+// Last Modified: Mon Oct 19 05:02:36 PDT 2026 (added getStats)
+// Last Modified: Mon Oct 19 08:31:47 PDT 2026 (orphan sysex buffers)
 // Filename:      ...sig/code/control/MidiInput/MidiInput.h
 // Web Address:   http://sig.sapp.org/include/sig/MidiInput.h
 // Syntax:        C++
@@ -17,6 +19,8 @@
 #define _MIDIINPUT_H_INCLUDED
 
 #include "MidiInPort.h"
+#include "MidiStats.h"
+#include "Array.h"
 
 
 class MidiInput : public MidiInPort {
@@ -25,10 +29,17 @@ class MidiInput : public MidiInPort {
                     MidiInput         (int aPort, int autoOpen = 1);
                    ~MidiInput         ();
 
+      void          clearSysex        (void);
+      void          clearSysex        (int buffer);
       int           getBufferSize     (void);
       int           getCount          (void);
+      void          getStats          (MidiPortStats& stats,
+                                       int resetQ = 0);
+      uchar*        getSysex          (int buffer);
+      int           getSysexSize      (int buffer);
       void          extract           (smf::MidiEvent& event);
       void          insert            (const smf::MidiEvent& aMessage);
+      int           installSysex      (uchar* anArray, int aSize);
       int           isOrphan          (void) const;
       void          makeOrphanBuffer  (int aSize = 1024);
       void          removeOrphanBuffer(void);
@@ -41,6 +52,8 @@ class MidiInput : public MidiInPort {
 
    protected:
       CircularBuffer<smf::MidiEvent>* orphanBuffer;
+      Array<uchar>*  orphanSysex;      // sysex buffers of an orphan
+      int            orphanSysexIndex; // next orphan sysex buffer
 
 };
 
@@ -5,6 +5,7 @@
 // Last Modified: Sat Jan 30 14:00:29 PST 1999
 // Last Modified: Sun Jul 18 18:52:42 PDT 1999 (added RPN functions)
 // Last Modified: Wed Jun  4 20:06:46 PDT 2003 (initial MIDI file recording)
+// Last Modified: Mon Oct 19 05:02:36 PDT 2026 (added getStats)
 // Filename:      ...sig/maint/code/control/MidiOutput/MidiOutput.h
 // Web Address:   http://www-ccrma.stanford.edu/~craig/improv/include/MidiOutput.h
 // Syntax:        C++
@@ -23,6 +24,7 @@
 #include "SigTimer.h"
 #include "Array.h"
 #include "MidiEvent.h"
+#include "MidiStats.h"
 
 #define RECORD_ASCII     (0)
 #define RECORD_BINARY    (1)
@@ -37,6 +39,7 @@ class MidiOutput : public MidiOutPort {
 
       // Basic user MIDI output commands:
       int       cont           (int channel, int controller, int data);
+      void      getStats       (MidiPortStats& stats, int resetQ = 0);
       int       off            (int channel, int keynum, int releaseVelocity);
       int       pc             (int channel, int timbre);
       int       play           (int channel, int keynum, int velocity);
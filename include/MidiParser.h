@@ -0,0 +1,53 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sun Oct 18 11:02:15 PDT 2026
+// Last Modified: Sun Oct 18 11:02:18 PDT 2026
+// Last Modified: Mon Oct 19 04:51:07 PDT 2026 (count bytes and errors)
+// Filename:      ...improv/include/MidiParser.h
+// Web Address:   http://sig.sapp.org/include/sig/MidiParser.h
+// Syntax:        C++
+//
+// Description:   Converts a raw MIDI byte stream into complete MIDI
+//                messages, one byte at a time, handling running status
+//                and system exclusive messages.  Factored out of the
+//                ALSA MIDI input thread so that the byte interpretation
+//                can be used (and timed) without a MIDI device.
+//
+
+#ifndef _MIDIPARSER_H_INCLUDED
+#define _MIDIPARSER_H_INCLUDED
+
+#include "Array.h"
+#include "MidiEvent.h"
+
+typedef unsigned char uchar;
+
+class MidiParser {
+   public:
+                      MidiParser        (void);
+                     ~MidiParser        ();
+
+      void            clearSysex        (void);
+      smf::MidiEvent& getMessage        (void);
+      uchar*          getSysexData      (void);
+      int             getSysexSize      (void);
+      int             isSysex           (void) const;
+      int             parse             (uchar aByte, int aTime);
+      void            reset             (void);
+      void            setPort           (int aPort);
+
+   protected:
+      smf::MidiEvent  message;          // message being assembled
+      int             argsExpected;     // parameter bytes expected
+      int             argsLeft;         // parameter bytes left to wait for
+      Array<uchar>    sysexIn;          // sysex message being assembled
+      int             port;             // input port for MidiStats
+
+      void            dropSysex         (void);
+};
+
+
+#endif  /* _MIDIPARSER_H_INCLUDED */
+
+
+
@@ -2,6 +2,11 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Sat Nov 27 14:00:11 PST 1999
 // Last Modified: Sat Jun 13 21:16:29 PDT 2009 (check --> xcheck for OSX)
+// Last Modified: Sun Oct 18 18:41:07 PDT 2026 (merged playback timeline)
+// Last Modified: Sun Oct 18 19:58:13 PDT 2026 (compiled performance files)
+// Last Modified: Sun Oct 18 22:31:40 PDT 2026 (lookahead dispatch thread)
+// Last Modified: Sun Oct 18 23:41:12 PDT 2026 (predictive beat tracking)
+// Last Modified: Mon Oct 19 06:48:22 PDT 2026 (check long messages)
 // Filename:      ...sig/maint/code/control/MidiPerform/MidiPerform.h
 // Web Address:   http://www-ccrma.stanford.edu/~craig/improv/include/MidiPerform.h
 // Syntax:        C++ 
@@ -9,7 +14,24 @@
 // Description:   A class which performs a MIDI file with various
 //                types of tempo and volume controls built in.
 //                Works similar to a sequencer program, but not designed
-//                for editing of the data.
+//                for editing of the data.  The tracks of the MIDI
+//                file are merged into a single time-sorted list of
+//                events when the file is read, so that playback only
+//                has to look at the next event in the list, and
+//                setBeatLocation() can find its place in the list with
+//                a binary search.  Compiled performance files (see
+//                PerformFile) are mapped into memory and played
+//                directly, without reading a MIDI file.
+//                With setLookahead(), xcheck() only queues the events
+//                which are due within the lookahead window, and a
+//                dispatch thread sends each one at its time, so the
+//                output timing does not depend on how often xcheck()
+//                is called.  Queued events are kept as score times and
+//                converted to clock times just before they are sent,
+//                so tempo changes from beat() also apply to them.
+//                In the automatic tempo method, the performance does
+//                not wait for beats, but if beats are given, their
+//                tempo and phase are followed with a BeatTracker.
 //
 
 #ifndef _MIDIPERFORM_H_INCLUDED
@@ -17,9 +39,17 @@
 
 #include "MidiFile.h"
 #include "CircularBuffer.h"
+#include "SigCollection.h"
+#include "PerformFile.h"
 #include "SigTimer.h"
 #include "MidiOutput.h"
 #include "MidiStageEvent.h"
+#include "NoteState.h"
+#include "BeatTracker.h"
+
+#ifndef VISUAL
+   #include <pthread.h>
+#endif
 
 #define TEMPO_METHOD_AUTOMATIC 0
 #define TEMPO_METHOD_CONSTANT  1
@@ -37,7 +67,9 @@ class MidiPerform : public MidiOutput {
 
       void      beat                  (void);
       double    getAmp                (void);
+      BeatTracker& getBeatTracker     (void);
       int       getMaxAmp             (void);
+      double    getLookahead          (void);
       int       getTempoMethod        (void);
       double    getTempo              (void);
       int       channelCollapse       (int aSetting = -1);
@@ -52,6 +84,7 @@ class MidiPerform : public MidiOutput {
       void      setAmp                (double anAmp);
       void      setMaxAmp             (int aMax);
       void      setBeatLocation       (double aLocation);
+      void      setLookahead          (double milliseconds);
       void      setTempoMethod        (int aMethod);
       void      setTempo              (double aTempo);
       void      stop                  (void);
@@ -65,17 +98,51 @@ class MidiPerform : public MidiOutput {
       double                          pauseLocation;
       int                             playingQ;   
       CircularBuffer<double>          beatTimes;
-      int                            *readIndex;
+      SigCollection<PerformEvent>     timeline;   // merged MIDI tracks
+      SigCollection<uchar>            longData;   // long message storage
+      PerformFile                     compiled;   // or a compiled file
+      const PerformEvent*             events;     // events being played
+      int                             eventCount;
+      const uchar*                    longBytes;  // long messages of events
+      long                            longSize;   // bytes in longBytes
+      int                             ticksPerQuarter;
+      int                             readIndex;  // next event to play
+      int                             sendIndex;  // next queued event
+      double                          lookahead;  // queue window in ms
+      NoteState                       sounding;   // notes sent but not off
+      BeatTracker                     tracker;    // for automatic method
+      double                          correctionEnd; // phase correction
       int                             tempoMethod;     
       double                          amp;
       int                             maxamp;
       int                             channelcollapseQ;
+   #ifndef VISUAL
+      pthread_t                       dispatcher; // sends queued events
+      pthread_mutex_t                 mutex;      // for queue and timers
+      pthread_cond_t                  wakeup;     // queue or tempo changed
+      int                             dispatchQ;  // dispatcher is running
+   #endif
+
+      int          findEvent          (int tick);
+      void         lock               (void);
+      void         notify             (void);
+      void         sendEvent          (const PerformEvent& event);
+      void         silence            (void);
+      void         unlock             (void);
+      int          waitingQ           (void);
 
    private:
+      void         initialize         (void);
+      void         startDispatcher    (void);
+      void         stopDispatcher     (void);
       double       getAverageTempo    (int count);
       void         beat_tracktempo    (int watchhistory);
       void         beat_automatic     (void);
       void         beat_constant      (void);
+
+   #ifndef VISUAL
+      static void* dispatch           (void* aPerform);
+   #endif
 };
 
 
@@ -0,0 +1,67 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Mon Oct 19 04:12:40 PDT 2026
+// Last Modified: Mon Oct 19 04:12:44 PDT 2026
+// Last Modified: Mon Oct 19 07:41:26 PDT 2026 (read with MidiCapture)
+// Last Modified: Mon Oct 19 08:31:47 PDT 2026 (replay into an orphan)
+// Last Modified: Mon Oct 19 08:55:41 PDT 2026 (added next())
+// Filename:      ...improv/include/MidiReplay.h
+// Web Address:   http://sig.sapp.org/include/sig/MidiReplay.h
+// Syntax:        C++
+//
+// Description:   Feeds a MIDI capture file written by MidiCapture into
+//                a MidiInput as if the messages were arriving from the
+//                MIDI hardware.  Messages are given out at their
+//                captured spacing, at a multiple of it, or as fast as
+//                the program takes them out of the input buffer.  The
+//                MidiInput must be an orphan (see makeOrphanBuffer()),
+//                so that the replay does not write into the buffers
+//                of a port while its MIDI input thread does.  A
+//                program which interprets the messages itself can take
+//                them out one at a time with next().
+//
+
+#ifndef _MIDIREPLAY_H_INCLUDED
+#define _MIDIREPLAY_H_INCLUDED
+
+#include "MidiCapture.h"
+#include "MidiInput.h"
+#include "SigCollection.h"
+#include "Array.h"
+#include "SigTimer.h"
+
+
+class MidiReplay {
+   public:
+                    MidiReplay         (void);
+                   ~MidiReplay         ();
+
+      void          clear              (void);
+      int           getCount           (void) const;
+      int           getIndex           (void) const;
+      double        getSpeed           (void) const;
+      int           next               (MidiInput& input,
+                                           smf::MidiEvent& aMessage,
+                                           int aPort = -1);
+      int           playingQ           (void) const;
+      int           read               (const char* aFilename);
+      void          start              (double aSpeed = 1.0);
+      void          stop               (void);
+      int           update             (MidiInput& input, int aPort = -1);
+
+   protected:
+      SigCollection<MidiCaptureRecord> records;  // messages in time order
+      Array<uchar>  data;              // MIDI bytes of all messages
+      int           index;             // next record to play
+      double        speed;             // playback speed (0 = fast as possible)
+      long          startTime;         // time playback started
+      int           runningQ;          // true while playing
+      SigTimer      timer;             // for the playback times
+      smf::MidiEvent message;          // for inserting into the input
+};
+
+
+#endif  /* _MIDIREPLAY_H_INCLUDED */
+
+
+
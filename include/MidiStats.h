@@ -0,0 +1,84 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Mon Oct 19 04:51:07 PDT 2026
+// Last Modified: Mon Oct 19 04:51:11 PDT 2026
+// Filename:      ...improv/include/MidiStats.h
+// Web Address:   http://sig.sapp.org/include/sig/MidiStats.h
+// Syntax:        C++
+//
+// Description:   Counters for the traffic on each MIDI input and output
+//                port: bytes and messages, sysex sizes, parsing errors,
+//                messages dropped while an input is paused, messages
+//                lost when the input queue was full, the deepest input
+//                queue and failed sends.  The input counters are only
+//                written by the MIDI input thread of the port, and the
+//                output counters are added atomically, so no locks are
+//                needed.  Read the counters with getStats() in
+//                MidiInput, MidiOutput or MidiIO.
+//
+
+#ifndef _MIDISTATS_H_INCLUDED
+#define _MIDISTATS_H_INCLUDED
+
+#ifndef OLDCPP
+   #include <iostream>
+   using namespace std;
+#else
+   #include <iostream.h>
+#endif
+
+#define MIDI_STATS_MAX_PORTS  (32)
+#define MIDI_STATS_INPUT      (1)
+#define MIDI_STATS_OUTPUT     (2)
+
+typedef struct {
+   long  bytesIn;           // bytes received, including ignored bytes
+   long  messagesIn;        // messages stored in the input queue
+   long  sysexIn;           // sysex messages received
+   long  maxSysexSize;      // largest sysex message received
+   long  parseErrors;       // unexpected bytes in the input
+   long  dropped;           // messages discarded while input was paused
+   long  overwrites;        // messages lost because the queue was full
+   long  maxQueueDepth;     // most messages waiting in the input queue
+   long  bytesOut;          // bytes sent
+   long  messagesOut;       // messages sent
+   long  sendErrors;        // messages which could not be sent
+} MidiPortStats;
+
+
+class MidiStats {
+   public:
+      // for the MIDI input thread of a port:
+      static void      inputByte          (int port);
+      static void      inputDropped       (int port);
+      static void      inputError         (int port);
+      static void      inputMessage       (int port, int queueCount,
+                                           int queueSize);
+      static void      inputSysex         (int port, int aSize);
+
+      // for any thread sending MIDI output:
+      static void      output             (int port, int byteCount,
+                                           int status);
+
+      static void      clear              (MidiPortStats& stats);
+      static void      getInput           (int port, MidiPortStats& stats,
+                                           int resetQ = 0);
+      static void      getOutput          (int port, MidiPortStats& stats,
+                                           int resetQ = 0);
+      static void      print              (ostream& out,
+                                           const MidiPortStats& stats,
+                                           int which = MIDI_STATS_INPUT |
+                                                       MIDI_STATS_OUTPUT);
+
+   protected:
+      static volatile MidiPortStats inputCounts[MIDI_STATS_MAX_PORTS];
+      static volatile MidiPortStats outputCounts[MIDI_STATS_MAX_PORTS];
+      static MidiPortStats inputBase[MIDI_STATS_MAX_PORTS];
+      static MidiPortStats outputBase[MIDI_STATS_MAX_PORTS];
+};
+
+
+#endif  /* _MIDISTATS_H_INCLUDED */
+
+
+
@@ -0,0 +1,91 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sun Oct 18 17:58:02 PDT 2026
+// Last Modified: Sun Oct 18 17:58:06 PDT 2026
+// Filename:      ...improv/include/NoteState.h
+// Web Address:   http://sig.sapp.org/include/sig/NoteState.h
+// Syntax:        C++
+//
+// Description:   Keeps track of which keys are held down on each MIDI
+//                channel, with the velocity and time of each note-on,
+//                and which notes are still sounding because of the
+//                sustain pedal.  The held notes can be listed in pitch
+//                order or in the order in which they were played, and
+//                the lowest, highest and most recent held notes are
+//                found without searching.  Updated from incoming MIDI
+//                messages with process().
+//
+
+#ifndef _NOTESTATE_H_INCLUDED
+#define _NOTESTATE_H_INCLUDED
+
+#include "MidiEvent.h"
+
+#include <stdint.h>
+
+typedef unsigned char uchar;
+
+#define NOTESTATE_ALL_CHANNELS  (-1)  /* query all channels together  */
+
+#define NOTESTATE_BY_PITCH      (0)   /* list notes lowest first      */
+#define NOTESTATE_BY_TIME       (1)   /* list notes oldest first      */
+
+
+class NoteState {
+   public:
+                  NoteState          (void);
+                 ~NoteState          ();
+
+      void        allNotesOff        (int channel = NOTESTATE_ALL_CHANNELS);
+      int         getHeldCount       (int channel = NOTESTATE_ALL_CHANNELS)
+                                         const;
+      int         getHeldNotes       (int* keys, int maxCount,
+                                      int order = NOTESTATE_BY_PITCH,
+                                      int channel = NOTESTATE_ALL_CHANNELS)
+                                         const;
+      int         getHighestHeld     (int channel = NOTESTATE_ALL_CHANNELS)
+                                         const;
+      int         getLatestHeld      (int channel = NOTESTATE_ALL_CHANNELS)
+                                         const;
+      int         getLowestHeld      (int channel = NOTESTATE_ALL_CHANNELS)
+                                         const;
+      long        getOnTime          (int key, int channel = 0) const;
+      int         getSoundingCount   (int channel = NOTESTATE_ALL_CHANNELS)
+                                         const;
+      int         getVelocity        (int key, int channel = 0) const;
+      int         heldQ              (int key, int channel = 0) const;
+      void        noteOff            (int channel, int key);
+      void        noteOn             (int channel, int key, int velocity,
+                                      long time);
+      void        process            (const smf::MidiEvent& aMessage);
+      void        reset              (void);
+      void        setSustain         (int channel, int downQ);
+      int         soundingQ          (int key, int channel = 0) const;
+      int         sustainQ           (int channel = 0) const;
+
+   protected:
+      uchar       velocity[16][128];     // velocity of the last note-on
+      long        onTime[16][128];       // time of the last note-on
+      uint32_t    heldBits[16][4];       // keys held down [channel][key/32]
+      uint32_t    soundingBits[16][4];   // keys held or sustained
+      uint32_t    anyHeldBits[4];        // keys held on any channel
+      uchar       heldChannels[128];     // number of channels holding key
+      int         heldCount[16];         // number of keys held on channel
+      int         totalHeld;             // number of keys held in all
+      int         sustainBits;           // sustain pedal down [channel]
+
+      // doubly linked list of held notes in order of note-on, indexed
+      // by channel * 128 + key:
+      short       prevHeld[16 * 128];
+      short       nextHeld[16 * 128];
+      short       oldestHeld;            // -1 if nothing is held
+      short       newestHeld;            // -1 if nothing is held
+
+      void        releaseHeld        (int channel, int key);
+};
+
+
+#endif  /* _NOTESTATE_H_INCLUDED */
+
+
+
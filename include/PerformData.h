@@ -3,17 +3,31 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Fri Jul  2 23:05:34 PDT 1999
 // Last Modified: Tue Jul  6 00:10:53 PDT 1999
+// Last Modified: Sun Oct 18 20:52:16 PDT 2026 (contiguous records, indexes)
+// Last Modified: Sun Oct 18 22:05:15 PDT 2026 (indexed text search)
+// Last Modified: Mon Oct 19 06:02:41 PDT 2026 (keep ticks per quarter)
+// Last Modified: Mon Oct 19 06:48:22 PDT 2026 (read compiled files)
+// Last Modified: Mon Oct 19 07:21:43 PDT 2026 (match with SearchPattern)
+// Last Modified: Mon Oct 19 08:04:51 PDT 2026 (SearchPattern declared only)
 // Filename:      .../sig/include/sigInfo/PerformData.h
 // Web Address:   http://sig.sapp.org/include/sigInfo/PerformData.h
 // Syntax:        C++
 //
 // Description:   Data for a somewhat defunct class, Perform.
+//                The records are stored in one array.  The measure and
+//                tempo records are indexed so that a measure, and the
+//                tempo in effect at any record, can be found with a
+//                binary search.  Text searches only look at the
+//                records which contain text (see PerformSearch).
 //
 
 #ifndef _PERFORMDATA_H_INCLUDED
 #define _PERFORMDATA_H_INCLUDED
 
 #include "PerformDataRecord.h"
+#include "PerformSearch.h"
+#include "PerformFile.h"
+#include "MidiFile.h"
 
 #define PERFORM_TIME_UNKNOWN -1
 #define PERFORM_TIME_ABSOLUTE 1
@@ -31,6 +45,9 @@ class PerformData {
       void                  clear                (void);
       int                   determineTimeType    (void);
       int                   eof                  (void);
+      int                   findMeasure          (int aMeasure);
+      int                   findMeasureAt        (int index);
+      int                   findTempo            (int index);
       void                  inputAsciiMidiFile   (const char* filename);
       void                  inputHumdrumMidiFile (const char* filename);
       void                  inputMidiFile        (const char* filename);
@@ -41,6 +58,7 @@ class PerformData {
       int                   getMeasure           (void);
       int                   getSize              (void);
       double                getTempo             (void);
+      int                   getTicksPerQuarterNote (void);
       int                   getTime              (void);
       int                   getTimeType          (void);
       int                   getType              (void);
@@ -51,6 +69,9 @@ class PerformData {
       PerformDataRecord&    operator[]           (int index);
       ostream&              print                (ostream& out = cout);
       int                   ready                (int aTime);
+      int                   search               (const char* pattern,
+                                                    int startIndex,
+                                                    int direction);
       void                  setIndex             (int index);
       void                  setTime              (int aTime);
       void                  setTimeType          (int aTimeType);
@@ -61,24 +82,33 @@ class PerformData {
 
    protected:
       int                   currentIndex;   // current performance index
-      Array<PerformDataRecord*>  records;   // data
+      SigCollection<PerformDataRecord> records;   // data
       PerformDataRecord     begin;          // first record in list
       PerformDataRecord     end;            // last record in list
       int                   timeFormat;     // times are delta or absolute
-
-      static int  performRecordCompare      (const void* a, const void* b);
+      SigCollection<int>    measureIndex;   // measure records by number
+      SigCollection<int>    measureOrder;   // measure records in order
+      SigCollection<int>    tempoIndex;     // tempo records in order
+      PerformSearch         finder;         // text records and trigrams
+      SearchPattern*        matchPattern;   // last expression for match()
+      int                   indexValidQ;    // indexes match records
+      int                   dataTicksPerQuarter; // ticks in a quarter note
+
+      void                  buildIndex           (void);
+      PerformDataRecord&    current              (void);
+      void                  inputMidiData        (smf::MidiFile& midifile);
+      void                  inputPerformFile     (PerformFile& file);
 
    private:  // helping functions for inputHumdrumMidiFile function
       double        last_tempo;                // for backward tempo tracking
+      int           humdrum_time;              // time of current line
       int           getLineType                (const char* line);
       int           getMeasureValue            (const char* string);
       int           getNextLine                (char* buffer, istream& input);
       int           getSpineCount              (const char* aString);
       void          processHumdrumData         (const char* currentLine, 
-                                                  Array<int>& spine_list,
                                                   Array<int>& chan_list);
       void          processInterpLine          (const char* line,
-                                                  Array<int>& spine_list,
                                                   Array<int>& chan_list,
                                                   Array<int>& path_list);
       void          processExclusiveInterpLine (const char* line,
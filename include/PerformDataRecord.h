@@ -3,11 +3,17 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Fri Jul  2 23:05:34 PDT 1999
 // Last Modified: Mon Jul  5 10:54:00 PDT 1999
+// Last Modified: Sun Oct 18 20:52:16 PDT 2026 (short data stored inline)
+// Last Modified: Mon Oct 19 07:21:43 PDT 2026 (match with SearchPattern)
+// Last Modified: Mon Oct 19 08:04:51 PDT 2026 (SearchPattern declared only)
 // Filename:      .../sig/include/sigInfo/PerformDataRecord.h
 // Web Address:   http://sig.sapp.org/src/sigInfo/PerformDataRecord.h
 // Syntax:        C++
 //
 // Description:   Data for a somewhat defunct class, Perform.
+//                Short data (MIDI messages, measure numbers and tempos)
+//                is stored inside of the record, so that an array of
+//                records does not need a memory allocation per record.
 //
 
 #ifndef _PERFORMDATARECORD_H_INCLUDED
@@ -15,6 +21,8 @@
 
 #include "Array.h"
 
+class SearchPattern;
+
 #define PERFORM_TYPE_NULL    (0)
 #define PERFORM_TYPE_TEXT    (1)
 #define PERFORM_TYPE_MIDI    (2)
@@ -25,11 +33,15 @@
 #define PERFORM_TYPE_BEGIN   (7)
 #define PERFORM_TYPE_END     (8)
 
+// data shorter than this is stored inside of the record:
+#define PERFORM_SHORT_SIZE   (20)
+
 
 class PerformDataRecord {
    public:
                    PerformDataRecord      (void);
                    PerformDataRecord      (PerformDataRecord& aRecord);
+                   PerformDataRecord      (PerformDataRecord&& aRecord);
                   ~PerformDataRecord      ();
 
       char*        getData                (void);
@@ -39,7 +51,9 @@ class PerformDataRecord {
       int          getTime                (void);
       int          getType                (void);
       int          match                  (const char* matchString);
+      int          match                  (const SearchPattern& pattern);
       PerformDataRecord& operator=        (PerformDataRecord& aRecord);
+      PerformDataRecord& operator=        (PerformDataRecord&& aRecord);
       ostream&     print                  (ostream& out = cout);
       void         setBar                 (int aTime, const char* measureData,
                                              int length = -1);
@@ -70,7 +84,12 @@ class PerformDataRecord {
    protected:
       int          time;                  // time to perform data
       int          type;                  // type of data
-      Array<char>  data;                  // data of record
+      int          length;                // number of bytes of data
+      char         shortData[PERFORM_SHORT_SIZE]; // data if short enough
+      char*        longData;              // data if too long for shortData
+
+      void         setData                (const char* someData, int aLength);
+      void         setNumber              (double aNumber);
 };
 
 
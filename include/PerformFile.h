@@ -0,0 +1,129 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sun Oct 18 19:22:35 PDT 2026
+// Last Modified: Sun Oct 18 19:22:38 PDT 2026
+// Last Modified: Mon Oct 19 06:48:22 PDT 2026 (64-bit offsets, checks)
+// Filename:      ...improv/include/PerformFile.h
+// Web Address:   http://sig.sapp.org/include/sig/PerformFile.h
+// Syntax:        C++
+//
+// Description:   Compiled performance files for MidiPerform.  The
+//                tracks of a MIDI file are merged into one list of
+//                fixed-size event records with absolute tick times,
+//                followed by tables giving the location of each beat,
+//                measure and tempo change.  A compiled file is mapped
+//                into memory when opened rather than read, so very
+//                large files can start playing immediately, and only
+//                the part of the file being played is kept in memory.
+//
+
+#ifndef _PERFORMFILE_H_INCLUDED
+#define _PERFORMFILE_H_INCLUDED
+
+#include "MidiFile.h"
+#include "SigCollection.h"
+
+#include <stdint.h>
+
+typedef unsigned char uchar;
+
+#define PERFORMFILE_VERSION  (2)
+
+// PerformEvent: one MIDI message in a playback timeline.  Messages
+// of up to four bytes are stored in the event, longer ones (system
+// exclusive) are stored in a separate array of bytes.
+typedef struct {
+   int    tick;        // absolute time of the message in ticks
+   int    size;        // number of bytes in the message
+   union {
+      uchar data[4];   // message bytes if size <= 4
+      int   offset;    // start of message in long data if size > 4
+   };
+} PerformEvent;
+
+// PerformMarker: the location of a beat, measure or tempo change.
+typedef struct {
+   int    tick;        // time of the marker in ticks
+   int    index;       // first event at or after the marker
+   int    value;       // tempo in microseconds per quarter note, or
+                       //    measure length in ticks, or 0 for beats
+} PerformMarker;
+
+// PerformFileHeader: the start of a compiled performance file.  The
+// offsets are in bytes from the start of the file, and are 64 bits
+// long since the sections of a large file can end past 2 GB.
+typedef struct {
+   char     magic[4];          // "IPRF"
+   int32_t  byteOrder;         // 0x01020304 in the writer's byte order
+   int32_t  version;           // PERFORMFILE_VERSION
+   int32_t  ticksPerQuarter;   // ticks per quarter note
+   int32_t  eventCount;        // number of PerformEvent records
+   int32_t  beatCount;         // number of beat PerformMarkers
+   int32_t  measureCount;      // number of measure PerformMarkers
+   int32_t  tempoCount;        // number of tempo PerformMarkers
+   int32_t  longDataSize;      // number of bytes of long messages
+   int32_t  reserved;
+   int64_t  eventOffset;
+   int64_t  beatOffset;
+   int64_t  measureOffset;
+   int64_t  tempoOffset;
+   int64_t  longDataOffset;
+} PerformFileHeader;
+
+
+class PerformFile {
+   public:
+                  PerformFile        (void);
+                 ~PerformFile        ();
+
+      void        close              (void);
+      int         findEvent          (int tick) const;
+      int         findTempo          (int tick) const;
+      const PerformMarker& getBeat   (int index) const;
+      int         getBeatCount       (void) const;
+      int         getEventCount      (void) const;
+      const PerformEvent* getEvents  (void) const;
+      const uchar* getLongData       (void) const;
+      int         getLongDataSize    (void) const;
+      const uchar* getLongMessage    (const PerformEvent& event) const;
+      const PerformMarker& getMeasure(int index) const;
+      int         getMeasureCount    (void) const;
+      const PerformMarker& getTempo  (int index) const;
+      int         getTempoCount      (void) const;
+      int         getTicksPerQuarterNote(void) const;
+      int         isOpen             (void) const;
+      int         open               (const char* filename);
+      void        release            (int index);
+
+      static int  findEvent          (const PerformEvent* events, int low,
+                                      int high, int tick);
+      static int  isPerformFile      (const char* filename);
+      static const uchar* getLongMessage (const PerformEvent& event,
+                                      const uchar* longData, long size);
+      static void merge              (smf::MidiFile& midifile,
+                                      SigCollection<PerformEvent>& events,
+                                      SigCollection<uchar>& longData);
+      static int  write              (const char* filename,
+                                      smf::MidiFile& midifile);
+
+   protected:
+      uchar*               mapping;       // contents of the file
+      long                 mappingSize;   // size of the file in bytes
+      int                  mappedQ;       // mapped rather than read in
+      PerformFileHeader    info;          // copy of the file header
+      PerformEvent*        events;
+      PerformMarker*       beats;
+      PerformMarker*       measures;
+      PerformMarker*       tempos;
+      uchar*               longData;
+      long                 releasedBytes; // events before this not needed
+      long                 pageSize;
+
+      int         checkHeader        (const char* filename);
+};
+
+
+#endif  /* _PERFORMFILE_H_INCLUDED */
+
+
+
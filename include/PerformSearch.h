@@ -0,0 +1,68 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sun Oct 18 22:05:12 PDT 2026
+// Last Modified: Sun Oct 18 22:05:15 PDT 2026
+// Last Modified: Mon Oct 19 07:21:43 PDT 2026 (expression kept in object)
+// Last Modified: Mon Oct 19 08:04:51 PDT 2026 (SearchPattern declared only)
+// Filename:      ...improv/include/PerformSearch.h
+// Web Address:   http://sig.sapp.org/include/sig/PerformSearch.h
+// Syntax:        C++
+//
+// Description:   Text search for PerformData.  Keeps a list of the
+//                records which contain text (text, measure and tempo
+//                records), so that MIDI records are never looked at,
+//                and an index of the three-letter sequences in the
+//                text so that a literal string can be found by
+//                checking only the records which could contain it.
+//                Regular expressions are compiled once per pattern.
+//
+
+#ifndef _PERFORMSEARCH_H_INCLUDED
+#define _PERFORMSEARCH_H_INCLUDED
+
+#include "SigCollection.h"
+
+#include <stdint.h>
+
+class PerformData;
+class SearchPattern;
+
+
+class PerformSearch {
+   public:
+                  PerformSearch      (void);
+                 ~PerformSearch      ();
+
+      void        clear              (void);
+      int         find               (PerformData& data, const char* pattern,
+                                      int startIndex, int direction);
+      int         getTextCount       (void);
+      void        index              (PerformData& data);
+      void        setTrigrams        (int aState = 1);
+
+   protected:
+      SigCollection<int>       textRecords;   // records which contain text
+      SigCollection<uint64_t>  trigrams;      // trigram << 32 | text position
+      int                      trigramQ;      // use the trigram index
+      int                      trigramValidQ; // trigram index is built
+      SearchPattern*           expression;    // last regular expression
+
+      void        buildTrigrams      (PerformData& data);
+      int         findExpression     (PerformData& data, const char* pattern,
+                                      int position, int direction);
+      int         findLiteral        (PerformData& data, const char* pattern,
+                                      int position, int direction);
+      int         getStartPosition   (int startIndex, int direction);
+
+      static int  literalQ           (const char* pattern);
+
+   private:
+                  PerformSearch      (const PerformSearch& aSearch);
+      PerformSearch& operator=       (const PerformSearch& aSearch);
+};
+
+
+#endif  /* _PERFORMSEARCH_H_INCLUDED */
+
+
+
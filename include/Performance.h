@@ -2,6 +2,7 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Fri Jul  2 23:05:34 PDT 1999
 // Last Modified: Thu Jul  8 15:11:51 PDT 1999
+// Last Modified: Mon Oct 19 08:11:27 PDT 2026 (keep ticks set by caller)
 // Filename:      .../sig/include/sigControl/Performance.h
 // Web Address:   http://sig.sapp.org/include/sigControl/Performance.h
 // Syntax:        C++
@@ -45,6 +46,7 @@ class Performance : public PerformData, public MidiOutput {
 
    protected:
       int        ticksPerQuarter;        // ticks per quarter note
+      int        ticksSetQ;              // ticksPerQuarter set by caller
       SigTimer   timer;                  // for keeping track of time
       double     tempoMultiplier;        // for altering the default tempos
       char       noteState[16][128];     // current on/off state of notes
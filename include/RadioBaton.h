@@ -8,6 +8,13 @@
 // Last Modified: Wed Apr 19 16:02:27 PDT 2000 (added axis reverse options)
 // Last Modified: Thu Apr 20 16:27:05 PDT 2000 (added scaling functions)
 // Last Modified: Sun Oct  1 15:19:13 PDT 2000 (revised for firmware "AE")
+// Last Modified: Sun Oct 18 17:04:12 PDT 2026 (history span note)
+// Last Modified: Sun Oct 18 23:52:06 PDT 2026 (frame history buffers)
+// Last Modified: Mon Oct 19 00:21:37 PDT 2026 (added getState)
+// Last Modified: Mon Oct 19 00:48:15 PDT 2026 (added trigger prediction)
+// Last Modified: Mon Oct 19 01:42:18 PDT 2026 (session record and replay)
+// Last Modified: Mon Oct 19 06:14:08 PDT 2026 (per-object input event)
+// Last Modified: Mon Oct 19 08:55:41 PDT 2026 (replay with MidiReplay)
 // Filename:      ...sig/code/control/RadioBaton/RadioBaton.h
 // Web Address:   http://sig.sapp.org/include/sig/RadioBaton.h
 // Syntax:        C++
@@ -22,6 +29,10 @@
 
 #include "batonprotocol.h"       /* October 2000 communication protocol    */
 #include "CircularBuffer.h"      /* for storage of state variables         */
+#include "FrameField.h"          /* for views of stored frame fields       */
+#include "TriggerPredictor.h"    /* for early triggers from stick heights  */
+#include "BatonRecorder.h"       /* for recording sessions of MIDI input   */
+#include "MidiReplay.h"          /* for replaying recorded sessions        */
 #include "MidiIO.h"              /* Inheritance of MIDI in/out class funcs */
 #include "MidiEvent.h"           /* for MIDI input from the drivers        */
 
@@ -74,6 +85,55 @@
 #define B15RECORD          "c2"   /* B15+ button state record                */
 
 
+// Frames for the storage buffers of old data.  Each frame holds one
+// complete report from the baton, so the values in a frame always
+// belong together.  The time is placed first so that a frame fills
+// 16 bytes (four frames to a 64-byte cache line) on 64-bit computers.
+
+struct BatonPositionFrame {
+   long  time;                      // time of the position report
+   uchar x;                         // x-axis position
+   uchar y;                         // y-axis position
+   uchar z;                         // z-axis position
+};
+
+struct BatonTriggerFrame {
+   long  time;                      // time of the trigger
+   uchar x;                         // x-axis position at trigger time
+   uchar y;                         // y-axis position at trigger time
+   uchar w;                         // whack strength of the trigger
+};
+
+struct BatonDialFrame {
+   long  time;                      // time of the dial report
+   uchar value;                     // dial position
+};
+
+
+// A copy of the complete state of the baton, made with getState().
+// The counts are incremented for each complete report, so that a
+// reader can tell whether a new position or trigger has arrived since
+// its last copy.
+
+struct BatonState {
+   BatonPositionFrame position1;    // last complete stick 1 position
+   BatonPositionFrame position2;    // last complete stick 2 position
+   BatonTriggerFrame  trigger1;     // last complete stick 1 trigger
+   BatonTriggerFrame  trigger2;     // last complete stick 2 trigger
+   BatonDialFrame     dial[4];      // last report of each dial
+   long  b14pt;                     // b14+ button trigger time
+   long  b15pt;                     // b15+ button trigger time
+   long  b14mdt;                    // b14- pedal down trigger time
+   long  b14mut;                    // b14- pedal up trigger time
+   long  b15mdt;                    // b15- pedal down trigger time
+   long  b15mut;                    // b15- pedal up trigger time
+   long  position1Count;            // number of stick 1 positions
+   long  position2Count;            // number of stick 2 positions
+   long  trigger1Count;             // number of stick 1 triggers
+   long  trigger2Count;             // number of stick 2 triggers
+};
+
+
 class RadioBaton : public MidiIO {
    public:
                   RadioBaton                (void);
@@ -83,9 +143,19 @@ class RadioBaton : public MidiIO {
 
       // general functions affecting object (No MIDI communication with drum):
       int         getBuf                   (int index);
+      int         getDialFrames            (int dial, BatonDialFrame* output,
+                                            int count);
       int         getError                 (void) const;
+      int         getPositionFrames        (int stick,
+                                            BatonPositionFrame* output,
+                                            int count);
       int         getPositionReporting     (void) const;
+      int         getPrediction            (void) const;
       int         getReportStatus          (void) const;
+      void        getState                 (BatonState& aState) const;
+      int         getTriggerFrames         (int stick,
+                                            BatonTriggerFrame* output,
+                                            int count);
       long        getWhack1Time            (void) const;
       long        getWhack2Time            (void) const;
       int         getXaxisDirection        (void) const;
@@ -98,6 +168,13 @@ class RadioBaton : public MidiIO {
       int         recordingQ               (void) const;
       void        recordStateStart         (const char* aFilename);
       void        recordStateStop          (void);
+      int         recordSessionStart       (const char* aFilename);
+      void        recordSessionStop        (void);
+      int         replayingQ               (void) const;
+      int         replaySessionStart       (const char* aFilename,
+                                            double aSpeed = 1.0);
+      void        replaySessionStop        (void);
+      void        setPrediction            (int aState = 1);
       void        setReportStatus          (int aStatus);
       void        setStateSize             (int aSize);
       void        setXaxisDirection        (int aDirection);
@@ -121,6 +198,8 @@ class RadioBaton : public MidiIO {
       void (*stick2trig)(void);
       void (*stick1position)(void);
       void (*stick2position)(void);
+      void (*stick1pretrig)(void);
+      void (*stick2pretrig)(void);
       void (*b14plustrig)(void);
       void (*b15plustrig)(void);
       void (*b14minusuptrig)(void);
@@ -143,7 +222,8 @@ class RadioBaton : public MidiIO {
       // reportings; for example, a new x-value could overwrite an old
       // x-value while the old z-value is still written.  The storage
       // buffers for the position data will always contain a complete
-      // set for a given index.
+      // set for a given index.  Other threads should use getState()
+      // to read a complete and consistent copy of these variables.
 
       long  t1p;                    // baton 1 position reporting time
       uchar x1p;                    // baton 1 x-axis position
@@ -231,40 +311,62 @@ class RadioBaton : public MidiIO {
       int d4pc(int min, int max);
 
 
-      // storage buffers for old data.  These buffers can be used as
-      // a circular buffer from which you can process data one by one
-      // without ever losing/skipping over incoming data.  Use the 
-      // buffer.extract() function to extract data, and buffer.getCount() 
-      // to see how many elements can be extracted.
-      // If you are using the storage buffers, you should set the ones 
-      // you are using to the same size if using the buffer.extract() command;
-      // otherwise after overflowing the buffers, the data sets (e.g.,
-      // baton 1 trigger values) will be out of index alignment.
-
-      CircularBuffer<long>   t1pb;   // stick1 time of position (stores t1p)
-      CircularBuffer<uchar>  x1pb;   // stick1 x-axis position (stores x1p)
-      CircularBuffer<uchar>  y1pb;   // stick1 y-axis position (stores y1p)
-      CircularBuffer<uchar>  z1pb;   // stick1 z-axis position (stores z1p)
-
-      CircularBuffer<long>   t2pb;   // stick2 time of position (stores t2p)
-      CircularBuffer<uchar>  x2pb;   // stick2 x-axis position (stores x2p)
-      CircularBuffer<uchar>  y2pb;   // stick2 y-axis position (stores y2p)
-      CircularBuffer<uchar>  z2pb;   // stick2 z-axis position (stores z2p)
-
-      CircularBuffer<uchar>  d1pb;   // dial 1 position (stores d1p)
-      CircularBuffer<uchar>  d2pb;   // dial 2 position (stores d2p)
-      CircularBuffer<uchar>  d3pb;   // dial 3 position (stores d3p)
-      CircularBuffer<uchar>  d4pb;   // dial 4 position (stores d4p)
-
-      CircularBuffer<long>   t1tb;   // trigger stick 1 time (stores t1t)
-      CircularBuffer<uchar>  x1tb;   // stick1 x-axis trigger pos. (stores x1t)
-      CircularBuffer<uchar>  y1tb;   // stick1 y-axis trigger pos. (stores y1t)
-      CircularBuffer<uchar>  w1tb;   // stick1 wack at trigger time (stores w1t)
-
-      CircularBuffer<long>   t2tb;   // trigger stick 2 time (stores t2t)
-      CircularBuffer<uchar>  x2tb;   // stick2 x-axis trigger pos. (stores x2t)
-      CircularBuffer<uchar>  y2tb;   // stick2 y-axis trigger pos. (stores y2t)
-      CircularBuffer<uchar>  w2tb;   // stick2 whack at trig time (stores w2t)
+      // storage buffers for old data.  One frame is stored for each
+      // complete position report, trigger, or dial report, so the time
+      // and the axis values of a report are always found at the same
+      // index.  These buffers can be used as a circular buffer from
+      // which you can process frames one by one without ever
+      // losing/skipping over incoming data.  Use the buffer.extract()
+      // function to extract frames, and buffer.getCount() to see how
+      // many frames can be extracted.  Use getPositionFrames(),
+      // getTriggerFrames() and getDialFrames() to copy a window of
+      // the most recent frames, or buffer.getHistorySpans() to process
+      // them in place.
+
+      CircularBuffer<BatonPositionFrame> position1Frames; // stick 1 positions
+      CircularBuffer<BatonPositionFrame> position2Frames; // stick 2 positions
+      CircularBuffer<BatonTriggerFrame>  trigger1Frames;  // stick 1 triggers
+      CircularBuffer<BatonTriggerFrame>  trigger2Frames;  // stick 2 triggers
+      CircularBuffer<BatonDialFrame>     dialFrames[4];   // dial positions
+
+      // Views of one value in the frames above, indexed in the same
+      // way as the buffers: x1pb[0] is the x-axis value of the last
+      // stick 1 position and t1pb[0] is the time of the same report.
+
+      FrameField<BatonPositionFrame, long>   t1pb;  // stick1 time of position
+      FrameField<BatonPositionFrame, uchar>  x1pb;  // stick1 x-axis position
+      FrameField<BatonPositionFrame, uchar>  y1pb;  // stick1 y-axis position
+      FrameField<BatonPositionFrame, uchar>  z1pb;  // stick1 z-axis position
+
+      FrameField<BatonPositionFrame, long>   t2pb;  // stick2 time of position
+      FrameField<BatonPositionFrame, uchar>  x2pb;  // stick2 x-axis position
+      FrameField<BatonPositionFrame, uchar>  y2pb;  // stick2 y-axis position
+      FrameField<BatonPositionFrame, uchar>  z2pb;  // stick2 z-axis position
+
+      FrameField<BatonDialFrame, uchar>      d1pb;  // dial 1 position
+      FrameField<BatonDialFrame, uchar>      d2pb;  // dial 2 position
+      FrameField<BatonDialFrame, uchar>      d3pb;  // dial 3 position
+      FrameField<BatonDialFrame, uchar>      d4pb;  // dial 4 position
+
+      FrameField<BatonTriggerFrame, long>    t1tb;  // trigger stick 1 time
+      FrameField<BatonTriggerFrame, uchar>   x1tb;  // stick1 x-axis trigger pos
+      FrameField<BatonTriggerFrame, uchar>   y1tb;  // stick1 y-axis trigger pos
+      FrameField<BatonTriggerFrame, uchar>   w1tb;  // stick1 wack at trigger
+
+      FrameField<BatonTriggerFrame, long>    t2tb;  // trigger stick 2 time
+      FrameField<BatonTriggerFrame, uchar>   x2tb;  // stick2 x-axis trigger pos
+      FrameField<BatonTriggerFrame, uchar>   y2tb;  // stick2 y-axis trigger pos
+      FrameField<BatonTriggerFrame, uchar>   w2tb;  // stick2 whack at trigger
+
+      // Trigger prediction (see setPrediction()).  When the stick is
+      // predicted to hit the trigger plane, stick1pretrig or
+      // stick2pretrig is called, and predictor1.getImpactTime() or
+      // predictor2.getImpactTime() gives the predicted time of the hit.
+
+      TriggerPredictor predictor1;  // stick 1 trigger prediction
+      TriggerPredictor predictor2;  // stick 2 trigger prediction
+
+      // button and pedal trigger times
 
       CircularBuffer<long> b14ptb;   // b14+ button trigger time buffer
       CircularBuffer<long> b15ptb;   // b15+ button trigger time buffer
@@ -309,6 +411,11 @@ class RadioBaton : public MidiIO {
       void        recordState    (long aTime, const char* aState,
                                     int value1, int value2, int value3);
 
+      // variables for recording and replaying the MIDI input:
+      BatonRecorder sessionRecorder;  // raw input to a session file
+      MidiReplay    sessionPlayer;    // session file fed in as input
+      int           replayReopenQ;    // open the input after the replay
+
 
    ///////////////////////////////////////////////////////////////////////////
    //
@@ -316,6 +423,7 @@ class RadioBaton : public MidiIO {
    // 
 
    private: 
+      void        attachFrameFields     (void);
       void        interpretCommand      (smf::MidiEvent& aMessage);
       void        s1ts                  (long aTime);
       void        s1td                  (int flag, uchar aValue);
@@ -326,12 +434,21 @@ class RadioBaton : public MidiIO {
       void        s2ps                  (long aTime);
       void        s2pd                  (int flag, uchar aValue);
 
+      int         predictionQ;          // true if predicting triggers
       int         storedReportStatus;   // variable used for next two functions
       void        pushReportingStatus   (void);
       void        popReportingStatus    (void);
 
       void        stoprunningstatus     (void);
 
+      // consistent copy of the state for other threads (a sequence lock):
+      BatonState            publishedState;  // last complete reports
+      volatile unsigned int stateSequence;   // odd while being written
+      void        beginStateUpdate      (void);
+      void        endStateUpdate        (void);
+
+      smf::MidiEvent inputEvent;        // reused for each input message
+
       int s1tf;     // stick 1 trigger flag
       int s2tf;     // stick 2 trigger flag
       int s1pf;     // stick 1 trigger flag
@@ -0,0 +1,74 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sun Oct 18 15:10:44 PDT 2026
+// Last Modified: Sun Oct 18 15:10:47 PDT 2026
+// Last Modified: Mon Oct 19 06:14:08 PDT 2026 (opt-in operator new, prepare)
+// Filename:      ...improv/include/RealtimeCheck.h
+// Web Address:   http://sig.sapp.org/include/sig/RealtimeCheck.h
+// Syntax:        C++
+//
+// Description:   Detects heap allocations in time-critical threads.
+//                Threads mark themselves as realtime with enterThread()
+//                (the MIDI input threads, and the improv event loops
+//                once initialization is finished).  When checking is
+//                turned on with setMode(), any call to operator new
+//                from a realtime thread is counted, or aborts the
+//                program so that it can be found in a debugger.
+//                Allocations with malloc() directly are not seen.
+//
+//                The library does not replace operator new.  A program
+//                which wants the check includes RealtimeNew.h in one of
+//                its source files (the improv environments do so when
+//                compiled with -DREALTIME_CHECK).
+//
+
+#ifndef _REALTIMECHECK_H_INCLUDED
+#define _REALTIMECHECK_H_INCLUDED
+
+#include "CircularBuffer.h"
+#include "MidiEvent.h"
+
+#include <stddef.h>
+
+#ifndef OLDCPP
+   #include <iostream>
+   using namespace std;
+#else
+   #include <iostream.h>
+#endif
+
+#define REALTIME_OFF     (0)    /* do not check for allocations     */
+#define REALTIME_COUNT   (1)    /* count allocations                */
+#define REALTIME_ABORT   (2)    /* abort on the first allocation    */
+
+
+class RealtimeCheck {
+   public:
+      static void      allocation         (size_t aSize);
+      static void      enterThread        (void);
+      static long      getCount           (void);
+      static int       getMode            (void);
+      static int       install            (void);
+      static int       isInstalled        (void);
+      static int       isRealtimeThread   (void);
+      static void      leaveThread        (void);
+      static void      prepare            (smf::MidiEvent& aMessage);
+      static void      prepare            (CircularBuffer<smf::MidiEvent>&
+                                                 aBuffer);
+      static void      report             (ostream& out);
+      static void      reset              (void);
+      static void      setMode            (int aMode);
+
+   protected:
+      static volatile int   mode;         // REALTIME_OFF, _COUNT or _ABORT
+      static int            installedQ;   // operator new reports here
+      static volatile long  count;        // allocations in realtime threads
+      static volatile long  largest;      // largest allocation in bytes
+      static thread_local int realtimeDepth; // > 0 in a realtime thread
+};
+
+
+#endif  /* _REALTIMECHECK_H_INCLUDED */
+
+
+
@@ -0,0 +1,74 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Mon Oct 19 06:14:08 PDT 2026
+// Last Modified: Mon Oct 19 06:14:08 PDT 2026
+// Filename:      ...improv/include/RealtimeNew.h
+// Web Address:   http://sig.sapp.org/include/sig/RealtimeNew.h
+// Syntax:        C++
+//
+// Description:   Replacement global operator new and delete which report
+//                each allocation to RealtimeCheck.  The definitions are
+//                not inline, so this file must be included in only one
+//                source file of a program.  The library never includes
+//                it, so programs which do not ask for the check keep
+//                the standard allocator.
+//
+
+#ifndef _REALTIMENEW_H_INCLUDED
+#define _REALTIMENEW_H_INCLUDED
+
+#include "RealtimeCheck.h"
+
+#include <stdlib.h>
+#include <new>
+
+
+//////////////////////////////
+//
+// operator new -- check for realtime threads before allocating.
+//
+
+void* operator new(size_t aSize) {
+   RealtimeCheck::allocation(aSize);
+   void* output = malloc(aSize > 0 ? aSize : 1);
+   if (output == NULL) {
+      throw std::bad_alloc();
+   }
+   return output;
+}
+
+
+void* operator new[](size_t aSize) {
+   RealtimeCheck::allocation(aSize);
+   void* output = malloc(aSize > 0 ? aSize : 1);
+   if (output == NULL) {
+      throw std::bad_alloc();
+   }
+   return output;
+}
+
+
+
+//////////////////////////////
+//
+// operator delete -- must match the replacement operator new.
+//
+
+void operator delete(void* aPointer) noexcept {
+   free(aPointer);
+}
+
+
+void operator delete[](void* aPointer) noexcept {
+   free(aPointer);
+}
+
+
+// tell RealtimeCheck that allocations can be seen
+static int realtimeNewInstalled = RealtimeCheck::install();
+
+
+#endif  /* _REALTIMENEW_H_INCLUDED */
+
+
+
@@ -0,0 +1,46 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Mon Oct 19 07:21:43 PDT 2026
+// Last Modified: Mon Oct 19 07:21:43 PDT 2026
+// Filename:      ...improv/include/SearchPattern.h
+// Web Address:   http://sig.sapp.org/include/sig/SearchPattern.h
+// Syntax:        C++
+//
+// Description:   A compiled regular expression (POSIX extended syntax)
+//                for searching the text of PerformData records.  The
+//                pattern is only compiled again when it changes, so an
+//                object can be kept and given the same pattern for each
+//                search.  A bad pattern is reported and matches
+//                nothing, so a typing mistake in a search does not stop
+//                a performance.
+//
+
+#ifndef _SEARCHPATTERN_H_INCLUDED
+#define _SEARCHPATTERN_H_INCLUDED
+
+#include <regex>
+#include <string>
+
+
+class SearchPattern {
+   public:
+                  SearchPattern      (void);
+                  SearchPattern      (const char* aPattern);
+                 ~SearchPattern      ();
+
+      int         isValid            (void) const;
+      int         matches            (const char* text) const;
+      int         setPattern         (const char* aPattern);
+
+   protected:
+      std::string source;            // the pattern as it was given
+      std::regex  expression;        // the compiled pattern
+      int         validQ;            // the pattern compiled
+      int         setQ;              // a pattern was given
+};
+
+
+#endif  /* _SEARCHPATTERN_H_INCLUDED */
+
+
+
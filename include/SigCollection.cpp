@@ -6,6 +6,8 @@
 // Last Modified: Wed Mar 30 14:00:16 PST 2005 Fixed for compiling in GCC 3.4
 // Last Modified: Fri Jun 12 22:58:34 PDT 2009 renamed SigCollection class
 // Last Modified: Fri Aug 10 09:17:03 PDT 2012 added reverse()
+// Last Modified: Sun Oct 18 16:02:11 PDT 2026 geometric growth, reserve()
+// Last Modified: Mon Oct 19 08:15:02 PDT 2026 no exit at maximum size
 // Filename:      ...sig/maint/code/base/SigCollection/SigCollection.cpp
 // Web Address:   http://sig.sapp.org/src/sigBase/SigCollection.cpp
 // Syntax:        C++ 
@@ -15,6 +17,14 @@
 //                derived Array class is specifically for collections
 //                of numbers.
 //
+//                When the array has to grow, the allocation size is
+//                multiplied by the growth factor (2.0 by default), or
+//                increased by the growth amount if that is larger, so
+//                that appending n elements takes O(n) time.  A growth
+//                factor of 1.0 gives the old linear growth.  Elements
+//                are moved into the new storage (or copied with memcpy
+//                if they are trivially copyable) rather than copied.
+//
 
 #ifndef _SIGCOLLECTION_CPP_INCLUDED
 #define _SIGCOLLECTION_CPP_INCLUDED
@@ -22,6 +32,9 @@
 #include "SigCollection.h"
 #include <iostream>
 #include <stdlib.h>
+#include <string.h>
+#include <type_traits>
+#include <utility>
 
 
 using namespace std;
@@ -38,6 +51,7 @@ SigCollection<type>::SigCollection(void) {
    this->array = NULL;
    this->allowGrowthQ = 0;
    this->growthAmount = 8;
+   this->growthFactor = 2.0;
    this->maxSize = 0;
 }
 
@@ -49,6 +63,7 @@ SigCollection<type>::SigCollection(int arraySize) {
    this->allocSize = arraySize;
    this->allowGrowthQ = 0;
    this->growthAmount = arraySize;
+   this->growthFactor = 2.0;
    this->maxSize = 0;
 }
 
@@ -62,6 +77,7 @@ SigCollection<type>::SigCollection(int arraySize, type *aSigCollection) {
       this->array[i] = aSigCollection[i];
    }
    this->growthAmount = arraySize;
+   this->growthFactor = 2.0;
    this->allowGrowthQ = 0;
    this->maxSize = 0;
 }
@@ -77,10 +93,27 @@ SigCollection<type>::SigCollection(SigCollection<type>& aSigCollection) {
    }
    this->allowGrowthQ = aSigCollection.allowGrowthQ;
    this->growthAmount = aSigCollection.growthAmount;
+   this->growthFactor = aSigCollection.growthFactor;
    this->maxSize = aSigCollection.maxSize;
 }
 
 
+template<class type>
+SigCollection<type>::SigCollection(SigCollection<type>&& aSigCollection) {
+   this->size = aSigCollection.size;
+   this->allocSize = aSigCollection.allocSize;
+   this->array = aSigCollection.array;
+   this->allowGrowthQ = aSigCollection.allowGrowthQ;
+   this->growthAmount = aSigCollection.growthAmount;
+   this->growthFactor = aSigCollection.growthFactor;
+   this->maxSize = aSigCollection.maxSize;
+
+   aSigCollection.size = 0;
+   aSigCollection.allocSize = 0;
+   aSigCollection.array = NULL;
+}
+
+
 
 //////////////////////////////
 //
@@ -89,9 +122,7 @@ SigCollection<type>::SigCollection(SigCollection<type>& aSigCollection) {
 
 template<class type>
 SigCollection<type>::~SigCollection() {
-   if (this->getAllocSize() != 0) {
-      delete [] this->array;
-   }
+   delete [] this->array;
 }
 
 
@@ -115,59 +146,77 @@ void SigCollection<type>::allowGrowth(int status) {
 
 //////////////////////////////
 //
-// SigCollection::append --
+// SigCollection::append -- add an element to the end of the array.
+//    Returns 0 if the array has reached its maximum size, in which
+//    case the element is not stored.
 //
 
 template<class type>
-void SigCollection<type>::append(type& element) {
-   if (this->size == this->getAllocSize()) {
-      this->grow();
+int SigCollection<type>::append(type& element) {
+   if (this->size == this->getAllocSize() && !this->grow()) {
+      return 0;
    }
    this->array[size] = element;
    this->size++;
+   return 1;
 }
 
 template<class type>
-void SigCollection<type>::appendcopy(type element) {
-   if (this->size == this->getAllocSize()) {
-      this->grow();
+int SigCollection<type>::appendcopy(type element) {
+   if (this->size == this->getAllocSize() && !this->grow()) {
+      return 0;
    }
-   this->array[size] = element;
+   this->array[size] = std::move(element);
    this->size++;
+   return 1;
 }
 
 template<class type>
-void SigCollection<type>::append(type *element) {
-   if (this->size == this->getAllocSize()) {
-      this->grow();
+int SigCollection<type>::append(type *element) {
+   if (this->size == this->getAllocSize() && !this->grow()) {
+      return 0;
    }
    this->array[size] = *element;
    this->size++;
+   return 1;
 }
 
 
 
 //////////////////////////////
 //
-// SigCollection::grow --
+// SigCollection::grow -- increase the allocation size by growamt
+//    elements.  If growamt is not given, the allocation size is
+//    multiplied by the growth factor, or increased by the growth
+//    amount if that is larger.  The allocation is limited to the
+//    maximum size (if set).  Returns 0 if the array could not grow.
 // 	default parameter: growamt = -1
 //
 
 template<class type>
-void SigCollection<type>::grow(long growamt) {
+int SigCollection<type>::grow(long growamt) {
+   long newAllocSize;
+   if (growamt > 0) {
+      newAllocSize = this->allocSize + growamt;
+   } else {
+      newAllocSize = (long)(this->allocSize * this->growthFactor);
+      if (newAllocSize < this->allocSize + this->growthAmount) {
+         newAllocSize = this->allocSize + this->growthAmount;
+      }
+      if (newAllocSize <= this->allocSize) {
+         newAllocSize = this->allocSize + 1;
+      }
+   }
 
-   this->allocSize += growamt > 0 ? growamt : this->growthAmount;
-   if (this->maxSize != 0 && this->getAllocSize() > this->maxSize) {
-      std::cerr << "Error: Maximum size allowed for array exceeded." << std::endl;
-      exit(1);
+   if (this->maxSize > 0 && newAllocSize > this->maxSize) {
+      newAllocSize = this->maxSize;
    }
- 
-   type *temp = new type[this->getAllocSize()];
-   for (int i=0; i<size; i++) {
-      temp[i] = this->array[i];
+   if (newAllocSize <= this->allocSize) {
+      return 0;
    }
-   delete [] this->array;
-   this->array = temp;
+
+   this->relocate(newAllocSize);
+   return 1;
 }
 
 
@@ -233,6 +282,23 @@ type& SigCollection<type>::last(int index) {
 
 
 
+//////////////////////////////
+//
+// SigCollection::reserve -- make sure that the array can hold at least
+//    aSize elements without reallocating.  The size of the array is not
+//    changed.  Returns 0 if aSize is larger than the maximum size.
+//
+
+template<class type>
+int SigCollection<type>::reserve(long aSize) {
+   if (aSize > this->getAllocSize()) {
+      this->grow(aSize - this->getAllocSize());
+   }
+   return this->getAllocSize() >= aSize;
+}
+
+
+
 //////////////////////////////
 //
 // SigCollection::setAllocSize --
@@ -250,7 +316,7 @@ void SigCollection<type>::setAllocSize(long aSize) {
       this->shrinkTo(aSize);
    } else {
       this->grow(aSize-this->getAllocSize());
-      this->size = aSize;
+      this->size = this->getAllocSize();
    }
 }
 
@@ -271,6 +337,36 @@ void SigCollection<type>::setGrowth(long growth) {
 
 
 
+//////////////////////////////
+//
+// SigCollection::setGrowthFactor -- set the multiplier for the
+//    allocation size when the array grows.  Factors less than 1.0 are
+//    ignored; 1.0 grows only by the growth amount each time.
+//
+
+template<class type>
+void SigCollection<type>::setGrowthFactor(double factor) {
+   if (factor >= 1.0) {
+      this->growthFactor = factor;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// SigCollection::setMaxSize -- limit the number of elements which the
+//    array can grow to.  When the limit is reached, append() returns 0
+//    instead of storing the element.  A size of 0 removes the limit.
+//
+
+template<class type>
+void SigCollection<type>::setMaxSize(long aSize) {
+   this->maxSize = aSize > 0 ? aSize : 0;
+}
+
+
+
 //////////////////////////////
 //
 // SigCollection::setSize --
@@ -281,13 +377,36 @@ void SigCollection<type>::setSize(long newSize) {
    if (newSize <= this->getAllocSize()) { 
       this->size = newSize;
    } else {
-      this->grow(newSize-this->getAllocSize());
+      long newAllocSize = (long)(this->getAllocSize() * this->growthFactor);
+      if (newAllocSize < newSize) {
+         newAllocSize = newSize;
+      }
+      // grow() limits the allocation to the maximum size
+      this->grow(newAllocSize - this->getAllocSize());
+      if (newSize > this->getAllocSize()) {
+         newSize = this->getAllocSize();
+      }
       this->size = newSize;
    }
 }
 
 
 
+//////////////////////////////
+//
+// SigCollection::shrinkToFit -- reduce the allocation size to the
+//    current size of the array.
+//
+
+template<class type>
+void SigCollection<type>::shrinkToFit(void) {
+   if (this->getAllocSize() > this->getSize()) {
+      this->shrinkTo(this->getSize());
+   }
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 // SigCollection operators
@@ -295,16 +414,23 @@ void SigCollection<type>::setSize(long newSize) {
 
 //////////////////////////////
 //
-// SigCollection::operator[] --
+// SigCollection::operator[] -- if growth is allowed, the element
+//    just past the end adds a new element.  When the array is at its
+//    maximum size, the element is not added (as with append()), and
+//    a scratch element which is not part of the array is returned.
 //
 
 template<class type>
 type& SigCollection<type>::operator[](int elementIndex) {
    if (this->allowGrowthQ && elementIndex == this->size) {
-      if (this->size == this->getAllocSize()) {
-         this->grow();
+      if (this->size < this->getAllocSize() || this->grow()) {
+         this->size++;
+      } else {
+         static type overflow;
+         std::cerr << "Error: array is at its maximum size of "
+                   << this->size << std::endl;
+         return overflow;
       }
-      this->size++;
    } else if ((elementIndex >= this->size) || (elementIndex < 0)) {
       std::cerr << "Error: accessing invalid array location " 
            << elementIndex 
@@ -344,16 +470,63 @@ void SigCollection<type>::shrinkTo(long aSize) {
       exit(1);
    }
 
-   type *temp = new type[aSize];
-   for (int i=0; i<this->size; i++) {
-      temp[i] = this->array[i];
+   this->relocate(aSize);
+}
+
+
+
+//////////////////////////////
+//
+// SigCollection::relocate -- move the contents of the array into newly
+//    allocated storage.  Trivially copyable elements are copied with
+//    memcpy; other elements are moved so that elements which own
+//    memory themselves (such as Arrays) are not copied.
+//
+
+template<class type>
+void SigCollection<type>::relocate(long newAllocSize) {
+   type *temp = newAllocSize > 0 ? new type[newAllocSize] : NULL;
+   long count = this->size < newAllocSize ? this->size : newAllocSize;
+   if (count > 0) {
+      if (std::is_trivially_copyable<type>::value) {
+         memcpy((void*)temp, (const void*)this->array, count * sizeof(type));
+      } else {
+         moveElements(temp, this->array, count,
+               typename std::is_move_assignable<type>::type());
+      }
    }
    delete [] this->array;
    this->array = temp;
 
-   allocSize = aSize;
-   if (size > allocSize) {
-      size = allocSize;
+   this->allocSize = newAllocSize;
+   if (this->size > this->allocSize) {
+      this->size = this->allocSize;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// SigCollection::moveElements -- move elements into new storage, or
+//    copy them if the element type cannot be moved (such as a class
+//    with an operator= which takes a non-const reference).
+//
+
+template<class type>
+void SigCollection<type>::moveElements(type* target, type* source,
+      long count, std::true_type) {
+   for (long i=0; i<count; i++) {
+      target[i] = std::move(source[i]);
+   }
+}
+
+
+template<class type>
+void SigCollection<type>::moveElements(type* target, type* source,
+      long count, std::false_type) {
+   for (long i=0; i<count; i++) {
+      target[i] = source[i];
    }
 }
 
@@ -410,6 +583,25 @@ void SigCollection<type>::reverse(void) {
 }
 
 
+
+//////////////////////////////
+//
+// SigCollection::swap -- exchange the contents and settings of two
+//     arrays without copying any elements.
+//
+
+template<class type>
+void SigCollection<type>::swap(SigCollection<type>& aCollection) {
+   std::swap(this->size, aCollection.size);
+   std::swap(this->allocSize, aCollection.allocSize);
+   std::swap(this->array, aCollection.array);
+   std::swap(this->allowGrowthQ, aCollection.allowGrowthQ);
+   std::swap(this->growthAmount, aCollection.growthAmount);
+   std::swap(this->growthFactor, aCollection.growthFactor);
+   std::swap(this->maxSize, aCollection.maxSize);
+}
+
+
 #endif  /* _SIGCOLLECTION_CPP_INCLUDED */
 
 
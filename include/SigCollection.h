@@ -6,6 +6,7 @@
 // Last Modified: Wed Sep  8 17:18:15 PDT 2010 added getGrowth()
 // Last Modified: Fri Aug 10 09:17:03 PDT 2012 added reverse()
 // Last Modified: Wed Dec 12 14:56:58 PST 2012 added decrease()
+// Last Modified: Sun Oct 18 16:02:11 PDT 2026 geometric growth, reserve()
 // Filename:      ...sig/maint/code/base/SigCollection/SigCollection.h
 // Web Address:   http://sig.sapp.org/include/sigBase/SigCollection.h
 // Documentation: http://sig.sapp.org/doc/classes/SigCollection
@@ -20,6 +21,8 @@
 #ifndef _SIGCOLLECTION_H_INCLUDED
 #define _SIGCOLLECTION_H_INCLUDED
 
+#include <type_traits>
+
 // Name change to avoid namespace collision with an Apple typedef
 //#define SigCollection Collection
 
@@ -30,12 +33,13 @@ class SigCollection {
                 SigCollection     (int arraySize);
                 SigCollection     (int arraySize, type *aCollection);
                 SigCollection     (SigCollection<type>& aCollection);
+                SigCollection     (SigCollection<type>&& aCollection);
                ~SigCollection     ();
 
       void      allowGrowth       (int status = 1);
-      void      append            (type& element);
-      void      appendcopy        (type element);
-      void      append            (type* element);
+      int       append            (type& element);
+      int       appendcopy        (type element);
+      int       append            (type* element);
       type     *getBase           (void) const;
       long      getAllocSize      (void) const;
       long      getSize           (void) const;
@@ -43,14 +47,21 @@ class SigCollection {
       void      setAllocSize      (long aSize);
       void      setGrowth         (long growth);
       long      getGrowth         (void) { return growthAmount; }
+      void      setGrowthFactor   (double factor);
+      double    getGrowthFactor   (void) const { return growthFactor; }
+      void      setMaxSize        (long aSize);
+      long      getMaxSize        (void) const { return maxSize; }
+      int       reserve           (long aSize);
+      void      shrinkToFit       (void);
       void      setSize           (long newSize);
       type&     operator[]        (int arrayIndex);
       type      operator[]        (int arrayIndex) const;
-      void      grow              (long growamt = -1);
+      int       grow              (long growamt = -1);
       type&     last              (int index = 0);
       int       increase          (int addcount = 1);
       int       decrease          (int subcount = 1);
       void      reverse           (void);
+      void      swap              (SigCollection<type>& aCollection);
 
 
    protected:
@@ -60,10 +71,17 @@ class SigCollection {
       char      allowGrowthQ;     // allow/disallow growth
       long      growthAmount;     // number of elements to grow by if index
 				  //    element one beyond max size is accessed
+      double    growthFactor;     // multiplier for the allocation size when
+                                  //    growing, if larger than growthAmount
       long maxSize;               // the largest size the array is allowed 
                                   //    to grow to, if 0, then ignore max
   
       void      shrinkTo          (long aSize);
+      void      relocate          (long newAllocSize);
+      static void moveElements    (type* target, type* source, long count,
+                                   std::true_type);
+      static void moveElements    (type* target, type* source, long count,
+                                   std::false_type);
 };
 
 
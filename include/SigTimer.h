@@ -11,6 +11,7 @@
 // Last Modified: Sun Nov 28 12:39:39 PST 1999 (added adjustPeriod())
 // Last Modified: Sun Nov 20 02:03:24 PST 2005 (changed to int64bit cpu speed)
 // Last Modified: Tue Jun  9 13:43:51 PDT 2009 (added Apple OSX interface)
+// Last Modified: Mon Oct 19 03:35:12 PDT 2026 (added setClockSource())
 // Filename:      .../sig/code/control/SigTimer/SigTimer.h
 // Web Address:   http://www-ccrma.stanford.edu/~craig/improv/include/SigTimer.h
 // Syntax:        C++ 
@@ -43,8 +44,12 @@
    #endif
 #endif
 
+typedef int64bits (*SigClockSource)(void);
+
 
 class SigTimer {
+   friend class VirtualClock;
+
    public:
                        SigTimer           (void);
                        SigTimer           (int aSpeed);
@@ -86,9 +91,15 @@ class SigTimer {
       // class, but everything else is based on it.
       static int64bits clockCycles        (void);
 
+      // Replace the hardware clock with another source of clock cycles,
+      // such as the VirtualClock.  NULL restores the hardware clock.
+      static SigClockSource getClockSource (void);
+      static void      setClockSource     (SigClockSource aSource);
+
    protected:
       static int64bits globalOffset;
       static int64bits cpuSpeed;         
+      static SigClockSource clockSource;
 
       int64bits        offset;          
       int              ticksPerSecond;    
@@ -0,0 +1,46 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Mon Oct 19 02:20:31 PDT 2026
+// Last Modified: Mon Oct 19 02:20:35 PDT 2026
+// Filename:      ...improv/include/StreamClock.h
+// Web Address:   http://sig.sapp.org/include/sig/StreamClock.h
+// Syntax:        C++
+//
+// Description:   Reconstructs the times at which a device sent frames
+//                of data at a steady rate from the jittered times at
+//                which the frames arrived.  A frame can arrive late but
+//                never early, so the clock follows the earliest arrivals
+//                and slowly adjusts its period to the clock drift
+//                between the device and the computer.  Times are in
+//                milliseconds.
+//
+
+#ifndef _STREAMCLOCK_H_INCLUDED
+#define _STREAMCLOCK_H_INCLUDED
+
+
+class StreamClock {
+   public:
+                  StreamClock        (void);
+                  StreamClock        (double aPeriod);
+                 ~StreamClock        ();
+
+      double      getPeriod          (void) const;
+      long        getResyncCount     (void) const;
+      void        reset              (void);
+      void        setPeriod          (double aPeriod);
+      double      stamp              (long arrivalTime);
+
+   protected:
+      double      nominalPeriod;     // expected time between frames
+      double      period;            // measured time between frames
+      double      lastTime;          // reconstructed time of last frame
+      int         runningQ;          // true after the first frame
+      long        resyncCount;       // times the stream was restarted
+};
+
+
+#endif  /* _STREAMCLOCK_H_INCLUDED */
+
+
+
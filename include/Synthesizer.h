@@ -2,6 +2,10 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: 5 January 1998
 // Last Modified: Sun Jan 25 18:39:32 GMT-0800 1998
+// Last Modified: Sun Oct 18 15:31:08 PDT 2026 (preallocate for realtime use)
+// Last Modified: Sun Oct 18 17:32:20 PDT 2026 (flat controller table)
+// Last Modified: Sun Oct 18 18:20:41 PDT 2026 (added note state)
+// Last Modified: Mon Oct 19 06:14:08 PDT 2026 (per-object input event)
 // Filename:      ...sig/code/control/Synthesizer/Synthesizer.h
 // Web Address:   http://www-ccrma.stanford.edu/~craig/improv/include/Synthesizer.h
 // Syntax:        C++
@@ -10,14 +14,33 @@
 //	  	  especially the input, the MidiOutput class is
 //		  sufficient for synthesizer output alone.
 //
+//                The current value of every controller on every channel
+//                is kept in one table, along with a bit for each
+//                controller which is set when the controller changes,
+//                so that programs can visit only the controllers which
+//                changed since the last time they looked.  Older values
+//                are kept in a single log shared by all controllers.
+//                The keys which are held down (and notes held by the
+//                sustain pedal) are tracked in a NoteState object which
+//                is available from getNoteState().
 //
 
 #ifndef _SYNTHESIZER_H_INCLUDED
 #define _SYNTHESIZER_H_INCLUDED
 
 #include "MidiIO.h"
+#include "NoteState.h"
 
-#define DEFAULT_CONT_SIZE (10)
+#include <stdint.h>
+
+#define DEFAULT_CONT_HISTORY (256)   /* controller changes kept in the log */
+
+// an entry in the controller history log:
+typedef struct {
+   uchar channel;
+   uchar number;
+   uchar value;
+} ControllerChange;
 
 
 class Synthesizer : public MidiIO {
@@ -28,19 +51,37 @@ class Synthesizer : public MidiIO {
 
       int            controller               (int controlNumber, int channel = 0, 
                                                int index = 0);
+      int            controller14             (int controlNumber, 
+                                               int channel = 0) const;
+      int            controllerChangedQ       (int controlNumber,
+                                               int channel = 0) const;
+      void           clearChangedControllers  (void);
+      int            extractChangedController (int& controlNumber, 
+                                               int& channel);
       smf::MidiEvent  extractNote              (void);
+      int             getControllerHistory     (void) const;
       int             getNoteCount             (void) const;        
+      NoteState&      getNoteState             (void);
       smf::MidiEvent& operator[]               (int index);
       void            processIncomingMessages  (void);
+      void            setControllerHistory     (int aSize);
       void            zeroControllers          (void);
 
    protected:
 
       // state variables
       CircularBuffer<smf::MidiEvent> note;
-      CircularBuffer<uchar> Controller[16][128];   // [channel][controller]
+      NoteState     noteState;               // held and sounding notes
+      uchar         controllers[16][128];    // current value [channel][cont]
+      uint32_t      changedBits[16][4];      // changed flags [channel][cont/32]
+      int           changedChannels;         // bit for each changed channel
+      uint32_t      lsbValid[16];            // LSB newer than MSB [channel]
+      CircularBuffer<ControllerChange> history;  // older controller values
+      smf::MidiEvent inputEvent;             // reused for each input message
    
       void        interpretMessage          (smf::MidiEvent& aMessage);
+      void        storeController           (int channel, int controlNumber,
+                                             int value);
 
 };
 
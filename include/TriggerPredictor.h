@@ -0,0 +1,72 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Mon Oct 19 00:48:15 PDT 2026
+// Last Modified: Mon Oct 19 00:48:19 PDT 2026
+// Filename:      ...improv/include/TriggerPredictor.h
+// Web Address:   http://sig.sapp.org/include/sig/TriggerPredictor.h
+// Syntax:        C++
+//
+// Description:   Predicts when a baton stick will hit the trigger
+//                plane from its recent heights, so that a sound can
+//                be started before the trigger message arrives from
+//                the baton.  A parabola is fitted to the last few
+//                heights to estimate the velocity and acceleration of
+//                the stick, and a pre-trigger is reported once for
+//                each stroke when the predicted impact is close enough
+//                and the fit is good enough.  Heights increase towards
+//                the trigger plane, as in the position reports of the
+//                Radio Baton.  Times are in milliseconds.
+//
+
+#ifndef _TRIGGERPREDICTOR_H_INCLUDED
+#define _TRIGGERPREDICTOR_H_INCLUDED
+
+#define PREDICTOR_MAX_WINDOW (16)  /* most positions used for a prediction */
+
+
+class TriggerPredictor {
+   public:
+                  TriggerPredictor   (void);
+                 ~TriggerPredictor   ();
+
+      double      getAcceleration    (void) const;
+      double      getConfidence      (void) const;
+      double      getImpactTime      (void) const;
+      double      getImpactVelocity  (void) const;
+      double      getVelocity        (void) const;
+      int         position           (long aTime, int height);
+      void        reset              (void);
+      void        setConfidence      (double minimum);
+      void        setLeadTime        (double milliseconds);
+      void        setMinVelocity     (double unitsPerSecond);
+      void        setRearmDistance   (double distance);
+      void        setTriggerLevel    (double level);
+      void        setWindow          (int count);
+      void        trigger            (void);
+
+   protected:
+      double      times[PREDICTOR_MAX_WINDOW];   // recent position times
+      double      heights[PREDICTOR_MAX_WINDOW]; // recent stick heights
+      int         count;             // number of stored positions
+      int         next;              // storage index of the next position
+      int         window;            // positions used in a prediction
+      double      level;             // height of the trigger plane
+      double      leadTime;          // earliest pre-trigger before impact
+      double      minVelocity;       // slowest approach which can trigger
+      double      minConfidence;     // worst fit which can trigger
+      double      rearmDistance;     // distance below plane to rearm
+      double      velocity;          // estimated velocity (units/ms)
+      double      acceleration;      // estimated acceleration (units/ms^2)
+      double      confidence;        // fraction of variation fitted
+      double      impactTime;        // predicted time of the last impact
+      double      impactVelocity;    // predicted velocity at the impact
+      int         armedQ;            // can pre-trigger on this stroke
+
+      int         estimate           (double& height);
+};
+
+
+#endif  /* _TRIGGERPREDICTOR_H_INCLUDED */
+
+
+
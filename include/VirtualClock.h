@@ -0,0 +1,48 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Mon Oct 19 03:35:12 PDT 2026
+// Last Modified: Mon Oct 19 03:35:16 PDT 2026
+// Filename:      ...improv/include/VirtualClock.h
+// Web Address:   http://sig.sapp.org/include/sig/VirtualClock.h
+// Syntax:        C++
+//
+// Description:   A manual clock for all SigTimers in the program.  When
+//                the virtual clock is active, time only moves forward
+//                when advance() is called, so a test program or the
+//                Idler can run an event loop faster than real time,
+//                and the times seen by the program are the same on
+//                every run.  The virtual time starts at a fixed time
+//                after the first SigTimer was created, or at the
+//                current real time if that is later, so that running
+//                timers do not jump backwards.
+//
+
+#ifndef _VIRTUALCLOCK_H_INCLUDED
+#define _VIRTUALCLOCK_H_INCLUDED
+
+#include "SigTimer.h"
+
+
+class VirtualClock {
+   public:
+      static void      activate           (double startTime = 0.0);
+      static void      advance            (double milliseconds);
+      static void      advanceTo          (double milliseconds);
+      static void      deactivate         (void);
+      static double    getTime            (void);
+      static int       isActive           (void);
+
+   protected:
+      static int64bits cycles             (void);
+
+      static volatile int64bits current;  // the current clock cycle count
+      static int64bits startCycles;       // clock cycles at activation
+      static double    cyclesPerMs;       // clock cycles in a millisecond
+      static double    elapsed;           // milliseconds since activation
+};
+
+
+#endif  /* _VIRTUALCLOCK_H_INCLUDED */
+
+
+
@@ -6,6 +6,14 @@
 // Last Modified: Sat Jul 17 22:50:37 PDT 1999 (changed readmidiconfig)
 // Last Modified: Wed Apr 19 17:09:34 PDT 2000 (added axis flipping)
 // Last Modified: Sun Oct  1 14:48:09 PDT 2000 (updated to RB firmware "AE")
+// Last Modified: Sun Oct 18 13:40:02 PDT 2026 (added main loop statistics)
+// Last Modified: Sun Oct 18 14:52:06 PDT 2026 (added --event-loop option)
+// Last Modified: Sun Oct 18 15:40:12 PDT 2026 (added --realtime option)
+// Last Modified: Mon Oct 19 01:42:18 PDT 2026 (added session record/replay)
+// Last Modified: Mon Oct 19 05:02:36 PDT 2026 (added MIDI port statistics)
+// Last Modified: Mon Oct 19 06:14:08 PDT 2026 (operator new is opt-in)
+// Last Modified: Mon Oct 19 08:37:05 PDT 2026 (added MIDI flight recorder)
+// Last Modified: Mon Oct 19 08:43:22 PDT 2026 (no --tick by default)
 // Filename:      ...sig/code/control/improv/batonImprov.h
 // Web Address:   http://sig.sapp.org/include/sig/batonImprov.h
 // Syntax:        C++
@@ -27,6 +35,10 @@
 
 #include "improv.h"
 
+#ifdef REALTIME_CHECK
+   #include "RealtimeNew.h"   // for the --realtime options
+#endif
+
 #include <stdlib.h>
 #include <string.h>
 
@@ -101,6 +113,8 @@ long        t_time = 0;     // global time (in milliseconds) which remains
 SigTimer      mainTimer;         // Timer counting in milliseconds
 KeyboardInput interfaceKeyboard; // for computer keyboard interface
 Idler         eventIdler(1.0);   // to control CPU usage for multiprocessing
+LoopStats     loopStats;         // timing statistics for the event loop
+EventLoop     eventLoop;         // waits for input instead of idling
 Options       options;           // for handling command-line options
 
 // global variables which the users shouldn't be messing with:
@@ -174,15 +188,24 @@ int runImprovInterface(void) {
    print_commands();   
    initialization();                     // user defined behavior
 
+   loopStats.reset();
+   RealtimeCheck::enterThread();      // no allocation in the event loop
    while (1) {
+      loopStats.begin();
+      loopStats.sampleQueue(baton.getCount());
       baton.processIncomingMessages();
       t_time = mainTimer.getTime(); 
+      loopStats.mark(LOOP_PHASE_INPUT);
 
       mainloopalgorithms();               // user defined behavior
+      loopStats.mark(LOOP_PHASE_ALGORITHM);
 
-      if (keyboardTimer.expired()) {
+      if (eventLoop.isActive() ? (eventLoop.getReady() & EVENTLOOP_KEYBOARD)
+                               : keyboardTimer.expired()) {
          keyboardTimer.reset();
+         RealtimeCheck::leaveThread();   // commands may allocate memory
          command = checkKeyboard();
+         RealtimeCheck::enterThread();
          switch (command) {
             case 'Q': 
                goto endmainwhile;
@@ -228,15 +251,22 @@ int runImprovInterface(void) {
             }
          }
       } // end of if keyboardTimer.expired
+      loopStats.mark(LOOP_PHASE_KEYBOARD);
  
       #ifndef VISUAL
-         eventIdler.sleep();
+         if (eventLoop.isActive()) {
+            eventLoop.wait();
+         } else {
+            eventIdler.sleep();
+         }
       #endif
+      loopStats.mark(LOOP_PHASE_IDLE);
 
    } // end of while (1);
 
 endmainwhile:
 
+   RealtimeCheck::leaveThread();
    finishup();                            // user defined behavior
    finishup_automatic();
 
@@ -388,12 +418,24 @@ int checkKeyboard(void) {
             }
          }
          break;
-   // case 'L': break;
+      case 'L':                         // print main loop statistics
+         loopStats.print(cout);
+         break;
       case 'M':                         // display more commands
          // this command displays less important commands
          print_aux_commands();
          break;
-   // case 'N': break;
+      case 'N':                         // print MIDI port statistics
+         {
+            MidiPortStats stats;
+            baton.getStats(stats, 1);
+            cout << "Radio baton:" << endl;
+            MidiStats::print(cout, stats);
+            synth.getStats(stats, 1);
+            cout << "Synthesizer:" << endl;
+            MidiStats::print(cout, stats, MIDI_STATS_OUTPUT);
+         }
+         break;
       case 'O':                         // set MIDI out device for radio drum
          cout << "radio drum MIDI output is currently set to device: "
               << baton.getOutputPort() << endl;
@@ -704,6 +746,10 @@ void echoKeysOn(void) {
 
 void finishup_automatic(void) {
    cout << endl;
+   loopStats.dump();
+   RealtimeCheck::report(cout);
+   baton.recordSessionStop();
+   FlightRecorder::stop();
    baton.positionReportingOff();
 }
 
@@ -734,6 +780,19 @@ void initialization_automatic(void) {
    options.define("help=b");         // display usage synopsis
    options.define("ports=b");        // display MIDI I/O ports
    options.define("description=b");  // display the description message
+   options.define("loop-stats=s");   // file for periodic loop statistics
+   options.define("loop-stats-period=d:10.0"); // seconds between statistics
+   options.define("no-loop-stats=b"); // turn off loop statistics
+   options.define("event-loop=b");    // wait for events instead of sleeping
+   options.define("tick=d:0.0");      // ms between polls with --event-loop
+   options.define("realtime=b");      // count allocations in the event loop
+   options.define("realtime-abort=b"); // abort on allocation in event loop
+   options.define("record-session=s"); // file for raw baton input session
+   options.define("replay=s");         // session file to replay as input
+   options.define("replay-speed=d:1.0"); // replay speed (0 = all at once)
+   options.define("flight-recorder=s"); // MIDI ring file ($HOME/.improv.flight)
+   options.define("flight-size=i:1048576"); // messages in flight recorder
+   options.define("no-flight-recorder=b"); // turn off the flight recorder
    options.process(1);               // process options but don't
  				     // complain about undefined options (0)
 
@@ -764,6 +823,13 @@ void initialization_automatic(void) {
       exit(0);
    }
 
+   // keep the recent MIDI traffic in a file which survives a crash
+   // (print it with the flightdump program)
+   if (!options.getBoolean("no-flight-recorder")) {
+      FlightRecorder::start(options.getString("flight-recorder").c_str(),
+            options.getInteger("flight-size"));
+   }
+
    // choose the MIDI in and out ports
    if (readmidiconfig() == 0) {   
       baton.pause();
@@ -794,6 +860,42 @@ void initialization_automatic(void) {
    // set the idling rate for the event loop to 1 millisecond
    eventIdler.setSoftSleep(1.0);
 
+   // main loop timing statistics
+   if (options.getBoolean("no-loop-stats")) {
+      loopStats.disable();
+   } else if (options.getBoolean("loop-stats")) {
+      loopStats.setDumpFile(options.getString("loop-stats").c_str(),
+            options.getDouble("loop-stats-period"));
+   }
+   loopStats.setOverrunTime(eventIdler.getPeriod());
+
+   // wait for keys, MIDI input and EventBuffer deadlines rather than
+   // sleeping for a fixed time between each pass of the event loop.
+   // Programs which poll timers in mainloopalgorithms() should also be
+   // given a --tick period, since there is no tick by default.
+   if (options.getBoolean("event-loop")) {
+      eventLoop.setTick(options.getDouble("tick"));
+      eventLoop.activate();
+   }
+
+   // check for heap allocations in the event loop and MIDI input threads
+   if (options.getBoolean("realtime-abort")) {
+      RealtimeCheck::setMode(REALTIME_ABORT);
+   } else if (options.getBoolean("realtime")) {
+      RealtimeCheck::setMode(REALTIME_COUNT);
+   }
+
+   // record the raw baton input, or replay a recorded session as input
+   if (options.getBoolean("record-session")) {
+      baton.recordSessionStart(options.getString("record-session").c_str());
+   }
+   if (options.getBoolean("replay")) {
+      if (!baton.replaySessionStart(options.getString("replay").c_str(),
+            options.getDouble("replay-speed"))) {
+         exit(1);
+      }
+   }
+
 }
 
 
@@ -831,6 +933,8 @@ void print_aux_commands(void) {
    psl("   G = chanGe CPU speed setting        B = buffer display toggle");
    psl("   shift-7 = flip X-axis               shift-8 = flip Y-axis");
    psl("   shift-9 = flip Z-axis               A = baton version check");
+   psl("   L = print main loop timing statistics");
+   psl("   N = print MIDI port statistics since the last N");
    printboxbottom();
 }
 
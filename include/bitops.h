@@ -0,0 +1,83 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Mon Oct 19 07:58:40 PDT 2026
+// Last Modified: Mon Oct 19 07:58:44 PDT 2026
+// Filename:      ...improv/include/bitops.h
+// Syntax:        C++
+//
+// Description:   Inline functions for finding the set bits in a 32-bit
+//                word, used by the bitmaps of NoteState and
+//                Synthesizer.  GCC builtins are used when available.
+//
+
+#ifndef _BITOPS_H_INCLUDED
+#define _BITOPS_H_INCLUDED
+
+#include <stdint.h>
+
+
+//////////////////////////////
+//
+// lowestBit -- returns the position of the lowest set bit, which
+//    must exist.
+//
+
+inline int lowestBit(uint32_t bits) {
+#ifdef __GNUC__
+   return __builtin_ctz(bits);
+#else
+   int output = 0;
+   while ((bits & 1) == 0) {
+      bits >>= 1;
+      output++;
+   }
+   return output;
+#endif
+}
+
+
+
+//////////////////////////////
+//
+// highestBit -- returns the position of the highest set bit, which
+//    must exist.
+//
+
+inline int highestBit(uint32_t bits) {
+#ifdef __GNUC__
+   return 31 - __builtin_clz(bits);
+#else
+   int output = 31;
+   while ((bits & 0x80000000u) == 0) {
+      bits <<= 1;
+      output--;
+   }
+   return output;
+#endif
+}
+
+
+
+//////////////////////////////
+//
+// countBits -- returns the number of set bits.
+//
+
+inline int countBits(uint32_t bits) {
+#ifdef __GNUC__
+   return __builtin_popcount(bits);
+#else
+   int output = 0;
+   while (bits != 0) {
+      bits &= bits - 1;
+      output++;
+   }
+   return output;
+#endif
+}
+
+
+#endif  /* _BITOPS_H_INCLUDED */
+
+
+
@@ -3,6 +3,17 @@
 // Creation Date: Wed Feb 11 23:19:44 GMT-0800 1998
 // Last Modified: 14 Oct 1998
 // Last Modified: Sat Sep 23 11:43:30 PDT 2000 (converted from synthImprov.h)
+// Last Modified: Sun Oct 18 13:40:02 PDT 2026 (added main loop statistics)
+// Last Modified: Sun Oct 18 14:52:06 PDT 2026 (added --event-loop option)
+// Last Modified: Sun Oct 18 15:40:12 PDT 2026 (added --realtime option)
+// Last Modified: Mon Oct 19 04:12:40 PDT 2026 (added MIDI capture/replay)
+// Last Modified: Mon Oct 19 05:02:36 PDT 2026 (added MIDI port statistics)
+// Last Modified: Mon Oct 19 05:31:24 PDT 2026 (added MIDI flight recorder)
+// Last Modified: Mon Oct 19 06:14:08 PDT 2026 (operator new is opt-in)
+// Last Modified: Mon Oct 19 06:31:50 PDT 2026 (per-user flight recorder)
+// Last Modified: Mon Oct 19 07:10:36 PDT 2026 (added --virtual-time option)
+// Last Modified: Mon Oct 19 08:31:47 PDT 2026 (replay into an orphan input)
+// Last Modified: Mon Oct 19 08:43:22 PDT 2026 (no --tick by default)
 // Filename:      ...sig/code/control/improv/hciImprov.h
 // Web Address:   http://improv.sapp.org/include/hciImprov.h
 // Syntax:        C++
@@ -15,6 +26,10 @@
 
 #include "improv.h"
 
+#ifdef REALTIME_CHECK
+   #include "RealtimeNew.h"   // for the --realtime options
+#endif
+
 #ifndef OLDCPP
    #include <iostream>
    using namespace std;
@@ -67,6 +82,9 @@ long        t_time = 0;  // global time (in milliseconds) which remains
 Options options;                 // for handling command-line options
 KeyboardInput interfaceKeyboard; // for computer keyboard interface
 Idler eventIdler(1.0);           // to control CPU usage for multiprocessing
+LoopStats loopStats;             // timing statistics for the event loop
+EventLoop eventLoop;             // waits for input instead of idling
+MidiReplay midiReplay;           // plays captured MIDI input
 
 
 
@@ -92,6 +110,7 @@ int runImprovInterface(void) {
    initialization();             // user defined behavior
    options.process();            // process options checking for errors
                                  // and enabling --options option
+   double virtualEnd = options.getDouble("virtual-time") * 1000.0;
 
    int mcount;   // prevention of stuck loop
    int intime;   // incoming time of a MIDI message in milliseconds
@@ -100,7 +119,12 @@ int runImprovInterface(void) {
    int p2;       // second parameter byte
   
    smf::MidiEvent message;
+   loopStats.reset();
+   RealtimeCheck::enterThread();      // no allocation in the event loop
    while (1) {                        // event loop
+      loopStats.begin();
+      midiReplay.update(midi);
+      loopStats.sampleQueue(midi.getCount());
       mcount = 0;
       while(midi.getCount() > 0 && mcount < 15) {
          mcount++;
@@ -112,24 +136,40 @@ int runImprovInterface(void) {
          mididata(intime, p0, p1, p2);
       }
       t_time = mainTimer.getTime(); 
+      loopStats.mark(LOOP_PHASE_INPUT);
 
       mainloopalgorithms();           // user defined behavior
+      loopStats.mark(LOOP_PHASE_ALGORITHM);
 
-      if (keyboardTimer.expired()) {
+      if (eventLoop.isActive() ? (eventLoop.getReady() & EVENTLOOP_KEYBOARD)
+                               : keyboardTimer.expired()) {
          keyboardTimer.reset();
+         RealtimeCheck::leaveThread();   // commands may allocate memory
          command = checkKeyboard();
+         RealtimeCheck::enterThread();
          if (command == 'Q') {
             break;
          } 
             
       }
+      loopStats.mark(LOOP_PHASE_KEYBOARD);
+
+      if (virtualEnd > 0.0 && VirtualClock::getTime() >= virtualEnd) {
+         break;
+      }
 
       #ifndef VISUAL
-         eventIdler.sleep();
+         if (eventLoop.isActive()) {
+            eventLoop.wait();
+         } else {
+            eventIdler.sleep();
+         }
       #endif
+      loopStats.mark(LOOP_PHASE_IDLE);
 
    } // end while(1)
 
+   RealtimeCheck::leaveThread();
    finishup();                        // user defined behavior
    finishup_automatic();
 
@@ -226,12 +266,20 @@ int checkKeyboard(void) {
          break;
    // case 'J': break;
    // case 'K': break;
-   // case 'L': break;
+      case 'L':                         // print main loop statistics
+         loopStats.print(cout);
+         break;
       case 'M':                         // display more commands
          // this command displays less important commands
          print_aux_commands();
          break;
-   // case 'N': break;
+      case 'N':                         // print MIDI port statistics
+         {
+            MidiPortStats stats;
+            midi.getStats(stats, 1);
+            MidiStats::print(cout, stats);
+         }
+         break;
       case 'O':                         // set MIDI out device
          cout << "MIDI output is currently set to port: "
               << midi.getOutputPort() << endl;
@@ -425,7 +473,11 @@ void echoKeysOn(void) {
 //
 
 void finishup_automatic(void) {
+   MidiCapture::stop();
+   FlightRecorder::stop();
    cout << endl;
+   loopStats.dump();
+   RealtimeCheck::report(cout);
 }
 
      
@@ -456,6 +508,20 @@ void initialization_automatic(void) {
    options.define("help=b");            // display usage synopsis
    options.define("ports=b");           // display MIDI I/O ports
    options.define("description=b");     // display the description message
+   options.define("loop-stats=s");      // file for periodic loop statistics
+   options.define("loop-stats-period=d:10.0"); // seconds between statistics
+   options.define("no-loop-stats=b");   // turn off loop statistics
+   options.define("event-loop=b");      // wait for events instead of sleeping
+   options.define("tick=d:0.0");        // ms between polls with --event-loop
+   options.define("realtime=b");        // count allocations in the event loop
+   options.define("realtime-abort=b");  // abort on allocation in event loop
+   options.define("capture=s");         // file for capturing MIDI input
+   options.define("replay=s");          // capture file to replay as input
+   options.define("replay-speed=d:1.0"); // replay speed (0 = fast as possible)
+   options.define("flight-recorder=s"); // MIDI ring file ($HOME/.improv.flight)
+   options.define("flight-size=i:1048576"); // messages in flight recorder
+   options.define("no-flight-recorder=b"); // turn off the flight recorder
+   options.define("virtual-time=d:0.0"); // seconds to run on virtual clock
    options.process(0, 1);               // process options but don't
                                         // complain about undefined options
    if (options.getBoolean("author")) {
@@ -493,6 +559,13 @@ void initialization_automatic(void) {
       return;
    }
 
+   // keep the recent MIDI traffic in a file which survives a crash
+   // (print it with the flightdump program)
+   if (!options.getBoolean("no-flight-recorder")) {
+      FlightRecorder::start(options.getString("flight-recorder").c_str(),
+            options.getInteger("flight-size"));
+   }
+
    // choose the MIDI out port for synthesizer
    midi.setOutputPort(chooseMidiOutputPort());
    midi.openOutput();
@@ -509,6 +582,54 @@ void initialization_automatic(void) {
    // set the idling rate for the evet loop to 1 millisecond
    eventIdler.setSoftSleep(1.0);
 
+   // run faster than real time with a clock which the Idler advances
+   // to the next event instead of sleeping.  Start at one second so
+   // that the times are the same on each run.
+   if (options.getDouble("virtual-time") > 0.0) {
+      VirtualClock::activate(1000.0);
+      t_time = mainTimer.getTime();
+   }
+
+   // main loop timing statistics
+   if (options.getBoolean("no-loop-stats")) {
+      loopStats.disable();
+   } else if (options.getBoolean("loop-stats")) {
+      loopStats.setDumpFile(options.getString("loop-stats").c_str(),
+            options.getDouble("loop-stats-period"));
+   }
+   loopStats.setOverrunTime(eventIdler.getPeriod());
+
+   // wait for keys, MIDI input and EventBuffer deadlines rather than
+   // sleeping for a fixed time between each pass of the event loop.
+   // Programs which poll timers in mainloopalgorithms() should also be
+   // given a --tick period, since there is no tick by default.
+   if (options.getBoolean("event-loop") && !VirtualClock::isActive()) {
+      eventLoop.setTick(options.getDouble("tick"));
+      eventLoop.activate();
+   }
+
+   // check for heap allocations in the event loop and MIDI input threads
+   if (options.getBoolean("realtime-abort")) {
+      RealtimeCheck::setMode(REALTIME_ABORT);
+   } else if (options.getBoolean("realtime")) {
+      RealtimeCheck::setMode(REALTIME_COUNT);
+   }
+
+   // capture the MIDI input, or replay a capture as MIDI input
+   if (options.getBoolean("capture")) {
+      MidiCapture::start(options.getString("capture").c_str());
+   }
+   if (options.getBoolean("replay")) {
+      if (!midiReplay.read(options.getString("replay").c_str())) {
+         exit(1);
+      }
+      // replay into a buffer of the midi object's own, since the
+      // port's buffers are written by the MIDI input thread
+      midi.closeInput();
+      midi.makeOrphanBuffer();
+      midiReplay.start(options.getDouble("replay-speed"));
+   }
+
 }
 
 
@@ -550,6 +671,10 @@ void print_aux_commands(void) {
    printintermediateline();
    printstringline(
 "   C = set CPU speed (used for timer)                                     ");
+   printstringline(
+"   L = print main loop timing statistics                                  ");
+   printstringline(
+"   N = print MIDI port statistics since the last N                        ");
    printboxbottom();
 }
 
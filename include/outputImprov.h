@@ -2,6 +2,13 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Wed Aug 13 11:35:33 PDT 2003
 // Last Modified: Wed Aug 13 11:35:37 PDT 2003
+// Last Modified: Sun Oct 18 13:40:02 PDT 2026 (added main loop statistics)
+// Last Modified: Sun Oct 18 14:52:06 PDT 2026 (added --event-loop option)
+// Last Modified: Sun Oct 18 15:40:12 PDT 2026 (added --realtime option)
+// Last Modified: Mon Oct 19 05:02:36 PDT 2026 (added MIDI port statistics)
+// Last Modified: Mon Oct 19 06:14:08 PDT 2026 (operator new is opt-in)
+// Last Modified: Mon Oct 19 08:37:05 PDT 2026 (added MIDI flight recorder)
+// Last Modified: Mon Oct 19 08:43:22 PDT 2026 (no --tick by default)
 // Filename:      ...sig/code/control/improv/outputImprov.h
 // Web Address:   http://improv.sapp.org/include/outputImprov.h
 // Syntax:        C++
@@ -16,6 +23,10 @@
 
 #include "improv.h"
 
+#ifdef REALTIME_CHECK
+   #include "RealtimeNew.h"   // for the --realtime options
+#endif
+
 #ifndef OLDCPP
    #include <iostream>
    using namespace std;
@@ -64,6 +75,8 @@ long        t_time = 0;  // global time (in milliseconds) which remains
 Options options;                 // for handling command-line options
 KeyboardInput interfaceKeyboard; // for computer keyboard interface
 Idler eventIdler(1.0);           // to control CPU usage for multiprocessing
+LoopStats loopStats;             // timing statistics for the event loop
+EventLoop eventLoop;             // waits for input instead of idling
 
 
 ///////////////////////////////////////////////////////////////////////////
@@ -95,26 +108,40 @@ int runImprovInterface(void) {
    options.process();            // process options checking for errors
                                  // and enabling --options option
 
+   loopStats.reset();
+   RealtimeCheck::enterThread();      // no allocation in the event loop
    while (1) {                        // event loop
+      loopStats.begin();
       t_time = mainTimer.getTime(); 
 
       mainloopalgorithms();           // user defined behavior
+      loopStats.mark(LOOP_PHASE_ALGORITHM);
 
-      if (keyboardTimer.expired()) {
+      if (eventLoop.isActive() ? (eventLoop.getReady() & EVENTLOOP_KEYBOARD)
+                               : keyboardTimer.expired()) {
          keyboardTimer.reset();
+         RealtimeCheck::leaveThread();   // commands may allocate memory
          command = checkKeyboard();
+         RealtimeCheck::enterThread();
          if (command == 'Q') {
             break;
          } 
             
       }
+      loopStats.mark(LOOP_PHASE_KEYBOARD);
 
       #ifndef VISUAL
-         eventIdler.sleep();
+         if (eventLoop.isActive()) {
+            eventLoop.wait();
+         } else {
+            eventIdler.sleep();
+         }
       #endif
+      loopStats.mark(LOOP_PHASE_IDLE);
 
    } // end while(1)
 
+   RealtimeCheck::leaveThread();
    finishup();                        // user defined behavior
    finishup_automatic();
 
@@ -204,12 +231,20 @@ int checkKeyboard(void) {
    // case 'I': break;
    // case 'J': break;
    // case 'K': break;
-   // case 'L': break;
+      case 'L':                         // print main loop statistics
+         loopStats.print(cout);
+         break;
       case 'M':                         // display more commands
          // this command displays less important commands
          print_aux_commands();
          break;
-   // case 'N': break;
+      case 'N':                         // print MIDI port statistics
+         {
+            MidiPortStats stats;
+            synth.getStats(stats, 1);
+            MidiStats::print(cout, stats, MIDI_STATS_OUTPUT);
+         }
+         break;
       case 'O':                         // set MIDI out device for synth
          cout << "synthesizer MIDI output is currently set to port: "
               << synth.getPort() << endl;
@@ -360,6 +395,9 @@ void echoKeysOn(void) {
 
 void finishup_automatic(void) {
    cout << endl;
+   loopStats.dump();
+   RealtimeCheck::report(cout);
+   FlightRecorder::stop();
 }
 
      
@@ -390,6 +428,16 @@ void initialization_automatic(void) {
    options.define("help=b");            // display usage synopsis
    options.define("ports=b");           // display MIDI I/O ports
    options.define("description=b");     // display the description message
+   options.define("loop-stats=s");      // file for periodic loop statistics
+   options.define("loop-stats-period=d:10.0"); // seconds between statistics
+   options.define("no-loop-stats=b");   // turn off loop statistics
+   options.define("event-loop=b");      // wait for events instead of sleeping
+   options.define("tick=d:0.0");        // ms between polls with --event-loop
+   options.define("realtime=b");        // count allocations in the event loop
+   options.define("realtime-abort=b");  // abort on allocation in event loop
+   options.define("flight-recorder=s"); // MIDI ring file ($HOME/.improv.flight)
+   options.define("flight-size=i:1048576"); // messages in flight recorder
+   options.define("no-flight-recorder=b"); // turn off the flight recorder
    options.process(0, 1);               // process options but don't
                                         // complain about undefined options
    if (options.getBoolean("author")) {
@@ -422,6 +470,13 @@ void initialization_automatic(void) {
       return;
    }
 
+   // keep the recent MIDI traffic in a file which survives a crash
+   // (print it with the flightdump program)
+   if (!options.getBoolean("no-flight-recorder")) {
+      FlightRecorder::start(options.getString("flight-recorder").c_str(),
+            options.getInteger("flight-size"));
+   }
+
    // choose the MIDI out port for synthesizer
    synth.setPort(chooseSynthOutputPort());
    synth.open();
@@ -431,6 +486,31 @@ void initialization_automatic(void) {
    // set the idling rate for the evet loop to 1 millisecond
    eventIdler.setSoftSleep(1.0);
 
+   // main loop timing statistics
+   if (options.getBoolean("no-loop-stats")) {
+      loopStats.disable();
+   } else if (options.getBoolean("loop-stats")) {
+      loopStats.setDumpFile(options.getString("loop-stats").c_str(),
+            options.getDouble("loop-stats-period"));
+   }
+   loopStats.setOverrunTime(eventIdler.getPeriod());
+
+   // wait for keys, MIDI input and EventBuffer deadlines rather than
+   // sleeping for a fixed time between each pass of the event loop.
+   // Programs which poll timers in mainloopalgorithms() should also be
+   // given a --tick period, since there is no tick by default.
+   if (options.getBoolean("event-loop")) {
+      eventLoop.setTick(options.getDouble("tick"));
+      eventLoop.activate();
+   }
+
+   // check for heap allocations in the event loop and MIDI input threads
+   if (options.getBoolean("realtime-abort")) {
+      RealtimeCheck::setMode(REALTIME_ABORT);
+   } else if (options.getBoolean("realtime")) {
+      RealtimeCheck::setMode(REALTIME_COUNT);
+   }
+
 }
 
 
@@ -470,6 +550,10 @@ void print_aux_commands(void) {
    printintermediateline();
    printstringline(
 "   C = set CPU speed (used for timer)                                     ");
+   printstringline(
+"   L = print main loop timing statistics                                  ");
+   printstringline(
+"   N = print MIDI port statistics since the last N                        ");
    printboxbottom();
 }
 
@@ -19,17 +19,27 @@
 
 // include headers for control classes
 #include "SigTimer.h"
+#include "VirtualClock.h"
 #include "Idler.h"
+#include "LoopStats.h"
+#include "EventLoop.h"
+#include "RealtimeCheck.h"
 #include "MidiOutPort_unsupported.h"
 #include "MidiOutPort.h"
 #include "MidiOutput.h"
 #include "MidiInPort_unsupported.h"
 #include "MidiInPort.h"
 #include "MidiInput.h"
+#include "MidiCapture.h"
+#include "MidiReplay.h"
+#include "MidiStats.h"
+#include "FlightRecorder.h"
 #include "MidiPort.h"
 #include "MidiIO.h"
 #include "RadioBaton.h"
 #include "AdamsStick.h"
+#include "GestureFeatures.h"
+#include "NoteState.h"
 #include "Synthesizer.h"
 #include "Voice.h"
 #include "KeyboardInput.h"
@@ -2,6 +2,12 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Sun Jul 16 13:39:10 PDT 2000
 // Last Modified: Sun Jul 16 16:56:01 PDT 2000
+// Last Modified: Sun Oct 18 15:31:08 PDT 2026 (no allocation for input)
+// Last Modified: Sun Oct 18 17:04:12 PDT 2026 (power-of-two state size)
+// Last Modified: Mon Oct 19 02:20:31 PDT 2026 (stream times, adaptive poll)
+// Last Modified: Mon Oct 19 06:14:08 PDT 2026 (per-object input event)
+// Last Modified: Mon Oct 19 08:20:14 PDT 2026 (stream mode when available)
+// Last Modified: Mon Oct 19 08:43:22 PDT 2026 (added getPollWait)
 // Filename:      ...sig/code/control/AdamsStick/AdamsStick.cpp
 // Web Address:   http://sig.sapp.org/include/sig/AdamsStick.cpp
 // Syntax:        C++
@@ -13,6 +19,7 @@
 //
 
 #include "AdamsStick.h"
+#include "RealtimeCheck.h"
 
 
 //////////////////////////////
@@ -24,6 +31,8 @@ AdamsStick::AdamsStick(void) {
    setStateSize(STICK_DEFAULT_STATE_SIZE);
    currentMode = STICK_POLL_MODE;
    connectedQ = 0;
+   modeChosenQ = 0;
+   versionAskedQ = 0;
    versionInfo = -1;
 
    t1s = t2s = t3s = 0;
@@ -49,6 +58,14 @@ AdamsStick::AdamsStick(void) {
    pollTimer.setPeriod(STICK_DEFAULT_POLL_PERIOD);
    pollTimer.reset();
    pollTimer.update(-1);
+
+   streamClock.setPeriod(STICK_STREAM_PERIOD);
+   frameTime = 0;
+   adaptivePollQ = 1;
+   fastPollPeriod = STICK_FAST_POLL_PERIOD;
+   slowPollPeriod = STICK_SLOW_POLL_PERIOD;
+   idleFrames = 0;
+   RealtimeCheck::prepare(inputEvent);
 }
 
 
@@ -57,6 +74,8 @@ AdamsStick::AdamsStick(int outputDevice, int inputDevice) :
    setStateSize(STICK_DEFAULT_STATE_SIZE);
    currentMode = STICK_POLL_MODE;
    connectedQ = 0;
+   modeChosenQ = 0;
+   versionAskedQ = 0;
    versionInfo = -1;
 
    t1s = t2s = t3s = 0;
@@ -82,6 +101,14 @@ AdamsStick::AdamsStick(int outputDevice, int inputDevice) :
    pollTimer.setPeriod(STICK_DEFAULT_POLL_PERIOD);
    pollTimer.reset();
    pollTimer.update(-1);
+
+   streamClock.setPeriod(STICK_STREAM_PERIOD);
+   frameTime = 0;
+   adaptivePollQ = 1;
+   fastPollPeriod = STICK_FAST_POLL_PERIOD;
+   slowPollPeriod = STICK_SLOW_POLL_PERIOD;
+   idleFrames = 0;
+   RealtimeCheck::prepare(inputEvent);
 }
 
 
@@ -101,10 +128,20 @@ AdamsStick::~AdamsStick() {
 //
 // AdamsStick::checkPoll -- compare the next poll time to 
 //   the current time and poll the stick if it is time to
-//   do so.
+//   do so.  Nothing is sent in stream mode, since the stick
+//   reports its state without being asked.  The first call asks
+//   the stick for its version; when the answer arrives the stick is
+//   switched to stream mode, unless a mode has been set already.
 //
 
 int AdamsStick::checkPoll(void) { 
+   if (currentMode == STICK_STREAM_MODE) {
+      return 0;
+   }
+   if (!versionAskedQ && !modeChosenQ) {
+      versionAskedQ = 1;
+      sendVersionMessage();
+   }
    if (pollTimer.expired()) {
       poll();
       pollTimer.reset();
@@ -116,6 +153,18 @@ int AdamsStick::checkPoll(void) {
 
 
 
+//////////////////////////////
+//
+// AdamsStick::getAdaptivePoll -- returns true if the poll period used
+//   with checkPoll() changes with the activity on the stick.
+//
+
+int AdamsStick::getAdaptivePoll(void) {
+   return adaptivePollQ;
+}
+
+
+
 //////////////////////////////
 //
 // AdamsStick::getLevel -- returns trigger level for the given
@@ -156,6 +205,28 @@ double AdamsStick::getPollPeriod(void) {
 
 
 
+//////////////////////////////
+//
+// AdamsStick::getPollWait -- returns the number of milliseconds until
+//     checkPoll() will next poll the stick (0.0 if a poll is due), or
+//     -1.0 in stream mode.  For waking up an event loop in time.
+//
+
+double AdamsStick::getPollWait(void) {
+   if (currentMode == STICK_STREAM_MODE) {
+      return -1.0;
+   }
+   if (!versionAskedQ && !modeChosenQ) {
+      return 0.0;
+   }
+   if (pollTimer.expired()) {
+      return 0.0;
+   }
+   return pollTimer.getPeriod() * (1.0 - pollTimer.getPeriodCount());
+}
+
+
+
 //////////////////////////////
 //
 // AdamsStick::getState -- returns 0 is fsr is off, otherwise 1.
@@ -252,15 +323,40 @@ void AdamsStick::poll(void) {
 //
 
 void AdamsStick::processIncomingMessages(void) { 
-   smf::MidiEvent event;
    while (MidiInput::getCount() > 0) {
-      MidiInput::extract(event);
-      interpretCommand(event);
+      MidiInput::extract(inputEvent);
+      interpretCommand(inputEvent);
    }
 }
 
 
 
+//////////////////////////////
+//
+// AdamsStick::setAdaptivePoll -- turn on or off the adaptive poll
+//   period of checkPoll().  When on, the stick is polled every
+//   fastPeriod milliseconds while an FSR is being pressed, and every
+//   slowPeriod milliseconds once the stick has been idle for
+//   STICK_ACTIVE_HOLD milliseconds.  The adaptive poll period is on
+//   by default, in place of the fixed STICK_DEFAULT_POLL_PERIOD;
+//   calling setPollPeriod() turns it off.
+//   default value: aState = 1
+//
+
+void AdamsStick::setAdaptivePoll(int aState) {
+   adaptivePollQ = aState ? 1 : 0;
+   idleFrames = 0;
+}
+
+
+void AdamsStick::setAdaptivePoll(double fastPeriod, double slowPeriod) {
+   fastPollPeriod = fastPeriod;
+   slowPollPeriod = slowPeriod;
+   setAdaptivePoll(1);
+}
+
+
+
 //////////////////////////////
 //
 // AdamsStick::setLevel -- 
@@ -304,6 +400,7 @@ void AdamsStick::setLevel(int aValue) {
 //
 
 void AdamsStick::setMode(int aMode) { 
+   modeChosenQ = 1;
    if (aMode) {
       currentMode = 1;
    } else {
@@ -319,7 +416,9 @@ void AdamsStick::setMode(int aMode) {
 //
 
 void AdamsStick::setPollMode(void) { 
+   modeChosenQ = 1;
    sendPollingMessage();
+   currentMode = STICK_POLL_MODE;
 }
 
 
@@ -327,11 +426,13 @@ void AdamsStick::setPollMode(void) {
 //////////////////////////////
 //
 // AdamsStick::setPollPeriod -- set the poll period used
-//     with checkPoll().  Time is in milliseconds.
+//     with checkPoll().  Time is in milliseconds.  The poll
+//     period will no longer adapt to the activity on the stick.
 //
 
 void AdamsStick::setPollPeriod(double aPeriod) { 
    pollTimer.setPeriod(aPeriod);
+   adaptivePollQ = 0;
 }
 
 
@@ -339,32 +440,37 @@ void AdamsStick::setPollPeriod(double aPeriod) {
 //////////////////////////////
 //
 // AdamsStick::setStateSize -- set the length of the circular buffers
-//     that store old state information.
+//     that store old state information.  The length is rounded up
+//     to a power of two for faster indexing.
 //
 
 void AdamsStick::setStateSize(int aSize) { 
-   t1sb.setSize(aSize);
-   s1pb.setSize(aSize);
-   s1fb.setSize(aSize);
+   t1sb.setPow2Size(aSize);
+   s1pb.setPow2Size(aSize);
+   s1fb.setPow2Size(aSize);
 
-   t2sb.setSize(aSize);
-   s2pb.setSize(aSize);
-   s2fb.setSize(aSize);
+   t2sb.setPow2Size(aSize);
+   s2pb.setPow2Size(aSize);
+   s2fb.setPow2Size(aSize);
 
-   t3sb.setSize(aSize);
-   s3pb.setSize(aSize);
-   s3fb.setSize(aSize);
+   t3sb.setPow2Size(aSize);
+   s3pb.setPow2Size(aSize);
+   s3fb.setPow2Size(aSize);
 }
 
 
 
 //////////////////////////////
 //
-// AdamsStick::setStreamMode --
+// AdamsStick::setStreamMode -- set the stick into Stream mode, where
+//    it reports its state every 16 milliseconds.
 //
 
 void AdamsStick::setStreamMode(void) { 
+   modeChosenQ = 1;
    sendStreamingMessage();
+   currentMode = STICK_STREAM_MODE;
+   streamClock.reset();
 }
 
 
@@ -401,11 +507,10 @@ void AdamsStick::setThreshold(int aValue) {
 //
 
 int AdamsStick::toggleMode(void) { 
-   currentMode = !currentMode;
-   if (currentMode) {
-      sendStreamingMessage();
+   if (currentMode == STICK_STREAM_MODE) {
+      setPollMode();
    } else {
-      sendPollingMessage();
+      setStreamMode();
    }
    return currentMode;
 }
@@ -516,7 +621,12 @@ int AdamsStick::s3fc(int min, int max) {
 void AdamsStick::interpretCommand(smf::MidiEvent& aMessage) { 
    switch (aMessage.getCommandByte()) {
       case 0x90:
-         t1s = aMessage.tick;
+         if (currentMode == STICK_STREAM_MODE) {
+            frameTime = (long)(streamClock.stamp(aMessage.tick) + 0.5);
+         } else {
+            frameTime = aMessage.tick;
+         }
+         t1s = frameTime;
          t1sb.insert(t1s);
          s1p = convertTo14bits(aMessage.getP1(), aMessage.getP2());
          s1pb.insert(s1p);
@@ -530,7 +640,7 @@ void AdamsStick::interpretCommand(smf::MidiEvent& aMessage) {
          }
          break;
       case 0x92:
-         t2s = aMessage.tick;
+         t2s = frameTime;
          t2sb.insert(t2s);
          s2p = convertTo14bits(aMessage.getP1(), aMessage.getP2());
          s2pb.insert(s2p);
@@ -544,7 +654,7 @@ void AdamsStick::interpretCommand(smf::MidiEvent& aMessage) {
          }
          break;
       case 0x94:
-         t3s = aMessage.tick;
+         t3s = frameTime;
          t3sb.insert(t3s);
          s3p = convertTo14bits(aMessage.getP1(), aMessage.getP2());
          s3pb.insert(s3p);
@@ -557,6 +667,7 @@ void AdamsStick::interpretCommand(smf::MidiEvent& aMessage) {
             loc3t = t3s;
          }
          determineTriggers();
+         adaptPollPeriod();
          response();
          break;
       case 0xf0:
@@ -570,6 +681,9 @@ void AdamsStick::interpretCommand(smf::MidiEvent& aMessage) {
          if (data[2] !=  0) return;
          versionInfo = data[3];
          connectedQ = 1;
+         if (!modeChosenQ && currentMode == STICK_POLL_MODE) {
+            setStreamMode();        // the stick answers, so stream
+         }
          }
          break;
       default:
@@ -578,6 +692,37 @@ void AdamsStick::interpretCommand(smf::MidiEvent& aMessage) {
    }
 }
 
+
+
+//////////////////////////////
+//
+// AdamsStick::adaptPollPeriod -- after each poll reply, poll quickly
+//     if an FSR is being touched, or slowly if no FSR has been touched
+//     for a while.
+//
+
+void AdamsStick::adaptPollPeriod(void) {
+   if (!adaptivePollQ || currentMode != STICK_POLL_MODE) {
+      return;
+   }
+
+   if (state1 || state2 || state3 || s1f > POSITION_THRESHOLD ||
+         s2f > POSITION_THRESHOLD || s3f > POSITION_THRESHOLD) {
+      idleFrames = 0;
+      if (pollTimer.getPeriod() != fastPollPeriod) {
+         pollTimer.setPeriod(fastPollPeriod);
+      }
+   } else {
+      idleFrames++;
+      if (idleFrames * fastPollPeriod >= STICK_ACTIVE_HOLD &&
+            pollTimer.getPeriod() != slowPollPeriod) {
+         pollTimer.setPeriod(slowPollPeriod);
+      }
+   }
+}
+
+
+
 //////////////////////////////
 //
 // determineTrigger --  Determine if an on/off trigger needs to
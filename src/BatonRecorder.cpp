@@ -0,0 +1,122 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Mon Oct 19 01:42:18 PDT 2026
+// Last Modified: Mon Oct 19 01:42:22 PDT 2026
+// Last Modified: Mon Oct 19 07:41:26 PDT 2026 (recorded by MidiCapture)
+// Last Modified: Mon Oct 19 08:55:41 PDT 2026 (replayed by MidiReplay)
+// Filename:      ...improv/src/BatonRecorder.cpp
+// Web Address:   http://sig.sapp.org/src/sig/BatonRecorder.cpp
+// Syntax:        C++
+//
+// Description:   Records the MIDI messages received from a Radio Baton
+//                into a session file which can be played back with
+//                RadioBaton::replaySessionStart().  The session is a
+//                MidiCapture of the baton's input port, so it can also
+//                be played with MidiReplay.
+//
+
+#include "BatonRecorder.h"
+
+#ifndef OLDCPP
+   #include <iostream>
+   using namespace std;
+#else
+   #include <iostream.h>
+#endif
+
+
+//////////////////////////////
+//
+// BatonRecorder::BatonRecorder --
+//
+
+BatonRecorder::BatonRecorder(void) {
+   runningQ = 0;
+}
+
+
+
+//////////////////////////////
+//
+// BatonRecorder::~BatonRecorder --
+//
+
+BatonRecorder::~BatonRecorder() {
+   stop();
+}
+
+
+
+//////////////////////////////
+//
+// BatonRecorder::getCount -- returns the number of messages recorded
+//    since the recording was started.
+//
+
+long BatonRecorder::getCount(void) const {
+   return runningQ ? MidiCapture::getCount() : 0;
+}
+
+
+
+//////////////////////////////
+//
+// BatonRecorder::getDropped -- returns the number of messages which
+//    were not recorded because the file could not be written quickly
+//    enough.
+//
+
+long BatonRecorder::getDropped(void) const {
+   return runningQ ? MidiCapture::getDropped() : 0;
+}
+
+
+
+//////////////////////////////
+//
+// BatonRecorder::recordingQ -- returns true if a session is being
+//    recorded.
+//
+
+int BatonRecorder::recordingQ(void) const {
+   return runningQ && MidiCapture::recordingQ();
+}
+
+
+
+//////////////////////////////
+//
+// BatonRecorder::start -- start recording the messages which arrive on
+//    the given MIDI input port into a session file.  Returns 0 if the
+//    file could not be opened, or if all MIDI input is already being
+//    captured.
+//
+
+int BatonRecorder::start(const char* aFilename, int aPort) {
+   stop();
+   if (MidiCapture::recordingQ()) {
+      cerr << "Error: cannot record a baton session while MIDI input "
+           << "is being captured" << endl;
+      return 0;
+   }
+   runningQ = MidiCapture::start(aFilename, aPort);
+   return runningQ;
+}
+
+
+
+//////////////////////////////
+//
+// BatonRecorder::stop -- stop recording and close the session file.
+//
+
+void BatonRecorder::stop(void) {
+   if (!runningQ) {
+      return;
+   }
+   MidiCapture::stop();
+   runningQ = 0;
+}
+
+
+
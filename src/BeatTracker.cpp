@@ -0,0 +1,294 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sun Oct 18 22:58:20 PDT 2026
+// Last Modified: Sun Oct 18 22:58:24 PDT 2026
+// Filename:      ...improv/src/BeatTracker.cpp
+// Web Address:   http://sig.sapp.org/src/sig/BeatTracker.cpp
+// Syntax:        C++
+//
+// Description:   Follows the tempo of a sequence of beats, such as
+//                the beats of a conductor's baton, and predicts when
+//                the next beat will occur.  The time of the current
+//                beat and the beat period are estimated together with
+//                a Kalman filter, so that a single late or early beat
+//                changes the tempo only a little, while a real change
+//                of tempo is followed within a few beats.  Beats which
+//                are skipped are counted, and extra beats which are
+//                too close to the predicted one are ignored.  Times
+//                are in milliseconds.
+//
+
+#include "BeatTracker.h"
+
+#include <math.h>
+
+#define MAX_SKIPPED_BEATS 4    /* longer gaps start the tracking again */
+#define SKIP_THRESHOLD    1.8  /* periods in a gap with a skipped beat  */
+
+
+//////////////////////////////
+//
+// BeatTracker::BeatTracker --
+//
+
+BeatTracker::BeatTracker(void) {
+   jitter      = 15.0 * 15.0;
+   phaseNoise  =  5.0 *  5.0;
+   periodNoise = 20.0 * 20.0;
+   minPeriod   = 60000.0 / 300.0;
+   maxPeriod   = 60000.0 / 20.0;
+   reset();
+}
+
+
+
+//////////////////////////////
+//
+// BeatTracker::~BeatTracker --
+//
+
+BeatTracker::~BeatTracker() {
+   // do nothing
+}
+
+
+
+//////////////////////////////
+//
+// BeatTracker::beat -- add the time of a new beat.  Returns 1 if the beat
+//    was used, or 0 if it was ignored because it came too soon after the
+//    previous beat.
+//
+
+int BeatTracker::beat(double aTime) {
+   if (beatCount == 0) {
+      restart(aTime);
+      return 1;
+   }
+
+   double elapsed = aTime - beatTime;
+   if (beatCount == 1) {
+      // the first interval gives the first estimate of the period
+      if (elapsed < minPeriod / 2.0) {
+         return 0;
+      }
+      if (elapsed > maxPeriod) {
+         restart(aTime);
+         return 1;
+      }
+      period = elapsed;
+      beatTime = aTime;
+      covariance[0][0] = jitter;
+      covariance[0][1] = covariance[1][0] = jitter;
+      covariance[1][1] = 2.0 * jitter;
+      beatCount++;
+      return 1;
+   }
+
+   // A performer slows down far more often than skipping a beat, so
+   // only count skipped beats when the gap is nearly two periods long.
+   int steps = 1;
+   if (elapsed < period / 2.0) {
+      return 0;
+   } else if (elapsed > SKIP_THRESHOLD * period) {
+      steps = (int)floor(elapsed / period + 0.5);
+   }
+   if (steps > MAX_SKIPPED_BEATS) {
+      restart(aTime);
+      return 1;
+   }
+
+   // predict the time of the beat, and the uncertainty of the prediction
+   double predicted = beatTime + steps * period;
+   double c00 = covariance[0][0] + 2.0 * steps * covariance[0][1] +
+         steps * steps * covariance[1][1] + steps * phaseNoise;
+   double c01 = covariance[0][1] + steps * covariance[1][1];
+   double c11 = covariance[1][1] + steps * periodNoise;
+
+   // correct the prediction by the error in the beat time
+   double error = aTime - predicted;
+   double gain0 = c00 / (c00 + jitter);
+   double gain1 = c01 / (c00 + jitter);
+   beatTime = predicted + gain0 * error;
+   period   = period + gain1 * error;
+   covariance[0][0] = (1.0 - gain0) * c00;
+   covariance[0][1] = covariance[1][0] = (1.0 - gain0) * c01;
+   covariance[1][1] = c11 - gain1 * c01;
+
+   if (period < minPeriod) {
+      period = minPeriod;
+   } else if (period > maxPeriod) {
+      period = maxPeriod;
+   }
+   beatCount++;
+   return 1;
+}
+
+
+
+//////////////////////////////
+//
+// BeatTracker::getBeatCount -- returns the number of beats which have
+//    been used since the last reset.
+//
+
+int BeatTracker::getBeatCount(void) const {
+   return beatCount;
+}
+
+
+
+//////////////////////////////
+//
+// BeatTracker::getBeatTime -- returns the estimated time of the last
+//    beat.
+//
+
+double BeatTracker::getBeatTime(void) const {
+   return beatTime;
+}
+
+
+
+//////////////////////////////
+//
+// BeatTracker::getNextBeat -- returns the predicted time of the next
+//    beat.
+//
+
+double BeatTracker::getNextBeat(void) const {
+   return beatTime + period;
+}
+
+
+
+//////////////////////////////
+//
+// BeatTracker::getPeriod -- returns the estimated beat period in
+//    milliseconds.
+//
+
+double BeatTracker::getPeriod(void) const {
+   return period;
+}
+
+
+
+//////////////////////////////
+//
+// BeatTracker::getPosition -- returns the number of beats (with fraction)
+//    since the last beat at the given time.
+//
+
+double BeatTracker::getPosition(double aTime) const {
+   if (beatCount == 0) {
+      return 0.0;
+   }
+   return (aTime - beatTime) / period;
+}
+
+
+
+//////////////////////////////
+//
+// BeatTracker::getTempo -- returns the estimated tempo in beats per
+//    minute.
+//
+
+double BeatTracker::getTempo(void) const {
+   return 60000.0 / period;
+}
+
+
+
+//////////////////////////////
+//
+// BeatTracker::reset -- forget the beats, and start with the given
+//    tempo.  default value: aTempo = 60.0
+//
+
+void BeatTracker::reset(double aTempo) {
+   if (aTempo <= 0.0) {
+      aTempo = 60.0;
+   }
+   period = 60000.0 / aTempo;
+   if (period < minPeriod) {
+      period = minPeriod;
+   } else if (period > maxPeriod) {
+      period = maxPeriod;
+   }
+   beatTime = 0.0;
+   beatCount = 0;
+   covariance[0][0] = jitter;
+   covariance[0][1] = covariance[1][0] = 0.0;
+   covariance[1][1] = period * period / 16.0;
+}
+
+
+
+//////////////////////////////
+//
+// BeatTracker::setJitter -- set the standard deviation in milliseconds
+//    of the placement of beats by the performer.  Larger values make
+//    the tempo steadier but slower to follow changes.
+//
+
+void BeatTracker::setJitter(double milliseconds) {
+   jitter = milliseconds * milliseconds;
+}
+
+
+
+//////////////////////////////
+//
+// BeatTracker::setTempoLimits -- set the slowest and fastest tempos
+//    in beats per minute which will be followed.
+//
+
+void BeatTracker::setTempoLimits(double minTempo, double maxTempo) {
+   if (minTempo <= 0.0 || maxTempo < minTempo) {
+      return;
+   }
+   minPeriod = 60000.0 / maxTempo;
+   maxPeriod = 60000.0 / minTempo;
+}
+
+
+
+//////////////////////////////
+//
+// BeatTracker::setVariation -- set how much the beat time and the beat
+//    period are expected to change from one beat to the next, as
+//    standard deviations in milliseconds.  Larger values follow tempo
+//    changes more quickly.
+//
+
+void BeatTracker::setVariation(double phaseVariation, double periodVariation) {
+   phaseNoise = phaseVariation * phaseVariation;
+   periodNoise = periodVariation * periodVariation;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// protected functions
+//
+
+
+//////////////////////////////
+//
+// BeatTracker::restart -- start following again from the given beat.
+//    The period is measured again from the next beat.
+//
+
+void BeatTracker::restart(double aTime) {
+   beatTime = aTime;
+   beatCount = 1;
+   covariance[0][0] = jitter;
+   covariance[0][1] = covariance[1][0] = 0.0;
+   covariance[1][1] = period * period / 16.0;
+}
+
+
+
@@ -4,6 +4,8 @@
 // Last Modified: Mon Feb 16 22:20:34 GMT-0800 1998
 // Last Modified: Thu Nov  5 17:06:33 PST 1998
 // Last Modified: Fri Apr 21 15:12:11 PDT 2000 (revisions finalized)
+// Last Modified: Sun Oct 18 14:31:12 PDT 2026 (added getWaitTime)
+// Last Modified: Mon Oct 19 08:43:22 PDT 2026 (earliest time kept up to date)
 // Filename:      ...sig/src/control/EventBuffer/EventBuffer.cpp
 // Web Address:   http://sig.sapp.org/src/sig/EventBuffer.cpp
 // Syntax:        C++ 
@@ -15,6 +17,11 @@
 
 #include <string.h>
 
+#define EB_NO_TIME (0x7fffffff)   /* earliestTime of an empty list */
+
+// declarations of static variables:
+EventBuffer* EventBuffer::firstBuffer = NULL;
+
 
 //////////////////////////////
 //
@@ -33,6 +40,10 @@ EventBuffer::EventBuffer(int aSize) {
    freeSlots.setSize(storageSize);
    pollTimer.setPeriod(10);
    reset();
+
+   // add to the list of EventBuffers for getNextWaitTime()
+   nextBuffer = firstBuffer;
+   firstBuffer = this;
 }
 
 
@@ -53,6 +64,15 @@ EventBuffer::~EventBuffer(void) {
    }
 
    storageSize = 0;
+
+   EventBuffer** link = &firstBuffer;
+   while (*link != NULL) {
+      if (*link == this) {
+         *link = nextBuffer;
+         break;
+      }
+      link = &(*link)->nextBuffer;
+   }
 }
    
 
@@ -101,6 +121,10 @@ void EventBuffer::activate(int index) {
       eventList[index].next = storageSize;
       eventList[storageSize].last = index;
    }
+
+   if (eventStorage[index].getActionTime() < earliestTime) {
+      earliestTime = eventStorage[index].getActionTime();
+   }
 }
 
 
@@ -108,7 +132,8 @@ void EventBuffer::activate(int index) {
 //////////////////////////////
 //
 // EventBuffer::xcheck -- look at each element in the 
-// 	buffer to see if they need to be executed.
+// 	buffer to see if they need to be executed.  The earliest action
+//      time of the events which remain is found on the way.
 //
 
 void EventBuffer::xcheck(void) {
@@ -119,6 +144,8 @@ void EventBuffer::xcheck(void) {
 void EventBuffer::xcheck(long currentTime) {
    int item = eventList[storageSize].next;
    int olditem;
+   int earliest = EB_NO_TIME;
+   earliestQ = 1;         // unless an action uses operator[]
    while (item < storageSize) {
       if (eventStorage[item].getActionTime() <= currentTime) {
          eventStorage[item].action(*this);
@@ -127,8 +154,11 @@ void EventBuffer::xcheck(long currentTime) {
       item = eventList[item].next;
       if (eventStorage[olditem].isdead()) {
          removeEvent(olditem);
+      } else if (eventStorage[olditem].getActionTime() < earliest) {
+         earliest = eventStorage[olditem].getActionTime();
       }
    }
+   earliestTime = earliest;
 }
 
 
@@ -204,6 +234,76 @@ int EventBuffer::getPollPeriod(void) const {
 
 
 
+//////////////////////////////
+//
+// EventBuffer::getWaitTime -- returns the number of milliseconds until
+//     checkPoll() will perform the next event in the buffer, or -1.0
+//     if the buffer is empty.  The result is 0.0 if an event is overdue.
+//     The earliest action time is kept up to date by activate() and
+//     xcheck(), so the events only have to be searched after one of
+//     them was accessed with operator[], which can change its time.
+//
+
+double EventBuffer::getWaitTime(void) const {
+   int item = eventList[storageSize].next;
+   if (item >= storageSize) {
+      return -1.0;
+   }
+
+   int earliest = earliestTime;
+   if (!earliestQ) {
+      earliest = eventStorage[item].getActionTime();
+      item = eventList[item].next;
+      while (item < storageSize) {
+         if (eventStorage[item].getActionTime() < earliest) {
+            earliest = eventStorage[item].getActionTime();
+         }
+         item = eventList[item].next;
+      }
+   }
+
+   double output = earliest - timer.getTimeInSeconds() * 1000.0;
+
+   // checkPoll() will not look at the events until the poll period
+   // has expired:
+   double pollWait = 0.0;
+   if (!pollTimer.expired()) {
+      pollWait = pollTimer.getPeriod() * (1.0 - pollTimer.getPeriodCount());
+   }
+   if (pollWait > output) {
+      output = pollWait;
+   }
+
+   if (output < 0.0) {
+      output = 0.0;
+   }
+   return output;
+}
+
+
+
+//////////////////////////////
+//
+// EventBuffer::getNextWaitTime -- returns the smallest wait time of
+//     all EventBuffers in the program, or -1.0 if they are all empty.
+//     (static function)
+//
+
+double EventBuffer::getNextWaitTime(void) {
+   double output = -1.0;
+   double wait;
+   for (EventBuffer* buffer = firstBuffer; buffer != NULL;
+         buffer = buffer->nextBuffer) {
+      wait = buffer->getWaitTime();
+      if (wait >= 0.0 && (output < 0.0 || wait < output)) {
+         output = wait;
+      }
+   }
+   return output;
+}
+
+
+
 //////////////////////////////
 //
 // EventBuffer::insert -- returns the location in the buffer
@@ -243,13 +343,17 @@ void EventBuffer::off(void) {
       item = eventList[item].next;
       removeEvent(olditem);
    }
+   earliestTime = EB_NO_TIME;
+   earliestQ = 1;
 }
 
 
 
 //////////////////////////////
 //
-// EventBuffer::operator[] --
+// EventBuffer::operator[] -- the event may be changed through the
+//     reference, so its action time is searched for again by the next
+//     getWaitTime() if xcheck() has not been called in between.
 //
 
 Event& EventBuffer::operator[](int index) {
@@ -257,6 +361,7 @@ Event& EventBuffer::operator[](int index) {
       cout << "Error: invalid index for accessing EventBuffer" << endl;
       exit(1);
    }
+   earliestQ = 0;
    return eventStorage[index];
 }
 
@@ -306,6 +411,8 @@ void EventBuffer::reset(void) {
    } 
    eventList[storageSize].next = storageSize;   // top of list
    eventList[storageSize].last = storageSize;   // bottom of list
+   earliestTime = EB_NO_TIME;
+   earliestQ = 1;
 
    pollTimer.reset();
 }
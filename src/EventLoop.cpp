@@ -0,0 +1,363 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sun Oct 18 14:20:31 PDT 2026
+// Last Modified: Sun Oct 18 14:20:35 PDT 2026
+// Last Modified: Mon Oct 19 03:35:12 PDT 2026 (not with the virtual clock)
+// Filename:      ...improv/src/EventLoop.cpp
+// Web Address:   http://sig.sapp.org/src/sig/EventLoop.cpp
+// Syntax:        C++
+//
+// Description:   Blocks the event loop of the improv environments
+//                until there is something to do, as an alternative to
+//                sleeping for a fixed time with the Idler class.
+//                The wait() function returns when a key is pressed,
+//                when a MIDI input thread has received a message, when
+//                the next event in any EventBuffer is due, or when an
+//                optional periodic tick for polling code has arrived.
+//                Uses epoll, timerfd and eventfd on Linux; on other
+//                systems activate() fails and the Idler should be used.
+//
+
+#include "EventLoop.h"
+#include "EventBuffer.h"
+#include "VirtualClock.h"
+
+#ifdef LINUX
+   #include <sys/epoll.h>
+   #include <sys/timerfd.h>
+   #include <sys/eventfd.h>
+   #include <unistd.h>
+   #include <errno.h>
+   #include <stdint.h>
+   #include <string.h>
+#endif
+
+#ifndef OLDCPP
+   #include <iostream>
+   using namespace std;
+#else
+   #include <iostream.h>
+#endif
+
+// tags for identifying the source of an epoll event:
+#define EVENTLOOP_SOURCE_KEYBOARD  (0)
+#define EVENTLOOP_SOURCE_MIDI      (1)
+#define EVENTLOOP_SOURCE_DEADLINE  (2)
+#define EVENTLOOP_SOURCE_TICK      (3)
+
+// declarations of static variables:
+int EventLoop::inputFd = -1;
+
+
+//////////////////////////////
+//
+// EventLoop::EventLoop --
+//
+
+EventLoop::EventLoop(void) {
+   epollFd    = -1;
+   deadlineFd = -1;
+   tickFd     = -1;
+   keyboardQ  = 0;
+   tickPeriod = 0.0;
+   userWait   = -1.0;
+   ready      = 0;
+}
+
+
+
+//////////////////////////////
+//
+// EventLoop::~EventLoop --
+//
+
+EventLoop::~EventLoop() {
+   deactivate();
+}
+
+
+
+//////////////////////////////
+//
+// EventLoop::activate -- create the file descriptors to wait on.
+//     Returns false if the system does not support waiting on events,
+//     in which case the event loop should sleep with an Idler instead.
+//     The system cannot wait for the VirtualClock, so the Idler must
+//     also be used when it is active.
+//
+
+int EventLoop::activate(void) {
+   if (VirtualClock::isActive()) {
+      cerr << "Warning: the event loop cannot wait with a virtual clock"
+           << endl;
+      return 0;
+   }
+
+#ifdef LINUX
+   if (epollFd >= 0) {
+      return 1;
+   }
+
+   epollFd    = epoll_create1(EPOLL_CLOEXEC);
+   deadlineFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+   tickFd     = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+   int midiFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+   if (epollFd < 0 || deadlineFd < 0 || tickFd < 0 || midiFd < 0) {
+      cerr << "Warning: cannot create event loop: " << strerror(errno) << endl;
+      if (midiFd >= 0) {
+         ::close(midiFd);
+      }
+      deactivate();
+      return 0;
+   }
+
+   struct epoll_event event;
+   memset(&event, 0, sizeof(event));
+   event.events = EPOLLIN;
+
+   event.data.u32 = EVENTLOOP_SOURCE_MIDI;
+   epoll_ctl(epollFd, EPOLL_CTL_ADD, midiFd, &event);
+   event.data.u32 = EVENTLOOP_SOURCE_DEADLINE;
+   epoll_ctl(epollFd, EPOLL_CTL_ADD, deadlineFd, &event);
+   event.data.u32 = EVENTLOOP_SOURCE_TICK;
+   epoll_ctl(epollFd, EPOLL_CTL_ADD, tickFd, &event);
+
+   // stdin cannot be watched if it is a regular file, in which case
+   // the keyboard is checked after every wakeup.
+   event.data.u32 = EVENTLOOP_SOURCE_KEYBOARD;
+   keyboardQ = epoll_ctl(epollFd, EPOLL_CTL_ADD, 0, &event) == 0;
+
+   inputFd = midiFd;
+   setTick(tickPeriod);
+   return 1;
+#else
+   return 0;
+#endif
+}
+
+
+
+//////////////////////////////
+//
+// EventLoop::deactivate -- close the file descriptors.
+//
+
+void EventLoop::deactivate(void) {
+#ifdef LINUX
+   int midiFd = inputFd;
+   inputFd = -1;
+   if (midiFd >= 0) {
+      ::close(midiFd);
+   }
+   if (tickFd >= 0) {
+      ::close(tickFd);
+   }
+   if (deadlineFd >= 0) {
+      ::close(deadlineFd);
+   }
+   if (epollFd >= 0) {
+      ::close(epollFd);
+   }
+#endif
+   epollFd    = -1;
+   deadlineFd = -1;
+   tickFd     = -1;
+   keyboardQ  = 0;
+}
+
+
+
+//////////////////////////////
+//
+// EventLoop::getReady -- returns the EVENTLOOP_* bits of the last
+//     call to wait().
+//
+
+int EventLoop::getReady(void) const {
+   return ready;
+}
+
+
+
+//////////////////////////////
+//
+// EventLoop::getTick -- returns the period of the polling tick in
+//     milliseconds, or 0 if there is no tick.
+//
+
+double EventLoop::getTick(void) const {
+   return tickPeriod;
+}
+
+
+
+//////////////////////////////
+//
+// EventLoop::isActive -- returns true if activate() was successful.
+//
+
+int EventLoop::isActive(void) const {
+   return epollFd >= 0;
+}
+
+
+
+//////////////////////////////
+//
+// EventLoop::setTick -- set the period in milliseconds for waking up
+//     without any input or EventBuffer deadline, for code which polls
+//     inside of mainloopalgorithms().  A period of 0 turns off the tick.
+//
+
+void EventLoop::setTick(double aPeriod) {
+   if (aPeriod < 0.0) {
+      aPeriod = 0.0;
+   }
+   tickPeriod = aPeriod;
+   if (tickFd >= 0) {
+      armTimer(tickFd, tickPeriod, 1);
+   }
+}
+
+
+
+//////////////////////////////
+//
+// EventLoop::wakeAfter -- return from the next wait() no later than
+//     the given number of milliseconds from now.  For user code which
+//     knows when it next needs to run.
+//
+
+void EventLoop::wakeAfter(double milliseconds) {
+   if (milliseconds < 0.0) {
+      milliseconds = 0.0;
+   }
+   if (userWait < 0.0 || milliseconds < userWait) {
+      userWait = milliseconds;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// EventLoop::wait -- block until a key is pressed, MIDI input arrives,
+//     the next EventBuffer event is due, the time given to wakeAfter()
+//     has passed, or the tick arrives.  Returns the EVENTLOOP_* bits
+//     describing why it returned.
+//
+
+int EventLoop::wait(void) {
+   ready = 0;
+#ifdef LINUX
+   if (epollFd < 0) {
+      return ready;
+   }
+
+   double timeout = EventBuffer::getNextWaitTime();
+   if (userWait >= 0.0 && (timeout < 0.0 || userWait < timeout)) {
+      timeout = userWait;
+   }
+   userWait = -1.0;
+   armTimer(deadlineFd, timeout, 0);
+
+   struct epoll_event events[4];
+   int count;
+   do {
+      count = epoll_wait(epollFd, events, 4, -1);
+   } while (count < 0 && errno == EINTR);
+
+   uint64_t value;
+   for (int i=0; i<count; i++) {
+      switch (events[i].data.u32) {
+         case EVENTLOOP_SOURCE_KEYBOARD:
+            if (events[i].events & (EPOLLHUP | EPOLLERR)) {
+               // stdin was closed: stop watching it
+               epoll_ctl(epollFd, EPOLL_CTL_DEL, 0, NULL);
+               keyboardQ = 0;
+            } else {
+               ready |= EVENTLOOP_KEYBOARD;
+            }
+            break;
+         case EVENTLOOP_SOURCE_MIDI:
+            if (read(inputFd, &value, sizeof(value)) > 0) {
+               ready |= EVENTLOOP_MIDI;
+            }
+            break;
+         case EVENTLOOP_SOURCE_DEADLINE:
+            if (read(deadlineFd, &value, sizeof(value)) > 0) {
+               ready |= EVENTLOOP_TIMER;
+            }
+            break;
+         case EVENTLOOP_SOURCE_TICK:
+            if (read(tickFd, &value, sizeof(value)) > 0) {
+               ready |= EVENTLOOP_TICK;
+            }
+            break;
+      }
+   }
+
+   if (!keyboardQ) {
+      ready |= EVENTLOOP_KEYBOARD;
+   }
+#endif
+   return ready;
+}
+
+
+
+//////////////////////////////
+//
+// EventLoop::signalInput -- wake up the active event loop.  Called
+//     by the MIDI input threads after a message has been stored.
+//     (static function)
+//
+
+void EventLoop::signalInput(void) {
+#ifdef LINUX
+   int fd = inputFd;
+   if (fd >= 0) {
+      uint64_t one = 1;
+      if (write(fd, &one, sizeof(one)) < 0) {
+         // counter is full, so the event loop is already awake
+      }
+   }
+#endif
+}
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// protected functions
+//
+
+
+//////////////////////////////
+//
+// EventLoop::armTimer -- start a timerfd expiring after the given
+//     number of milliseconds (and then every that many milliseconds if
+//     repeatQ is true).  A negative time stops a one-shot timer, and
+//     a zero time stops a repeating timer.
+//
+
+void EventLoop::armTimer(int fd, double milliseconds, int repeatQ) {
+#ifdef LINUX
+   struct itimerspec spec;
+   memset(&spec, 0, sizeof(spec));
+   if (milliseconds > 0.0 || (milliseconds == 0.0 && !repeatQ)) {
+      long nanoseconds = (long)(milliseconds * 1000000.0);
+      if (nanoseconds < 1) {
+         nanoseconds = 1;         // a zero value would stop the timer
+      }
+      spec.it_value.tv_sec  = nanoseconds / 1000000000L;
+      spec.it_value.tv_nsec = nanoseconds % 1000000000L;
+      if (repeatQ) {
+         spec.it_interval = spec.it_value;
+      }
+   }
+   timerfd_settime(fd, 0, &spec, NULL);
+#endif
+}
+
+
+
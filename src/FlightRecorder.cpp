@@ -0,0 +1,571 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Mon Oct 19 05:31:24 PDT 2026
+// Last Modified: Mon Oct 19 05:31:28 PDT 2026
+// Last Modified: Mon Oct 19 06:31:50 PDT 2026 (per-user file, silences)
+// Last Modified: Mon Oct 19 08:37:05 PDT 2026 (reserve records without a lock)
+// Filename:      ...improv/src/FlightRecorder.cpp
+// Web Address:   http://sig.sapp.org/src/sig/FlightRecorder.cpp
+// Syntax:        C++
+//
+// Description:   Keeps the most recent MIDI traffic on all input and
+//                output ports in a ring of fixed-size records inside a
+//                file which is mapped into memory.  The MIDI input
+//                threads and the output functions only copy a record
+//                into the mapping, so the recorder can be left running
+//                during a performance, and the operating system keeps
+//                the records in the file if the program crashes.
+//
+
+#include "FlightRecorder.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef VISUAL
+   #include <fcntl.h>
+   #include <unistd.h>
+   #include <sys/mman.h>
+#endif
+
+#ifndef OLDCPP
+   #include <iostream>
+   using namespace std;
+#else
+   #include <iostream.h>
+#endif
+
+// declare static variables
+FlightRecorderHeader* FlightRecorder::header      = NULL;
+FlightRecord*         FlightRecorder::ring        = NULL;
+long                  FlightRecorder::mappingSize = 0;
+uint64_t              FlightRecorder::mask        = 0;
+int                   FlightRecorder::shift       = 0;
+volatile long         FlightRecorder::lastTime    = 0;
+volatile int64_t      FlightRecorder::nextMark    = 0;
+volatile int          FlightRecorder::writers     = 0;
+SigTimer              FlightRecorder::clock;
+
+// function declarations:
+static int  messageSize   (int command);
+static long unwrapTime    (long nearTime, int lowBits);
+
+
+//////////////////////////////
+//
+// FlightRecorder::getDefaultFilename -- returns the file used when
+//    start() is not given one: .improv.flight in the home directory,
+//    or a file in /tmp with the user id in its name if there is no
+//    home directory.
+//
+
+const char* FlightRecorder::getDefaultFilename(void) {
+   static char filename[1024] = {0};
+   if (filename[0] != '\0') {
+      return filename;
+   }
+   const char* home = getenv("HOME");
+   if (home != NULL && home[0] != '\0') {
+      snprintf(filename, sizeof(filename), "%s/.improv.flight", home);
+   } else {
+      #ifndef VISUAL
+         snprintf(filename, sizeof(filename), "/tmp/improv-%d.flight",
+               (int)getuid());
+      #else
+         snprintf(filename, sizeof(filename), "improv.flight");
+      #endif
+   }
+   return filename;
+}
+
+
+
+//////////////////////////////
+//
+// FlightRecorder::input -- record a message which arrived on the given
+//    MIDI input port.  A sysex message should be given with all of its
+//    bytes.  The number of bytes in a MidiEvent is found from its
+//    command byte, since the input parsers always store four bytes.
+//    Does nothing if the recorder is not running.
+//
+
+void FlightRecorder::input(int port, const smf::MidiEvent& aMessage) {
+   if (aMessage.size() == 0) {
+      return;
+   }
+   uchar bytes[3];
+   int size = messageSize(aMessage[0]);
+   for (int i=0; i<size; i++) {
+      bytes[i] = i < (int)aMessage.size() ? aMessage[i] : 0;
+   }
+   input(port, bytes, size);
+}
+
+
+void FlightRecorder::input(int port, const uchar* data, int size) {
+   if (port < 0 || port >= FLIGHT_MAX_PORTS) {
+      return;
+   }
+   write(port, data, size);
+}
+
+
+
+//////////////////////////////
+//
+// FlightRecorder::output -- record a message which was sent to the
+//    given MIDI output port.  Does nothing if the recorder is not
+//    running.
+//
+
+void FlightRecorder::output(int port, const uchar* data, int size) {
+   if (port < 0 || port >= FLIGHT_MAX_PORTS) {
+      return;
+   }
+   write(FLIGHT_OUTPUT | port, data, size);
+}
+
+
+
+//////////////////////////////
+//
+// FlightRecorder::read -- read the messages which are in a flight
+//    recorder file, oldest first.  The MIDI bytes of all of the messages
+//    are stored one after another in data.  A message whose first
+//    records were written over is left out.  Returns 0 if the file
+//    could not be read.
+//
+
+int FlightRecorder::read(const char* aFilename,
+      SigCollection<FlightEvent>& events, Array<uchar>& data) {
+   events.setSize(0);
+   data.setSize(0);
+
+   FILE* input = fopen(aFilename, "rb");
+   if (input == NULL) {
+      cerr << "Error: cannot open file " << aFilename << endl;
+      return 0;
+   }
+   FlightRecorderHeader info;
+   if (fread(&info, sizeof(info), 1, input) != 1 ||
+         strncmp(info.magic, FLIGHT_MAGIC, 4) != 0) {
+      cerr << "Error: " << aFilename << " is not a flight recorder file"
+           << endl;
+      fclose(input);
+      return 0;
+   }
+   if (info.byteOrder != 0x01020304) {
+      cerr << "Error: " << aFilename
+           << " was written on a computer with a different byte order"
+           << endl;
+      fclose(input);
+      return 0;
+   }
+   if (info.version != FLIGHT_VERSION) {
+      cerr << "Error: unknown flight recorder version " << info.version
+           << " in " << aFilename << endl;
+      fclose(input);
+      return 0;
+   }
+   int capacity = info.capacity;
+   if (capacity <= 0 || (capacity & (capacity - 1)) != 0) {
+      cerr << "Error: bad ring size in " << aFilename << endl;
+      fclose(input);
+      return 0;
+   }
+   FlightRecord* records = new FlightRecord[capacity];
+   int found = (int)fread(records, sizeof(FlightRecord), capacity, input);
+   fclose(input);
+   if (found != capacity) {
+      cerr << "Error: " << aFilename << " is too short" << endl;
+      delete [] records;
+      return 0;
+   }
+
+   int bits = 0;
+   while ((1 << bits) < capacity) {
+      bits++;
+   }
+
+   // keep the records which were completely written, oldest first
+   SigCollection<FlightRecord*> order;
+   order.setSize(0);
+   order.setGrowth(capacity);
+   int64_t first = info.count > capacity ? info.count - capacity : 0;
+   int64_t n;
+   for (n=first; n<info.count; n++) {
+      FlightRecord* record = &records[n & (capacity - 1)];
+      if (record->lap == (uchar)((n >> bits) % 255 + 1)) {
+         order.append(record);
+      }
+   }
+   int count = (int)order.getSize();
+
+   // rebuild the times from the first mark, going backwards to the
+   // start of the ring and forwards to the end.  Each record has the
+   // low 16 bits of its time, which are unwrapped next to the time of
+   // its neighbor.  A mark after a long silence does not know the time
+   // of the record before it, so the records before such a mark are
+   // left out.
+   Array<long> times(count > 0 ? count : 1);
+   int32_t markTime = 0;
+   int markIndex = 0;
+   int i;
+   for (i=0; i<count; i++) {
+      if ((order[i]->info & FLIGHT_KIND_MASK) == FLIGHT_MARK) {
+         markIndex = i;
+         break;
+      }
+   }
+   if (count > 0) {
+      if ((order[markIndex]->info & FLIGHT_KIND_MASK) == FLIGHT_MARK) {
+         memcpy(&markTime, order[markIndex]->data, 4);
+      }
+      times[markIndex] = markTime;
+   }
+   int firstTimed = 0;
+   if (count > 0 && (order[markIndex]->info & FLIGHT_KIND_MASK) ==
+         FLIGHT_MARK && order[markIndex]->time == FLIGHT_AFTER_SILENCE) {
+      firstTimed = markIndex;
+   }
+   for (i=markIndex-1; i>=firstTimed; i--) {
+      times[i] = unwrapTime(times[i+1], order[i]->time);
+   }
+   for (i=markIndex+1; i<count; i++) {
+      if ((order[i]->info & FLIGHT_KIND_MASK) == FLIGHT_MARK) {
+         memcpy(&markTime, order[i]->data, 4);
+         times[i] = markTime;
+      } else {
+         times[i] = unwrapTime(times[i-1], order[i]->time);
+      }
+   }
+
+   // join the parts of each message
+   FlightEvent event;
+   int pendingQ = 0;
+   for (i=firstTimed; i<count; i++) {
+      FlightRecord& record = *order[i];
+      int kind = record.info & FLIGHT_KIND_MASK;
+      if (kind == FLIGHT_MARK) {
+         continue;
+      }
+      int port    = record.info & FLIGHT_PORT_MASK;
+      int outputQ = (record.info & FLIGHT_OUTPUT) ? 1 : 0;
+      if (pendingQ && (port != event.port || outputQ != event.outputQ)) {
+         data.setSize(event.offset);
+         pendingQ = 0;
+      }
+      if (!pendingQ) {
+         if (record.data[0] < 0x80) {
+            // the start of this message was written over
+            continue;
+         }
+         event.time    = times[i];
+         event.port    = port;
+         event.outputQ = outputQ;
+         event.offset  = (int)data.getSize();
+         event.size    = 0;
+         pendingQ      = 1;
+      }
+      int size = record.data[3] > 3 ? 3 : record.data[3];
+      for (int j=0; j<size; j++) {
+         data.append(record.data[j]);
+      }
+      event.size += size;
+      if (kind == FLIGHT_MESSAGE) {
+         events.append(event);
+         pendingQ = 0;
+      }
+   }
+   if (pendingQ) {
+      data.setSize(event.offset);
+   }
+
+   // messages from different threads can be a little out of order in
+   // the ring, so sort them by time (keeping the order of equal times)
+   int j;
+   for (i=1; i<(int)events.getSize(); i++) {
+      event = events[i];
+      for (j=i; j>0 && events[j-1].time > event.time; j--) {
+         events[j] = events[j-1];
+      }
+      events[j] = event;
+   }
+
+   delete [] records;
+   return 1;
+}
+
+
+
+//////////////////////////////
+//
+// FlightRecorder::recordingQ -- returns true if the recorder is
+//    running.
+//
+
+int FlightRecorder::recordingQ(void) {
+   return ring != NULL;
+}
+
+
+
+//////////////////////////////
+//
+// FlightRecorder::start -- start recording into the given file, which
+//    is made large enough for recordCount records (rounded up to a power
+//    of two).  If no file is given, getDefaultFilename() is used.  An
+//    existing file is renamed with ".old" added to its name, since it
+//    may hold the end of a run which crashed.  The new file is only
+//    made if nothing is in its place, so a link left in a shared
+//    directory cannot send the records somewhere else.  Returns 0 if
+//    the file could not be made.
+//    default values: aFilename = NULL, recordCount = FLIGHT_DEFAULT_SIZE
+//
+
+int FlightRecorder::start(const char* aFilename, int recordCount) {
+   stop();
+
+   #ifdef VISUAL
+      cerr << "Error: the MIDI flight recorder needs memory-mapped files"
+           << endl;
+      return 0;
+   #else
+      int capacity = 1024;
+      int bits = 10;
+      while (capacity < recordCount && bits < 28) {
+         capacity <<= 1;
+         bits++;
+      }
+
+      if (aFilename == NULL || aFilename[0] == '\0') {
+         aFilename = getDefaultFilename();
+      }
+
+      char* oldName = new char[strlen(aFilename) + 5];
+      strcpy(oldName, aFilename);
+      strcat(oldName, ".old");
+      int status = rename(aFilename, oldName);
+      if (status != 0 && errno != ENOENT) {
+         cerr << "Error: cannot rename " << aFilename << " to " << oldName
+              << endl;
+         delete [] oldName;
+         return 0;
+      }
+      delete [] oldName;
+
+      int fd = ::open(aFilename, O_RDWR | O_CREAT | O_EXCL | O_NOFOLLOW,
+            0600);
+      if (fd < 0) {
+         cerr << "Error: cannot make file " << aFilename << endl;
+         return 0;
+      }
+      long size = sizeof(FlightRecorderHeader) +
+            (long)capacity * sizeof(FlightRecord);
+      if (ftruncate(fd, size) != 0) {
+         cerr << "Error: cannot make " << aFilename << " large enough"
+              << endl;
+         ::close(fd);
+         return 0;
+      }
+      void* mapping = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+            fd, 0);
+      ::close(fd);
+      if (mapping == MAP_FAILED) {
+         cerr << "Error: cannot map " << aFilename << " into memory" << endl;
+         return 0;
+      }
+
+      // touch all of the pages now, so that recording a message does
+      // not have to wait for the operating system to find memory
+      memset(mapping, 0, size);
+
+      FlightRecorderHeader* newHeader = (FlightRecorderHeader*)mapping;
+      memcpy(newHeader->magic, FLIGHT_MAGIC, 4);
+      newHeader->byteOrder    = 0x01020304;
+      newHeader->version      = FLIGHT_VERSION;
+      newHeader->capacity     = capacity;
+      newHeader->count        = 0;
+      newHeader->startSeconds = (int64_t)time(NULL);
+
+      mappingSize = size;
+      mask        = capacity - 1;
+      shift       = bits;
+      lastTime    = 0;
+      nextMark    = 0;                    // start with a mark
+      clock.reset();
+      header      = newHeader;
+      __sync_synchronize();       // set up everything before recording
+      ring        = (FlightRecord*)((uchar*)mapping +
+                                    sizeof(FlightRecorderHeader));
+      return 1;
+   #endif
+}
+
+
+
+//////////////////////////////
+//
+// FlightRecorder::stop -- stop recording and close the file.  The
+//    records stay in the file.
+//
+
+void FlightRecorder::stop(void) {
+   #ifndef VISUAL
+      if (header == NULL) {
+         return;
+      }
+      ring = NULL;
+      __sync_synchronize();       // new writers now see that ring is NULL
+      while (writers > 0) {
+         // wait for the messages being recorded
+      }
+      FlightRecorderHeader* mapping = header;
+      header = NULL;
+
+      msync(mapping, mappingSize, MS_SYNC);
+      munmap(mapping, mappingSize);
+      mappingSize = 0;
+   #endif
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// protected functions
+//
+
+
+//////////////////////////////
+//
+// FlightRecorder::write -- store a message in the ring.  The records
+//    for the message, and the marks before it if any are due, are
+//    reserved with one atomic addition to the record count, so that
+//    the parts of a message are always next to each other and no
+//    thread waits for another one.  Two threads may both decide that
+//    a mark is due, which only adds an extra mark.  The count of
+//    writers lets stop() wait until no message is being copied into
+//    the mapping.
+//
+
+void FlightRecorder::write(int info, const uchar* data, int size) {
+   if (ring == NULL || size <= 0) {
+      return;
+   }
+
+   #ifndef VISUAL
+      __sync_fetch_and_add(&writers, 1);   // also a full memory barrier
+
+      if (ring != NULL) {
+         long now = clock.getTime();
+         int silenceQ = now - lastTime > FLIGHT_MAX_SILENCE;
+         int markQ = silenceQ || header->count >= nextMark;
+         int parts = (size + 2) / 3;
+         int total = parts + (markQ ? 1 : 0) + (silenceQ ? 1 : 0);
+         uint64_t number = (uint64_t)__sync_fetch_and_add(&header->count,
+               (int64_t)total);
+
+         FlightRecord record;
+         int32_t markTime;
+         if (silenceQ) {
+            // after a long silence, first mark the time of the previous
+            // record, so that the records before this point can still be
+            // timed if the mark below is the oldest one in the ring
+            markTime = (int32_t)lastTime;
+            record.time = 0;
+            record.info = FLIGHT_MARK;
+            memcpy(record.data, &markTime, 4);
+            writeRecord(number++, record);
+         }
+         if (markQ) {
+            markTime = (int32_t)now;
+            record.time = silenceQ ? FLIGHT_AFTER_SILENCE : 0;
+            record.info = FLIGHT_MARK;
+            memcpy(record.data, &markTime, 4);
+            writeRecord(number, record);
+            nextMark = (int64_t)number + FLIGHT_MARK_SPACING;
+            number++;
+         }
+
+         record.time = (uint16_t)(now & 0xffff);
+         for (int i=0; i<size; i+=3) {
+            int count = size - i > 3 ? 3 : size - i;
+            record.info = (uchar)(info |
+                  (size - i > 3 ? FLIGHT_PART : FLIGHT_MESSAGE));
+            record.data[0] = data[i];
+            record.data[1] = count > 1 ? data[i+1] : 0;
+            record.data[2] = count > 2 ? data[i+2] : 0;
+            record.data[3] = (uchar)count;
+            writeRecord(number++, record);
+         }
+
+         lastTime = now;
+      }
+
+      __sync_fetch_and_sub(&writers, 1);
+   #endif
+}
+
+
+
+//////////////////////////////
+//
+// FlightRecorder::writeRecord -- copy a record into its place in the
+//    ring.  Only write() calls this function, with a record number
+//    which it has reserved.
+//
+
+void FlightRecorder::writeRecord(uint64_t number, FlightRecord& record) {
+   record.lap = (uchar)((number >> shift) % 255 + 1);
+   memcpy(&ring[number & mask], &record, sizeof(FlightRecord));
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// static functions
+//
+
+
+//////////////////////////////
+//
+// messageSize -- returns the number of bytes in a MIDI message which
+//    starts with the given command byte (not counting sysex data).
+//
+
+static int messageSize(int command) {
+   switch (command & 0xf0) {
+      case 0x80: case 0x90: case 0xa0: case 0xb0: case 0xe0:
+         return 3;
+      case 0xc0: case 0xd0:
+         return 2;
+   }
+   switch (command) {
+      case 0xf2:
+         return 3;
+      case 0xf1: case 0xf3:
+         return 2;
+   }
+   return 1;
+}
+
+
+
+//////////////////////////////
+//
+// unwrapTime -- returns the time whose low 16 bits are lowBits and
+//    which is closest to nearTime.
+//
+
+static long unwrapTime(long nearTime, int lowBits) {
+   int16_t difference = (int16_t)(uint16_t)(lowBits - (nearTime & 0xffff));
+   return nearTime + difference;
+}
+
+
+
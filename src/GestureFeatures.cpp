@@ -0,0 +1,228 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Mon Oct 19 02:58:44 PDT 2026
+// Last Modified: Mon Oct 19 02:58:48 PDT 2026
+// Last Modified: Mon Oct 19 07:02:15 PDT 2026 (keep short time steps)
+// Last Modified: Mon Oct 19 08:26:33 PDT 2026 (not a faster pipeline)
+// Filename:      ...improv/src/GestureFeatures.cpp
+// Web Address:   http://sig.sapp.org/src/sig/GestureFeatures.cpp
+// Syntax:        C++
+//
+// Description:   Feature extraction for gestures from the baton, the
+//                stick or MIDI controllers.  A window of the recent
+//                history of a sensor is copied into an array with
+//                loadHistory() (oldest value first), and the other
+//                functions then work on the whole array at once:
+//                smoothing, velocity and acceleration, scaling to a
+//                new range, and finding peaks and onsets.  Each
+//                function is a separate pass over the window, so a
+//                chain of them is a convenience rather than a speedup:
+//                a short chain (such as velocity, average and peaks
+//                over 64 values) is slower than one hand-written loop
+//                over the history with operator[].  A single pass
+//                such as scale() is where they can be faster, since
+//                the loops have no dependencies between elements
+//                (except for lowpass()) and can be vectorized by the
+//                compiler.
+//
+
+#include "GestureFeatures.h"
+
+
+//////////////////////////////
+//
+// GestureFeatures::acceleration -- calculate the acceleration between
+//    each three values which were measured at the given times.
+//    output[i] is the acceleration at times[i+1].  Returns the number
+//    of accelerations, which is count-2.  Times which do not increase
+//    are treated as one time unit apart; other time differences, even
+//    those of less than one unit, are used as they are.
+//
+
+int GestureFeatures::acceleration(double* output, const double* values,
+      const double* times, int count) {
+   for (int i=0; i<count-2; i++) {
+      double dt0 = times[i+1] - times[i];
+      double dt1 = times[i+2] - times[i+1];
+      dt0 = dt0 <= 0.0 ? 1.0 : dt0;
+      dt1 = dt1 <= 0.0 ? 1.0 : dt1;
+      double v0 = (values[i+1] - values[i]) / dt0;
+      double v1 = (values[i+2] - values[i+1]) / dt1;
+      output[i] = 2.0 * (v1 - v0) / (dt0 + dt1);
+   }
+   return count > 2 ? count - 2 : 0;
+}
+
+
+
+//////////////////////////////
+//
+// GestureFeatures::average -- smooth the input with a moving average
+//    of width values.  output[i] is the average of input[i] to
+//    input[i+width-1].  Returns the number of averages, which is
+//    count-width+1.
+//
+
+int GestureFeatures::average(double* output, const double* input, int count,
+      int width) {
+   if (width < 1) {
+      width = 1;
+   }
+   int outCount = count - width + 1;
+   if (outCount <= 0) {
+      return 0;
+   }
+
+   double factor = 1.0 / width;
+   for (int i=0; i<outCount; i++) {
+      double sum = 0.0;
+      for (int j=0; j<width; j++) {
+         sum += input[i+j];
+      }
+      output[i] = sum * factor;
+   }
+   return outCount;
+}
+
+
+
+//////////////////////////////
+//
+// GestureFeatures::difference -- calculate the difference between each
+//    pair of values, multiplied by aScale.  For values measured at a
+//    steady rate, use the rate as the scale to get the velocity.
+//    output[i] is (input[i+1] - input[i]) * aScale.  Returns the number
+//    of differences, which is count-1.
+//    default value: aScale = 1.0
+//
+
+int GestureFeatures::difference(double* output, const double* input,
+      int count, double aScale) {
+   for (int i=0; i<count-1; i++) {
+      output[i] = (input[i+1] - input[i]) * aScale;
+   }
+   return count > 1 ? count - 1 : 0;
+}
+
+
+
+//////////////////////////////
+//
+// GestureFeatures::findOnsets -- find where the input rises to the
+//    threshold: input[i-1] is below the threshold and input[i] is not.
+//    An onset within minSpacing values of the previous onset is
+//    ignored.  The indices of the onsets are stored in indices, up to
+//    maxCount of them.  Returns the number of onsets found.
+//
+
+int GestureFeatures::findOnsets(int* indices, const double* input, int count,
+      double threshold, int minSpacing, int maxCount) {
+   int found = 0;
+   int last = -minSpacing - 1;
+   for (int i=1; i<count && found<maxCount; i++) {
+      if (input[i-1] < threshold && input[i] >= threshold &&
+            i - last > minSpacing) {
+         indices[found++] = i;
+         last = i;
+      }
+   }
+   return found;
+}
+
+
+
+//////////////////////////////
+//
+// GestureFeatures::findPeaks -- find the local maxima of the input which
+//    are at least as large as the threshold.  A peak is larger than the
+//    value before it and not smaller than the value after it, so a flat
+//    peak is found once.  The first and last values cannot be peaks.
+//    The indices of the peaks are stored in indices, up to maxCount of
+//    them.  Returns the number of peaks found.
+//
+
+int GestureFeatures::findPeaks(int* indices, const double* input, int count,
+      double threshold, int maxCount) {
+   int found = 0;
+   for (int i=1; i<count-1 && found<maxCount; i++) {
+      if (input[i] >= threshold && input[i] > input[i-1] &&
+            input[i] >= input[i+1]) {
+         indices[found++] = i;
+      }
+   }
+   return found;
+}
+
+
+
+//////////////////////////////
+//
+// GestureFeatures::lowpass -- smooth the input with a one-pole lowpass
+//    filter: output[i] = output[i-1] + gain * (input[i] - output[i-1]),
+//    starting at input[0].  A gain of 1.0 does no smoothing, and smaller
+//    gains smooth more.  Each output depends on the one before it, so
+//    this loop cannot be vectorized; use average() for large windows.
+//
+
+void GestureFeatures::lowpass(double* output, const double* input, int count,
+      double gain) {
+   if (count <= 0) {
+      return;
+   }
+   double state = input[0];
+   for (int i=0; i<count; i++) {
+      state += gain * (input[i] - state);
+      output[i] = state;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// GestureFeatures::scale -- map the input from the range inMin..inMax
+//    to the range outMin..outMax.  Values outside of the input range are
+//    limited to the ends of the output range.  output can be the same
+//    array as input.
+//
+
+void GestureFeatures::scale(double* output, const double* input, int count,
+      double inMin, double inMax, double outMin, double outMax) {
+   double factor = 0.0;
+   if (inMax != inMin) {
+      factor = (outMax - outMin) / (inMax - inMin);
+   }
+   double low  = outMin < outMax ? outMin : outMax;
+   double high = outMin < outMax ? outMax : outMin;
+   for (int i=0; i<count; i++) {
+      double value = outMin + (input[i] - inMin) * factor;
+      value = value < low  ? low  : value;
+      value = value > high ? high : value;
+      output[i] = value;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// GestureFeatures::velocity -- calculate the velocity between each pair
+//    of values which were measured at the given times.  output[i] is the
+//    velocity between times[i] and times[i+1].  Returns the number of
+//    velocities, which is count-1.  Times which do not increase are
+//    treated as one time unit apart; other time differences, even those
+//    of less than one unit, are used as they are.
+//
+
+int GestureFeatures::velocity(double* output, const double* values,
+      const double* times, int count) {
+   for (int i=0; i<count-1; i++) {
+      double dt = times[i+1] - times[i];
+      dt = dt <= 0.0 ? 1.0 : dt;
+      output[i] = (values[i+1] - values[i]) / dt;
+   }
+   return count > 1 ? count - 1 : 0;
+}
+
+
+
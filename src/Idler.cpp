@@ -2,6 +2,7 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Sat Jan 16 03:46:03 PST 1999
 // Last Modified: Sat Jan 16 06:33:47 PST 1999
+// Last Modified: Mon Oct 19 03:35:12 PDT 2026 (jump ahead on virtual clock)
 // Filename:      ...sig/maint/code/control/Idler/Idler.h
 // Web Address:   http://www-ccrma.stanford.edu/~craig/improv/src/Idler.cpp
 // Syntax:        C++
@@ -13,10 +14,16 @@
 //                variable-sleep time, where the period between
 //                sleep times is fixed (useful for variable duration
 //                event loop iterations.  The class is useful in Unix
-//                MIDI event loops to allow multiprocessing.
+//                MIDI event loops to allow multiprocessing.  When the
+//                VirtualClock is active, the Idler does not sleep but
+//                advances the clock to the next EventBuffer deadline.
 //
 
 #include "Idler.h"
+#include "VirtualClock.h"
+#include "EventBuffer.h"
+
+#include <math.h>
 
 #ifndef VISUAL
    #include <unistd.h>
@@ -32,9 +39,11 @@ Idler::Idler(void) {
    sleepPeriod = 1.0;  // default of one millisecond sleep period
    sleepMode = SLEEP_MODE_SOFT;
    saturation = -1;
+   jumpLimit = 10.0;
 }
 
 Idler::Idler(double aPeriod, int aSleepType) {
+   jumpLimit = 10.0;
    if (aPeriod >= 0.0) {
       sleepPeriod = aPeriod;
    }
@@ -154,6 +163,22 @@ void Idler::setHardSleep(double aPeriod) {
 
 
 
+//////////////////////////////
+//
+// Idler::setJumpLimit -- set the largest number of milliseconds that
+//    the virtual clock is advanced by sleep().  Deadlines which are not
+//    in an EventBuffer, such as a SigTimer checked in the event loop,
+//    can be up to this late with the virtual clock.
+//
+
+void Idler::setJumpLimit(double aLimit) {
+   if (aLimit >= 1.0) {
+      jumpLimit = aLimit;
+   }
+}
+
+
+
 //////////////////////////////
 //
 // Idler::setPeriod --
@@ -191,6 +216,11 @@ void Idler::setSoftSleep(double aPeriod) {
 //
 
 int Idler::sleep(void) {
+   if (VirtualClock::isActive()) {
+      jump();
+      return 1;
+   }
+
    if (sleepMode == SLEEP_MODE_SOFT) {
       millisleep(sleepPeriod);
    } else if (saturation != -1) {
@@ -218,4 +248,40 @@ int Idler::sleep(void) {
 
 
 
+///////////////////////////////////////////////////////////////////////////
+//
+// protected functions
+//
+
+//////////////////////////////
+//
+// Idler::jump -- instead of sleeping, advance the virtual clock to the
+//    next event in any EventBuffer, by at most the jump limit.  If an
+//    event is already due, advance by the sleep period.  The clock
+//    always moves forward by whole milliseconds, so that the event
+//    loop sees the same times on each run.
+//
+
+void Idler::jump(void) {
+   double wait = EventBuffer::getNextWaitTime();
+   double step;
+   if (wait < 0.0) {
+      step = jumpLimit;
+   } else if (wait == 0.0) {
+      step = sleepPeriod;
+   } else {
+      step = wait;
+   }
+   step = ceil(step);
+   if (step > jumpLimit) {
+      step = jumpLimit;
+   }
+   if (step < 1.0) {
+      step = 1.0;
+   }
+   VirtualClock::advance(step);
+}
+
+
+
 // md5sum: 1513dc2ad940943d2f40c03a10592f22 Idler.cpp [20050403]
@@ -0,0 +1,414 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sun Oct 18 13:05:11 PDT 2026
+// Last Modified: Sun Oct 18 13:05:14 PDT 2026
+// Filename:      ...improv/src/LoopStats.cpp
+// Web Address:   http://sig.sapp.org/src/sig/LoopStats.cpp
+// Syntax:        C++
+//
+// Description:   Timing statistics for the event loop of the improv
+//                environments.  The time spent in each phase of a
+//                loop pass (MIDI input, user algorithms, keyboard
+//                checking and idling) is collected into a histogram
+//                with power-of-two microsecond buckets, along with
+//                the loop rate, the number of phases which took longer
+//                than an overrun limit, and samples of the MIDI input
+//                queue depth.  Statistics can be printed on request
+//                and/or written periodically to a file.
+//
+
+#include "LoopStats.h"
+
+#include <stdio.h>
+
+static const char* phaseNames[LOOP_PHASE_COUNT+1] = {
+   "input", "algorithm", "keyboard", "idle", "busy"
+};
+
+
+//////////////////////////////
+//
+// LoopStats::LoopStats --
+//
+
+LoopStats::LoopStats(void) {
+   enabledQ = 1;
+   dumpQ = 0;
+   overrunLimit = 1000.0;
+   reset();
+}
+
+
+
+//////////////////////////////
+//
+// LoopStats::~LoopStats --
+//
+
+LoopStats::~LoopStats() {
+   closeDumpFile();
+}
+
+
+
+//////////////////////////////
+//
+// LoopStats::begin -- call at the start of each pass through the
+//     event loop.  A periodic dump of the statistics is written here
+//     (if requested) so that the time to write the file is not
+//     included in any of the phases.
+//
+
+void LoopStats::begin(void) {
+   if (!enabledQ) {
+      return;
+   }
+   if (dumpQ && dumpTimer.expired()) {
+      dump();
+      dumpTimer.reset();
+   }
+   passStart = lastMark = SigTimer::clockCycles();
+   loopCount++;
+}
+
+
+
+//////////////////////////////
+//
+// LoopStats::closeDumpFile -- stop writing periodic dumps.
+//
+
+void LoopStats::closeDumpFile(void) {
+   if (dumpQ) {
+      dumpFile.close();
+      dumpQ = 0;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// LoopStats::disable -- stop collecting statistics.  The cost of the
+//     begin() and mark() functions is a single test when disabled.
+//
+
+void LoopStats::disable(void) {
+   enabledQ = 0;
+}
+
+
+
+//////////////////////////////
+//
+// LoopStats::dump -- write the current statistics as one line in
+//     the dump file.
+//
+
+void LoopStats::dump(void) {
+   if (!dumpQ) {
+      return;
+   }
+   printRecord(dumpFile);
+   dumpFile.flush();
+}
+
+
+
+//////////////////////////////
+//
+// LoopStats::enable -- start collecting statistics.  The statistics
+//     are reset if they were previously disabled.
+//
+
+void LoopStats::enable(void) {
+   if (!enabledQ) {
+      enabledQ = 1;
+      reset();
+   }
+}
+
+
+
+//////////////////////////////
+//
+// LoopStats::getOverrunTime -- returns the overrun limit in
+//     milliseconds.
+//
+
+double LoopStats::getOverrunTime(void) const {
+   return overrunLimit / 1000.0;
+}
+
+
+
+//////////////////////////////
+//
+// LoopStats::isEnabled -- returns true if collecting statistics.
+//
+
+int LoopStats::isEnabled(void) const {
+   return enabledQ;
+}
+
+
+
+//////////////////////////////
+//
+// LoopStats::mark -- call at the end of each phase of the event loop.
+//     The time since the end of the previous phase (or the start of
+//     the loop pass) is stored for the given phase.  When the idle
+//     phase is marked, the time of the entire pass up to the start
+//     of idling is also stored as the busy time.
+//
+
+void LoopStats::mark(int phase) {
+   if (!enabledQ) {
+      return;
+   }
+   int64bits now = SigTimer::clockCycles();
+   if (phase == LOOP_PHASE_IDLE) {
+      store(LOOP_PHASE_BUSY, (lastMark - passStart) / cyclesPerMicrosecond);
+   }
+   store(phase, (now - lastMark) / cyclesPerMicrosecond);
+   lastMark = now;
+}
+
+
+
+//////////////////////////////
+//
+// LoopStats::print -- print a summary of the statistics for reading
+//     on the terminal.
+//
+
+void LoopStats::print(ostream& out) {
+   char buffer[256];
+   double seconds = getSeconds();
+
+   if (!enabledQ) {
+      out << "Main loop statistics are disabled." << endl;
+      return;
+   }
+
+   sprintf(buffer, "Main loop: %ld passes in %.1f seconds (%.1f passes/sec)",
+         loopCount, seconds, seconds > 0.0 ? loopCount / seconds : 0.0);
+   out << buffer << '\n';
+   sprintf(buffer, "Overrun limit: %.3f ms (idle: %.3f ms)",
+         overrunLimit / 1000.0, 2.0 * overrunLimit / 1000.0);
+   out << buffer << '\n';
+   out << "   phase          mean(us)    max(us)    p50(us)    p99(us)"
+          "  overruns\n";
+   for (int i=0; i<=LOOP_PHASE_COUNT; i++) {
+      sprintf(buffer, "   %-10s %10.1f %10.1f %10.0f %10.0f %9ld",
+            phaseNames[i],
+            count[i] > 0 ? total[i] / count[i] : 0.0,
+            maximum[i],
+            getPercentile(i, 0.50),
+            getPercentile(i, 0.99),
+            overruns[i]);
+      out << buffer << '\n';
+   }
+   sprintf(buffer, "Input queue depth: mean %.2f, max %d",
+         queueSamples > 0 ? queueTotal / queueSamples : 0.0, queueMax);
+   out << buffer << endl;
+}
+
+
+
+//////////////////////////////
+//
+// LoopStats::printRecord -- print the statistics on one line as
+//     space separated key=value pairs.  The histogram of each phase
+//     is given as a comma separated list of bucket counts, where
+//     bucket i counts durations less than 2^i microseconds (and
+//     at least 2^(i-1) microseconds).
+//
+
+void LoopStats::printRecord(ostream& out) {
+   double seconds = getSeconds();
+   int i, j;
+
+   out << "time="   << seconds
+       << " loops=" << loopCount
+       << " rate="  << (seconds > 0.0 ? loopCount / seconds : 0.0);
+   for (i=0; i<=LOOP_PHASE_COUNT; i++) {
+      out << ' ' << phaseNames[i] << ".mean="
+          << (count[i] > 0 ? total[i] / count[i] : 0.0);
+      out << ' ' << phaseNames[i] << ".max="      << maximum[i];
+      out << ' ' << phaseNames[i] << ".overruns=" << overruns[i];
+      out << ' ' << phaseNames[i] << ".hist=";
+      for (j=0; j<LOOP_HISTOGRAM_SIZE; j++) {
+         if (j > 0) {
+            out << ',';
+         }
+         out << histogram[i][j];
+      }
+   }
+   out << " queue.mean=" << (queueSamples > 0 ? queueTotal/queueSamples : 0.0)
+       << " queue.max="  << queueMax
+       << endl;
+}
+
+
+
+//////////////////////////////
+//
+// LoopStats::reset -- clear all statistics.
+//
+
+void LoopStats::reset(void) {
+   int i, j;
+   for (i=0; i<=LOOP_PHASE_COUNT; i++) {
+      count[i]    = 0;
+      overruns[i] = 0;
+      total[i]    = 0.0;
+      maximum[i]  = 0.0;
+      for (j=0; j<LOOP_HISTOGRAM_SIZE; j++) {
+         histogram[i][j] = 0;
+      }
+   }
+   loopCount    = 0;
+   queueSamples = 0;
+   queueTotal   = 0.0;
+   queueMax     = 0;
+
+   cyclesPerMicrosecond = SigTimer::getCpuSpeed() / 1000000.0;
+   if (cyclesPerMicrosecond <= 0.0) {
+      cyclesPerMicrosecond = 1.0;
+   }
+   startCycles = passStart = lastMark = SigTimer::clockCycles();
+}
+
+
+
+//////////////////////////////
+//
+// LoopStats::sampleQueue -- record the number of messages waiting
+//     in the MIDI input queue.
+//
+
+void LoopStats::sampleQueue(int count) {
+   if (!enabledQ) {
+      return;
+   }
+   queueSamples++;
+   queueTotal += count;
+   if (count > queueMax) {
+      queueMax = count;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// LoopStats::setDumpFile -- write the statistics to the given file
+//     every aPeriod seconds.  Returns 0 if the file could not be opened.
+//
+
+int LoopStats::setDumpFile(const char* filename, double aPeriod) {
+   closeDumpFile();
+   dumpFile.open(filename, ios::out);
+   if (!dumpFile.is_open()) {
+      cerr << "Error: cannot open " << filename
+           << " for writing loop statistics" << endl;
+      return 0;
+   }
+   if (aPeriod <= 0.0) {
+      aPeriod = 10.0;
+   }
+   dumpTimer.setPeriod(aPeriod * 1000.0);
+   dumpTimer.reset();
+   dumpQ = 1;
+   return 1;
+}
+
+
+
+//////////////////////////////
+//
+// LoopStats::setOverrunTime -- set the time in milliseconds above
+//     which a phase (or the busy part of a loop pass) is counted as
+//     an overrun.  The idle phase is counted as an overrun when it
+//     takes longer than twice this time.
+//
+
+void LoopStats::setOverrunTime(double milliseconds) {
+   if (milliseconds > 0.0) {
+      overrunLimit = milliseconds * 1000.0;
+   }
+}
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// protected functions
+//
+
+
+//////////////////////////////
+//
+// LoopStats::getPercentile -- returns the upper limit of the histogram
+//     bucket which contains the given fraction of the durations.
+//
+
+double LoopStats::getPercentile(int phase, double fraction) const {
+   if (count[phase] <= 0) {
+      return 0.0;
+   }
+   double target = fraction * count[phase];
+   double sum = 0.0;
+   double limit = 1.0;
+   for (int i=0; i<LOOP_HISTOGRAM_SIZE; i++) {
+      sum += histogram[phase][i];
+      if (sum >= target) {
+         return limit;
+      }
+      limit *= 2.0;
+   }
+   return limit;
+}
+
+
+
+//////////////////////////////
+//
+// LoopStats::getSeconds -- returns the time since the last reset.
+//
+
+double LoopStats::getSeconds(void) const {
+   return (SigTimer::clockCycles() - startCycles) / cyclesPerMicrosecond
+         / 1000000.0;
+}
+
+
+
+//////////////////////////////
+//
+// LoopStats::store -- add a duration to the statistics of a phase.
+//
+
+void LoopStats::store(int phase, double microseconds) {
+   count[phase]++;
+   total[phase] += microseconds;
+   if (microseconds > maximum[phase]) {
+      maximum[phase] = microseconds;
+   }
+
+   double limit = phase == LOOP_PHASE_IDLE ? 2.0 * overrunLimit : overrunLimit;
+   if (microseconds > limit) {
+      overruns[phase]++;
+   }
+
+   int bucket = 0;
+   double upper = 1.0;
+   while (microseconds >= upper && bucket < LOOP_HISTOGRAM_SIZE-1) {
+      upper *= 2.0;
+      bucket++;
+   }
+   histogram[phase][bucket]++;
+}
+
+
+
@@ -0,0 +1,385 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Mon Oct 19 04:12:40 PDT 2026
+// Last Modified: Mon Oct 19 04:12:44 PDT 2026
+// Last Modified: Mon Oct 19 07:41:26 PDT 2026 (port filter, read())
+// Filename:      ...improv/src/MidiCapture.cpp
+// Web Address:   http://sig.sapp.org/src/sig/MidiCapture.cpp
+// Syntax:        C++
+//
+// Description:   Records every MIDI message which arrives on any MIDI
+//                input port, with its time and port number, into a
+//                binary capture file which can be fed back into a
+//                MidiInput with MidiReplay.  The MIDI input threads
+//                only copy each message into a ring buffer for their
+//                port; a background thread writes the ring buffers to
+//                the file, so capturing does not slow down the input.
+//                The capture can be limited to a single input port.
+//
+
+#include "MidiCapture.h"
+
+#include <string.h>
+
+#ifndef VISUAL
+   #include <unistd.h>
+#endif
+
+#ifndef OLDCPP
+   #include <iostream>
+   using namespace std;
+#else
+   #include <iostream.h>
+#endif
+
+#include <algorithm>
+
+#define RING_MASK (MIDI_CAPTURE_RING_SIZE - 1)
+
+// function declarations:
+static bool earlierRecord    (const MidiCaptureRecord& a,
+                              const MidiCaptureRecord& b);
+
+// declare static variables
+FILE*                 MidiCapture::output   = NULL;
+uchar*                MidiCapture::ring     = NULL;
+volatile unsigned int MidiCapture::writeCount[MIDI_CAPTURE_MAX_PORTS] = {0};
+volatile unsigned int MidiCapture::readCount[MIDI_CAPTURE_MAX_PORTS]  = {0};
+long                  MidiCapture::count[MIDI_CAPTURE_MAX_PORTS]      = {0};
+long                  MidiCapture::dropped[MIDI_CAPTURE_MAX_PORTS]    = {0};
+volatile int          MidiCapture::runningQ = 0;
+int                   MidiCapture::onlyPort = -1;
+#ifndef VISUAL
+   pthread_t          MidiCapture::writer;
+#endif
+
+
+//////////////////////////////
+//
+// MidiCapture::getCount -- returns the number of messages captured
+//    since the capture was started.
+//
+
+long MidiCapture::getCount(void) {
+   long sum = 0;
+   for (int i=0; i<MIDI_CAPTURE_MAX_PORTS; i++) {
+      sum += count[i];
+   }
+   return sum;
+}
+
+
+
+//////////////////////////////
+//
+// MidiCapture::getDropped -- returns the number of messages which were
+//    not captured because the file could not be written quickly enough.
+//
+
+long MidiCapture::getDropped(void) {
+   long sum = 0;
+   for (int i=0; i<MIDI_CAPTURE_MAX_PORTS; i++) {
+      sum += dropped[i];
+   }
+   return sum;
+}
+
+
+
+//////////////////////////////
+//
+// MidiCapture::record -- store a message which arrived on the given
+//    input port.  For a sysex message, give the sysex bytes as well;
+//    they are stored instead of the message.  Messages from other
+//    ports are ignored if the capture was started for a single port.
+//    Only the MIDI input thread for the port should call this function.
+//    It does not allocate memory or wait for the file.
+//    default values: sysex = NULL, sysexSize = 0
+//
+
+void MidiCapture::record(int port, const smf::MidiEvent& aMessage,
+      const uchar* sysex, int sysexSize) {
+   if (!runningQ || port < 0 || port >= MIDI_CAPTURE_MAX_PORTS) {
+      return;
+   }
+   if (onlyPort >= 0 && port != onlyPort) {
+      return;
+   }
+
+   int length = sysex != NULL ? sysexSize : (int)aMessage.size();
+   unsigned int size = MIDI_CAPTURE_RECORD_SIZE + length;
+   unsigned int space = MIDI_CAPTURE_RING_SIZE -
+         (writeCount[port] - readCount[port]);
+   if (length > 0xffff || size > space) {
+      dropped[port]++;
+      return;
+   }
+
+   uchar header[MIDI_CAPTURE_RECORD_SIZE];
+   unsigned long time = (unsigned long)aMessage.tick;
+   header[0] = (uchar)(time & 0xff);
+   header[1] = (uchar)((time >> 8) & 0xff);
+   header[2] = (uchar)((time >> 16) & 0xff);
+   header[3] = (uchar)((time >> 24) & 0xff);
+   header[4] = (uchar)port;
+   header[5] = (uchar)(length & 0xff);
+   header[6] = (uchar)((length >> 8) & 0xff);
+
+   #ifdef VISUAL
+      // no writing thread without pthreads, so write to the file
+      fwrite(header, MIDI_CAPTURE_RECORD_SIZE, 1, output);
+      for (int j=0; j<length; j++) {
+         uchar datum = sysex != NULL ? sysex[j] : (uchar)aMessage[j];
+         fwrite(&datum, 1, 1, output);
+      }
+      count[port]++;
+   #else
+      uchar* base = ring + port * MIDI_CAPTURE_RING_SIZE;
+      unsigned int position = writeCount[port];
+      int i;
+      for (i=0; i<MIDI_CAPTURE_RECORD_SIZE; i++) {
+         base[(position++) & RING_MASK] = header[i];
+      }
+      for (i=0; i<length; i++) {
+         base[(position++) & RING_MASK] = sysex != NULL ? sysex[i] :
+               (uchar)aMessage[i];
+      }
+      __sync_synchronize();       // the record must be complete first
+      writeCount[port] = position;
+      count[port]++;
+   #endif
+}
+
+
+
+//////////////////////////////
+//
+// MidiCapture::read -- read a capture file written by MidiCapture.  The
+//    MIDI bytes of all messages are stored one after another in data,
+//    and each record gives the location of its bytes.  The records are
+//    sorted into time order.  Returns 0 if the file could not be read.
+//
+
+int MidiCapture::read(const char* aFilename,
+      SigCollection<MidiCaptureRecord>& records, Array<uchar>& data) {
+   records.setSize(0);
+   data.setSize(0);
+   FILE* input = fopen(aFilename, "rb");
+   if (input == NULL) {
+      cerr << "Error: cannot open file " << aFilename << endl;
+      return 0;
+   }
+
+   uchar header[MIDI_CAPTURE_HEADER_SIZE];
+   if (fread(header, MIDI_CAPTURE_HEADER_SIZE, 1, input) != 1 ||
+         strncmp((char*)header, MIDI_CAPTURE_MAGIC, 4) != 0) {
+      cerr << "Error: " << aFilename << " is not a MIDI capture file"
+           << endl;
+      fclose(input);
+      return 0;
+   }
+   int version = header[4] | (header[5] << 8) | (header[6] << 16) |
+         (header[7] << 24);
+   if (version != MIDI_CAPTURE_VERSION) {
+      cerr << "Error: unknown MIDI capture version " << version
+           << " in " << aFilename << endl;
+      fclose(input);
+      return 0;
+   }
+
+   uchar buffer[MIDI_CAPTURE_RECORD_SIZE];
+   MidiCaptureRecord record;
+   while (fread(buffer, MIDI_CAPTURE_RECORD_SIZE, 1, input) == 1) {
+      record.time = (long)((unsigned long)buffer[0] |
+            ((unsigned long)buffer[1] << 8) |
+            ((unsigned long)buffer[2] << 16) |
+            ((unsigned long)buffer[3] << 24));
+      record.port   = buffer[4];
+      record.length = buffer[5] | (buffer[6] << 8);
+      record.offset = data.getSize();
+      data.setSize(record.offset + record.length);
+      if (record.length > 0 && fread(data.getBase() + record.offset,
+            record.length, 1, input) != 1) {
+         cerr << "Warning: " << aFilename << " ends in the middle of a "
+              << "message" << endl;
+         data.setSize(record.offset);
+         break;
+      }
+      if (record.length > 0) {
+         records.append(record);
+      }
+   }
+   fclose(input);
+
+   // each port is written in its own blocks, so put the ports together
+   std::stable_sort(records.getBase(), records.getBase() + records.getSize(),
+         earlierRecord);
+   return 1;
+}
+
+
+
+//////////////////////////////
+//
+// MidiCapture::recordingQ -- returns true if MIDI input is being
+//    captured.
+//
+
+int MidiCapture::recordingQ(void) {
+   return runningQ;
+}
+
+
+
+//////////////////////////////
+//
+// MidiCapture::start -- start capturing MIDI input into the given
+//    file.  Give a port number to capture only the messages which
+//    arrive on that port, or -1 to capture all input ports.  Returns
+//    0 if the file could not be opened.
+//    default value: aPort = -1
+//
+
+int MidiCapture::start(const char* aFilename, int aPort) {
+   stop();
+   output = fopen(aFilename, "wb");
+   if (output == NULL) {
+      cerr << "Error: cannot open file " << aFilename << endl;
+      return 0;
+   }
+
+   uchar header[MIDI_CAPTURE_HEADER_SIZE];
+   int version = MIDI_CAPTURE_VERSION;
+   for (int i=0; i<4; i++) {
+      header[i] = MIDI_CAPTURE_MAGIC[i];
+      header[4+i] = (uchar)((version >> (8 * i)) & 0xff);
+   }
+   fwrite(header, MIDI_CAPTURE_HEADER_SIZE, 1, output);
+
+   #ifndef VISUAL
+      if (ring == NULL) {
+         ring = new uchar[MIDI_CAPTURE_MAX_PORTS * MIDI_CAPTURE_RING_SIZE];
+      }
+   #endif
+   for (int j=0; j<MIDI_CAPTURE_MAX_PORTS; j++) {
+      writeCount[j] = 0;
+      readCount[j]  = 0;
+      count[j]      = 0;
+      dropped[j]    = 0;
+   }
+   onlyPort = aPort;
+   #ifndef VISUAL
+      __sync_synchronize();       // clear the rings before input uses them
+   #endif
+   runningQ = 1;
+
+   #ifndef VISUAL
+      if (pthread_create(&writer, NULL, writeLoop, NULL) != 0) {
+         cerr << "Error: cannot start MIDI capture thread" << endl;
+         runningQ = 0;
+         fclose(output);
+         output = NULL;
+         return 0;
+      }
+   #endif
+
+   return 1;
+}
+
+
+
+//////////////////////////////
+//
+// MidiCapture::stop -- stop capturing, write the remaining messages
+//    and close the capture file.
+//
+
+void MidiCapture::stop(void) {
+   if (output == NULL) {
+      return;
+   }
+   runningQ = 0;
+   #ifndef VISUAL
+      pthread_join(writer, NULL);
+      writeRecords();
+   #endif
+   fclose(output);
+   output = NULL;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// protected functions
+//
+
+
+//////////////////////////////
+//
+// MidiCapture::writeRecords -- write the records in the ring buffers
+//    to the file.  Only the writing thread (or stop(), after the writing
+//    thread has finished) calls this function.
+//
+
+void MidiCapture::writeRecords(void) {
+   #ifndef VISUAL
+      for (int port=0; port<MIDI_CAPTURE_MAX_PORTS; port++) {
+         uchar* base = ring + port * MIDI_CAPTURE_RING_SIZE;
+         unsigned int available = writeCount[port] - readCount[port];
+         __sync_synchronize();    // read the records after the count
+         while (available > 0) {
+            unsigned int first = readCount[port] & RING_MASK;
+            unsigned int chunk = MIDI_CAPTURE_RING_SIZE - first;
+            if (chunk > available) {
+               chunk = available;
+            }
+            fwrite(base + first, 1, chunk, output);
+            __sync_synchronize(); // finish reading before freeing space
+            readCount[port] = readCount[port] + chunk;
+            available -= chunk;
+         }
+      }
+   #endif
+}
+
+
+
+#ifndef VISUAL
+
+//////////////////////////////
+//
+// MidiCapture::writeLoop -- write the ring buffers to the file every
+//    10 milliseconds until the capture is stopped.
+//
+
+void* MidiCapture::writeLoop(void*) {
+   while (runningQ) {
+      writeRecords();
+      usleep(10000);
+   }
+   return NULL;
+}
+
+#endif
+
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// static functions
+//
+
+
+//////////////////////////////
+//
+// earlierRecord -- sort records by time; equal times keep their order.
+//
+
+static bool earlierRecord(const MidiCaptureRecord& a,
+      const MidiCaptureRecord& b) {
+   return a.time < b.time;
+}
+
+
+
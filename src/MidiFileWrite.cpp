@@ -3,6 +3,7 @@
 // Creation Date: Sun Mar 15 10:55:56 GMT-0800 1998
 // Last Modified: Sun Mar 15 10:55:56 GMT-0800 1998
 // Last Modified: Sun Jan 18 22:30:45 PST 2004 (fixed bug in close())
+// Last Modified: Mon Oct 19 05:31:24 PDT 2026 (one track in the header)
 // Filename:      ...sig/code/control/MidiFileWrite/MidiFileWrite.cpp
 // Web Address:   http://www-ccrma.stanford.edu/~craig/improv/src/MidiFileWrite.cpp
 // Syntax:        C++ 
@@ -97,7 +98,7 @@ void MidiFileWrite::setup(const char* aFilename, int startTime) {
    *midifile << "MThd";                    // file identification: MIDI file
    midifile->writeBigEndian(6L);          // size of header (always 6)
    midifile->writeBigEndian((short)0);    // format: type 0;
-   midifile->writeBigEndian((short)0);    // num of tracks (always 0 for type 0)
+   midifile->writeBigEndian((short)1);    // num of tracks (always 1 for type 0)
    midifile->writeBigEndian((short)1000); // divisions per quarter note
    
 
@@ -2,6 +2,7 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: 21 December 1997
 // Last Modified: Sun Jan 25 15:45:18 GMT-0800 1998
+// Last Modified: Mon Oct 19 05:02:36 PDT 2026 (added getStats)
 // Filename:      ...sig/code/control/MidiIO/MidiIO.cpp
 // Web Address:   http://www-ccrma.stanford.edu/~craig/improv/src/MidiIO.cpp
 // Syntax:        C++
@@ -166,6 +167,25 @@ int MidiIO::getOutputTrace(void) {
 
 
 
+//////////////////////////////
+//
+// MidiIO::getStats -- store the counters of the input port and of the
+//    output port in stats.  If resetQ is true, the counters start again
+//    from zero after they are read.
+//    default value: resetQ = 0
+//
+
+void MidiIO::getStats(MidiPortStats& stats, int resetQ) {
+   MidiPortStats output;
+   MidiInput::getStats(stats, resetQ);
+   MidiOutput::getStats(output, resetQ);
+   stats.bytesOut    = output.bytesOut;
+   stats.messagesOut = output.messagesOut;
+   stats.sendErrors  = output.sendErrors;
+}
+
+
+
 //////////////////////////////
 //
 // MidiIO::open --
@@ -5,6 +5,13 @@
 // Last Modified: Fri Oct 26 14:41:36 PDT 2001 (running status for 0xa0 and 0xd0
 //                                              fixed by Daniel Gardner)
 // Last Modified: Mon Nov 19 17:52:15 PST 2001 (thread on exit improved)
+// Last Modified: Sun Oct 18 11:20:04 PDT 2026 (byte parsing moved to MidiParser)
+// Last Modified: Sun Oct 18 14:40:27 PDT 2026 (wake up the EventLoop on input)
+// Last Modified: Sun Oct 18 15:31:08 PDT 2026 (preallocate for realtime use)
+// Last Modified: Mon Oct 19 04:12:40 PDT 2026 (capture input with MidiCapture)
+// Last Modified: Mon Oct 19 04:51:07 PDT 2026 (count traffic in MidiStats)
+// Last Modified: Mon Oct 19 05:31:24 PDT 2026 (record in FlightRecorder)
+// Last Modified: Mon Oct 19 06:14:08 PDT 2026 (shared prepare())
 // Filename:      ...sig/code/control/MidiInPort/linux/MidiInPort_alsa.cpp
 // Web Address:   http://sig.sapp.org/src/sig/MidiInPort_alsa.cpp
 // Syntax:        C++ 
@@ -17,6 +24,12 @@
 #if defined(LINUX) && defined(ALSA)
 
 #include "MidiInPort_alsa.h"
+#include "MidiParser.h"
+#include "EventLoop.h"
+#include "MidiCapture.h"
+#include "FlightRecorder.h"
+#include "MidiStats.h"
+#include "RealtimeCheck.h"
 
 #include <stdlib.h>
 #include <pthread.h>
@@ -35,6 +48,7 @@
 #endif
 
 #define DEFAULT_INPUT_BUFFER_SIZE (1024)
+#define DEFAULT_SYSEX_RESERVE     (256)   /* preallocated bytes per sysex */
 
 // initialized static variables
 
@@ -107,21 +121,22 @@ MidiInPort_alsa::~MidiInPort_alsa() {
 //////////////////////////////
 //
 // MidiInPort_alsa::clearSysex -- clears the data from a sysex
-//      message and sets the allocation size to the default size (of 32
-//      bytes).
+//      message and sets the allocation size back to the default size
+//      if a large message was stored in it.
 //
 
 void MidiInPort_alsa::clearSysex(int buffer) {
-   buffer = 0x7f | buffer;    // limit buffer range from 0 to 127
+   buffer &= 0x7f;            // limit buffer range from 0 to 127
  
    if (getPort() == -1) {
       return;
    }
    
    sysexBuffers[getPort()][buffer].setSize(0);
-   if (sysexBuffers[getPort()][buffer].getAllocSize() != 32) {
+   if (sysexBuffers[getPort()][buffer].getAllocSize() >
+         DEFAULT_SYSEX_RESERVE) {
       // shrink the storage buffer's size if necessary
-      sysexBuffers[getPort()][buffer].setAllocSize(32);
+      sysexBuffers[getPort()][buffer].setAllocSize(DEFAULT_SYSEX_RESERVE);
    }
 }
 
@@ -456,6 +471,7 @@ void MidiInPort_alsa::setBufferSize(int aSize) {
    if (getPort() == -1)  return;
 
    midiBuffer[getPort()]->setSize(aSize);
+   RealtimeCheck::prepare(*midiBuffer[getPort()]);
 }
 
 
@@ -666,12 +682,13 @@ void MidiInPort_alsa::initialize(void) {
          pauseQ[i] = 0;
          midiBuffer[i] = new CircularBuffer<smf::MidiEvent>;
          midiBuffer[i]->setSize(DEFAULT_INPUT_BUFFER_SIZE);
+         RealtimeCheck::prepare(*midiBuffer[i]);
 
          sysexWriteBuffer[i] = 0;
          sysexBuffers[i] = new Array<uchar>[128];
          for (int n=0; n<128; n++) {
             sysexBuffers[i][n].allowGrowth(0);      // shouldn't need to grow
-            sysexBuffers[i][n].setAllocSize(32);
+            sysexBuffers[i][n].setAllocSize(DEFAULT_SYSEX_RESERVE);
             sysexBuffers[i][n].setSize(0);
             sysexBuffers[i][n].setGrowth(32);       // in case it will ever grow
          }
@@ -764,42 +781,19 @@ void *interpretMidiInputStreamPrivateALSA(void * arg) {
       return NULL;
    }
 
-   int* argsExpected = NULL;     // MIDI parameter bytes expected to follow
-   int* argsLeft     = NULL;     // MIDI parameter bytes left to wait for
+   MidiParser parser;            // converts input bytes into MIDI messages
    uchar packet[1];              // bytes for sequencer driver
-   smf::MidiEvent* message = NULL;  // holder for current MIDI message
-   int newSigTime = 0;           // for millisecond timer
-   // int lastSigTime = -1;         // for millisecond timer
    int zeroSigTime = -1;         // for timing incoming events
    int device = -1;              // for sorting out the bytes by input device
-   Array<uchar>* sysexIn;        // MIDI Input sysex temporary storage
-
-   // Note on the use of argsExpected and argsLeft for sysexs:
-   // If argsExpected is -1, then a sysex message is coming in.
-   // If argsLeft < 0, then the sysex message has not finished comming
-   // in.  If argsLeft == 0 and argsExpected == -1, then the sysex
-   // has finished coming in and is to be sent to the correct
-   // location.
-
-   // allocate space for MIDI messages, each device has a different message
-   // holding spot in case the messages overlap in the input stream
-   message      = new smf::MidiEvent[MidiInPort_alsa::numDevices];
-   argsExpected = new int[MidiInPort_alsa::numDevices];
-   argsLeft     = new int[MidiInPort_alsa::numDevices];
-
-   sysexIn = new Array<uchar>[MidiInPort_alsa::numDevices];
-   for (int j=0; j<MidiInPort_alsa::numDevices; j++) {
-      sysexIn[j].allowGrowth();
-      sysexIn[j].setSize(32);
-      sysexIn[j].setSize(0);
-      sysexIn[j].setGrowth(512);
-   }
+   parser.setPort(portToWatch);
+
+   // no memory allocation from this point on (see RealtimeCheck)
+   RealtimeCheck::enterThread();
 
    // interpret MIDI bytes as they come into the computer
    // and repackage them as MIDI messages.
    int packetReadCount;
    while (1) {
-top_of_loop:
       packetReadCount = 0;
 
       // If the all Sequencer_alsa classes have been deleted,
@@ -837,177 +831,75 @@ top_of_loop:
       // stream is based here on the observation that MIDI status
       // bytes and subsequent data bytes are NOT returned in the same
       // read() call.  Rather, they are spread out over multiple read()
-      // returns, with only a single value per return.  So if we
-      // find a status byte, we then determine the number of expected
-      // operands and process that number of subsequent read()s to
-      // to determine the complete midi message.
+      // returns, with only a single value per return.  So the bytes
+      // are given to the parser one at a time, and it reports when
+      // a complete message has been assembled.
 
       // store the MIDI input device to which the incoming MIDI
       // byte belongs.
       device = portToWatch;
-     
-      // ignore the active sensing 0xfe and MIDI clock 0xf8 commands:
-      if (packet[0] == 0xfe || packet[0] == 0xf8) {
+
+      if (!parser.parse(packet[0],
+            MidiInPort_alsa::midiTimer.getTime() - zeroSigTime)) {
          continue;
       }
 
-      if (packet[0] & 0x80) {   // a command byte has arrived
-         switch (packet[0] & 0xf0) {
-            case 0xf0:   
-               if (packet[0] == 0xf0) {
-                  argsExpected[device] = -1;
-                  argsLeft[device] = -1;
-                  if (sysexIn[device].getSize() != 0) {
-                     // ignore the command for now.  It is most
-                     // likely an active sensing message.
-                     goto top_of_loop;
-                  } else {
-                     uchar datum = 0xf0;
-                     sysexIn[device].append(datum);
-                  }
-               } if (packet[0] == 0xf7) {
-                  argsLeft[device] = 0;         // indicates sysex is done
-                  uchar datum = 0xf7;
-                  sysexIn[device].append(datum);
-               } else if (argsExpected[device] != -1) {
-                  // this is a system message that may or may
-                  // not be coming while a sysex is coming in
-                  argsExpected[device] = 0;
-               } else {
-                  // this is a system message that is not coming
-                  // while a system exclusive is coming in
-                  //argsExpected[device] = 0;
-               }
-               break;
-            case 0xc0:   
-               if (argsExpected[device] < 0) {
-                  cout << "Error: received program change during sysex" 
-                       << endl;
-                  exit(1);
-               } else {
-                  argsExpected[device] = 1;    
-               }
-               break;
-            case 0xd0:   
-               if (argsExpected[device] < 0) {
-                  cout << "Error: received aftertouch message during" 
-                          " sysex" << endl;
-                  exit(1);
-               } else {
-                  argsExpected[device] = 1;    
-               }
-               break;
-            default:     
-               if (argsExpected[device] < 0) {
-                  cout << "Error: received another message during sysex" 
-                       << endl;
-                  exit(1);
-               } else {
-                  argsExpected[device] = 2;    
-               }
-               break;
-         }
-         if (argsExpected[device] >= 0) {
-            argsLeft[device] = argsExpected[device];
-         }
-
-         newSigTime = MidiInPort_alsa::midiTimer.getTime();
-         message[device].tick = newSigTime - zeroSigTime;
+      smf::MidiEvent& message = parser.getMessage();
 
-         if (packet[0] != 0xf7) {
-            message[device].setP0(packet[0]);
-         } 
-         message[device].setP1(0);
-         message[device].setP2(0);
-         message[device].setP3(0);
+      // keep every message in the flight recorder, even when paused
+      if (parser.isSysex()) {
+         FlightRecorder::input(device, parser.getSysexData(),
+               parser.getSysexSize());
+      } else {
+         FlightRecorder::input(device, message);
+      }
 
-         if (packet[0] == 0xf7) {
-            goto sysex_done;
-         }
-      } else if (argsLeft[device]) {   // not a command byte coming in
-         if (message[device].tick == 0) {
-            // store the receipt time of the first message byte
-            newSigTime = MidiInPort_alsa::midiTimer.getTime();
-            message[device].tick = newSigTime - zeroSigTime;
-         }
-            
-         if (argsExpected[device] < 0) {
-            // continue processing a sysex message
-            sysexIn[device].append(packet[0]);
+      // insert the MIDI message into the appropriate buffer
+      // do not insert into buffer if the MIDI input device
+      // is paused (which can mean closed).  Or if the
+      // pauseQ array is pointing to NULL (which probably means that
+      // things are about to shut down).
+      if (MidiInPort_alsa::pauseQ != NULL &&
+            MidiInPort_alsa::pauseQ[device] == 0) {
+         if (parser.isSysex()) {
+            // store the sysex in the MidiInPort_alsa
+            // buffer for sysexs and return the storage
+            // location:
+            int sysexlocation = 
+               MidiInPort_alsa::installSysexPrivate(device,
+                  parser.getSysexData(), parser.getSysexSize());
+
+            message.setP0(0xf0);
+            message.setP1(sysexlocation);
+
+            MidiCapture::record(device, message, parser.getSysexData(),
+                  parser.getSysexSize());
+            parser.clearSysex();   // also no running status for sysex
          } else {
-            // handle a message other than a sysex message
-            if (argsLeft[device] == argsExpected[device]) {
-               message[device].setP1(packet[0]);
-            } else {
-               message[device].setP2(packet[0]);
-            }
-            argsLeft[device]--;
+            MidiCapture::record(device, message);
          }
-
-         // if MIDI message is complete, setup for running status, and 
-         // insert note into proper buffer.
-
-         if (argsExpected[device] >= 0 && !argsLeft[device]) {
-
-            // store parameter data for running status
-            switch (message[device].getP0() & 0xf0) {
-               case 0xc0:      argsLeft[device] = 1;      break;
-               case 0xd0:      argsLeft[device] = 1;      break;  // fix by dan
-               default:        argsLeft[device] = 2;      break;
-                  // 0x80 expects two arguments
-                  // 0x90 expects two arguments
-                  // 0xa0 expects two arguments
-                  // 0xb0 expects two arguments
-                  // 0xe0 expects two arguments
-            }
-
-            // lastSigTime = newSigTime;
-
-            sysex_done:      // come here when a sysex is completely done
-
-            // insert the MIDI message into the appropriate buffer
-            // do not insert into buffer if the MIDI input device
-            // is paused (which can mean closed).  Or if the
-            // pauseQ array is pointing to NULL (which probably means that
-            // things are about to shut down).
-            if (MidiInPort_alsa::pauseQ != NULL &&
-                  MidiInPort_alsa::pauseQ[device] == 0) {
-               if (argsExpected[device] < 0) {
-                  // store the sysex in the MidiInPort_alsa
-                  // buffer for sysexs and return the storage
-                  // location:
-                  int sysexlocation = 
-                     MidiInPort_alsa::installSysexPrivate(device,
-                        sysexIn[device].getBase(),
-                        sysexIn[device].getSize());
-
-                  message[device].setP0(0xf0);
-                  message[device].setP1(sysexlocation);
-
-                  sysexIn[device].setSize(0); // empty the sysex storage
-                  argsExpected[device] = 0;   // no run status for sysex
-                  argsLeft[device] = 0;       // turn off sysex input flag
-               }
-               MidiInPort_alsa::midiBuffer[device]->insert(
-                     message[device]);
-//                   if (MidiInPort_alsa::callbackFunction != NULL) {
-//                      MidiInPort_alsa::callbackFunction(device);
-//                   }
-               if (MidiInPort_alsa::trace[device]) {
-                  cout << '[' << hex << (int)message[device].getP0()
-                       << ':' << dec << (int)message[device].getP1()
-                       << ',' << (int)message[device].getP2() << ']'
-                       << flush;
-               }
-               message[device].tick = 0;
-            } else {
-               if (MidiInPort_alsa::trace[device]) {
-                  cout << '[' << hex << (int)message[device].getP0()
-                       << 'P' << dec << (int)message[device].getP1()
-                       << ',' << (int)message[device].getP2() << ']'
-                       << flush;
-               }
-            }
+         MidiStats::inputMessage(device,
+               MidiInPort_alsa::midiBuffer[device]->getCount(),
+               MidiInPort_alsa::midiBuffer[device]->getSize());
+         MidiInPort_alsa::midiBuffer[device]->insert(message);
+         EventLoop::signalInput();
+//       if (MidiInPort_alsa::callbackFunction != NULL) {
+//          MidiInPort_alsa::callbackFunction(device);
+//       }
+         if (MidiInPort_alsa::trace[device]) {
+            cout << '[' << hex << (int)message.getP0()
+                 << ':' << dec << (int)message.getP1()
+                 << ',' << (int)message.getP2() << ']'
+                 << flush;
+         }
+         message.tick = 0;
+      } else {
+         MidiStats::inputDropped(device);
+         if (MidiInPort_alsa::trace[device]) {
+            cout << '[' << hex << (int)message.getP0()
+                 << 'P' << dec << (int)message.getP1()
+                 << ',' << (int)message.getP2() << ']'
+                 << flush;
          }
       }
 
@@ -1015,27 +907,6 @@ top_of_loop:
 
    // This code is not yet reached, but should be made to do so eventually
 
-   if (message != NULL) {
-      delete message;
-      message = NULL;
-   }
-
-   if (argsExpected != NULL) {
-      delete argsExpected;
-      argsExpected = NULL;
-   }
-
-   if (argsLeft != NULL) {
-      delete argsLeft;
-      argsLeft = NULL;
-   }
-
-   if (sysexIn != NULL) { 
-      delete sysexIn;
-      sysexIn = NULL;
-   }
-
-
    return NULL;
 }
 
@@ -8,6 +8,12 @@
 // Last Modified: Wed May 10 17:10:05 PDT 2000 (name change from _linux to _oss)
 // Last Modified: Fri Oct 26 14:41:36 PDT 2001 (running status for 0xa0 and 0xd0 
 //                                              fixed by Daniel Gardner)
+// Last Modified: Sun Oct 18 14:40:27 PDT 2026 (wake up the EventLoop on input)
+// Last Modified: Sun Oct 18 15:31:08 PDT 2026 (preallocate for realtime use)
+// Last Modified: Mon Oct 19 04:12:40 PDT 2026 (capture input with MidiCapture)
+// Last Modified: Mon Oct 19 04:51:07 PDT 2026 (count traffic in MidiStats)
+// Last Modified: Mon Oct 19 05:31:24 PDT 2026 (record in FlightRecorder)
+// Last Modified: Mon Oct 19 06:14:08 PDT 2026 (shared prepare())
 // Filename:      ...sig/code/control/MidiInPort/linux/MidiInPort_oss.cpp
 // Web Address:   http://sig.sapp.org/src/sig/MidiInPort_oss.cpp
 // Syntax:        C++ 
@@ -21,6 +27,11 @@
 
 using namespace std;
 #include "MidiInPort_oss.h"
+#include "EventLoop.h"
+#include "MidiCapture.h"
+#include "FlightRecorder.h"
+#include "MidiStats.h"
+#include "RealtimeCheck.h"
 #include <stdlib.h>
 #include <pthread.h>
 #include <linux/soundcard.h>
@@ -33,6 +44,7 @@ using namespace std;
 #endif
 
 #define DEFAULT_INPUT_BUFFER_SIZE (1024)
+#define DEFAULT_SYSEX_RESERVE     (256)   /* preallocated bytes per sysex */
 
 // initialized static variables
 int       MidiInPort_oss::numDevices                     = 0;
@@ -102,20 +114,21 @@ MidiInPort_oss::~MidiInPort_oss() {
 //////////////////////////////
 //
 // MidiInPort_oss::clearSysex -- clears the data from a sysex
-//      message and sets the allocation size to the default size (of 32
-//      bytes).
+//      message and sets the allocation size back to the default size
+//      if a large message was stored in it.
 //
 
 void MidiInPort_oss::clearSysex(int buffer) {
-   buffer = 0x7f | buffer;    // limit buffer range from 0 to 127
+   buffer &= 0x7f;            // limit buffer range from 0 to 127
    if (getPort() == -1) {
       return;
    }
    
    sysexBuffers[getPort()][buffer].setSize(0);
-   if (sysexBuffers[getPort()][buffer].getAllocSize() != 32) {
+   if (sysexBuffers[getPort()][buffer].getAllocSize() >
+         DEFAULT_SYSEX_RESERVE) {
       // shrink the storage buffer's size if necessary
-      sysexBuffers[getPort()][buffer].setAllocSize(32);
+      sysexBuffers[getPort()][buffer].setAllocSize(DEFAULT_SYSEX_RESERVE);
    }
 }
 
@@ -437,6 +450,7 @@ void MidiInPort_oss::setBufferSize(int aSize) {
    if (getPort() == -1)  return;
 
    midiBuffer[getPort()]->setSize(aSize);
+   RealtimeCheck::prepare(*midiBuffer[getPort()]);
 }
 
 
@@ -644,12 +658,13 @@ void MidiInPort_oss::initialize(void) {
          pauseQ[i] = 0;
          midiBuffer[i] = new CircularBuffer<smf::MidiEvent>;
          midiBuffer[i]->setSize(DEFAULT_INPUT_BUFFER_SIZE);
+         RealtimeCheck::prepare(*midiBuffer[i]);
 
          sysexWriteBuffer[i] = 0;
          sysexBuffers[i] = new Array<uchar>[128];
          for (int n=0; n<128; n++) {
             sysexBuffers[i][n].allowGrowth(0);      // shouldn't need to grow
-            sysexBuffers[i][n].setAllocSize(32);
+            sysexBuffers[i][n].setAllocSize(DEFAULT_SYSEX_RESERVE);
             sysexBuffers[i][n].setSize(0);
             sysexBuffers[i][n].setGrowth(32);       // in case it will ever grow
          }
@@ -765,13 +780,16 @@ void *interpretMidiInputStreamPrivate(void *) {
       sysexIn = new Array<uchar>[MidiInPort_oss::numDevices];
       for (int j=0; j<MidiInPort_oss::numDevices; j++) {
          sysexIn[j].allowGrowth();
-         sysexIn[j].setSize(32);
+         sysexIn[j].setSize(DEFAULT_SYSEX_RESERVE * 4);
          sysexIn[j].setSize(0);
          sysexIn[j].setGrowth(512);
       }
 
       count++;
    }
+
+   // no memory allocation from this point on (see RealtimeCheck)
+   RealtimeCheck::enterThread();
    
    // interpret MIDI bytes as they come into the computer
    // and repackage them as MIDI messages.
@@ -835,6 +853,7 @@ top_of_loop:
             // store the MIDI input device to which the incoming MIDI
             // byte belongs.
             device = packet[2];
+            MidiStats::inputByte(device);
            
             // ignore the active sensing 0xfe and MIDI clock 0xf8 commands:
             if (packet[1] == 0xfe || packet[1] == 0xf8) {
@@ -859,6 +878,8 @@ top_of_loop:
                         argsLeft[device] = 0;         // indicates sysex is done
                         uchar datum = 0xf7;
                         sysexIn[device].append(datum);
+                        MidiStats::inputSysex(device,
+                              sysexIn[device].getSize());
                      } else if (argsExpected[device] != -1) {
                         // this is a system message that may or may
                         // not be coming while a sysex is coming in
@@ -870,31 +891,20 @@ top_of_loop:
                      }
                      break;
                   case 0xc0:   
-                     if (argsExpected[device] < 0) {
-                        cout << "Error: received program change during sysex" 
-                             << endl;
-                        exit(1);
-                     } else {
-                        argsExpected[device] = 1;    
-                     }
-                     break;
                   case 0xd0:   
                      if (argsExpected[device] < 0) {
-                        cout << "Error: received aftertouch message during" 
-                                " sysex" << endl;
-                        exit(1);
-                     } else {
-                        argsExpected[device] = 1;    
+                        // a sysex was cut off, so throw it away
+                        MidiStats::inputError(device);
+                        sysexIn[device].setSize(0);
                      }
+                     argsExpected[device] = 1;    
                      break;
                   default:     
                      if (argsExpected[device] < 0) {
-                        cout << "Error: received another message during sysex" 
-                             << endl;
-                        exit(1);
-                     } else {
-                        argsExpected[device] = 2;    
+                        MidiStats::inputError(device);
+                        sysexIn[device].setSize(0);
                      }
+                     argsExpected[device] = 2;    
                      break;
                }
                if (argsExpected[device] >= 0) {
@@ -955,6 +965,15 @@ top_of_loop:
 
                   sysex_done:      // come here when a sysex is completely done
 
+                  // keep every message in the flight recorder, even
+                  // when paused
+                  if (argsExpected[device] < 0) {
+                     FlightRecorder::input(device, sysexIn[device].getBase(),
+                           sysexIn[device].getSize());
+                  } else {
+                     FlightRecorder::input(device, message[device]);
+                  }
+
                   // insert the MIDI message into the appropriate buffer
                   // do not insert into buffer if the MIDI input device
                   // is paused (which can mean closed).  Or if the
@@ -974,12 +993,21 @@ top_of_loop:
                         message[device].setP0(0xf0);
                         message[device].setP1(sysexlocation);
 
+                        MidiCapture::record(device, message[device],
+                              sysexIn[device].getBase(),
+                              sysexIn[device].getSize());
                         sysexIn[device].setSize(0); // empty the sysex storage
                         argsExpected[device] = 0;   // no run status for sysex
                         argsLeft[device] = 0;       // turn off sysex input flag
+                     } else {
+                        MidiCapture::record(device, message[device]);
                      }
+                     MidiStats::inputMessage(device,
+                           MidiInPort_oss::midiBuffer[device]->getCount(),
+                           MidiInPort_oss::midiBuffer[device]->getSize());
                      MidiInPort_oss::midiBuffer[device]->insert(
                            message[device]);
+                     EventLoop::signalInput();
 //                   if (MidiInPort_oss::callbackFunction != NULL) {
 //                      MidiInPort_oss::callbackFunction(device);
 //                   }
@@ -991,6 +1019,7 @@ top_of_loop:
                      }
                      message[device].tick = 0;
                   } else {
+                     MidiStats::inputDropped(device);
                      if (MidiInPort_oss::trace[device]) {
                         cout << '[' << hex << (int)message[device].getP0()
                              << 'P' << dec << (int)message[device].getP1()
@@ -999,6 +1028,9 @@ top_of_loop:
                      }
                   }
                }
+            } else {
+               // a data byte without a command to go with it
+               MidiStats::inputError(device);
             }
             break;
 
@@ -3,6 +3,10 @@
 // Creation Date: 18 December 1997
 // Last Modified: Sun Jan 25 15:31:49 GMT-0800 1998
 // Last Modified: Thu Apr 27 17:56:03 PDT 2000 (added scale function)
+// Last Modified: Sun Oct 18 14:40:27 PDT 2026 (wake up the EventLoop on insert)
+// Last Modified: Sun Oct 18 15:31:08 PDT 2026 (preallocate for realtime use)
+// Last Modified: Mon Oct 19 05:02:36 PDT 2026 (added getStats)
+// Last Modified: Mon Oct 19 08:31:47 PDT 2026 (orphan sysex buffers)
 // Filename:      ...sig/code/control/MidiInput/MidiInput.cpp
 // Web Address:   http://sig.sapp.org/src/sig/MidiInput.cpp
 // Syntax:        C++
@@ -10,12 +14,19 @@
 // Description:   A higher-level MIDI input interface than the 
 //                MidiInPort class.  Can be used to allow multiple
 //                objects to share a single MIDI input stream, or
-//                to fake a MIDI input connection.
+//                to fake a MIDI input connection.  An orphan input
+//                (see makeOrphanBuffer()) keeps its messages and its
+//                sysex buffers to itself, so that they are never
+//                shared with the MIDI input thread of a port.
 //
 
 #include "MidiInput.h"
+#include "EventLoop.h"
 #include <stdlib.h>
 
+#define ORPHAN_SYSEX_COUNT    (128)   /* same number as a port has */
+#define ORPHAN_SYSEX_RESERVE  (256)   /* preallocated bytes per sysex */
+
 #ifndef OLDCPP
    #include <iostream>
    using namespace std;
@@ -32,11 +43,15 @@
 
 MidiInput::MidiInput(void) : MidiInPort() {
    orphanBuffer = NULL;
+   orphanSysex = NULL;
+   orphanSysexIndex = 0;
 }
 
 
 MidiInput::MidiInput(int aPort, int autoOpen) : MidiInPort(aPort, autoOpen) {
    orphanBuffer = NULL;
+   orphanSysex = NULL;
+   orphanSysexIndex = 0;
 }
 
 
@@ -47,9 +62,36 @@ MidiInput::MidiInput(int aPort, int autoOpen) : MidiInPort(aPort, autoOpen) {
 //
 
 MidiInput::~MidiInput() {
-   if (orphanBuffer != NULL) {
-      delete orphanBuffer;
-      orphanBuffer = NULL;
+   removeOrphanBuffer();
+}
+
+
+
+//////////////////////////////
+//
+// MidiInput::clearSysex -- empty one sysex buffer, or all of them.
+//
+
+void MidiInput::clearSysex(void) {
+   if (isOrphan()) {
+      for (int i=0; i<ORPHAN_SYSEX_COUNT; i++) {
+         clearSysex(i);
+      }
+   } else {
+      MidiInPort::clearSysex();
+   }
+}
+
+
+void MidiInput::clearSysex(int buffer) {
+   if (isOrphan()) {
+      buffer &= 0x7f;
+      orphanSysex[buffer].setSize(0);
+      if (orphanSysex[buffer].getAllocSize() > ORPHAN_SYSEX_RESERVE) {
+         orphanSysex[buffer].setAllocSize(ORPHAN_SYSEX_RESERVE);
+      }
+   } else {
+      MidiInPort::clearSysex(buffer);
    }
 }
 
@@ -85,6 +127,56 @@ int MidiInput::getCount(void) {
 
 
 
+//////////////////////////////
+//
+// MidiInput::getStats -- store the input counters of the MIDI port in
+//    stats.  If resetQ is true, the counters start again from zero
+//    after they are read.  An orphan input has no port, so all of
+//    its counters are zero.
+//    default value: resetQ = 0
+//
+
+void MidiInput::getStats(MidiPortStats& stats, int resetQ) {
+   if (isOrphan()) {
+      MidiStats::clear(stats);
+   } else {
+      MidiStats::getInput(getPort(), stats, resetQ);
+   }
+}
+
+
+
+//////////////////////////////
+//
+// MidiInput::getSysex -- returns the contents of a sysex buffer.
+//
+
+uchar* MidiInput::getSysex(int buffer) {
+   if (isOrphan()) {
+      return orphanSysex[buffer & 0x7f].getBase();
+   } else {
+      return MidiInPort::getSysex(buffer);
+   }
+}
+
+
+
+//////////////////////////////
+//
+// MidiInput::getSysexSize -- returns the number of bytes in a sysex
+//    buffer.
+//
+
+int MidiInput::getSysexSize(int buffer) {
+   if (isOrphan()) {
+      return orphanSysex[buffer & 0x7f].getSize();
+   } else {
+      return MidiInPort::getSysexSize(buffer);
+   }
+}
+
+
+
 //////////////////////////////
 //
 // MidiInput::extract --
@@ -133,6 +225,7 @@ double MidiInput::fscale14(int value, double min, double max) {
 void MidiInput::insert(const smf::MidiEvent& aMessage) {
    if (isOrphan()) {
       orphanBuffer->insert(aMessage);
+      EventLoop::signalInput();
    } else {
       MidiInPort::insert(aMessage);
    }
@@ -140,6 +233,31 @@ void MidiInput::insert(const smf::MidiEvent& aMessage) {
 
 
 
+//////////////////////////////
+//
+// MidiInput::installSysex -- copy a sysex message into the next sysex
+//    buffer.  Returns the number of the buffer, which is given as the
+//    second byte of the 0xf0 message inserted for the sysex.
+//
+
+int MidiInput::installSysex(uchar* anArray, int aSize) {
+   if (!isOrphan()) {
+      return MidiInPort::installSysex(anArray, aSize);
+   }
+
+   int bufferNumber = orphanSysexIndex;
+   orphanSysexIndex = (orphanSysexIndex + 1) % ORPHAN_SYSEX_COUNT;
+   Array<uchar>& sysex = orphanSysex[bufferNumber];
+   sysex.setSize(aSize);
+   uchar* data = sysex.getBase();
+   for (int i=0; i<aSize; i++) {
+      data[i] = anArray[i];
+   }
+   return bufferNumber;
+}
+
+
+
 //////////////////////////////
 //
 // MidiInput::isOrphan --
@@ -157,7 +275,11 @@ int MidiInput::isOrphan(void) const {
 
 //////////////////////////////
 //
-// MidiInput::makeOrphanBuffer --
+// MidiInput::makeOrphanBuffer -- disconnect the input from its port
+//     buffers: insert() and extract() use a buffer of aSize messages
+//     which belongs to this object, and installSysex() and getSysex()
+//     use sysex buffers which belong to this object.  Messages which
+//     arrive at the port are not seen until removeOrphanBuffer().
 //     default value: aSize = 1024
 //
 
@@ -168,6 +290,21 @@ void MidiInput::makeOrphanBuffer(int aSize) {
          orphanBuffer = NULL;
       }
       orphanBuffer = new CircularBuffer<smf::MidiEvent>(aSize);
+
+      // storage for each message so that insert() does not allocate
+      smf::MidiEvent blank;
+      blank.setP0(0);
+      blank.setP1(0);
+      blank.setP2(0);
+      blank.setP3(0);
+      orphanBuffer->fill(blank);
+
+      orphanSysex = new Array<uchar>[ORPHAN_SYSEX_COUNT];
+      for (int i=0; i<ORPHAN_SYSEX_COUNT; i++) {
+         orphanSysex[i].setAllocSize(ORPHAN_SYSEX_RESERVE);
+         orphanSysex[i].setSize(0);
+      }
+      orphanSysexIndex = 0;
    }
 }
 
@@ -182,6 +319,8 @@ void MidiInput::removeOrphanBuffer(void) {
    if (isOrphan()) {
       delete orphanBuffer;
       orphanBuffer = NULL;
+      delete [] orphanSysex;
+      orphanSysex = NULL;
    }
 }
 
@@ -2,6 +2,8 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Wed May 10 16:16:21 PDT 2000
 // Last Modified: Sun May 14 20:44:12 PDT 2000
+// Last Modified: Mon Oct 19 04:51:07 PDT 2026 (count traffic in MidiStats)
+// Last Modified: Mon Oct 19 05:31:24 PDT 2026 (record in FlightRecorder)
 // Filename:      ...sig/code/control/MidiOutPort/alsa/MidiOutPort_alsa.cpp
 // Web Address:   http://sig.sapp.org/src/sig/MidiOutPort_alsa.cpp
 // Syntax:        C++ 
@@ -15,6 +17,8 @@
 #if defined(LINUX) && defined(ALSA)
 
 #include "MidiOutPort_alsa.h"
+#include "MidiStats.h"
+#include "FlightRecorder.h"
 #include <stdlib.h>
 
 #ifndef OLDCPP
@@ -202,6 +206,8 @@ int MidiOutPort_alsa::rawsend(int command, int p1, int p2) {
    int status;
    uchar mdata[3] = {(uchar)command, (uchar)p1, (uchar)p2};
    status = write(getPort(), mdata, 3);   
+   MidiStats::output(getPort(), 3, status);
+   FlightRecorder::output(getPort(), mdata, 3);
 
    if (getTrace()) {
       if (status == 1) {
@@ -226,6 +232,8 @@ int MidiOutPort_alsa::rawsend(int command, int p1) {
    uchar mdata[2] = {(uchar)command, (uchar)p1};
 
    status = write(getPort(), mdata, 2);   
+   MidiStats::output(getPort(), 2, status);
+   FlightRecorder::output(getPort(), mdata, 2);
 
    if (getTrace()) {
       if (status == 1) {
@@ -250,6 +258,8 @@ int MidiOutPort_alsa::rawsend(int command) {
    uchar mdata[1] = {(uchar)command};
 
    status = write(getPort(), mdata, 1);
+   MidiStats::output(getPort(), 1, status);
+   FlightRecorder::output(getPort(), mdata, 1);
 
    if (getTrace()) {
       if (status == 1) {
@@ -270,6 +280,8 @@ int MidiOutPort_alsa::rawsend(uchar* array, int size) {
 
    int status;
    status = write(getPort(), array, size);
+   MidiStats::output(getPort(), size, status);
+   FlightRecorder::output(getPort(), array, size);
    
    if (getTrace()) {
       if (status == 1) {
@@ -3,6 +3,8 @@
 // Creation Date: Fri Dec 18 19:22:20 PST 1998
 // Last Modified: Fri Jan  8 04:26:16 PST 1999
 // Last Modified: Wed May 10 17:00:11 PDT 2000 (name change from _linux to _oss)
+// Last Modified: Mon Oct 19 04:51:07 PDT 2026 (count traffic in MidiStats)
+// Last Modified: Mon Oct 19 05:31:24 PDT 2026 (record in FlightRecorder)
 // Filename:      ...sig/code/control/MidiOutPort/linux/MidiOutPort_oss.cpp
 // Web Address:   http://sig.sapp.org/src/sig/MidiOutPort_oss.cpp
 // Syntax:        C++ 
@@ -16,6 +18,8 @@
 #ifdef LINUX
 
 #include "MidiOutPort_oss.h"
+#include "MidiStats.h"
+#include "FlightRecorder.h"
 
 #include <stdlib.h>
 
@@ -205,6 +209,8 @@ int MidiOutPort_oss::rawsend(int command, int p1, int p2) {
    int status;
    uchar mdata[3] = {(uchar)command, (uchar)p1, (uchar)p2};
    status = write(getPort(), mdata, 3);   
+   MidiStats::output(getPort(), 3, status);
+   FlightRecorder::output(getPort(), mdata, 3);
 
    if (getTrace()) {
       if (status == 1) {
@@ -229,6 +235,8 @@ int MidiOutPort_oss::rawsend(int command, int p1) {
    uchar mdata[2] = {(uchar)command, (uchar)p1};
 
    status = write(getPort(), mdata, 2);   
+   MidiStats::output(getPort(), 2, status);
+   FlightRecorder::output(getPort(), mdata, 2);
 
    if (getTrace()) {
       if (status == 1) {
@@ -253,6 +261,8 @@ int MidiOutPort_oss::rawsend(int command) {
    uchar mdata[1] = {(uchar)command};
 
    status = write(getPort(), mdata, 1);
+   MidiStats::output(getPort(), 1, status);
+   FlightRecorder::output(getPort(), mdata, 1);
 
    if (getTrace()) {
       if (status == 1) {
@@ -273,6 +283,8 @@ int MidiOutPort_oss::rawsend(uchar* array, int size) {
 
    int status;
    status = write(getPort(), array, size);
+   MidiStats::output(getPort(), size, status);
+   FlightRecorder::output(getPort(), array, size);
    
    if (getTrace()) {
       if (status == 1) {
@@ -7,6 +7,7 @@
 // Last Modified: Sun Dec  9 15:01:33 PST 2001 switched con/des code
 // Last Modified: Wed Jun  4 20:06:46 PDT 2003 initial MIDI file recording
 // Last Modified: Sun Feb 17 14:11:15 PST 2013 added MidiEvent send
+// Last Modified: Mon Oct 19 05:02:36 PDT 2026 added getStats
 // Filename:      ...sig/code/control/MidiOutput/MidiOutput.cpp
 // Web Address:   http://sig.sapp.org/src/sig/MidiOutput.cpp
 // Syntax:        C++
@@ -96,6 +97,20 @@ int MidiOutput::cont(int channel, int controller, int data) {
 
 
 
+//////////////////////////////
+//
+// MidiOutput::getStats -- store the output counters of the MIDI port
+//    in stats.  If resetQ is true, the counters start again from zero
+//    after they are read.
+//    default value: resetQ = 0
+//
+
+void MidiOutput::getStats(MidiPortStats& stats, int resetQ) {
+   MidiStats::getOutput(getPort(), stats, resetQ);
+}
+
+
+
 //////////////////////////////
 //
 // MidiOutput::off -- sends a Note Off MIDI message (0x80).
@@ -0,0 +1,303 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sun Oct 18 11:02:15 PDT 2026
+// Last Modified: Sun Oct 18 15:31:08 PDT 2026 (preallocate for realtime use)
+// Last Modified: Mon Oct 19 04:51:07 PDT 2026 (count bytes and errors)
+// Filename:      ...improv/src/MidiParser.cpp
+// Web Address:   http://sig.sapp.org/src/sig/MidiParser.cpp
+// Syntax:        C++
+//
+// Description:   Converts a raw MIDI byte stream into complete MIDI
+//                messages, one byte at a time, handling running status
+//                and system exclusive messages.  Factored out of the
+//                ALSA MIDI input thread so that the byte interpretation
+//                can be used (and timed) without a MIDI device.
+//
+
+#include "MidiParser.h"
+#include "MidiStats.h"
+
+#include <stdlib.h>
+
+#ifndef OLDCPP
+   #include <iostream>
+   using namespace std;
+#else
+   #include <iostream.h>
+#endif
+
+
+//////////////////////////////
+//
+// MidiParser::MidiParser --
+//
+
+MidiParser::MidiParser(void) {
+   // reserve space for typical sysex messages so that the input
+   // thread does not usually need to allocate memory
+   sysexIn.allowGrowth();
+   sysexIn.setSize(1024);
+   sysexIn.setSize(0);
+   sysexIn.setGrowth(512);
+
+   // and for the largest regular message
+   message.setP0(0);
+   message.setP1(0);
+   message.setP2(0);
+   message.setP3(0);
+   port = -1;
+   reset();
+}
+
+
+
+//////////////////////////////
+//
+// MidiParser::~MidiParser --
+//
+
+MidiParser::~MidiParser() {
+   // do nothing
+}
+
+
+
+//////////////////////////////
+//
+// MidiParser::clearSysex -- empty the sysex storage after a completed
+//     sysex message has been stored elsewhere.  Running status is
+//     not available after a sysex message.
+//
+
+void MidiParser::clearSysex(void) {
+   sysexIn.setSize(0);
+   argsExpected = 0;
+   argsLeft = 0;
+}
+
+
+
+//////////////////////////////
+//
+// MidiParser::getMessage -- returns the message being assembled.  Only
+//     valid as a complete message when parse() has returned true.
+//     The tick field is the time of the first byte of the message.
+//
+
+smf::MidiEvent& MidiParser::getMessage(void) {
+   return message;
+}
+
+
+
+//////////////////////////////
+//
+// MidiParser::getSysexData -- returns the bytes of the sysex
+//     message (including the 0xf0 and 0xf7 bytes).
+//
+
+uchar* MidiParser::getSysexData(void) {
+   return sysexIn.getBase();
+}
+
+
+
+//////////////////////////////
+//
+// MidiParser::getSysexSize -- returns the number of bytes in the
+//     sysex message.
+//
+
+int MidiParser::getSysexSize(void) {
+   return sysexIn.getSize();
+}
+
+
+
+//////////////////////////////
+//
+// MidiParser::isSysex -- returns true if the complete message is a
+//     system exclusive message, in which case the message bytes
+//     should be read with getSysexData() and then cleared with
+//     clearSysex().
+//
+
+int MidiParser::isSysex(void) const {
+   return argsExpected < 0;
+}
+
+
+
+//////////////////////////////
+//
+// MidiParser::parse -- process the next byte of the MIDI input stream.
+//     aTime is the arrival time of the byte, which will be stored in
+//     the message if it is the first byte of the message.  Returns
+//     true when a complete message is available from getMessage().
+//     Unexpected bytes are counted as errors in MidiStats: a channel
+//     message in the middle of a sysex throws away the unfinished
+//     sysex, and a data byte without a command is ignored.
+//
+// Note on the use of argsExpected and argsLeft for sysexs:
+// If argsExpected is -1, then a sysex message is coming in.
+// If argsLeft < 0, then the sysex message has not finished comming
+// in.  If argsLeft == 0 and argsExpected == -1, then the sysex
+// has finished coming in and is to be sent to the correct
+// location.
+//
+
+int MidiParser::parse(uchar aByte, int aTime) {
+   MidiStats::inputByte(port);
+
+   // ignore the active sensing 0xfe and MIDI clock 0xf8 commands:
+   if (aByte == 0xfe || aByte == 0xf8) {
+      return 0;
+   }
+
+   if (aByte & 0x80) {   // a command byte has arrived
+      switch (aByte & 0xf0) {
+         case 0xf0:
+            if (aByte == 0xf0) {
+               argsExpected = -1;
+               argsLeft = -1;
+               if (sysexIn.getSize() != 0) {
+                  // ignore the command for now.  It is most
+                  // likely an active sensing message.
+                  return 0;
+               } else {
+                  uchar datum = 0xf0;
+                  sysexIn.append(datum);
+               }
+            } if (aByte == 0xf7) {
+               argsLeft = 0;         // indicates sysex is done
+               uchar datum = 0xf7;
+               sysexIn.append(datum);
+               MidiStats::inputSysex(port, sysexIn.getSize());
+            } else if (argsExpected != -1) {
+               // this is a system message that may or may
+               // not be coming while a sysex is coming in
+               argsExpected = 0;
+            } else {
+               // this is a system message that is not coming
+               // while a system exclusive is coming in
+               //argsExpected = 0;
+            }
+            break;
+         case 0xc0:
+         case 0xd0:
+            if (argsExpected < 0) {
+               dropSysex();
+            }
+            argsExpected = 1;
+            break;
+         default:
+            if (argsExpected < 0) {
+               dropSysex();
+            }
+            argsExpected = 2;
+            break;
+      }
+      if (argsExpected >= 0) {
+         argsLeft = argsExpected;
+      }
+
+      message.tick = aTime;
+
+      if (aByte != 0xf7) {
+         message.setP0(aByte);
+      }
+      message.setP1(0);
+      message.setP2(0);
+      message.setP3(0);
+
+      if (aByte == 0xf7) {
+         return 1;
+      }
+   } else if (argsLeft) {   // not a command byte coming in
+      if (message.tick == 0) {
+         // store the receipt time of the first message byte
+         message.tick = aTime;
+      }
+
+      if (argsExpected < 0) {
+         // continue processing a sysex message
+         sysexIn.append(aByte);
+      } else {
+         // handle a message other than a sysex message
+         if (argsLeft == argsExpected) {
+            message.setP1(aByte);
+         } else {
+            message.setP2(aByte);
+         }
+         argsLeft--;
+      }
+
+      // if MIDI message is complete, setup for running status.
+      if (argsExpected >= 0 && !argsLeft) {
+         switch (message.getP0() & 0xf0) {
+            case 0xc0:      argsLeft = 1;      break;
+            case 0xd0:      argsLeft = 1;      break;  // fix by dan
+            default:        argsLeft = 2;      break;
+               // 0x80 expects two arguments
+               // 0x90 expects two arguments
+               // 0xa0 expects two arguments
+               // 0xb0 expects two arguments
+               // 0xe0 expects two arguments
+         }
+         return 1;
+      }
+   } else {
+      // a data byte without a command to go with it
+      MidiStats::inputError(port);
+   }
+
+   return 0;
+}
+
+
+
+//////////////////////////////
+//
+// MidiParser::reset -- forget any partial message and running status.
+//
+
+void MidiParser::reset(void) {
+   argsExpected = 0;
+   argsLeft = 0;
+   sysexIn.setSize(0);
+   message.tick = 0;
+}
+
+
+
+//////////////////////////////
+//
+// MidiParser::setPort -- set the input port which the bytes come from,
+//     for counting them in MidiStats.  The default of -1 does not
+//     count anything.
+//
+
+void MidiParser::setPort(int aPort) {
+   port = aPort;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// protected functions
+//
+
+//////////////////////////////
+//
+// MidiParser::dropSysex -- throw away a sysex message which was cut
+//     off by another command.
+//
+
+void MidiParser::dropSysex(void) {
+   MidiStats::inputError(port);
+   sysexIn.setSize(0);
+}
+
+
+
@@ -2,6 +2,12 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Sat Nov 27 14:10:32 PST 1999
 // Last Modified: Wed Dec  1 11:35:37 PST 1999
+// Last Modified: Sun Oct 18 18:41:07 PDT 2026 (merged playback timeline)
+// Last Modified: Sun Oct 18 19:58:13 PDT 2026 (compiled performance files)
+// Last Modified: Sun Oct 18 22:31:40 PDT 2026 (lookahead dispatch thread)
+// Last Modified: Sun Oct 18 23:41:12 PDT 2026 (predictive beat tracking)
+// Last Modified: Mon Oct 19 06:48:22 PDT 2026 (check long messages)
+// Last Modified: Mon Oct 19 07:10:36 PDT 2026 (virtual clock dispatch)
 // Filename:      ...sig/maint/code/info/MidiPerform/MidiPerform.cpp
 // Syntax:        C++ 
 //
@@ -12,6 +18,21 @@
 //
 
 #include "MidiPerform.h"
+#include "VirtualClock.h"
+
+#include <math.h>
+
+#ifndef VISUAL
+   #include <sys/time.h>
+#endif
+
+#define MAX_PHASE_CORRECTION 0.25   /* beats of phase fixed in one beat */
+
+#ifndef VISUAL
+// function declarations:
+static void waitFor(pthread_cond_t* condition, pthread_mutex_t* mutex,
+      double milliseconds);
+#endif
 
 
 //////////////////////////////
@@ -20,31 +41,12 @@
 //
 
 MidiPerform::MidiPerform(void) { 
-   tempo = 120.0;
-   performanceTimer.setTempo(tempo);
-   beatTimer.setTempo(tempo);
-   pauseLocation = 0.0;
-   beatTimes.setSize(100);
-   beatTimes.reset();
-   readIndex = new int[1];
-   readIndex = 0;
-   tempoMethod = TEMPO_METHOD_AUTOMATIC;
-   amp = 1.0;
+   initialize();
 }
 
 
 MidiPerform::MidiPerform(char* aFile) { 
-   tempo = 120.0;
-   performanceTimer.setTempo(tempo);
-   beatTimer.setTempo(tempo);
-   pauseLocation = 0.0;
-   beatTimes.setSize(100);
-   beatTimes.reset();
-   readIndex = new int[1];
-   readIndex = 0;
-   tempoMethod = TEMPO_METHOD_AUTOMATIC;
-   amp = 1.0;
-  
+   initialize();
    read(aFile);
 }
 
@@ -55,7 +57,11 @@ MidiPerform::MidiPerform(char* aFile) {
 //
 
 MidiPerform::~MidiPerform() { 
-   // do nothing
+   stopDispatcher();
+   #ifndef VISUAL
+      pthread_cond_destroy(&wakeup);
+      pthread_mutex_destroy(&mutex);
+   #endif
 }
 
 
@@ -67,6 +73,7 @@ MidiPerform::~MidiPerform() {
 
 void MidiPerform::beat(void) { 
    double aNewTime = millisecTimer.getTime();
+   lock();
    beatTimes.insert(aNewTime);
 
    switch (getTempoMethod()) {
@@ -107,6 +114,8 @@ void MidiPerform::beat(void) {
       default:
          beat_automatic();
    }
+   notify();
+   unlock();
 
    cout << " Current Tempo: " << tempo << "\t\t Current Beat: " 
         << performanceTimer.getPeriodCount() << endl;
@@ -116,12 +125,43 @@ void MidiPerform::beat(void) {
 
 //////////////////////////////
 //
-// MidiPerform::beat_automatic -- ignores the beat indicators.
+// MidiPerform::beat_automatic -- follow the tempo of the beats without
+//    waiting for them.  The beat tracker predicts when the next beat
+//    will come, and the tempo is set so that the performance reaches
+//    the next whole beat at that time, which also corrects the phase of
+//    the performance.  After the predicted beat, xcheck() returns to
+//    the tracked tempo.
 //
 
 void MidiPerform::beat_automatic(void) {
-cout << "Beat AUTOMATIC" << endl;
-   // do nothing
+   double now = beatTimes[0];
+   if (!tracker.beat(now) || tracker.getBeatCount() < 2) {
+      return;
+   }
+   tempo = tracker.getTempo();
+   beatTimer.adjustPeriod(-beatTimer.getPeriodCount());
+   beatTimer.setTempo(tempo);
+
+   // performance location at the estimated time of the beat
+   double position = performanceTimer.getPeriodCount();
+   double beatPosition = position + (tracker.getBeatTime() - now) *
+         performanceTimer.getTempo() / 60000.0;
+   double error = floor(beatPosition + 0.5) - beatPosition;
+   if (error > MAX_PHASE_CORRECTION) {
+      error = MAX_PHASE_CORRECTION;
+   } else if (error < -MAX_PHASE_CORRECTION) {
+      error = -MAX_PHASE_CORRECTION;
+   }
+
+   double remaining = tracker.getNextBeat() - now;
+   double beats = beatPosition + error + 1.0 - position;
+   if (remaining <= 0.0 || beats <= 0.0) {
+      performanceTimer.setTempo(tempo);
+      correctionEnd = 0.0;
+      return;
+   }
+   performanceTimer.setTempo(beats * 60000.0 / remaining);
+   correctionEnd = tracker.getNextBeat();
 }
    
 
@@ -183,6 +223,18 @@ double MidiPerform::getAmp(void) {
 
 
 
+//////////////////////////////
+//
+// MidiPerform::getBeatTracker -- returns the beat tracker which is
+//    used in the automatic tempo method, for changing its settings.
+//
+
+BeatTracker& MidiPerform::getBeatTracker(void) {
+   return tracker;
+}
+
+
+
 //////////////////////////////
 //
 // MidiPerform::getMaxAmp --
@@ -237,48 +289,67 @@ int MidiPerform::channelCollapse(int aSetting) {
 //
 
 void MidiPerform::xcheck(void) {
-   int quitQ = 0;
-   smf::MidiEvent* event = NULL;
-   if (beatTimer.expired()) {   // waiting for the next beat, so don't continue
-      if (getTempoMethod() != TEMPO_METHOD_AUTOMATIC) {
-         return;
-      }
+   if (lookahead > 0.0 && VirtualClock::isActive()) {
+      // the dispatch thread waits in real time, so the events are sent
+      // from here when the virtual clock was started after the thread
+      setLookahead(0.0);
    }
-   int currentTime = (int)(performanceTimer.getPeriodCount() *
-         midifile.getTicksPerQuarterNote());
-   int i;
-   for (i=0; i<midifile.getTrackCount(); i++) {
-      if (readIndex[i] >= midifile.getNumEvents(i)) {
-         quitQ++;
-         continue;
+   lock();
+   if (waitingQ()) {   // waiting for the next beat, so don't continue
+      unlock();
+      return;
+   }
+   if (correctionEnd > 0.0 && millisecTimer.getTime() >= correctionEnd) {
+      // the phase correction of beat_automatic is finished
+      correctionEnd = 0.0;
+      if (getTempoMethod() == TEMPO_METHOD_AUTOMATIC) {
+         performanceTimer.setTempo(tempo);
+         notify();
       }
-      while (midifile.getEvent(i, readIndex[i]).tick <= currentTime) {
-         event = &midifile.getEvent(i, readIndex[i]);
-         if ((((*event)[0] & 0xf0) == 0x90) ||
-             (((*event)[0] & 0xf0) == 0x80)) {
-            if (channelCollapse()) {
-               (*event)[0] = (*event)[0] & (uchar)0xf0;
-            }
-            if ((*event)[2] != 0) {
-               int amplitude = (int)((*event)[2] * getAmp());
-               if (amplitude < 0) {
-                  amplitude = 0;
-               } else if (amplitude > getMaxAmp()) {
-                  amplitude = getMaxAmp();
-               }
-               (*event)[2] = (uchar)amplitude;
-            }
-         }
-         rawsend(event->data(), event->size());
-         readIndex[i] = readIndex[i] + 1;
-         if (readIndex[i] >= midifile.getNumEvents(i)) {
-            quitQ++;
-            break;
+   }
+   double position = performanceTimer.getPeriodCount();
+
+   if (lookahead > 0.0) {
+      // queue the events in the lookahead window for the dispatch thread
+      double horizon = position + lookahead / 60000.0 * 
+            performanceTimer.getTempo();
+      if (getTempoMethod() != TEMPO_METHOD_AUTOMATIC) {
+         // don't queue past a beat which has not been given yet
+         double beatEnd = position + 1.0 - beatTimer.getPeriodCount();
+         if (horizon > beatEnd) {
+            horizon = beatEnd;
          }
       }
+      int horizonTime = (int)(horizon * ticksPerQuarter);
+      int oldIndex = readIndex;
+      while (readIndex < eventCount && events[readIndex].tick <= horizonTime) {
+         readIndex++;
+      }
+      if (readIndex != oldIndex) {
+         notify();
+      }
+      compiled.release(sendIndex);
+      int doneQ = sendIndex >= eventCount;
+      unlock();
+      if (doneQ) {
+         exit(0);
+      }
+      return;
+   }
+
+   int currentTime = (int)(position * ticksPerQuarter);
+   if (readIndex < eventCount && events[readIndex].tick <= currentTime) {
+      while (readIndex < eventCount && events[readIndex].tick <= currentTime) {
+         sendEvent(events[readIndex]);
+         readIndex++;
+      }
+      compiled.release(readIndex);
    }
+   sendIndex = readIndex;
+   int doneQ = readIndex >= eventCount;
+   unlock();
 
-   if (quitQ == midifile.getTrackCount()) {
+   if (doneQ) {
       exit(0);
    }
 }
@@ -310,6 +381,19 @@ int MidiPerform::getBeatLocation(void) {
 
 
 
+//////////////////////////////
+//
+// MidiPerform::getLookahead -- returns the size of the window in
+//    milliseconds in which events are queued for the dispatch thread,
+//    or 0.0 if xcheck() sends the events itself.
+//
+
+double MidiPerform::getLookahead(void) {
+   return lookahead;
+}
+
+
+
 //////////////////////////////
 //
 // MidiPerform::getTempo -- return current performance
@@ -340,8 +424,10 @@ int MidiPerform::getTempoMethod(void) {
 //
 
 void MidiPerform::pause(void) { 
+   lock();
    pauseLocation = performanceTimer.getTime();
    playingQ = 0;
+   unlock();
 }
 
 
@@ -352,10 +438,15 @@ void MidiPerform::pause(void) {
 //
 
 void MidiPerform::play(void) { 
+   lock();
    playingQ = 1;
    performanceTimer.reset();
    beatTimer.reset();
    beatTimer.sync(performanceTimer);
+   tracker.reset(tempo);
+   correctionEnd = 0.0;
+   notify();
+   unlock();
 }
 
 
@@ -370,22 +461,46 @@ void MidiPerform::read(const string& aFile) {
 }
 
 void MidiPerform::read(const char* aFile) { 
-   int status = midifile.read(aFile);
-   if (status == 0) {
-      cout << "Error: midifile " << aFile << " is bad." << endl;
-   }
-   
-   if (readIndex != NULL) {
-      delete readIndex;
+   lock();
+   silence();
+   compiled.close();
+   timeline.setSize(0);
+   longData.setSize(0);
+   timeline.shrinkToFit();
+   longData.shrinkToFit();
+
+   if (PerformFile::isPerformFile(aFile)) {
+      if (!compiled.open(aFile)) {
+         cout << "Error: performance file " << aFile << " is bad." << endl;
+      }
+      events          = compiled.getEvents();
+      eventCount      = compiled.getEventCount();
+      longBytes       = compiled.getLongData();
+      longSize        = compiled.getLongDataSize();
+      ticksPerQuarter = compiled.getTicksPerQuarterNote();
+   } else {
+      int status = midifile.read(aFile);
+      if (status == 0) {
+         cout << "Error: midifile " << aFile << " is bad." << endl;
+      }
+      midifile.absoluteTicks();
+      PerformFile::merge(midifile, timeline, longData);
+      events          = timeline.getBase();
+      eventCount      = (int)timeline.getSize();
+      longBytes       = longData.getBase();
+      longSize        = longData.getSize();
+      ticksPerQuarter = midifile.getTicksPerQuarterNote();
    }
-   readIndex = new int[midifile.getTrackCount()];
-   for (int i=0; i<midifile.getTrackCount(); i++) {
-      readIndex[i] = 0;
+   if (ticksPerQuarter <= 0) {
+      ticksPerQuarter = 120;
    }
+   readIndex = 0;
+   sendIndex = 0;
+   sounding.reset();
 
    performanceTimer.setTempo(tempo);
    beatTimer.setTempo(tempo);
-
+   unlock();
 }
 
 
@@ -396,7 +511,12 @@ void MidiPerform::read(const char* aFile) {
 //
 
 void MidiPerform::rewind(void) { 
+   lock();
+   silence();
+   readIndex = 0;
+   sendIndex = 0;
    pauseLocation = 0.0;
+   unlock();
 }
 
 
@@ -434,11 +554,60 @@ void MidiPerform::setMaxAmp(int aMax) {
 
 //////////////////////////////
 //
-// MidiPerform::setBeatLocation --
+// MidiPerform::setBeatLocation -- move the performance to the given
+//    beat (quarter note) in the MIDI file.  Notes which are sounding
+//    are turned off, and the next event to play is found with a
+//    binary search of the timeline.
 //
 
 void MidiPerform::setBeatLocation(double aLocation) { 
-   // xxx
+   if (aLocation < 0.0) {
+      aLocation = 0.0;
+   }
+   lock();
+   silence();
+   readIndex = findEvent((int)(aLocation * ticksPerQuarter));
+   sendIndex = readIndex;
+   performanceTimer.setPeriodCount(aLocation);
+   beatTimer.setPeriodCount(aLocation - (int)aLocation);
+   notify();
+   unlock();
+}
+
+
+
+//////////////////////////////
+//
+// MidiPerform::setLookahead -- queue the events which are due within
+//    the given number of milliseconds when xcheck() is called, and send
+//    them at their times from a dispatch thread.  20 to 50 milliseconds
+//    is enough to cover a slow main loop.  A value of 0 turns off the
+//    thread, and xcheck() sends the events itself.  Not available in
+//    Windows.  The thread is not used with the virtual clock, since it
+//    waits in real time: the events are sent by xcheck() at their
+//    virtual times instead.
+//
+
+void MidiPerform::setLookahead(double milliseconds) {
+   if (milliseconds < 0.0 || VirtualClock::isActive()) {
+      milliseconds = 0.0;
+   }
+   #ifdef VISUAL
+      milliseconds = 0.0;
+   #endif
+
+   if (milliseconds > 0.0) {
+      startDispatcher();
+   } else {
+      stopDispatcher();
+   }
+   lock();
+   #ifndef VISUAL
+      lookahead = dispatchQ ? milliseconds : 0.0;
+   #else
+      lookahead = milliseconds;
+   #endif
+   unlock();
 }
 
 
@@ -449,9 +618,14 @@ void MidiPerform::setBeatLocation(double aLocation) {
 //
 
 void MidiPerform::setTempo(double aTempo) { 
+   lock();
    tempo = aTempo;
    performanceTimer.setTempo(tempo);
    beatTimer.setTempo(tempo);
+   tracker.reset(tempo);
+   correctionEnd = 0.0;
+   notify();
+   unlock();
 }
 
 
@@ -462,10 +636,18 @@ void MidiPerform::setTempo(double aTempo) {
 //
 
 void MidiPerform::setTempoMethod(int aMethod) { 
+   lock();
    if (aMethod == TEMPO_METHOD_AUTOMATIC) {
       beatTimes.reset();
+      tracker.reset(tempo);
+   }
+   if (correctionEnd > 0.0) {
+      performanceTimer.setTempo(tempo);
+      correctionEnd = 0.0;
    }
    tempoMethod = aMethod;
+   notify();
+   unlock();
 }
 
 
@@ -476,9 +658,329 @@ void MidiPerform::setTempoMethod(int aMethod) {
 //
 
 void MidiPerform::stop(void) { 
+   lock();
    pauseLocation = performanceTimer.getTime();
+   unlock();
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// protected functions
+//
+
+
+//////////////////////////////
+//
+// MidiPerform::findEvent -- return the index of the first event in
+//    the timeline which is at or after the given tick time.
+//
+
+int MidiPerform::findEvent(int tick) {
+   if (compiled.isOpen()) {
+      return compiled.findEvent(tick);
+   }
+   return PerformFile::findEvent(events, 0, eventCount, tick);
+}
+
+
+
+//////////////////////////////
+//
+// MidiPerform::lock -- keep the dispatch thread from using the queue,
+//    the timers or the MIDI output.
+//
+
+void MidiPerform::lock(void) {
+   #ifndef VISUAL
+      pthread_mutex_lock(&mutex);
+   #endif
+}
+
+
+
+//////////////////////////////
+//
+// MidiPerform::notify -- tell the dispatch thread that the queue or the
+//    tempo has changed, so that it can recalculate when to send the next
+//    event.  Call while locked.
+//
+
+void MidiPerform::notify(void) {
+   #ifndef VISUAL
+      pthread_cond_signal(&wakeup);
+   #endif
+}
+
+
+
+//////////////////////////////
+//
+// MidiPerform::sendEvent -- send a message from the timeline, after
+//    applying the channel collapse and amplitude settings to a copy
+//    of it.  The notes which are left on are remembered so that they
+//    can be turned off when the performance location changes.  A long
+//    message which is not inside of the long message storage (from a
+//    damaged compiled file) is not sent.
+//
+
+void MidiPerform::sendEvent(const PerformEvent& event) {
+   if (event.size > 4) {
+      const uchar* bytes = PerformFile::getLongMessage(event, longBytes,
+            longSize);
+      if (bytes != NULL) {
+         rawsend((uchar*)bytes, event.size);
+      }
+      return;
+   }
+   if (event.size <= 0) {
+      return;
+   }
+
+   uchar message[4];
+   int i;
+   for (i=0; i<event.size; i++) {
+      message[i] = event.data[i];
+   }
+
+   int command = message[0] & 0xf0;
+   if ((command == 0x90 || command == 0x80) && event.size >= 3) {
+      if (channelCollapse()) {
+         message[0] = message[0] & (uchar)0xf0;
+      }
+      if (message[2] != 0) {
+         int amplitude = (int)(message[2] * getAmp());
+         if (amplitude < 0) {
+            amplitude = 0;
+         } else if (amplitude > getMaxAmp()) {
+            amplitude = getMaxAmp();
+         }
+         message[2] = (uchar)amplitude;
+      }
+      if (command == 0x90 && message[2] != 0) {
+         sounding.noteOn(message[0] & 0x0f, message[1], message[2],
+               event.tick);
+      } else {
+         sounding.noteOff(message[0] & 0x0f, message[1]);
+      }
+   } else if (command == 0xb0 && event.size >= 3 && message[1] == 64) {
+      sounding.setSustain(message[0] & 0x0f, message[2] >= 64);
+   }
+
+   rawsend(message, event.size);
+}
+
+
+
+//////////////////////////////
+//
+// MidiPerform::silence -- turn off the notes and sustain pedals which
+//    were left on by the performance.  Call while locked.
+//
+
+void MidiPerform::silence(void) {
+   int keys[128];
+   int channel;
+   int i;
+   for (channel=0; channel<16; channel++) {
+      int count = sounding.getHeldNotes(keys, 128, NOTESTATE_BY_PITCH,
+            channel);
+      for (i=0; i<count; i++) {
+         rawsend(0x80 | channel, keys[i], 0);
+      }
+      if (sounding.sustainQ(channel)) {
+         rawsend(0xb0 | channel, 64, 0);
+      }
+   }
+   sounding.reset();
+}
+
+
+
+//////////////////////////////
+//
+// MidiPerform::unlock -- let the dispatch thread continue.
+//
+
+void MidiPerform::unlock(void) {
+   #ifndef VISUAL
+      pthread_mutex_unlock(&mutex);
+   #endif
+}
+
+
+
+//////////////////////////////
+//
+// MidiPerform::waitingQ -- returns true if the performance is waiting
+//    for the next beat to be given.
+//
+
+int MidiPerform::waitingQ(void) {
+   return beatTimer.expired() && getTempoMethod() != TEMPO_METHOD_AUTOMATIC;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// private functions
+//
+
+
+//////////////////////////////
+//
+// MidiPerform::initialize -- set the initial values of the variables.
+//
+
+void MidiPerform::initialize(void) {
+   tempo = 120.0;
+   performanceTimer.setTempo(tempo);
+   beatTimer.setTempo(tempo);
+   pauseLocation = 0.0;
+   beatTimes.setSize(100);
+   beatTimes.reset();
+   events = NULL;
+   eventCount = 0;
+   longBytes = NULL;
+   longSize = 0;
+   ticksPerQuarter = 120;
+   readIndex = 0;
+   sendIndex = 0;
+   lookahead = 0.0;
+   correctionEnd = 0.0;
+   playingQ = 0;
+   tempoMethod = TEMPO_METHOD_AUTOMATIC;
+   amp = 1.0;
+   maxamp = 127;
+   channelcollapseQ = 0;
+   #ifndef VISUAL
+      pthread_mutex_init(&mutex, NULL);
+      pthread_cond_init(&wakeup, NULL);
+      dispatchQ = 0;
+   #endif
+}
+
+
+
+//////////////////////////////
+//
+// MidiPerform::startDispatcher -- start the thread which sends the
+//    queued events.
+//
+
+void MidiPerform::startDispatcher(void) {
+   #ifndef VISUAL
+      lock();
+      if (dispatchQ) {
+         unlock();
+         return;
+      }
+      dispatchQ = 1;
+      if (pthread_create(&dispatcher, NULL, dispatch, this) != 0) {
+         cerr << "Error: cannot start MIDI dispatch thread" << endl;
+         dispatchQ = 0;
+      }
+      unlock();
+   #endif
 }
 
 
 
+//////////////////////////////
+//
+// MidiPerform::stopDispatcher -- stop the dispatch thread.  Events which
+//    were queued but not sent will be sent by xcheck().
+//
+
+void MidiPerform::stopDispatcher(void) {
+   #ifndef VISUAL
+      lock();
+      if (!dispatchQ) {
+         unlock();
+         return;
+      }
+      dispatchQ = 0;
+      notify();
+      unlock();
+      pthread_join(dispatcher, NULL);
+
+      lock();
+      lookahead = 0.0;
+      readIndex = sendIndex;
+      unlock();
+   #endif
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// static functions
+//
+
+#ifndef VISUAL
+
+//////////////////////////////
+//
+// MidiPerform::dispatch -- send each queued event when the performance
+//    reaches its time.  The time to wait is calculated from the timer
+//    each time the thread wakes up, so beats and tempo changes which
+//    happen while an event is queued change when it is sent.  The
+//    thread wakes up at least every 10 milliseconds in case the tempo
+//    was changed without notify().
+//
+
+void* MidiPerform::dispatch(void* aPerform) {
+   MidiPerform& perform = *(MidiPerform*)aPerform;
+   pthread_mutex_lock(&perform.mutex);
+   while (perform.dispatchQ) {
+      if (perform.sendIndex >= perform.readIndex || perform.waitingQ()) {
+         waitFor(&perform.wakeup, &perform.mutex, 10.0);
+         continue;
+      }
+      const PerformEvent& event = perform.events[perform.sendIndex];
+      double ticks = event.tick - perform.performanceTimer.getPeriodCount() *
+            perform.ticksPerQuarter;
+      if (ticks <= 0.0) {
+         perform.sendEvent(event);
+         perform.sendIndex++;
+         continue;
+      }
+      double milliseconds = ticks / perform.ticksPerQuarter * 60000.0 /
+            perform.performanceTimer.getTempo();
+      if (milliseconds > 10.0) {
+         milliseconds = 10.0;
+      }
+      waitFor(&perform.wakeup, &perform.mutex, milliseconds);
+   }
+   pthread_mutex_unlock(&perform.mutex);
+   return NULL;
+}
+
+
+
+//////////////////////////////
+//
+// waitFor -- wait for the condition to be signaled or for the given
+//    number of milliseconds to pass.  The mutex must be locked.
+//
+
+static void waitFor(pthread_cond_t* condition, pthread_mutex_t* mutex,
+      double milliseconds) {
+   struct timeval now;
+   gettimeofday(&now, NULL);
+   long long nanoseconds = (long long)now.tv_usec * 1000 +
+         (long long)(milliseconds * 1000000.0);
+   struct timespec until;
+   until.tv_sec  = now.tv_sec + (time_t)(nanoseconds / 1000000000);
+   until.tv_nsec = (long)(nanoseconds % 1000000000);
+   pthread_cond_timedwait(condition, mutex, &until);
+}
+
+#endif
+
+
+
 // md5sum: 901e82cd86464be403679222b09a3940 MidiPerform.cpp [20020518]
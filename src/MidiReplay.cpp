@@ -0,0 +1,253 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Mon Oct 19 04:12:40 PDT 2026
+// Last Modified: Mon Oct 19 04:12:44 PDT 2026
+// Last Modified: Mon Oct 19 07:41:26 PDT 2026 (read with MidiCapture)
+// Last Modified: Mon Oct 19 08:31:47 PDT 2026 (replay into an orphan)
+// Last Modified: Mon Oct 19 08:55:41 PDT 2026 (added next())
+// Filename:      ...improv/src/MidiReplay.cpp
+// Web Address:   http://sig.sapp.org/src/sig/MidiReplay.cpp
+// Syntax:        C++
+//
+// Description:   Feeds a MIDI capture file written by MidiCapture into
+//                a MidiInput as if the messages were arriving from the
+//                MIDI hardware.  Messages are given out at their
+//                captured spacing, at a multiple of it, or as fast as
+//                the program takes them out of the input buffer.  The
+//                MidiInput must be an orphan (see makeOrphanBuffer()),
+//                so that the replay does not write into the buffers
+//                of a port while its MIDI input thread does.  A
+//                program which interprets the messages itself can take
+//                them out one at a time with next().
+//
+
+#include "MidiReplay.h"
+
+#ifndef OLDCPP
+   #include <iostream>
+   using namespace std;
+#else
+   #include <iostream.h>
+#endif
+
+
+//////////////////////////////
+//
+// MidiReplay::MidiReplay --
+//
+
+MidiReplay::MidiReplay(void) {
+   index     = 0;
+   speed     = 1.0;
+   startTime = 0;
+   runningQ  = 0;
+   message.resize(3);           // so that update() does not allocate
+}
+
+
+
+//////////////////////////////
+//
+// MidiReplay::~MidiReplay --
+//
+
+MidiReplay::~MidiReplay() {
+   // do nothing
+}
+
+
+
+//////////////////////////////
+//
+// MidiReplay::clear -- forget the capture.
+//
+
+void MidiReplay::clear(void) {
+   stop();
+   records.setSize(0);
+   data.setSize(0);
+   index = 0;
+}
+
+
+
+//////////////////////////////
+//
+// MidiReplay::getCount -- returns the number of messages in the
+//    capture.
+//
+
+int MidiReplay::getCount(void) const {
+   return (int)records.getSize();
+}
+
+
+
+//////////////////////////////
+//
+// MidiReplay::getIndex -- returns the number of messages which have
+//    been played.
+//
+
+int MidiReplay::getIndex(void) const {
+   return index;
+}
+
+
+
+//////////////////////////////
+//
+// MidiReplay::getSpeed -- returns the playback speed.
+//
+
+double MidiReplay::getSpeed(void) const {
+   return speed;
+}
+
+
+
+//////////////////////////////
+//
+// MidiReplay::next -- if the next message of the capture is due, store
+//    it in aMessage and return 1.  Otherwise returns 0.  Call repeatedly
+//    until it returns 0 to get all of the messages which are due.  Use
+//    aPort to play only the messages which were captured from that
+//    input port, or -1 to play the messages from all ports.  The message
+//    keeps its captured time in aMessage.tick, so that a program which
+//    uses the message times sees the same input at any playback speed.
+//    A sysex message is installed in the sysex buffers of the given
+//    input and given out as 0xf0 and the buffer index, the same form as
+//    a sysex message from the MIDI hardware.  The input must be an
+//    orphan; otherwise the replay is stopped.  Playback stops after the
+//    last message.
+//    default value: aPort = -1
+//
+
+int MidiReplay::next(MidiInput& input, smf::MidiEvent& aMessage,
+      int aPort) {
+   if (!runningQ) {
+      return 0;
+   }
+   if (!input.isOrphan()) {
+      cerr << "Error: MIDI capture can only be replayed into an orphan "
+           << "MidiInput" << endl;
+      stop();
+      return 0;
+   }
+
+   long now = timer.getTime();
+   int i;
+   while (index < records.getSize()) {
+      MidiCaptureRecord& record = records[index];
+      if (speed > 0.0 && (now - startTime) * speed <
+            record.time - records[0].time) {
+         return 0;
+      }
+      index++;
+      if (aPort >= 0 && record.port != aPort) {
+         continue;
+      }
+
+      uchar* bytes = data.getBase() + record.offset;
+      if (bytes[0] == 0xf0 && record.length > 2) {
+         aMessage.resize(2);
+         aMessage[0] = 0xf0;
+         aMessage[1] = (uchar)input.installSysex(bytes, record.length);
+      } else {
+         aMessage.resize(record.length);
+         for (i=0; i<record.length; i++) {
+            aMessage[i] = bytes[i];
+         }
+      }
+      aMessage.tick = (int)record.time;
+      return 1;
+   }
+
+   runningQ = 0;
+   return 0;
+}
+
+
+
+//////////////////////////////
+//
+// MidiReplay::playingQ -- returns true if the capture is being played.
+//
+
+int MidiReplay::playingQ(void) const {
+   return runningQ;
+}
+
+
+
+//////////////////////////////
+//
+// MidiReplay::read -- read a capture file written by MidiCapture.
+//    The messages are sorted into time order.  Returns 0 if the file
+//    could not be read.
+//
+
+int MidiReplay::read(const char* aFilename) {
+   clear();
+   return MidiCapture::read(aFilename, records, data);
+}
+
+
+
+//////////////////////////////
+//
+// MidiReplay::start -- start playing the capture from the beginning.
+//    A speed of 1.0 plays the messages with their captured spacing, 2.0
+//    plays twice as fast, and 0.0 plays them as fast as the program
+//    takes them out of the input buffer.
+//    default value: aSpeed = 1.0
+//
+
+void MidiReplay::start(double aSpeed) {
+   index     = 0;
+   speed     = aSpeed < 0.0 ? 0.0 : aSpeed;
+   startTime = timer.getTime();
+   runningQ  = records.getSize() > 0;
+}
+
+
+
+//////////////////////////////
+//
+// MidiReplay::stop -- stop playing the capture.
+//
+
+void MidiReplay::stop(void) {
+   runningQ = 0;
+}
+
+
+
+//////////////////////////////
+//
+// MidiReplay::update -- put the messages which are due into the input
+//    buffer of the given MidiInput.  Use aPort to play only the messages
+//    which were captured from that input port, or -1 to play the
+//    messages from all ports.  The input must be an orphan; otherwise
+//    the replay is stopped.  The messages are stamped with the current
+//    time, like a message from the MIDI hardware, and sysex messages are
+//    installed in the sysex buffers of the input.  No more messages are
+//    inserted than there is room for in the input buffer.  Call this
+//    function once in each pass of the event loop.  Returns the number
+//    of messages inserted.
+//    default value: aPort = -1
+//
+
+int MidiReplay::update(MidiInput& input, int aPort) {
+   long now = timer.getTime();
+   int space = input.getBufferSize() - input.getCount();
+   int inserted = 0;
+   while (inserted < space && next(input, message, aPort)) {
+      message.tick = (int)now;
+      input.insert(message);
+      inserted++;
+   }
+   return inserted;
+}
+
+
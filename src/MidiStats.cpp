@@ -0,0 +1,299 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Mon Oct 19 04:51:07 PDT 2026
+// Last Modified: Mon Oct 19 04:51:11 PDT 2026
+// Filename:      ...improv/src/MidiStats.cpp
+// Web Address:   http://sig.sapp.org/src/sig/MidiStats.cpp
+// Syntax:        C++
+//
+// Description:   Counters for the traffic on each MIDI input and output
+//                port: bytes and messages, sysex sizes, parsing errors,
+//                messages dropped while an input is paused, messages
+//                lost when the input queue was full, the deepest input
+//                queue and failed sends.  The input counters are only
+//                written by the MIDI input thread of the port, and the
+//                output counters are added atomically, so no locks are
+//                needed.  Read the counters with getStats() in
+//                MidiInput, MidiOutput or MidiIO.
+//
+
+#include "MidiStats.h"
+
+#include <stdio.h>
+
+#ifdef VISUAL
+   #define ATOMIC_ADD(x, y)  ((x) += (y))
+#else
+   #define ATOMIC_ADD(x, y)  __sync_fetch_and_add(&(x), (y))
+#endif
+
+// declare static variables
+volatile MidiPortStats MidiStats::inputCounts[MIDI_STATS_MAX_PORTS];
+volatile MidiPortStats MidiStats::outputCounts[MIDI_STATS_MAX_PORTS];
+MidiPortStats          MidiStats::inputBase[MIDI_STATS_MAX_PORTS];
+MidiPortStats          MidiStats::outputBase[MIDI_STATS_MAX_PORTS];
+
+// function declarations:
+static void copyStats        (MidiPortStats& output,
+                              volatile MidiPortStats& input);
+static int  validPort        (int port);
+
+
+//////////////////////////////
+//
+// MidiStats::inputByte -- count a byte received on an input port.
+//
+
+void MidiStats::inputByte(int port) {
+   if (validPort(port)) {
+      inputCounts[port].bytesIn++;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// MidiStats::inputDropped -- count a message which was discarded
+//    because the input port was paused.
+//
+
+void MidiStats::inputDropped(int port) {
+   if (validPort(port)) {
+      inputCounts[port].dropped++;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// MidiStats::inputError -- count an unexpected byte in the input, such
+//    as a data byte without a command or a command inside of a sysex.
+//
+
+void MidiStats::inputError(int port) {
+   if (validPort(port)) {
+      inputCounts[port].parseErrors++;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// MidiStats::inputMessage -- count a message which is about to be
+//    stored in an input queue holding queueCount of queueSize messages.
+//    If the queue is full, the oldest message will be overwritten.
+//
+
+void MidiStats::inputMessage(int port, int queueCount, int queueSize) {
+   if (!validPort(port)) {
+      return;
+   }
+   volatile MidiPortStats& counts = inputCounts[port];
+   counts.messagesIn++;
+   if (queueCount >= queueSize) {
+      counts.overwrites++;
+   } else {
+      queueCount++;
+   }
+   if (queueCount > counts.maxQueueDepth) {
+      counts.maxQueueDepth = queueCount;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// MidiStats::inputSysex -- count a complete sysex message of the given
+//    number of bytes.
+//
+
+void MidiStats::inputSysex(int port, int aSize) {
+   if (!validPort(port)) {
+      return;
+   }
+   volatile MidiPortStats& counts = inputCounts[port];
+   counts.sysexIn++;
+   if (aSize > counts.maxSysexSize) {
+      counts.maxSysexSize = aSize;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// MidiStats::output -- count a message of byteCount bytes sent on an
+//    output port.  A status of 0 means that the message was not sent.
+//
+
+void MidiStats::output(int port, int byteCount, int status) {
+   if (!validPort(port)) {
+      return;
+   }
+   volatile MidiPortStats& counts = outputCounts[port];
+   if (status) {
+      ATOMIC_ADD(counts.messagesOut, 1);
+      ATOMIC_ADD(counts.bytesOut, byteCount);
+   } else {
+      ATOMIC_ADD(counts.sendErrors, 1);
+   }
+}
+
+
+
+//////////////////////////////
+//
+// MidiStats::clear -- set all of the counts to zero.
+//
+
+void MidiStats::clear(MidiPortStats& stats) {
+   stats.bytesIn       = 0;
+   stats.messagesIn    = 0;
+   stats.sysexIn       = 0;
+   stats.maxSysexSize  = 0;
+   stats.parseErrors   = 0;
+   stats.dropped       = 0;
+   stats.overwrites    = 0;
+   stats.maxQueueDepth = 0;
+   stats.bytesOut      = 0;
+   stats.messagesOut   = 0;
+   stats.sendErrors    = 0;
+}
+
+
+
+//////////////////////////////
+//
+// MidiStats::getInput -- store the input counts of a port in stats,
+//    leaving the output counts at zero.  If resetQ is true, the next
+//    call will count from now.  The counters themselves are never
+//    cleared, since the input thread may be writing them; instead the
+//    counts at the reset are remembered and subtracted.  A new largest
+//    sysex or queue depth which arrives during a reset may be missed.
+//    default value: resetQ = 0
+//
+
+void MidiStats::getInput(int port, MidiPortStats& stats, int resetQ) {
+   clear(stats);
+   if (!validPort(port)) {
+      return;
+   }
+   MidiPortStats current;
+   copyStats(current, inputCounts[port]);
+   MidiPortStats& base = inputBase[port];
+   stats.bytesIn       = current.bytesIn     - base.bytesIn;
+   stats.messagesIn    = current.messagesIn  - base.messagesIn;
+   stats.sysexIn       = current.sysexIn     - base.sysexIn;
+   stats.parseErrors   = current.parseErrors - base.parseErrors;
+   stats.dropped       = current.dropped     - base.dropped;
+   stats.overwrites    = current.overwrites  - base.overwrites;
+   stats.maxSysexSize  = current.maxSysexSize;
+   stats.maxQueueDepth = current.maxQueueDepth;
+   if (resetQ) {
+      base = current;
+      inputCounts[port].maxSysexSize  = 0;
+      inputCounts[port].maxQueueDepth = 0;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// MidiStats::getOutput -- store the output counts of a port in stats,
+//    leaving the input counts at zero.  If resetQ is true, the next
+//    call will count from now.
+//    default value: resetQ = 0
+//
+
+void MidiStats::getOutput(int port, MidiPortStats& stats, int resetQ) {
+   clear(stats);
+   if (!validPort(port)) {
+      return;
+   }
+   MidiPortStats current;
+   copyStats(current, outputCounts[port]);
+   MidiPortStats& base = outputBase[port];
+   stats.bytesOut    = current.bytesOut    - base.bytesOut;
+   stats.messagesOut = current.messagesOut - base.messagesOut;
+   stats.sendErrors  = current.sendErrors  - base.sendErrors;
+   if (resetQ) {
+      base = current;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// MidiStats::print -- print the input and/or output counts for
+//    reading on the terminal.
+//    default value: which = MIDI_STATS_INPUT | MIDI_STATS_OUTPUT
+//
+
+void MidiStats::print(ostream& out, const MidiPortStats& stats, int which) {
+   char buffer[256];
+   if (which & MIDI_STATS_INPUT) {
+      sprintf(buffer, "   in:  %ld messages, %ld bytes, %ld sysex "
+            "(largest %ld bytes), queue depth max %ld",
+            stats.messagesIn, stats.bytesIn, stats.sysexIn,
+            stats.maxSysexSize, stats.maxQueueDepth);
+      out << buffer << '\n';
+      sprintf(buffer, "        %ld parse errors, %ld dropped while paused, "
+            "%ld lost to full queue",
+            stats.parseErrors, stats.dropped, stats.overwrites);
+      out << buffer << '\n';
+   }
+   if (which & MIDI_STATS_OUTPUT) {
+      sprintf(buffer, "   out: %ld messages, %ld bytes, %ld send errors",
+            stats.messagesOut, stats.bytesOut, stats.sendErrors);
+      out << buffer << '\n';
+   }
+   out << flush;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// static functions
+//
+
+
+//////////////////////////////
+//
+// copyStats -- read the counters which are being written by other
+//    threads.
+//
+
+static void copyStats(MidiPortStats& output, volatile MidiPortStats& input) {
+   output.bytesIn       = input.bytesIn;
+   output.messagesIn    = input.messagesIn;
+   output.sysexIn       = input.sysexIn;
+   output.maxSysexSize  = input.maxSysexSize;
+   output.parseErrors   = input.parseErrors;
+   output.dropped       = input.dropped;
+   output.overwrites    = input.overwrites;
+   output.maxQueueDepth = input.maxQueueDepth;
+   output.bytesOut      = input.bytesOut;
+   output.messagesOut   = input.messagesOut;
+   output.sendErrors    = input.sendErrors;
+}
+
+
+
+//////////////////////////////
+//
+// validPort -- returns true if the port has counters.
+//
+
+static int validPort(int port) {
+   return port >= 0 && port < MIDI_STATS_MAX_PORTS;
+}
+
+
+
@@ -0,0 +1,443 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sun Oct 18 17:58:02 PDT 2026
+// Last Modified: Sun Oct 18 17:58:06 PDT 2026
+// Last Modified: Mon Oct 19 07:58:40 PDT 2026 (bit functions in bitops.h)
+// Filename:      ...improv/src/NoteState.cpp
+// Web Address:   http://sig.sapp.org/src/sig/NoteState.cpp
+// Syntax:        C++
+//
+// Description:   Keeps track of which keys are held down on each MIDI
+//                channel, with the velocity and time of each note-on,
+//                and which notes are still sounding because of the
+//                sustain pedal.  The held notes can be listed in pitch
+//                order or in the order in which they were played, and
+//                the lowest, highest and most recent held notes are
+//                found without searching.  Updated from incoming MIDI
+//                messages with process().
+//
+
+#include "NoteState.h"
+#include "bitops.h"
+
+#include <string.h>
+
+
+//////////////////////////////
+//
+// NoteState::NoteState --
+//
+
+NoteState::NoteState(void) {
+   reset();
+}
+
+
+
+//////////////////////////////
+//
+// NoteState::~NoteState --
+//
+
+NoteState::~NoteState() {
+   // do nothing
+}
+
+
+
+//////////////////////////////
+//
+// NoteState::allNotesOff -- release all keys on a channel (or on all
+//     channels), including notes which are held by the sustain pedal.
+//     default value: channel = NOTESTATE_ALL_CHANNELS
+//
+
+void NoteState::allNotesOff(int channel) {
+   if (channel < 0) {
+      for (int i=0; i<16; i++) {
+         allNotesOff(i);
+      }
+      return;
+   }
+   channel &= 0x0f;
+   for (int word=0; word<4; word++) {
+      while (heldBits[channel][word] != 0) {
+         releaseHeld(channel, word * 32 + lowestBit(heldBits[channel][word]));
+      }
+      soundingBits[channel][word] = 0;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// NoteState::getHeldCount -- returns the number of keys held down.
+//     default value: channel = NOTESTATE_ALL_CHANNELS
+//
+
+int NoteState::getHeldCount(int channel) const {
+   if (channel < 0) {
+      return totalHeld;
+   }
+   return heldCount[channel & 0x0f];
+}
+
+
+
+//////////////////////////////
+//
+// NoteState::getHeldNotes -- store up to maxCount held keys in the
+//     keys array, either lowest first (NOTESTATE_BY_PITCH) or in the
+//     order they were played (NOTESTATE_BY_TIME).  When listing all
+//     channels by pitch, a key held on several channels is listed once.
+//     Returns the number of keys stored.
+//     default value: order = NOTESTATE_BY_PITCH
+//     default value: channel = NOTESTATE_ALL_CHANNELS
+//
+
+int NoteState::getHeldNotes(int* keys, int maxCount, int order,
+      int channel) const {
+   int count = 0;
+
+   if (order == NOTESTATE_BY_TIME) {
+      for (int slot=oldestHeld; slot>=0 && count<maxCount;
+            slot=nextHeld[slot]) {
+         if (channel < 0 || (slot >> 7) == (channel & 0x0f)) {
+            keys[count++] = slot & 0x7f;
+         }
+      }
+      return count;
+   }
+
+   const uint32_t* bits = channel < 0 ? anyHeldBits : heldBits[channel & 0x0f];
+   for (int word=0; word<4; word++) {
+      uint32_t remaining = bits[word];
+      while (remaining != 0 && count < maxCount) {
+         int bit = lowestBit(remaining);
+         remaining &= ~(1u << bit);
+         keys[count++] = word * 32 + bit;
+      }
+   }
+   return count;
+}
+
+
+
+//////////////////////////////
+//
+// NoteState::getHighestHeld -- returns the highest key held down, or
+//     -1 if no keys are held.
+//     default value: channel = NOTESTATE_ALL_CHANNELS
+//
+
+int NoteState::getHighestHeld(int channel) const {
+   const uint32_t* bits = channel < 0 ? anyHeldBits : heldBits[channel & 0x0f];
+   for (int word=3; word>=0; word--) {
+      if (bits[word] != 0) {
+         return word * 32 + highestBit(bits[word]);
+      }
+   }
+   return -1;
+}
+
+
+
+//////////////////////////////
+//
+// NoteState::getLatestHeld -- returns the most recently played key
+//     which is still held down, or -1 if no keys are held.
+//     default value: channel = NOTESTATE_ALL_CHANNELS
+//
+
+int NoteState::getLatestHeld(int channel) const {
+   for (int slot=newestHeld; slot>=0; slot=prevHeld[slot]) {
+      if (channel < 0 || (slot >> 7) == (channel & 0x0f)) {
+         return slot & 0x7f;
+      }
+   }
+   return -1;
+}
+
+
+
+//////////////////////////////
+//
+// NoteState::getLowestHeld -- returns the lowest key held down, or
+//     -1 if no keys are held.
+//     default value: channel = NOTESTATE_ALL_CHANNELS
+//
+
+int NoteState::getLowestHeld(int channel) const {
+   const uint32_t* bits = channel < 0 ? anyHeldBits : heldBits[channel & 0x0f];
+   for (int word=0; word<4; word++) {
+      if (bits[word] != 0) {
+         return word * 32 + lowestBit(bits[word]);
+      }
+   }
+   return -1;
+}
+
+
+
+//////////////////////////////
+//
+// NoteState::getOnTime -- returns the time of the last note-on for
+//     the key (in the time units of the MIDI input, milliseconds).
+//     default value: channel = 0
+//
+
+long NoteState::getOnTime(int key, int channel) const {
+   return onTime[channel & 0x0f][key & 0x7f];
+}
+
+
+
+//////////////////////////////
+//
+// NoteState::getSoundingCount -- returns the number of notes which
+//     are held down or held by the sustain pedal.
+//     default value: channel = NOTESTATE_ALL_CHANNELS
+//
+
+int NoteState::getSoundingCount(int channel) const {
+   int count = 0;
+   int first = channel < 0 ? 0  : (channel & 0x0f);
+   int last  = channel < 0 ? 15 : (channel & 0x0f);
+   for (int i=first; i<=last; i++) {
+      for (int word=0; word<4; word++) {
+         count += countBits(soundingBits[i][word]);
+      }
+   }
+   return count;
+}
+
+
+
+//////////////////////////////
+//
+// NoteState::getVelocity -- returns the attack velocity of the last
+//     note-on for the key.  The velocity is kept after the key is
+//     released.
+//     default value: channel = 0
+//
+
+int NoteState::getVelocity(int key, int channel) const {
+   return velocity[channel & 0x0f][key & 0x7f];
+}
+
+
+
+//////////////////////////////
+//
+// NoteState::heldQ -- returns true if the key is held down.
+//     default value: channel = 0
+//
+
+int NoteState::heldQ(int key, int channel) const {
+   key &= 0x7f;
+   return (heldBits[channel & 0x0f][key >> 5] >> (key & 0x1f)) & 1;
+}
+
+
+
+//////////////////////////////
+//
+// NoteState::noteOff -- release a key.  The note keeps sounding if
+//     the sustain pedal is down.
+//
+
+void NoteState::noteOff(int channel, int key) {
+   channel &= 0x0f;
+   key &= 0x7f;
+   if (!heldQ(key, channel)) {
+      return;
+   }
+   releaseHeld(channel, key);
+   if (!sustainQ(channel)) {
+      soundingBits[channel][key >> 5] &= ~(1u << (key & 0x1f));
+   }
+}
+
+
+
+//////////////////////////////
+//
+// NoteState::noteOn -- press a key.  A note-on with a velocity of 0
+//     is a note-off.  A key which is already held is moved to the end
+//     of the list of played notes.
+//
+
+void NoteState::noteOn(int channel, int key, int aVelocity, long time) {
+   channel &= 0x0f;
+   key &= 0x7f;
+   if (aVelocity <= 0) {
+      noteOff(channel, key);
+      return;
+   }
+
+   velocity[channel][key] = (uchar)aVelocity;
+   onTime[channel][key] = time;
+   if (heldQ(key, channel)) {
+      releaseHeld(channel, key);
+   }
+
+   uint32_t mask = 1u << (key & 0x1f);
+   heldBits[channel][key >> 5] |= mask;
+   soundingBits[channel][key >> 5] |= mask;
+   anyHeldBits[key >> 5] |= mask;
+   heldChannels[key]++;
+   heldCount[channel]++;
+   totalHeld++;
+
+   int slot = (channel << 7) | key;
+   prevHeld[slot] = newestHeld;
+   nextHeld[slot] = -1;
+   if (newestHeld >= 0) {
+      nextHeld[newestHeld] = slot;
+   } else {
+      oldestHeld = slot;
+   }
+   newestHeld = slot;
+}
+
+
+
+//////////////////////////////
+//
+// NoteState::process -- update the state from a MIDI message.  Note-on,
+//     note-off, sustain pedal (controller 64), all sound off (120) and
+//     all notes off (123) messages are used; other messages are ignored.
+//     The time of a note-on comes from the tick field of the message.
+//
+
+void NoteState::process(const smf::MidiEvent& aMessage) {
+   int command = aMessage.getCommandByte() & 0xf0;
+   int channel = aMessage.getCommandByte() & 0x0f;
+   switch (command) {
+      case 0x90:
+         noteOn(channel, aMessage.getP1(), aMessage.getP2(), aMessage.tick);
+         break;
+      case 0x80:
+         noteOff(channel, aMessage.getP1());
+         break;
+      case 0xb0:
+         switch (aMessage.getP1()) {
+            case 64:
+               setSustain(channel, aMessage.getP2() >= 64);
+               break;
+            case 120:
+            case 123:
+               allNotesOff(channel);
+               break;
+         }
+         break;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// NoteState::reset -- release all keys and pedals, and clear the
+//     velocities and times.
+//
+
+void NoteState::reset(void) {
+   memset(velocity, 0, sizeof(velocity));
+   memset(onTime, 0, sizeof(onTime));
+   memset(heldBits, 0, sizeof(heldBits));
+   memset(soundingBits, 0, sizeof(soundingBits));
+   memset(anyHeldBits, 0, sizeof(anyHeldBits));
+   memset(heldChannels, 0, sizeof(heldChannels));
+   memset(heldCount, 0, sizeof(heldCount));
+   totalHeld   = 0;
+   sustainBits = 0;
+   oldestHeld  = -1;
+   newestHeld  = -1;
+}
+
+
+
+//////////////////////////////
+//
+// NoteState::setSustain -- press or release the sustain pedal.  When
+//     the pedal is released, notes whose keys are not held stop sounding.
+//
+
+void NoteState::setSustain(int channel, int downQ) {
+   channel &= 0x0f;
+   if (downQ) {
+      sustainBits |= 1 << channel;
+   } else {
+      sustainBits &= ~(1 << channel);
+      for (int word=0; word<4; word++) {
+         soundingBits[channel][word] = heldBits[channel][word];
+      }
+   }
+}
+
+
+
+//////////////////////////////
+//
+// NoteState::soundingQ -- returns true if the key is held down or is
+//     held by the sustain pedal.
+//     default value: channel = 0
+//
+
+int NoteState::soundingQ(int key, int channel) const {
+   key &= 0x7f;
+   return (soundingBits[channel & 0x0f][key >> 5] >> (key & 0x1f)) & 1;
+}
+
+
+
+//////////////////////////////
+//
+// NoteState::sustainQ -- returns true if the sustain pedal is down.
+//     default value: channel = 0
+//
+
+int NoteState::sustainQ(int channel) const {
+   return (sustainBits >> (channel & 0x0f)) & 1;
+}
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// protected functions
+//
+
+
+//////////////////////////////
+//
+// NoteState::releaseHeld -- remove a held key from the held note
+//     bits and the list of played notes.  Does not change the
+//     sounding state.
+//
+
+void NoteState::releaseHeld(int channel, int key) {
+   uint32_t mask = 1u << (key & 0x1f);
+   heldBits[channel][key >> 5] &= ~mask;
+   heldCount[channel]--;
+   totalHeld--;
+   if (--heldChannels[key] == 0) {
+      anyHeldBits[key >> 5] &= ~mask;
+   }
+
+   int slot = (channel << 7) | key;
+   if (prevHeld[slot] >= 0) {
+      nextHeld[prevHeld[slot]] = nextHeld[slot];
+   } else {
+      oldestHeld = nextHeld[slot];
+   }
+   if (nextHeld[slot] >= 0) {
+      prevHeld[nextHeld[slot]] = prevHeld[slot];
+   } else {
+      newestHeld = prevHeld[slot];
+   }
+}
+
+
+
@@ -0,0 +1,1369 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sun Oct 18 20:52:16 PDT 2026
+// Last Modified: Sun Oct 18 20:52:20 PDT 2026
+// Last Modified: Sun Oct 18 22:05:15 PDT 2026 (indexed text search)
+// Last Modified: Mon Oct 19 06:02:41 PDT 2026 (keep ticks per quarter)
+// Last Modified: Mon Oct 19 06:48:22 PDT 2026 (read compiled files)
+// Last Modified: Mon Oct 19 07:21:43 PDT 2026 (match with SearchPattern)
+// Last Modified: Mon Oct 19 07:36:12 PDT 2026 (OLDCPP includes)
+// Last Modified: Mon Oct 19 08:04:51 PDT 2026 (SearchPattern declared only)
+// Filename:      ...improv/src/PerformData.cpp
+// Web Address:   http://sig.sapp.org/src/sig/PerformData.cpp
+// Syntax:        C++
+//
+// Description:   Data for a somewhat defunct class, Perform.
+//                The records are stored in one array.  The measure and
+//                tempo records are indexed so that a measure, and the
+//                tempo in effect at any record, can be found with a
+//                binary search.  The indexes are rebuilt the next time
+//                they are needed after the records change, along
+//                with the list of text records used for searching.
+//
+
+#include "PerformData.h"
+#include "SearchPattern.h"
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include <utility>
+
+#ifndef OLDCPP
+   #include <iostream>
+   #include <fstream>
+   using namespace std;
+#else
+   #include <iostream.h>
+   #include <fstream.h>
+#endif
+
+// Humdrum line types for inputHumdrumMidiFile:
+#define HUMDRUM_EMPTY           0
+#define HUMDRUM_DATA            1
+#define HUMDRUM_GLOBAL_COMMENT  2
+#define HUMDRUM_LOCAL_COMMENT   3
+#define HUMDRUM_EXINTERP        4
+#define HUMDRUM_INTERP          5
+#define HUMDRUM_MEASURE         6
+
+#define HUMDRUM_LINE_SIZE       (16 * 1024)
+
+// function declarations:
+static void  mergeSort       (int* order, int* temp, int count,
+                              const int* keys);
+static void  deleteSegments  (Array<char*>* segments);
+
+
+//////////////////////////////
+//
+// PerformData::PerformData --
+//
+
+PerformData::PerformData(void) {
+   currentIndex = 0;
+   timeFormat = PERFORM_TIME_UNKNOWN;
+   begin.setType(PERFORM_TYPE_BEGIN);
+   end.setType(PERFORM_TYPE_END);
+   indexValidQ = 0;
+   dataTicksPerQuarter = 72;
+   matchPattern = new SearchPattern;
+   last_tempo = 0.0;
+   humdrum_time = 0;
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::~PerformData --
+//
+
+PerformData::~PerformData() {
+   delete matchPattern;
+   matchPattern = NULL;
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::add -- add a copy of the record to the end of the list.
+//    Returns the index of the new record.
+//
+
+int PerformData::add(PerformDataRecord& record) {
+   records.append(record);
+   indexValidQ = 0;
+   return (int)records.getSize() - 1;
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::back -- move to the previous record.
+//
+
+void PerformData::back(void) {
+   if (currentIndex >= 0) {
+      currentIndex--;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::bof -- returns true if before the first record.
+//
+
+int PerformData::bof(void) {
+   return currentIndex < 0;
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::clear -- remove all records.  The ticks per quarter
+//    note go back to 72, the Humdrum resolution.
+//
+
+void PerformData::clear(void) {
+   records.setSize(0);
+   currentIndex = 0;
+   timeFormat = PERFORM_TIME_UNKNOWN;
+   indexValidQ = 0;
+   dataTicksPerQuarter = 72;
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::determineTimeType -- returns the time format if it is
+//    known.  Otherwise guesses that the times are relative if any of
+//    them decrease, and absolute if they never do.
+//
+
+int PerformData::determineTimeType(void) {
+   if (timeFormat != PERFORM_TIME_UNKNOWN || records.getSize() == 0) {
+      return timeFormat;
+   }
+   PerformDataRecord* base = records.getBase();
+   for (long i=1; i<records.getSize(); i++) {
+      if (base[i].getTime() < base[i-1].getTime()) {
+         return PERFORM_TIME_RELATIVE;
+      }
+   }
+   return PERFORM_TIME_ABSOLUTE;
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::eof -- returns true if after the last record.
+//
+
+int PerformData::eof(void) {
+   return currentIndex >= records.getSize();
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::findMeasure -- returns the index of the first record
+//    for the given measure number, or -1 if there is no such measure.
+//
+
+int PerformData::findMeasure(int aMeasure) {
+   if (!indexValidQ) {
+      buildIndex();
+   }
+   PerformDataRecord* base = records.getBase();
+   int* list = measureIndex.getBase();
+   int low  = 0;
+   int high = (int)measureIndex.getSize();
+   while (low < high) {
+      int middle = (low + high) / 2;
+      if (base[list[middle]].getMeasureNumber() < aMeasure) {
+         low = middle + 1;
+      } else {
+         high = middle;
+      }
+   }
+   if (low < measureIndex.getSize() &&
+         base[list[low]].getMeasureNumber() == aMeasure) {
+      return list[low];
+   }
+   return -1;
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::findMeasureAt -- returns the index of the last measure
+//    record at or before the given record index, or -1 if there is none.
+//
+
+int PerformData::findMeasureAt(int index) {
+   if (!indexValidQ) {
+      buildIndex();
+   }
+   int* list = measureOrder.getBase();
+   int low  = 0;
+   int high = (int)measureOrder.getSize();
+   while (low < high) {
+      int middle = (low + high) / 2;
+      if (list[middle] <= index) {
+         low = middle + 1;
+      } else {
+         high = middle;
+      }
+   }
+   return low > 0 ? list[low - 1] : -1;
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::findTempo -- returns the index of the tempo record which
+//    is in effect at the given record index, or -1 if there is none.
+//
+
+int PerformData::findTempo(int index) {
+   if (!indexValidQ) {
+      buildIndex();
+   }
+   int* list = tempoIndex.getBase();
+   int low  = 0;
+   int high = (int)tempoIndex.getSize();
+   while (low < high) {
+      int middle = (low + high) / 2;
+      if (list[middle] <= index) {
+         low = middle + 1;
+      } else {
+         high = middle;
+      }
+   }
+   return low > 0 ? list[low - 1] : -1;
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::inputAsciiMidiFile -- read a MIDI file which has been
+//    converted to text (such as by the textmidi program).  The MidiFile
+//    class recognizes the text form when reading.
+//
+
+void PerformData::inputAsciiMidiFile(const char* filename) {
+   inputMidiFile(filename);
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::inputHumdrumMidiFile -- read a Humdrum file containing
+//    **MIDI spines.  Each **MIDI data token contains subtokens of the
+//    form "ticks/key/velocity", where ticks is the time since the
+//    previous data line (72 ticks per quarter note), and a negative
+//    key number is a note-off.  Channels are given with *Ch#, tempos
+//    with *MM#, and measures with =#.  Global comments become text
+//    records.
+//
+
+void PerformData::inputHumdrumMidiFile(const char* filename) {
+   ifstream input(filename);
+   if (!input.is_open()) {
+      cerr << "Error: cannot read Humdrum file " << filename << endl;
+      exit(1);
+   }
+
+   clear();
+   last_tempo = 0.0;
+   humdrum_time = 0;
+
+   Array<int> chan_list;      // MIDI channel of each spine, -1 if not **MIDI
+   Array<int> path_list;      // spines waiting for an exclusive interp.
+   chan_list.setSize(0);
+   chan_list.allowGrowth(1);
+   path_list.setSize(0);
+   path_list.allowGrowth(1);
+
+   char* buffer = new char[HUMDRUM_LINE_SIZE];
+   PerformDataRecord record;
+   while (getNextLine(buffer, input)) {
+      switch (getLineType(buffer)) {
+         case HUMDRUM_EXINTERP:
+            if (chan_list.getSize() == 0) {
+               processExclusiveInterpLine(buffer, chan_list);
+               path_list.setSize(chan_list.getSize());
+               path_list.zero();
+            } else {
+               processInterpLine(buffer, chan_list, path_list);
+            }
+            break;
+         case HUMDRUM_INTERP:
+            processInterpLine(buffer, chan_list, path_list);
+            break;
+         case HUMDRUM_MEASURE:
+            if (getMeasureValue(buffer) >= 0) {
+               record.setMeasure(humdrum_time, buffer);
+               add(record);
+            }
+            break;
+         case HUMDRUM_GLOBAL_COMMENT:
+            {
+            int length = (int)strlen(buffer);
+            buffer[length] = '\n';
+            record.setText(humdrum_time, buffer, length + 1);
+            add(record);
+            }
+            break;
+         case HUMDRUM_DATA:
+            processHumdrumData(buffer, chan_list);
+            break;
+         default:
+            break;
+      }
+   }
+   delete [] buffer;
+
+   markAsAbsoluteTime();
+   sort();
+   setTimeType(PERFORM_TIME_RELATIVE);
+   currentIndex = 0;
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::inputMidiFile -- read a standard MIDI file.  Measure
+//    records are made from the time signatures (4/4 until the first
+//    time signature), tempo records from the tempo meta messages, and
+//    text records from the text meta messages.  The times are converted
+//    to relative times in MIDI file ticks.  Compiled performance files
+//    (see PerformFile) are also read.
+//
+
+void PerformData::inputMidiFile(const char* filename) {
+   if (PerformFile::isPerformFile(filename)) {
+      PerformFile file;
+      if (!file.open(filename)) {
+         exit(1);
+      }
+      inputPerformFile(file);
+      return;
+   }
+
+   smf::MidiFile midifile;
+   if (!midifile.read(filename)) {
+      cerr << "Error: cannot read MIDI file " << filename << endl;
+      exit(1);
+   }
+   inputMidiData(midifile);
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::getBar -- same as getMeasure.
+//
+
+int PerformData::getBar(void) {
+   return getMeasure();
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::getData -- returns the data of the current record.
+//
+
+char* PerformData::getData(void) {
+   return current().getData();
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::getIndex -- returns the current record index.
+//
+
+int PerformData::getIndex(void) {
+   return currentIndex;
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::getLength -- returns the data length of the current record.
+//
+
+int PerformData::getLength(void) {
+   return current().getLength();
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::getMeasure -- returns the measure number of the current
+//    record, or -1 if it is not a measure record.
+//
+
+int PerformData::getMeasure(void) {
+   return current().getMeasureNumber();
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::getSize -- returns the number of records.
+//
+
+int PerformData::getSize(void) {
+   return (int)records.getSize();
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::getTempo -- returns the tempo of the current record, or
+//    0.0 if it is not a tempo record.
+//
+
+double PerformData::getTempo(void) {
+   return current().getTempoNumber();
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::getTicksPerQuarterNote -- returns the time resolution
+//    of the records: 72 for Humdrum files, or that of the MIDI file.
+//
+
+int PerformData::getTicksPerQuarterNote(void) {
+   return dataTicksPerQuarter;
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::getTime -- returns the time of the current record.
+//
+
+int PerformData::getTime(void) {
+   return current().getTime();
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::getTimeType --
+//
+
+int PerformData::getTimeType(void) {
+   return timeFormat;
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::getType -- returns the type of the current record.
+//
+
+int PerformData::getType(void) {
+   return current().getType();
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::markAsAbsoluteTime -- set the time format without
+//    changing the times.
+//
+
+void PerformData::markAsAbsoluteTime(void) {
+   timeFormat = PERFORM_TIME_ABSOLUTE;
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::markAsRelativeTime -- set the time format without
+//    changing the times.
+//
+
+void PerformData::markAsRelativeTime(void) {
+   timeFormat = PERFORM_TIME_RELATIVE;
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::match -- returns true if the current record matches
+//    the regular expression.  The expression is only compiled again
+//    when it changes.
+//
+
+int PerformData::match(const char* matchString) {
+   matchPattern->setPattern(matchString);
+   return current().match(*matchPattern);
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::next -- move to the next record.
+//
+
+void PerformData::next(void) {
+   if (currentIndex < records.getSize()) {
+      currentIndex++;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::operator[] -- returns the begin or end record if the
+//    index is out of range.
+//
+
+PerformDataRecord& PerformData::operator[](int index) {
+   if (index < 0) {
+      return begin;
+   } else if (index >= records.getSize()) {
+      return end;
+   }
+   return records.getBase()[index];
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::print -- print all of the records, one per line.
+//
+
+ostream& PerformData::print(ostream& out) {
+   PerformDataRecord* base = records.getBase();
+   for (long i=0; i<records.getSize(); i++) {
+      base[i].print(out);
+   }
+   return out;
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::ready -- returns true if the current record is due at
+//    the given time.
+//
+
+int PerformData::ready(int aTime) {
+   return !eof() && !bof() && current().getTime() <= aTime;
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::search -- returns the index of the first text, measure
+//    or tempo record, starting at startIndex and going forward if the
+//    direction is positive or backward if negative, which matches the
+//    pattern.  Returns -1 if nothing matches.  Patterns without regular
+//    expression characters are searched for as plain text.
+//
+
+int PerformData::search(const char* pattern, int startIndex, int direction) {
+   if (!indexValidQ) {
+      buildIndex();
+   }
+   return finder.find(*this, pattern, startIndex, direction);
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::setIndex -- set the current record.  Indexes before the
+//    first record or after the last one are limited to -1 and getSize().
+//
+
+void PerformData::setIndex(int index) {
+   if (index < -1) {
+      index = -1;
+   } else if (index > records.getSize()) {
+      index = (int)records.getSize();
+   }
+   currentIndex = index;
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::setTime -- set the time of the current record.
+//
+
+void PerformData::setTime(int aTime) {
+   if (!eof() && !bof()) {
+      current().setTime(aTime);
+   }
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::setTimeType -- convert the record times between absolute
+//    and relative times.  If the current format is unknown, then the
+//    times are only marked with the new format.
+//
+
+void PerformData::setTimeType(int aTimeType) {
+   PerformDataRecord* base = records.getBase();
+   long count = records.getSize();
+   long i;
+   if (timeFormat == PERFORM_TIME_ABSOLUTE &&
+         aTimeType == PERFORM_TIME_RELATIVE) {
+      for (i=count-1; i>0; i--) {
+         base[i].setTime(base[i].getTime() - base[i-1].getTime());
+      }
+   } else if (timeFormat == PERFORM_TIME_RELATIVE &&
+         aTimeType == PERFORM_TIME_ABSOLUTE) {
+      for (i=1; i<count; i++) {
+         base[i].setTime(base[i].getTime() + base[i-1].getTime());
+      }
+   }
+   timeFormat = aTimeType;
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::setType -- set the type of the current record.
+//
+
+void PerformData::setType(int aType) {
+   if (!eof() && !bof()) {
+      current().setType(aType);
+      indexValidQ = 0;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::swap -- exchange two records.  If timeHeld is true, then
+//    the times stay in their places and only the data is exchanged.
+//    default value: timeHeld = 0
+//
+
+void PerformData::swap(int index1, int index2, int timeHeld) {
+   if (index1 < 0 || index2 < 0 || index1 >= records.getSize() ||
+         index2 >= records.getSize() || index1 == index2) {
+      return;
+   }
+   PerformDataRecord* base = records.getBase();
+   int time1 = base[index1].getTime();
+   int time2 = base[index2].getTime();
+   std::swap(base[index1], base[index2]);
+   if (timeHeld) {
+      base[index1].setTime(time1);
+      base[index2].setTime(time2);
+   }
+   indexValidQ = 0;
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::sort -- sort the records by time.  Records at the same
+//    time stay in their original order.  Relative times are converted
+//    to absolute times for sorting and then back again.
+//
+
+void PerformData::sort(void) {
+   int count = (int)records.getSize();
+   if (count < 2) {
+      return;
+   }
+
+   int timeType = determineTimeType();
+   timeFormat = timeType;
+   if (timeType == PERFORM_TIME_RELATIVE) {
+      setTimeType(PERFORM_TIME_ABSOLUTE);
+   }
+
+   PerformDataRecord* base = records.getBase();
+   int* keys  = new int[count];
+   int* order = new int[count];
+   int* temp  = new int[count];
+   int sortedQ = 1;
+   int i;
+   for (i=0; i<count; i++) {
+      keys[i] = base[i].getTime();
+      order[i] = i;
+      if (i > 0 && keys[i] < keys[i-1]) {
+         sortedQ = 0;
+      }
+   }
+
+   if (!sortedQ) {
+      mergeSort(order, temp, count, keys);
+      SigCollection<PerformDataRecord> sorted;
+      sorted.setSize(count);
+      PerformDataRecord* target = sorted.getBase();
+      for (i=0; i<count; i++) {
+         target[i] = std::move(base[order[i]]);
+      }
+      records.swap(sorted);
+      indexValidQ = 0;
+   }
+
+   delete [] temp;
+   delete [] order;
+   delete [] keys;
+
+   if (timeType == PERFORM_TIME_RELATIVE) {
+      setTimeType(PERFORM_TIME_RELATIVE);
+   }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// protected functions
+//
+
+
+//////////////////////////////
+//
+// PerformData::buildIndex -- make the list of measure records sorted
+//    by measure number (records for the same measure number stay in
+//    order), the list of measure and tempo records in the order that
+//    they occur, and the list of records which contain text.
+//
+
+void PerformData::buildIndex(void) {
+   measureIndex.setSize(0);
+   measureOrder.setSize(0);
+   tempoIndex.setSize(0);
+   PerformDataRecord* base = records.getBase();
+   int count = (int)records.getSize();
+   int i;
+   for (i=0; i<count; i++) {
+      if (base[i].getType() == PERFORM_TYPE_MEASURE) {
+         if (base[i].getMeasureNumber() >= 0) {
+            measureIndex.append(i);
+         }
+      } else if (base[i].getType() == PERFORM_TYPE_TEMPO) {
+         tempoIndex.append(i);
+      }
+   }
+
+   // measure numbers usually only increase, but may not (repeats)
+   int measureCount = (int)measureIndex.getSize();
+   measureOrder.reserve(measureCount);
+   for (i=0; i<measureCount; i++) {
+      measureOrder.append(measureIndex[i]);
+   }
+   int* list = measureIndex.getBase();
+   int sortedQ = 1;
+   for (i=1; i<measureCount; i++) {
+      if (base[list[i]].getMeasureNumber() <
+            base[list[i-1]].getMeasureNumber()) {
+         sortedQ = 0;
+         break;
+      }
+   }
+   if (!sortedQ) {
+      int* keys  = new int[count];
+      int* temp  = new int[measureCount];
+      for (i=0; i<measureCount; i++) {
+         keys[list[i]] = base[list[i]].getMeasureNumber();
+      }
+      mergeSort(list, temp, measureCount, keys);
+      delete [] temp;
+      delete [] keys;
+   }
+
+   finder.index(*this);
+   indexValidQ = 1;
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::current -- returns the current record, or the begin
+//    or end record if outside of the list.
+//
+
+PerformDataRecord& PerformData::current(void) {
+   return (*this)[currentIndex];
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::inputMidiData -- convert a MIDI file into records.
+//    The records are added with absolute times in the order: measures,
+//    then each track in turn, so that the stable sort puts a measure
+//    before the notes at the same time, and keeps the track order.
+//
+
+void PerformData::inputMidiData(smf::MidiFile& midifile) {
+   clear();
+   midifile.absoluteTicks();
+   int tpq = midifile.getTicksPerQuarterNote();
+   if (tpq <= 0) {
+      tpq = 120;
+   }
+   dataTicksPerQuarter = tpq;
+
+   // find the time signatures and the end of the music
+   Array<int> meterTicks;
+   Array<int> meterLengths;
+   meterTicks.setSize(0);
+   meterTicks.allowGrowth(1);
+   meterLengths.setSize(0);
+   meterLengths.allowGrowth(1);
+   int lastTick = 0;
+   long total = 0;
+   int i, j;
+   for (i=0; i<midifile.getTrackCount(); i++) {
+      total += midifile.getNumEvents(i);
+      for (j=0; j<midifile.getNumEvents(i); j++) {
+         smf::MidiEvent& event = midifile.getEvent(i, j);
+         if (event.tick > lastTick) {
+            lastTick = event.tick;
+         }
+         if (event.size() >= 5 && event[0] == 0xff && event[1] == 0x58) {
+            int length = event[3] * tpq * 4 / (1 << (event[4] & 0x0f));
+            if (length > 0) {
+               // keep the list sorted by time
+               int k = (int)meterTicks.getSize();
+               meterTicks.append(event.tick);
+               meterLengths.append(length);
+               while (k > 0 && meterTicks[k-1] > event.tick) {
+                  meterTicks[k] = meterTicks[k-1];
+                  meterLengths[k] = meterLengths[k-1];
+                  k--;
+               }
+               meterTicks[k] = event.tick;
+               meterLengths[k] = length;
+            }
+         }
+      }
+   }
+
+   records.reserve(total + lastTick / tpq + 1);
+   PerformDataRecord record;
+
+   int length  = tpq * 4;
+   int meter   = 0;
+   int tick    = 0;
+   int measure = 1;
+   while (tick <= lastTick) {
+      while (meter < meterTicks.getSize() && meterTicks[meter] <= tick) {
+         length = meterLengths[meter];
+         meter++;
+      }
+      int nextTick = tick + length;
+      if (meter < meterTicks.getSize() && meterTicks[meter] < nextTick) {
+         nextTick = meterTicks[meter];
+      }
+      record.setMeasure(tick, measure++);
+      add(record);
+      tick = nextTick;
+   }
+
+   for (i=0; i<midifile.getTrackCount(); i++) {
+      for (j=0; j<midifile.getNumEvents(i); j++) {
+         smf::MidiEvent& event = midifile.getEvent(i, j);
+         int size = (int)event.size();
+         if (size == 0) {
+            continue;
+         }
+         if (event[0] != 0xff) {
+            record.setMidi(event.tick, (char*)event.data(), size);
+            add(record);
+            continue;
+         }
+         if (size < 3) {
+            continue;
+         }
+         // skip the variable-length data size
+         int start = 2;
+         while (start < size && (event[start] & 0x80)) {
+            start++;
+         }
+         start++;
+         if (event[1] == 0x51 && size >= 6) {
+            int usec = (event[3] << 16) | (event[4] << 8) | event[5];
+            if (usec > 0) {
+               record.setTempo(event.tick, (int)(60000000.0 / usec + 0.5));
+               add(record);
+            }
+         } else if (event[1] >= 0x01 && event[1] <= 0x07 && start <= size) {
+            record.setText(event.tick, (char*)event.data() + start,
+                  size - start);
+            add(record);
+         }
+      }
+   }
+
+   markAsAbsoluteTime();
+   sort();
+   setTimeType(PERFORM_TIME_RELATIVE);
+   currentIndex = 0;
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::inputPerformFile -- convert a compiled performance file
+//    into records, using its measure and tempo tables.  Compiled files
+//    do not keep text meta messages, so there are no text records.
+//
+
+void PerformData::inputPerformFile(PerformFile& file) {
+   clear();
+   dataTicksPerQuarter = file.getTicksPerQuarterNote();
+
+   records.reserve(file.getMeasureCount() + file.getTempoCount() +
+         file.getEventCount());
+   PerformDataRecord record;
+   int i;
+   for (i=0; i<file.getMeasureCount(); i++) {
+      record.setMeasure(file.getMeasure(i).tick, i + 1);
+      add(record);
+   }
+   for (i=0; i<file.getTempoCount(); i++) {
+      const PerformMarker& tempo = file.getTempo(i);
+      if (tempo.value > 0) {
+         record.setTempo(tempo.tick, (int)(60000000.0 / tempo.value + 0.5));
+         add(record);
+      }
+   }
+
+   const PerformEvent* events = file.getEvents();
+   for (i=0; i<file.getEventCount(); i++) {
+      const PerformEvent& event = events[i];
+      if (event.size > 4) {
+         const uchar* bytes = file.getLongMessage(event);
+         if (bytes != NULL) {
+            record.setMidi(event.tick, (const char*)bytes, event.size);
+            add(record);
+         }
+      } else if (event.size > 0) {
+         record.setMidi(event.tick, (const char*)event.data, event.size);
+         add(record);
+      }
+   }
+
+   markAsAbsoluteTime();
+   sort();
+   setTimeType(PERFORM_TIME_RELATIVE);
+   currentIndex = 0;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// private functions
+//
+
+
+//////////////////////////////
+//
+// PerformData::getLineType -- returns the type of a Humdrum line.
+//
+
+int PerformData::getLineType(const char* line) {
+   if (line[0] == '\0') {
+      return HUMDRUM_EMPTY;
+   } else if (line[0] == '!') {
+      return line[1] == '!' ? HUMDRUM_GLOBAL_COMMENT : HUMDRUM_LOCAL_COMMENT;
+   } else if (line[0] == '*') {
+      return line[1] == '*' ? HUMDRUM_EXINTERP : HUMDRUM_INTERP;
+   } else if (line[0] == '=') {
+      return HUMDRUM_MEASURE;
+   }
+   return HUMDRUM_DATA;
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::getMeasureValue -- returns the number of a measure line
+//    such as "=12", or -1 if there is no number.
+//
+
+int PerformData::getMeasureValue(const char* string) {
+   while (*string == '=') {
+      string++;
+   }
+   if (!isdigit(*string)) {
+      return -1;
+   }
+   return atoi(string);
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::getNextLine -- read the next line of the input, without
+//    the newline.  Returns 0 at the end of the input.
+//
+
+int PerformData::getNextLine(char* buffer, istream& input) {
+   // leave room to add a newline to the line
+   input.getline(buffer, HUMDRUM_LINE_SIZE - 1);
+   if (input.eof() && buffer[0] == '\0') {
+      return 0;
+   }
+   if (input.fail()) {
+      if (input.eof()) {
+         return 0;
+      }
+      // line was too long: drop the rest of it
+      input.clear();
+      input.ignore(1 << 30, '\n');
+   }
+   int length = (int)strlen(buffer);
+   if (length > 0 && buffer[length-1] == '\r') {
+      buffer[length-1] = '\0';
+   }
+   return 1;
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::getSpineCount -- returns the number of tab-separated
+//    spines on a line.
+//
+
+int PerformData::getSpineCount(const char* aString) {
+   int count = 1;
+   while (*aString != '\0') {
+      if (*aString == '\t') {
+         count++;
+      }
+      aString++;
+   }
+   return count;
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::processHumdrumData -- add the MIDI messages on a data
+//    line.  The time of the line is the largest tick value of its
+//    subtokens.
+//
+
+void PerformData::processHumdrumData(const char* currentLine,
+      Array<int>& chan_list) {
+   Array<char*>* tokens = segment(currentLine);
+   int count = (int)tokens->getSize();
+   if (count > chan_list.getSize()) {
+      count = (int)chan_list.getSize();
+   }
+
+   int i;
+   int delta = 0;
+   for (i=0; i<count; i++) {
+      if (chan_list[i] < 0 || strcmp((*tokens)[i], ".") == 0) {
+         continue;
+      }
+      const char* sub = (*tokens)[i];
+      while (*sub != '\0') {
+         if (isdigit(*sub)) {
+            int ticks = atoi(sub);
+            if (ticks > delta) {
+               delta = ticks;
+            }
+         }
+         sub = strchr(sub, ' ');
+         if (sub == NULL) {
+            break;
+         }
+         sub++;
+      }
+   }
+   humdrum_time += delta;
+
+   PerformDataRecord record;
+   char message[3];
+   for (i=0; i<count; i++) {
+      if (chan_list[i] < 0 || strcmp((*tokens)[i], ".") == 0) {
+         continue;
+      }
+      const char* sub = (*tokens)[i];
+      while (sub != NULL && *sub != '\0') {
+         const char* keyField = strchr(sub, '/');
+         const char* space = strchr(sub, ' ');
+         if (keyField != NULL && (space == NULL || keyField < space)) {
+            int key = atoi(keyField + 1);
+            const char* velField = strchr(keyField + 1, '/');
+            int velocity = 64;
+            if (velField != NULL && (space == NULL || velField < space)) {
+               velocity = atoi(velField + 1);
+            }
+            if (velocity < 0)   velocity = 0;
+            if (velocity > 127) velocity = 127;
+            if (key < 0) {
+               message[0] = (char)(0x80 | chan_list[i]);
+               key = -key;
+            } else {
+               message[0] = (char)(0x90 | chan_list[i]);
+            }
+            message[1] = (char)(key & 0x7f);
+            message[2] = (char)velocity;
+            record.setMidi(humdrum_time, message, 3);
+            add(record);
+         }
+         sub = space != NULL ? space + 1 : NULL;
+      }
+   }
+
+   deleteSegments(tokens);
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::processInterpLine -- handle channel (*Ch#) and tempo
+//    (*MM#) interpretations, exclusive interpretations for spines added
+//    with *+, and the spine manipulators *^, *v, *x, *+ and *-.
+//
+
+void PerformData::processInterpLine(const char* line, Array<int>& chan_list,
+      Array<int>& path_list) {
+   Array<char*>* tokens = segment(line);
+   int count = (int)tokens->getSize();
+   if (count > chan_list.getSize()) {
+      count = (int)chan_list.getSize();
+   }
+
+   int i;
+   PerformDataRecord record;
+   for (i=0; i<count; i++) {
+      const char* token = (*tokens)[i];
+      if (path_list[i] && strncmp(token, "**", 2) == 0) {
+         chan_list[i] = strcmp(token, "**MIDI") == 0 ? 0 : -1;
+         path_list[i] = 0;
+      } else if (strncmp(token, "*Ch", 3) == 0 && isdigit(token[3])) {
+         if (chan_list[i] >= 0) {
+            int channel = atoi(token + 3) - 1;
+            chan_list[i] = channel < 0 ? 0 : (channel > 15 ? 15 : channel);
+         }
+      } else if (strncmp(token, "*MM", 3) == 0 && isdigit(token[3])) {
+         double tempo = atof(token + 3);
+         if (tempo > 0.0 && tempo != last_tempo) {
+            record.setTempo(humdrum_time, token + 3);
+            add(record);
+            last_tempo = tempo;
+         }
+      }
+   }
+
+   // spine manipulators
+   Array<int> newChannels;
+   Array<int> newPaths;
+   newChannels.setSize(0);
+   newChannels.allowGrowth(1);
+   newPaths.setSize(0);
+   newPaths.allowGrowth(1);
+   int zero = 0;
+   int one = 1;
+   i = 0;
+   while (i < count) {
+      const char* token = (*tokens)[i];
+      if (strcmp(token, "*^") == 0) {
+         newChannels.append(chan_list[i]);
+         newChannels.append(chan_list[i]);
+         newPaths.append(path_list[i]);
+         newPaths.append(path_list[i]);
+      } else if (strcmp(token, "*v") == 0) {
+         newChannels.append(chan_list[i]);
+         newPaths.append(path_list[i]);
+         while (i + 1 < count && strcmp((*tokens)[i+1], "*v") == 0) {
+            i++;
+         }
+      } else if (strcmp(token, "*-") == 0) {
+         // spine ends
+      } else if (strcmp(token, "*+") == 0) {
+         newChannels.append(chan_list[i]);
+         newPaths.append(path_list[i]);
+         int none = -1;
+         newChannels.append(none);
+         newPaths.append(one);
+      } else if (strcmp(token, "*x") == 0 && i + 1 < count &&
+            strcmp((*tokens)[i+1], "*x") == 0) {
+         newChannels.append(chan_list[i+1]);
+         newChannels.append(chan_list[i]);
+         newPaths.append(path_list[i+1]);
+         newPaths.append(path_list[i]);
+         i++;
+      } else {
+         newChannels.append(chan_list[i]);
+         newPaths.append(path_list[i]);
+      }
+      i++;
+   }
+   for (i=count; i<chan_list.getSize(); i++) {
+      newChannels.append(chan_list[i]);
+      newPaths.append(zero);
+   }
+   chan_list.swap(newChannels);
+   path_list.swap(newPaths);
+
+   deleteSegments(tokens);
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::processExclusiveInterpLine -- set the channel of each
+//    **MIDI spine to 0, and of the other spines to -1.
+//
+
+void PerformData::processExclusiveInterpLine(const char* line,
+      Array<int>& chan_list) {
+   Array<char*>* tokens = segment(line);
+   chan_list.setSize(tokens->getSize());
+   for (int i=0; i<tokens->getSize(); i++) {
+      chan_list[i] = strcmp((*tokens)[i], "**MIDI") == 0 ? 0 : -1;
+   }
+   deleteSegments(tokens);
+}
+
+
+
+//////////////////////////////
+//
+// PerformData::segment -- split a line into its tab-separated spines.
+//    The strings and the list must be deleted by the caller.
+//
+
+Array<char*>* PerformData::segment(const char* line) {
+   int count = getSpineCount(line);
+   Array<char*>* output = new Array<char*>;
+   output->setSize(count);
+   for (int i=0; i<count; i++) {
+      const char* tab = strchr(line, '\t');
+      int length = tab != NULL ? (int)(tab - line) : (int)strlen(line);
+      (*output)[i] = new char[length + 1];
+      strncpy((*output)[i], line, length);
+      (*output)[i][length] = '\0';
+      line += length + (tab != NULL ? 1 : 0);
+   }
+   return output;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// static functions
+//
+
+
+//////////////////////////////
+//
+// mergeSort -- stable sort of a list of indexes by the key of each index.
+//
+
+static void mergeSort(int* order, int* temp, int count, const int* keys) {
+   int width;
+   int i;
+   for (width=1; width<count; width*=2) {
+      for (i=0; i<count; i+=2*width) {
+         int left  = i;
+         int middle = i + width < count ? i + width : count;
+         int right = i + 2*width < count ? i + 2*width : count;
+         int a = left;
+         int b = middle;
+         int k = left;
+         while (a < middle && b < right) {
+            if (keys[order[b]] < keys[order[a]]) {
+               temp[k++] = order[b++];
+            } else {
+               temp[k++] = order[a++];
+            }
+         }
+         while (a < middle) {
+            temp[k++] = order[a++];
+         }
+         while (b < right) {
+            temp[k++] = order[b++];
+         }
+      }
+      for (i=0; i<count; i++) {
+         order[i] = temp[i];
+      }
+   }
+}
+
+
+
+//////////////////////////////
+//
+// deleteSegments -- free the list made by PerformData::segment.
+//
+
+static void deleteSegments(Array<char*>* segments) {
+   for (int i=0; i<segments->getSize(); i++) {
+      delete [] (*segments)[i];
+   }
+   delete segments;
+}
+
+
+
@@ -0,0 +1,538 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sun Oct 18 20:52:16 PDT 2026
+// Last Modified: Sun Oct 18 20:52:20 PDT 2026
+// Last Modified: Mon Oct 19 07:21:43 PDT 2026 (match with SearchPattern)
+// Last Modified: Mon Oct 19 08:04:51 PDT 2026 (SearchPattern declared only)
+// Filename:      ...improv/src/PerformDataRecord.cpp
+// Web Address:   http://sig.sapp.org/src/sig/PerformDataRecord.cpp
+// Syntax:        C++
+//
+// Description:   Data for a somewhat defunct class, Perform.
+//                Short data (MIDI messages, measure numbers and tempos)
+//                is stored inside of the record, so that an array of
+//                records does not need a memory allocation per record.
+//                The data is always followed by a null character so
+//                that text can be printed directly.
+//
+
+#include "PerformDataRecord.h"
+#include "SearchPattern.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef OLDCPP
+   #include <iostream>
+   using namespace std;
+#else
+   #include <iostream.h>
+#endif
+
+
+//////////////////////////////
+//
+// PerformDataRecord::PerformDataRecord --
+//
+
+PerformDataRecord::PerformDataRecord(void) {
+   time = 0;
+   type = PERFORM_TYPE_NULL;
+   length = 0;
+   shortData[0] = '\0';
+   longData = NULL;
+}
+
+
+PerformDataRecord::PerformDataRecord(PerformDataRecord& aRecord) {
+   time = aRecord.time;
+   type = aRecord.type;
+   length = 0;
+   shortData[0] = '\0';
+   longData = NULL;
+   setData(aRecord.getData(), aRecord.length);
+}
+
+
+PerformDataRecord::PerformDataRecord(PerformDataRecord&& aRecord) {
+   time = aRecord.time;
+   type = aRecord.type;
+   length = aRecord.length;
+   memcpy(shortData, aRecord.shortData, sizeof(shortData));
+   longData = aRecord.longData;
+
+   aRecord.length = 0;
+   aRecord.shortData[0] = '\0';
+   aRecord.longData = NULL;
+}
+
+
+
+//////////////////////////////
+//
+// PerformDataRecord::~PerformDataRecord --
+//
+
+PerformDataRecord::~PerformDataRecord() {
+   if (longData != NULL) {
+      delete [] longData;
+      longData = NULL;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// PerformDataRecord::getData -- returns the data of the record,
+//    followed by a null character.
+//
+
+char* PerformDataRecord::getData(void) {
+   return longData != NULL ? longData : shortData;
+}
+
+
+
+//////////////////////////////
+//
+// PerformDataRecord::getMeasureNumber -- returns the first number
+//    in the data of a measure record, or -1 if there is none.
+//
+
+int PerformDataRecord::getMeasureNumber(void) {
+   if (type != PERFORM_TYPE_MEASURE) {
+      return -1;
+   }
+   const char* data = getData();
+   while (*data != '\0' && !isdigit(*data)) {
+      data++;
+   }
+   if (*data == '\0') {
+      return -1;
+   }
+   return atoi(data);
+}
+
+
+
+//////////////////////////////
+//
+// PerformDataRecord::getLength -- returns the number of bytes of data,
+//    not counting the null character after the data.
+//
+
+int PerformDataRecord::getLength(void) {
+   return length;
+}
+
+
+
+//////////////////////////////
+//
+// PerformDataRecord::getTempoNumber -- returns the first number in
+//    the data of a tempo record, or 0.0 if there is none.
+//
+
+double PerformDataRecord::getTempoNumber(void) {
+   if (type != PERFORM_TYPE_TEMPO) {
+      return 0.0;
+   }
+   const char* data = getData();
+   while (*data != '\0' && !isdigit(*data) && *data != '.') {
+      data++;
+   }
+   return atof(data);
+}
+
+
+
+//////////////////////////////
+//
+// PerformDataRecord::getTime --
+//
+
+int PerformDataRecord::getTime(void) {
+   return time;
+}
+
+
+
+//////////////////////////////
+//
+// PerformDataRecord::getType --
+//
+
+int PerformDataRecord::getType(void) {
+   return type;
+}
+
+
+
+//////////////////////////////
+//
+// PerformDataRecord::match -- returns true if the regular expression
+//    matches the data of a text, measure or tempo record.  A bad
+//    expression matches nothing.  When checking many records, give
+//    a SearchPattern so that the expression is only compiled once.
+//
+
+int PerformDataRecord::match(const char* matchString) {
+   switch (type) {
+      case PERFORM_TYPE_TEXT:
+      case PERFORM_TYPE_MEASURE:
+      case PERFORM_TYPE_TEMPO:
+         break;
+      default:
+         return 0;
+   }
+   SearchPattern pattern(matchString);
+   return pattern.matches(getData());
+}
+
+
+int PerformDataRecord::match(const SearchPattern& pattern) {
+   switch (type) {
+      case PERFORM_TYPE_TEXT:
+      case PERFORM_TYPE_MEASURE:
+      case PERFORM_TYPE_TEMPO:
+         break;
+      default:
+         return 0;
+   }
+   return pattern.matches(getData());
+}
+
+
+
+//////////////////////////////
+//
+// PerformDataRecord::operator= --
+//
+
+PerformDataRecord& PerformDataRecord::operator=(PerformDataRecord& aRecord) {
+   if (&aRecord == this) {
+      return *this;
+   }
+   time = aRecord.time;
+   type = aRecord.type;
+   setData(aRecord.getData(), aRecord.length);
+   return *this;
+}
+
+
+PerformDataRecord& PerformDataRecord::operator=(PerformDataRecord&& aRecord) {
+   if (&aRecord == this) {
+      return *this;
+   }
+   if (longData != NULL) {
+      delete [] longData;
+   }
+   time = aRecord.time;
+   type = aRecord.type;
+   length = aRecord.length;
+   memcpy(shortData, aRecord.shortData, sizeof(shortData));
+   longData = aRecord.longData;
+
+   aRecord.length = 0;
+   aRecord.shortData[0] = '\0';
+   aRecord.longData = NULL;
+   return *this;
+}
+
+
+
+//////////////////////////////
+//
+// PerformDataRecord::print -- print the time, the type and the data
+//    of the record on one line.  MIDI data is printed in hex.
+//
+
+ostream& PerformDataRecord::print(ostream& out) {
+   out << time << '\t';
+   switch (type) {
+      case PERFORM_TYPE_NULL:    out << "null";    break;
+      case PERFORM_TYPE_TEXT:    out << "text";    break;
+      case PERFORM_TYPE_MIDI:    out << "midi";    break;
+      case PERFORM_TYPE_MEASURE: out << "measure"; break;
+      case PERFORM_TYPE_TEMPO:   out << "tempo";   break;
+      case PERFORM_TYPE_CLEAR:   out << "clear";   break;
+      case PERFORM_TYPE_IGNORED: out << "ignored"; break;
+      case PERFORM_TYPE_BEGIN:   out << "begin";   break;
+      case PERFORM_TYPE_END:     out << "end";     break;
+      default:                   out << type;
+   }
+
+   const char* data = getData();
+   if (type == PERFORM_TYPE_MIDI) {
+      char hex[8];
+      for (int i=0; i<length; i++) {
+         snprintf(hex, sizeof(hex), " %02x", (unsigned char)data[i]);
+         out << hex;
+      }
+   } else if (length > 0) {
+      out << '\t';
+      for (int i=0; i<length; i++) {
+         if (data[i] == '\n') {
+            out << "\\n";
+         } else {
+            out << data[i];
+         }
+      }
+   }
+   out << '\n';
+   return out;
+}
+
+
+
+//////////////////////////////
+//
+// PerformDataRecord::setBar -- same as setMeasure.
+//
+
+void PerformDataRecord::setBar(int aTime, const char* measureData,
+      int aLength) {
+   setMeasure(aTime, measureData, aLength);
+}
+
+
+void PerformDataRecord::setBar(int aTime, int aMeasure) {
+   setMeasure(aTime, aMeasure);
+}
+
+
+
+//////////////////////////////
+//
+// PerformDataRecord::setClear --
+//
+
+void PerformDataRecord::setClear(int aTime) {
+   time = aTime;
+   type = PERFORM_TYPE_CLEAR;
+   setData("", 0);
+}
+
+
+
+//////////////////////////////
+//
+// PerformDataRecord::setMeasure -- the measure number is the first
+//    number in the data.  default value: length = -1 (null terminated).
+//
+
+void PerformDataRecord::setMeasure(int aTime, const char* measureData,
+      int aLength) {
+   time = aTime;
+   type = PERFORM_TYPE_MEASURE;
+   setData(measureData, aLength < 0 ? (int)strlen(measureData) : aLength);
+}
+
+
+void PerformDataRecord::setMeasure(int aTime, int aMeasure) {
+   time = aTime;
+   type = PERFORM_TYPE_MEASURE;
+   setNumber(aMeasure);
+}
+
+
+
+//////////////////////////////
+//
+// PerformDataRecord::setMidi --
+//
+
+void PerformDataRecord::setMidi(int aTime, const char* someData, int aLength) {
+   time = aTime;
+   type = PERFORM_TYPE_MIDI;
+   setData(someData, aLength);
+}
+
+
+
+//////////////////////////////
+//
+// PerformDataRecord::setTempo -- the tempo is the first number in the
+//     data.  default value: length = -1 (null terminated).
+//
+
+void PerformDataRecord::setTempo(int aTime, const char* tempoData,
+      int aLength) {
+   time = aTime;
+   type = PERFORM_TYPE_TEMPO;
+   setData(tempoData, aLength < 0 ? (int)strlen(tempoData) : aLength);
+}
+
+
+void PerformDataRecord::setTempo(int aTime, int aTempo) {
+   time = aTime;
+   type = PERFORM_TYPE_TEMPO;
+   setNumber(aTempo);
+}
+
+
+
+//////////////////////////////
+//
+// PerformDataRecord::setText -- default value: length = -1 (null
+//     terminated).
+//
+
+void PerformDataRecord::setText(int aTime, const char* someText,
+      int aLength) {
+   time = aTime;
+   type = PERFORM_TYPE_TEXT;
+   setData(someText, aLength < 0 ? (int)strlen(someText) : aLength);
+}
+
+
+
+//////////////////////////////
+//
+// PerformDataRecord::setTime --
+//
+
+void PerformDataRecord::setTime(int aTime) {
+   time = aTime;
+}
+
+
+
+//////////////////////////////
+//
+// PerformDataRecord::setType --
+//
+
+void PerformDataRecord::setType(int aType) {
+   type = aType;
+}
+
+
+
+//////////////////////////////
+//
+// PerformDataRecord::barQ -- returns true if a measure record.
+//
+
+int PerformDataRecord::barQ(void) {
+   return type == PERFORM_TYPE_MEASURE;
+}
+
+
+
+//////////////////////////////
+//
+// PerformDataRecord::beginQ --
+//
+
+int PerformDataRecord::beginQ(void) {
+   return type == PERFORM_TYPE_BEGIN;
+}
+
+
+
+//////////////////////////////
+//
+// PerformDataRecord::endQ --
+//
+
+int PerformDataRecord::endQ(void) {
+   return type == PERFORM_TYPE_END;
+}
+
+
+
+//////////////////////////////
+//
+// PerformDataRecord::measureQ --
+//
+
+int PerformDataRecord::measureQ(void) {
+   return type == PERFORM_TYPE_MEASURE;
+}
+
+
+
+//////////////////////////////
+//
+// PerformDataRecord::midiQ --
+//
+
+int PerformDataRecord::midiQ(void) {
+   return type == PERFORM_TYPE_MIDI;
+}
+
+
+
+//////////////////////////////
+//
+// PerformDataRecord::tempoQ --
+//
+
+int PerformDataRecord::tempoQ(void) {
+   return type == PERFORM_TYPE_TEMPO;
+}
+
+
+
+//////////////////////////////
+//
+// PerformDataRecord::textQ --
+//
+
+int PerformDataRecord::textQ(void) {
+   return type == PERFORM_TYPE_TEXT;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// protected functions
+//
+
+
+//////////////////////////////
+//
+// PerformDataRecord::setData -- store a copy of the data followed by
+//    a null character.  Data which fits is stored in the record.
+//
+
+void PerformDataRecord::setData(const char* someData, int aLength) {
+   if (aLength < 0) {
+      aLength = 0;
+   }
+   char* oldData = longData;
+   if (aLength < PERFORM_SHORT_SIZE) {
+      memmove(shortData, someData, aLength);
+      shortData[aLength] = '\0';
+      longData = NULL;
+   } else {
+      longData = new char[aLength + 1];
+      memcpy(longData, someData, aLength);
+      longData[aLength] = '\0';
+   }
+   length = aLength;
+   if (oldData != NULL) {
+      delete [] oldData;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// PerformDataRecord::setNumber -- store a number as text.
+//
+
+void PerformDataRecord::setNumber(double aNumber) {
+   char buffer[32];
+   snprintf(buffer, sizeof(buffer), "%g", aNumber);
+   setData(buffer, (int)strlen(buffer));
+}
+
+
+
@@ -0,0 +1,800 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sun Oct 18 19:22:35 PDT 2026
+// Last Modified: Sun Oct 18 19:22:38 PDT 2026
+// Last Modified: Mon Oct 19 06:48:22 PDT 2026 (64-bit offsets, checks)
+// Filename:      ...improv/src/PerformFile.cpp
+// Web Address:   http://sig.sapp.org/src/sig/PerformFile.cpp
+// Syntax:        C++
+//
+// Description:   Compiled performance files for MidiPerform.  The
+//                tracks of a MIDI file are merged into one list of
+//                fixed-size event records with absolute tick times,
+//                followed by tables giving the location of each beat,
+//                measure and tempo change.  A compiled file is mapped
+//                into memory when opened rather than read, so very
+//                large files can start playing immediately, and only
+//                the part of the file being played is kept in memory.
+//
+
+#include "PerformFile.h"
+
+#include <string.h>
+
+#ifndef VISUAL
+   #include <fcntl.h>
+   #include <unistd.h>
+   #include <sys/mman.h>
+   #include <sys/stat.h>
+#endif
+
+#ifndef OLDCPP
+   #include <iostream>
+   #include <fstream>
+   using namespace std;
+#else
+   #include <iostream.h>
+   #include <fstream.h>
+#endif
+
+// amount of the file which has been played before memory is released:
+#define PERFORMFILE_RELEASE_SIZE (1024 * 1024)
+
+// function declarations:
+static int  trackBefore  (smf::MidiFile& midifile, int* cursor, int track1,
+                          int track2);
+static void siftTrack    (smf::MidiFile& midifile, int* cursor, int* heap,
+                          int heapSize, int index);
+static void sortMarkers  (SigCollection<PerformMarker>& markers);
+
+
+//////////////////////////////
+//
+// PerformFile::PerformFile --
+//
+
+PerformFile::PerformFile(void) {
+   mapping       = NULL;
+   mappingSize   = 0;
+   mappedQ       = 0;
+   events        = NULL;
+   beats         = NULL;
+   measures      = NULL;
+   tempos        = NULL;
+   longData      = NULL;
+   releasedBytes = 0;
+   memset(&info, 0, sizeof(info));
+   pageSize      = 4096;
+   #ifndef VISUAL
+      long systemPageSize = sysconf(_SC_PAGESIZE);
+      if (systemPageSize > 0) {
+         pageSize = systemPageSize;
+      }
+   #endif
+}
+
+
+
+//////////////////////////////
+//
+// PerformFile::~PerformFile --
+//
+
+PerformFile::~PerformFile() {
+   close();
+}
+
+
+
+//////////////////////////////
+//
+// PerformFile::close -- unmap the file.
+//
+
+void PerformFile::close(void) {
+   if (mapping != NULL) {
+      #ifndef VISUAL
+         if (mappedQ) {
+            munmap(mapping, mappingSize);
+         } else {
+            delete [] mapping;
+         }
+      #else
+         delete [] mapping;
+      #endif
+   }
+   mapping       = NULL;
+   mappingSize   = 0;
+   mappedQ       = 0;
+   events        = NULL;
+   beats         = NULL;
+   measures      = NULL;
+   tempos        = NULL;
+   longData      = NULL;
+   releasedBytes = 0;
+   memset(&info, 0, sizeof(info));
+}
+
+
+
+//////////////////////////////
+//
+// PerformFile::findEvent -- return the index of the first event at
+//    or after the given tick time.  The beat table narrows the search
+//    to the events within one beat, so that only a few pages of a
+//    large file are looked at.
+//
+
+int PerformFile::findEvent(int tick) const {
+   int low  = 0;
+   int high = info.eventCount;
+   if (info.beatCount > 0 && info.ticksPerQuarter > 0 && tick >= 0) {
+      int beat = tick / info.ticksPerQuarter;
+      if (beat >= info.beatCount) {
+         low = beats[info.beatCount - 1].index;
+      } else {
+         low = beats[beat].index;
+         if (beat + 1 < info.beatCount) {
+            high = beats[beat + 1].index;
+         }
+      }
+   }
+   return findEvent(events, low, high, tick);
+}
+
+
+int PerformFile::findEvent(const PerformEvent* events, int low, int high,
+      int tick) {
+   while (low < high) {
+      int middle = (low + high) / 2;
+      if (events[middle].tick < tick) {
+         low = middle + 1;
+      } else {
+         high = middle;
+      }
+   }
+   return low;
+}
+
+
+
+//////////////////////////////
+//
+// PerformFile::findTempo -- return the index of the tempo marker
+//    in effect at the given tick time, or -1 if there is none.
+//
+
+int PerformFile::findTempo(int tick) const {
+   int low  = 0;
+   int high = info.tempoCount;
+   while (low < high) {
+      int middle = (low + high) / 2;
+      if (tempos[middle].tick <= tick) {
+         low = middle + 1;
+      } else {
+         high = middle;
+      }
+   }
+   return low - 1;
+}
+
+
+
+//////////////////////////////
+//
+// PerformFile::getBeat -- the location of a quarter-note beat,
+//    starting at 0.
+//
+
+const PerformMarker& PerformFile::getBeat(int index) const {
+   return beats[index];
+}
+
+
+
+//////////////////////////////
+//
+// PerformFile::getBeatCount --
+//
+
+int PerformFile::getBeatCount(void) const {
+   return info.beatCount;
+}
+
+
+
+//////////////////////////////
+//
+// PerformFile::getEventCount --
+//
+
+int PerformFile::getEventCount(void) const {
+   return info.eventCount;
+}
+
+
+
+//////////////////////////////
+//
+// PerformFile::getEvents --
+//
+
+const PerformEvent* PerformFile::getEvents(void) const {
+   return events;
+}
+
+
+
+//////////////////////////////
+//
+// PerformFile::getLongData -- the storage for system exclusive messages.
+//
+
+const uchar* PerformFile::getLongData(void) const {
+   return longData;
+}
+
+
+
+//////////////////////////////
+//
+// PerformFile::getLongDataSize -- the number of bytes in the storage
+//     for system exclusive messages.
+//
+
+int PerformFile::getLongDataSize(void) const {
+   return info.longDataSize;
+}
+
+
+
+//////////////////////////////
+//
+// PerformFile::getLongMessage -- returns the bytes of a message which
+//     is too long to be stored in its event, or NULL if the event
+//     points outside of the long message storage (which happens only
+//     if the file is damaged).  The events are not checked when the
+//     file is opened, since that would read the whole file.
+//
+
+const uchar* PerformFile::getLongMessage(const PerformEvent& event) const {
+   return getLongMessage(event, longData, info.longDataSize);
+}
+
+
+const uchar* PerformFile::getLongMessage(const PerformEvent& event,
+      const uchar* longData, long size) {
+   if (event.size <= 4 || event.offset < 0 || event.offset > size ||
+         event.size > size - event.offset) {
+      return NULL;
+   }
+   return longData + event.offset;
+}
+
+
+
+//////////////////////////////
+//
+// PerformFile::getMeasure -- the location of a measure, starting at 0.
+//     The value of the marker is the length of the measure in ticks.
+//
+
+const PerformMarker& PerformFile::getMeasure(int index) const {
+   return measures[index];
+}
+
+
+
+//////////////////////////////
+//
+// PerformFile::getMeasureCount --
+//
+
+int PerformFile::getMeasureCount(void) const {
+   return info.measureCount;
+}
+
+
+
+//////////////////////////////
+//
+// PerformFile::getTempo -- the location of a tempo change.  The value
+//     of the marker is the tempo in microseconds per quarter note.
+//
+
+const PerformMarker& PerformFile::getTempo(int index) const {
+   return tempos[index];
+}
+
+
+
+//////////////////////////////
+//
+// PerformFile::getTempoCount --
+//
+
+int PerformFile::getTempoCount(void) const {
+   return info.tempoCount;
+}
+
+
+
+//////////////////////////////
+//
+// PerformFile::getTicksPerQuarterNote --
+//
+
+int PerformFile::getTicksPerQuarterNote(void) const {
+   return info.ticksPerQuarter;
+}
+
+
+
+//////////////////////////////
+//
+// PerformFile::isOpen --
+//
+
+int PerformFile::isOpen(void) const {
+   return mapping != NULL;
+}
+
+
+
+//////////////////////////////
+//
+// PerformFile::open -- map a compiled performance file into memory.
+//    Returns 0 if the file could not be opened.
+//
+
+int PerformFile::open(const char* filename) {
+   close();
+
+   #ifndef VISUAL
+      int fd = ::open(filename, O_RDONLY);
+      if (fd < 0) {
+         cerr << "Error: cannot open " << filename << endl;
+         return 0;
+      }
+      struct stat status;
+      if (fstat(fd, &status) != 0 || status.st_size < (long)sizeof(info)) {
+         cerr << "Error: " << filename
+              << " is not a compiled performance file" << endl;
+         ::close(fd);
+         return 0;
+      }
+      mappingSize = status.st_size;
+      void* data = mmap(NULL, mappingSize, PROT_READ, MAP_SHARED, fd, 0);
+      ::close(fd);
+      if (data == MAP_FAILED) {
+         cerr << "Error: cannot map " << filename << " into memory" << endl;
+         mappingSize = 0;
+         return 0;
+      }
+      mapping = (uchar*)data;
+      mappedQ = 1;
+   #else
+      ifstream input(filename, ios::binary);
+      if (!input.is_open()) {
+         cerr << "Error: cannot open " << filename << endl;
+         return 0;
+      }
+      input.seekg(0, ios::end);
+      mappingSize = (long)input.tellg();
+      input.seekg(0, ios::beg);
+      mapping = new uchar[mappingSize > 0 ? mappingSize : 1];
+      input.read((char*)mapping, mappingSize);
+      mappedQ = 0;
+   #endif
+
+   if (!checkHeader(filename)) {
+      close();
+      return 0;
+   }
+
+   events   = (PerformEvent*)(mapping + info.eventOffset);
+   beats    = (PerformMarker*)(mapping + info.beatOffset);
+   measures = (PerformMarker*)(mapping + info.measureOffset);
+   tempos   = (PerformMarker*)(mapping + info.tempoOffset);
+   longData = mapping + info.longDataOffset;
+
+   #ifndef VISUAL
+      madvise(mapping, mappingSize, MADV_SEQUENTIAL);
+   #endif
+
+   return 1;
+}
+
+
+
+//////////////////////////////
+//
+// PerformFile::release -- tell the operating system that the events
+//    before the given index have been played, so that the memory which
+//    holds them can be reused.  They are read back in from the file if
+//    they are needed again.
+//
+
+void PerformFile::release(int index) {
+   if (!mappedQ || index < 0 || index > info.eventCount) {
+      return;
+   }
+   long location = (long)info.eventOffset +
+         (long)index * (long)sizeof(PerformEvent);
+   location -= location % pageSize;
+   if (location < releasedBytes) {
+      // moved backwards in the performance
+      releasedBytes = location;
+      return;
+   }
+   if (location - releasedBytes < PERFORMFILE_RELEASE_SIZE) {
+      return;
+   }
+   #ifndef VISUAL
+      madvise(mapping + releasedBytes, location - releasedBytes,
+            MADV_DONTNEED);
+   #endif
+   releasedBytes = location;
+}
+
+
+
+//////////////////////////////
+//
+// PerformFile::isPerformFile -- returns true if the file starts like
+//     a compiled performance file.
+//
+
+int PerformFile::isPerformFile(const char* filename) {
+   ifstream input(filename, ios::binary);
+   if (!input.is_open()) {
+      return 0;
+   }
+   char magic[4];
+   input.read(magic, 4);
+   if (input.gcount() != 4) {
+      return 0;
+   }
+   return strncmp(magic, "IPRF", 4) == 0;
+}
+
+
+
+//////////////////////////////
+//
+// PerformFile::merge -- merge the tracks of a MIDI file into a single
+//    list of events sorted by time.  Events at the same time are kept
+//    in track order.  Meta messages are not MIDI messages, so they are
+//    left out of the list.  The MIDI file must be in absolute ticks.
+//
+
+void PerformFile::merge(smf::MidiFile& midifile,
+      SigCollection<PerformEvent>& events, SigCollection<uchar>& longData) {
+   events.setSize(0);
+   longData.setSize(0);
+   int trackCount = midifile.getTrackCount();
+   if (trackCount <= 0) {
+      return;
+   }
+
+   long total = 0;
+   int i;
+   for (i=0; i<trackCount; i++) {
+      total += midifile.getNumEvents(i);
+   }
+   events.reserve(total);
+
+   // heap of the tracks which still have events, ordered by the
+   // time of the next event in each track:
+   int* cursor = new int[trackCount];
+   int* heap   = new int[trackCount];
+   int heapSize = 0;
+   for (i=0; i<trackCount; i++) {
+      cursor[i] = 0;
+      if (midifile.getNumEvents(i) > 0) {
+         heap[heapSize++] = i;
+      }
+   }
+   for (i=heapSize/2-1; i>=0; i--) {
+      siftTrack(midifile, cursor, heap, heapSize, i);
+   }
+
+   PerformEvent item;
+   while (heapSize > 0) {
+      int track = heap[0];
+      smf::MidiEvent& event = midifile.getEvent(track, cursor[track]);
+      int size = (int)event.size();
+      if (size > 0 && event[0] != 0xff) {
+         item.tick = event.tick;
+         item.size = size;
+         if (size <= 4) {
+            for (i=0; i<size; i++) {
+               item.data[i] = event[i];
+            }
+         } else {
+            item.offset = (int)longData.getSize();
+            longData.setSize(item.offset + size);
+            memcpy(longData.getBase() + item.offset, event.data(), size);
+         }
+         events.append(item);
+      }
+
+      cursor[track]++;
+      if (cursor[track] >= midifile.getNumEvents(track)) {
+         heap[0] = heap[--heapSize];
+      }
+      siftTrack(midifile, cursor, heap, heapSize, 0);
+   }
+
+   delete [] heap;
+   delete [] cursor;
+}
+
+
+
+//////////////////////////////
+//
+// PerformFile::write -- compile a MIDI file into a performance file.
+//    Beats are quarter notes starting at tick 0.  Measures start at
+//    tick 0 in 4/4 until the first time signature, and a time
+//    signature always starts a new measure.  Returns 0 if the file
+//    could not be written.
+//
+
+int PerformFile::write(const char* filename, smf::MidiFile& midifile) {
+   midifile.absoluteTicks();
+   int tpq = midifile.getTicksPerQuarterNote();
+   if (tpq <= 0) {
+      cerr << "Error: bad ticks per quarter note: " << tpq << endl;
+      return 0;
+   }
+
+   SigCollection<PerformEvent> events;
+   SigCollection<uchar> longData;
+   merge(midifile, events, longData);
+   PerformEvent* eventBase = events.getBase();
+   int eventCount = (int)events.getSize();
+
+   // find the end of the music and the tempo and meter changes
+   SigCollection<PerformMarker> tempos;
+   SigCollection<PerformMarker> meters;
+   PerformMarker marker;
+   int lastTick = 0;
+   int i, j;
+   for (i=0; i<midifile.getTrackCount(); i++) {
+      for (j=0; j<midifile.getNumEvents(i); j++) {
+         smf::MidiEvent& event = midifile.getEvent(i, j);
+         if (event.tick > lastTick) {
+            lastTick = event.tick;
+         }
+         if (event.size() < 4 || event[0] != 0xff) {
+            continue;
+         }
+         marker.tick  = event.tick;
+         marker.index = findEvent(eventBase, 0, eventCount, event.tick);
+         if (event[1] == 0x51 && event.size() >= 6) {
+            marker.value = (event[3] << 16) | (event[4] << 8) | event[5];
+            tempos.append(marker);
+         } else if (event[1] == 0x58 && event.size() >= 5) {
+            marker.value = event[3] * tpq * 4 / (1 << (event[4] & 0x0f));
+            if (marker.value > 0) {
+               meters.append(marker);
+            }
+         }
+      }
+   }
+   sortMarkers(tempos);
+   sortMarkers(meters);
+
+   SigCollection<PerformMarker> beats;
+   beats.reserve(lastTick / tpq + 1);
+   for (i=0; i<=lastTick/tpq; i++) {
+      marker.tick  = i * tpq;
+      marker.index = findEvent(eventBase, 0, eventCount, marker.tick);
+      marker.value = 0;
+      beats.append(marker);
+   }
+
+   SigCollection<PerformMarker> measures;
+   int length = tpq * 4;
+   int meter  = 0;
+   int tick   = 0;
+   while (tick <= lastTick) {
+      while (meter < meters.getSize() && meters[meter].tick <= tick) {
+         length = meters[meter].value;
+         meter++;
+      }
+      int next = tick + length;
+      if (meter < meters.getSize() && meters[meter].tick < next) {
+         next = meters[meter].tick;
+      }
+      marker.tick  = tick;
+      marker.index = findEvent(eventBase, 0, eventCount, tick);
+      marker.value = next - tick;
+      measures.append(marker);
+      tick = next;
+   }
+
+   PerformFileHeader header;
+   memset(&header, 0, sizeof(header));
+   memcpy(header.magic, "IPRF", 4);
+   header.byteOrder       = 0x01020304;
+   header.version         = PERFORMFILE_VERSION;
+   header.ticksPerQuarter = tpq;
+   header.eventCount      = eventCount;
+   header.eventOffset     = sizeof(header);
+   header.beatCount       = (int)beats.getSize();
+   header.beatOffset      = header.eventOffset +
+                            (int64_t)eventCount * sizeof(PerformEvent);
+   header.measureCount    = (int)measures.getSize();
+   header.measureOffset   = header.beatOffset +
+                            (int64_t)header.beatCount * sizeof(PerformMarker);
+   header.tempoCount      = (int)tempos.getSize();
+   header.tempoOffset     = header.measureOffset +
+                            (int64_t)header.measureCount *
+                            sizeof(PerformMarker);
+   header.longDataSize    = (int)longData.getSize();
+   header.longDataOffset  = header.tempoOffset +
+                            (int64_t)header.tempoCount * sizeof(PerformMarker);
+
+   ofstream output(filename, ios::binary);
+   if (!output.is_open()) {
+      cerr << "Error: cannot write " << filename << endl;
+      return 0;
+   }
+   output.write((char*)&header, sizeof(header));
+   output.write((char*)eventBase, (long)eventCount * sizeof(PerformEvent));
+   output.write((char*)beats.getBase(),
+         (long)header.beatCount * sizeof(PerformMarker));
+   output.write((char*)measures.getBase(),
+         (long)header.measureCount * sizeof(PerformMarker));
+   output.write((char*)tempos.getBase(),
+         (long)header.tempoCount * sizeof(PerformMarker));
+   output.write((char*)longData.getBase(), header.longDataSize);
+   output.close();
+   if (output.fail()) {
+      cerr << "Error: problem writing " << filename << endl;
+      return 0;
+   }
+
+   return 1;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// protected functions
+//
+
+
+//////////////////////////////
+//
+// PerformFile::checkHeader -- copy the header from the start of the
+//    file and make sure that the tables it describes are inside of
+//    the file.  The offsets of the long messages in the events are
+//    checked when they are used (see getLongMessage).
+//
+
+int PerformFile::checkHeader(const char* filename) {
+   memcpy(&info, mapping, sizeof(info));
+   if (strncmp(info.magic, "IPRF", 4) != 0) {
+      cerr << "Error: " << filename
+           << " is not a compiled performance file" << endl;
+      return 0;
+   }
+   if (info.byteOrder != 0x01020304) {
+      cerr << "Error: " << filename
+           << " was compiled on a computer with a different byte order"
+           << endl;
+      return 0;
+   }
+   if (info.version != PERFORMFILE_VERSION) {
+      cerr << "Error: " << filename << " is version " << info.version
+           << " but version " << PERFORMFILE_VERSION << " is needed" << endl;
+      return 0;
+   }
+
+   int64_t sections[5][3] = {
+      { info.eventOffset,    info.eventCount,   sizeof(PerformEvent)  },
+      { info.beatOffset,     info.beatCount,    sizeof(PerformMarker) },
+      { info.measureOffset,  info.measureCount, sizeof(PerformMarker) },
+      { info.tempoOffset,    info.tempoCount,   sizeof(PerformMarker) },
+      { info.longDataOffset, info.longDataSize, 1                     }
+   };
+   int64_t fileSize = mappingSize;
+   for (int i=0; i<5; i++) {
+      // the count is 32 bits, so the section size cannot overflow
+      if (sections[i][0] < (int64_t)sizeof(info) || sections[i][1] < 0 ||
+            sections[i][0] % 4 != 0 || sections[i][0] > fileSize ||
+            sections[i][1] * sections[i][2] > fileSize - sections[i][0]) {
+         cerr << "Error: " << filename << " is damaged" << endl;
+         return 0;
+      }
+   }
+   if (info.ticksPerQuarter <= 0) {
+      cerr << "Error: " << filename << " is damaged" << endl;
+      return 0;
+   }
+
+   return 1;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// static functions
+//
+
+
+//////////////////////////////
+//
+// trackBefore -- return true if the next event in track1 should be
+//    played before the next event in track2.
+//
+
+static int trackBefore(smf::MidiFile& midifile, int* cursor, int track1,
+      int track2) {
+   int tick1 = midifile.getEvent(track1, cursor[track1]).tick;
+   int tick2 = midifile.getEvent(track2, cursor[track2]).tick;
+   if (tick1 != tick2) {
+      return tick1 < tick2;
+   }
+   return track1 < track2;
+}
+
+
+
+//////////////////////////////
+//
+// siftTrack -- move a track down the heap until the tracks below it
+//    have later events.
+//
+
+static void siftTrack(smf::MidiFile& midifile, int* cursor, int* heap,
+      int heapSize, int index) {
+   while (1) {
+      int child = 2 * index + 1;
+      if (child >= heapSize) {
+         break;
+      }
+      if (child + 1 < heapSize &&
+            trackBefore(midifile, cursor, heap[child+1], heap[child])) {
+         child++;
+      }
+      if (!trackBefore(midifile, cursor, heap[child], heap[index])) {
+         break;
+      }
+      int temp = heap[index];
+      heap[index] = heap[child];
+      heap[child] = temp;
+      index = child;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// sortMarkers -- sort markers by time, keeping markers at the same
+//    time in their original order.  There are only a few tempo and
+//    meter changes, so an insertion sort is used.
+//
+
+static void sortMarkers(SigCollection<PerformMarker>& markers) {
+   PerformMarker* base = markers.getBase();
+   long count = markers.getSize();
+   for (long i=1; i<count; i++) {
+      PerformMarker item = base[i];
+      long j = i - 1;
+      while (j >= 0 && base[j].tick > item.tick) {
+         base[j+1] = base[j];
+         j--;
+      }
+      base[j+1] = item;
+   }
+}
+
+
+
@@ -0,0 +1,354 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sun Oct 18 22:05:12 PDT 2026
+// Last Modified: Sun Oct 18 22:05:15 PDT 2026
+// Last Modified: Mon Oct 19 07:21:43 PDT 2026 (expression kept in object)
+// Last Modified: Mon Oct 19 07:33:05 PDT 2026 (backward search at start)
+// Last Modified: Mon Oct 19 08:04:51 PDT 2026 (SearchPattern declared only)
+// Filename:      ...improv/src/PerformSearch.cpp
+// Web Address:   http://sig.sapp.org/src/sig/PerformSearch.cpp
+// Syntax:        C++
+//
+// Description:   Text search for PerformData.  Keeps a list of the
+//                records which contain text (text, measure and tempo
+//                records), so that MIDI records are never looked at,
+//                and an index of the three-letter sequences in the
+//                text so that a literal string can be found by
+//                checking only the records which could contain it.
+//                Regular expressions are compiled once per pattern.
+//
+
+#include "PerformSearch.h"
+#include "PerformData.h"
+#include "SearchPattern.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+#ifndef OLDCPP
+   #include <iostream>
+   using namespace std;
+#else
+   #include <iostream.h>
+#endif
+
+// function declarations:
+static uint32_t trigramKey   (const char* text);
+
+
+//////////////////////////////
+//
+// PerformSearch::PerformSearch --
+//
+
+PerformSearch::PerformSearch(void) {
+   trigramQ = 1;
+   trigramValidQ = 0;
+   expression = new SearchPattern;
+}
+
+
+
+//////////////////////////////
+//
+// PerformSearch::~PerformSearch --
+//
+
+PerformSearch::~PerformSearch() {
+   delete expression;
+   expression = NULL;
+}
+
+
+
+//////////////////////////////
+//
+// PerformSearch::clear -- forget the indexes.
+//
+
+void PerformSearch::clear(void) {
+   textRecords.setSize(0);
+   trigrams.setSize(0);
+   trigramValidQ = 0;
+}
+
+
+
+//////////////////////////////
+//
+// PerformSearch::find -- returns the index of the first record, starting
+//    at startIndex and going in the given direction, whose text matches
+//    the pattern, or -1 if there is none.  Patterns without regular
+//    expression characters are searched for as literal strings.
+//
+
+int PerformSearch::find(PerformData& data, const char* pattern,
+      int startIndex, int direction) {
+   if (direction == 0 || pattern == NULL) {
+      return -1;
+   }
+   direction = direction > 0 ? 1 : -1;
+   int position = getStartPosition(startIndex, direction);
+   if (position < 0 || position >= textRecords.getSize()) {
+      return -1;
+   }
+   if (literalQ(pattern)) {
+      return findLiteral(data, pattern, position, direction);
+   }
+   return findExpression(data, pattern, position, direction);
+}
+
+
+
+//////////////////////////////
+//
+// PerformSearch::getTextCount -- returns the number of records which
+//     contain text.
+//
+
+int PerformSearch::getTextCount(void) {
+   return (int)textRecords.getSize();
+}
+
+
+
+//////////////////////////////
+//
+// PerformSearch::index -- make the list of records which contain text.
+//     The trigram index is made the first time that it is needed.
+//
+
+void PerformSearch::index(PerformData& data) {
+   clear();
+   int count = data.getSize();
+   for (int i=0; i<count; i++) {
+      switch (data[i].getType()) {
+         case PERFORM_TYPE_TEXT:
+         case PERFORM_TYPE_MEASURE:
+         case PERFORM_TYPE_TEMPO:
+            textRecords.append(i);
+            break;
+      }
+   }
+}
+
+
+
+//////////////////////////////
+//
+// PerformSearch::setTrigrams -- turn the trigram index on or off.  When
+//     off, literal strings are searched for in every text record.
+//     default value: aState = 1
+//
+
+void PerformSearch::setTrigrams(int aState) {
+   trigramQ = aState ? 1 : 0;
+   if (!trigramQ) {
+      trigrams.setSize(0);
+      trigrams.shrinkToFit();
+      trigramValidQ = 0;
+   }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// protected functions
+//
+
+
+//////////////////////////////
+//
+// PerformSearch::buildTrigrams -- list each three-letter sequence in
+//    each text record, sorted by sequence and then by position in the
+//    list of text records.
+//
+
+void PerformSearch::buildTrigrams(PerformData& data) {
+   trigrams.setSize(0);
+   int count = (int)textRecords.getSize();
+   int i, j;
+   for (i=0; i<count; i++) {
+      PerformDataRecord& record = data[textRecords[i]];
+      const char* text = record.getData();
+      int length = (int)strlen(text);
+      for (j=0; j+3<=length; j++) {
+         uint64_t entry = ((uint64_t)trigramKey(text + j) << 32) | (uint32_t)i;
+         trigrams.append(entry);
+      }
+   }
+
+   uint64_t* base = trigrams.getBase();
+   long size = trigrams.getSize();
+   if (size > 0) {
+      std::sort(base, base + size);
+      size = std::unique(base, base + size) - base;
+      trigrams.setSize(size);
+   }
+   trigramValidQ = 1;
+}
+
+
+
+//////////////////////////////
+//
+// PerformSearch::findExpression -- check each text record with a
+//    regular expression.  The last expression is remembered, so it
+//    is only compiled once when searching repeatedly.  A bad
+//    expression finds nothing.
+//
+
+int PerformSearch::findExpression(PerformData& data, const char* pattern,
+      int position, int direction) {
+   if (!expression->setPattern(pattern)) {
+      return -1;
+   }
+
+   int count = (int)textRecords.getSize();
+   int* list = textRecords.getBase();
+   for ( ; position >= 0 && position < count; position += direction) {
+      if (expression->matches(data[list[position]].getData())) {
+         return list[position];
+      }
+   }
+   return -1;
+}
+
+
+
+//////////////////////////////
+//
+// PerformSearch::findLiteral -- find a literal string.  Strings of three
+//    or more characters only check the records which contain the rarest
+//    trigram in the string.
+//
+
+int PerformSearch::findLiteral(PerformData& data, const char* pattern,
+      int position, int direction) {
+   int count = (int)textRecords.getSize();
+   int* list = textRecords.getBase();
+   int length = (int)strlen(pattern);
+
+   if (!trigramQ || length < 3) {
+      for ( ; position >= 0 && position < count; position += direction) {
+         if (strstr(data[list[position]].getData(), pattern) != NULL) {
+            return list[position];
+         }
+      }
+      return -1;
+   }
+
+   if (!trigramValidQ) {
+      buildTrigrams(data);
+   }
+
+   // find the trigram in the pattern with the fewest records
+   uint64_t* base = trigrams.getBase();
+   uint64_t* end  = base + trigrams.getSize();
+   uint64_t* first = NULL;
+   uint64_t* last  = NULL;
+   for (int i=0; i+3<=length; i++) {
+      uint64_t key = (uint64_t)trigramKey(pattern + i) << 32;
+      uint64_t* low  = std::lower_bound(base, end, key);
+      uint64_t* high = std::lower_bound(low, end, key + ((uint64_t)1 << 32));
+      if (low == high) {
+         return -1;
+      }
+      if (first == NULL || high - low < last - first) {
+         first = low;
+         last  = high;
+      }
+   }
+
+   uint64_t prefix = *first & ~(uint64_t)0xffffffff;
+   uint64_t* entry = std::lower_bound(first, last, prefix | (uint32_t)position);
+   if (direction > 0) {
+      for ( ; entry < last; entry++) {
+         int index = list[(uint32_t)*entry];
+         if (strstr(data[index].getData(), pattern) != NULL) {
+            return index;
+         }
+      }
+   } else {
+      // entry is the first one after the position, unless it is at the
+      // position; never step before first, which may start the array
+      if (entry != last && (int)(uint32_t)*entry <= position) {
+         entry++;
+      }
+      while (entry != first) {
+         entry--;
+         int index = list[(uint32_t)*entry];
+         if (strstr(data[index].getData(), pattern) != NULL) {
+            return index;
+         }
+      }
+   }
+   return -1;
+}
+
+
+
+//////////////////////////////
+//
+// PerformSearch::getStartPosition -- returns the position in the list of
+//    text records of the first text record at or after startIndex when
+//    searching forward, or at or before it when searching backward.
+//
+
+int PerformSearch::getStartPosition(int startIndex, int direction) {
+   int* list = textRecords.getBase();
+   int count = (int)textRecords.getSize();
+   int low  = 0;
+   int high = count;
+   while (low < high) {
+      int middle = (low + high) / 2;
+      if (list[middle] < startIndex) {
+         low = middle + 1;
+      } else {
+         high = middle;
+      }
+   }
+   if (direction > 0) {
+      return low;
+   }
+   if (low < count && list[low] == startIndex) {
+      return low;
+   }
+   return low - 1;
+}
+
+
+
+//////////////////////////////
+//
+// PerformSearch::literalQ -- returns true if the pattern does not use
+//    any regular expression characters.
+//
+
+int PerformSearch::literalQ(const char* pattern) {
+   return strpbrk(pattern, ".[]()*+?{}|^$\\") == NULL;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// static functions
+//
+
+
+//////////////////////////////
+//
+// trigramKey -- the first three characters of the text as a number.
+//
+
+static uint32_t trigramKey(const char* text) {
+   return ((uint32_t)(unsigned char)text[0] << 16) |
+          ((uint32_t)(unsigned char)text[1] << 8)  |
+           (uint32_t)(unsigned char)text[2];
+}
+
+
+
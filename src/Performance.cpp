@@ -2,6 +2,10 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Fri Jul  2 23:05:34 PDT 1999
 // Last Modified: Thu Jul  8 15:11:58 PDT 1999
+// Last Modified: Sun Oct 18 21:34:50 PDT 2026 (indexed gotoBar)
+// Last Modified: Sun Oct 18 22:05:15 PDT 2026 (indexed search)
+// Last Modified: Mon Oct 19 06:02:41 PDT 2026 (data ticks per quarter)
+// Last Modified: Mon Oct 19 08:11:27 PDT 2026 (keep ticks set by caller)
 // Filename:      ...sig/maint/code/info/Performance/Performance.cpp
 // Syntax:        C++
 //
@@ -16,6 +20,7 @@
 
 Performance::Performance(void) { 
    ticksPerQuarter = 72;
+   ticksSetQ = 0;
    tempoMultiplier = 1.0;
    zeroNoteStates(); 
    playingQ = 0;
@@ -79,7 +84,7 @@ double Performance::getTempo(void) {
 //
 
 double Performance::getTempoMultiplier(void) {
-   return timeFormat;
+   return tempoMultiplier;
 }
 
 
@@ -112,8 +117,9 @@ double Performance::getTicksPerQuarterNote(int ticks) {
 //
 // Performance::gotoBar -- go to the specified bar.  If the new bar is
 //     less than or equal to zero, then just set us up at the start;
-//     otherwise, search through the list in whatever direction for 
-//     the barline.
+//     otherwise, the barline and the tempo in effect there are found
+//     in the measure and tempo indexes.  If there is no such bar, the
+//     performance continues from where it was.
 //
 
 void Performance::gotoBar(int aBar) {
@@ -122,27 +128,20 @@ void Performance::gotoBar(int aBar) {
       currentIndex = 0;
       current_measure = 0;
       current_tempo = default_tempo;
+      start();
+      return;
    }
 
-   int direction = aBar < current_measure ? -1 : 1;
-   current_measure = -1;
-   while ((getType() != PERFORM_TYPE_BEGIN) && (getType() != PERFORM_TYPE_END) 
-         && (current_measure != aBar)) {
-      switch (getType()) {
-         case PERFORM_TYPE_TEMPO:
-            current_tempo = getTempo();
-            break;
-         case PERFORM_TYPE_MEASURE:
-            current_measure = getBar();
-            break;
-         default:
-            break;
-      }
-
-      if (direction > 0) {
-         next();
+   int index = findMeasure(aBar);
+   if (index >= 0) {
+      currentIndex = index;
+      current_measure = aBar;
+      int tempoIndex = findTempo(index);
+      if (tempoIndex >= 0) {
+         current_tempo = (*this)[tempoIndex].getTempoNumber() * 
+               getTempoMultiplier();
       } else {
-         back();
+         current_tempo = default_tempo;
       }
    }
    start();
@@ -172,7 +171,7 @@ void Performance::perform(void) {
       return;
    }
 
-   while (timer.getPeriodCount() >= nextActionTime) {
+   while (timer.getPeriodCount() * ticksPerQuarter >= nextActionTime) {
       play();
       next();
       nextActionTime += getTime();
@@ -246,7 +245,10 @@ void Performance::reset(void) {
 //////////////////////////////
 //
 // Performance::search -- look for a string in a certain direction
-//   and start playing from there.
+//   and start playing from there.  Only the text, measure and tempo
+//   records are searched.  The performance continues from the record
+//   after the match (or before it when searching backwards), or from
+//   the end (or beginning) if nothing matches.
 //
 
 void Performance::search(const char* regexpression, int dir) { 
@@ -255,33 +257,28 @@ void Performance::search(const char* regexpression, int dir) {
       cout << "Error: search direction cannot be zero" << endl;
       exit(1);
    }
-   int result = 0;
-   while (!result && !eof() && !bof()) {
-      switch (getType()) {
-         case PERFORM_TYPE_TEXT:
-            result = match(regexpression);
-            break;
-         case PERFORM_TYPE_MIDI:
-            // not searching MIDI data for now
-            break;
-         case PERFORM_TYPE_MEASURE:
-            current_measure = PerformData::getMeasure();
-            result = match(regexpression);
-            break;
-         case PERFORM_TYPE_TEMPO:
-            current_tempo = PerformData::getTempo();
-            result = match(regexpression);
-            break;
-         case PERFORM_TYPE_BEGIN:
-         case PERFORM_TYPE_END:
-            return;
-            break;
-      }
-      if (dir > 0) {
-         next();
-      } else {
-         back();
-      }
+   if (eof() || bof()) {
+      return;
+   }
+
+   int found = PerformData::search(regexpression, getIndex(), dir);
+   int last;
+   if (found >= 0) {
+      last = found;
+      setIndex(dir > 0 ? found + 1 : found - 1);
+   } else {
+      last = dir > 0 ? getSize() - 1 : 0;
+      setIndex(dir > 0 ? getSize() : -1);
+   }
+
+   int measureRecord = findMeasureAt(last);
+   if (measureRecord >= 0) {
+      current_measure = (*this)[measureRecord].getMeasureNumber();
+   }
+   int tempoRecord = findTempo(last);
+   if (tempoRecord >= 0) {
+      current_tempo = (*this)[tempoRecord].getTempoNumber() *
+            getTempoMultiplier();
    }
 }
 
@@ -315,12 +312,14 @@ void Performance::setTempoMultiplier(double aMultiplier) {
 //////////////////////////////
 //
 // Performance::setTicksPerQuarterNote -- set the number of ticks
-//   per quarter note.
+//   per quarter note.  Once set, the value is used instead of the
+//   ticks per quarter note of the data.
 //
 
 void Performance::setTicksPerQuarterNote(int ticks) { 
    if (ticks > 1) {
       ticksPerQuarter = ticks;
+      ticksSetQ = 1;
    }
 }
 
@@ -328,10 +327,16 @@ void Performance::setTicksPerQuarterNote(int ticks) {
 
 //////////////////////////////
 //
-// Performance::start -- start playing the data.
+// Performance::start -- start playing the data.  Unless they were
+//    set with setTicksPerQuarterNote(), the ticks per quarter note are
+//    taken from the data, since they depend on the kind of file which
+//    was read.
 //
 
 void Performance::start(void) { 
+   if (!ticksSetQ && PerformData::getTicksPerQuarterNote() > 1) {
+      ticksPerQuarter = PerformData::getTicksPerQuarterNote();
+   }
    playingQ = 1;     // tell perform() that it can play notes.
    nextActionTime = 0;
    timer.setTempo(current_tempo);
@@ -7,6 +7,16 @@
 // Last Modified: Mon Nov 29 13:44:52 PST 1999 (name RadioDrum->RadioBaton)
 // Last Modified: Thu Apr 27 17:59:04 PDT 2000 (readded scale and change fns)
 // Last Modified: Sun Oct  1 15:19:13 PDT 2000 (revised for firmware "AE")
+// Last Modified: Sun Oct 18 15:31:08 PDT 2026 (no allocation for input)
+// Last Modified: Sun Oct 18 17:04:12 PDT 2026 (power-of-two state size)
+// Last Modified: Sun Oct 18 23:52:06 PDT 2026 (frame history buffers)
+// Last Modified: Mon Oct 19 00:21:37 PDT 2026 (added getState)
+// Last Modified: Mon Oct 19 00:48:15 PDT 2026 (added trigger prediction)
+// Last Modified: Mon Oct 19 01:42:18 PDT 2026 (session record and replay)
+// Last Modified: Mon Oct 19 06:14:08 PDT 2026 (per-object input event)
+// Last Modified: Mon Oct 19 07:41:26 PDT 2026 (sessions by MidiCapture)
+// Last Modified: Mon Oct 19 07:52:19 PDT 2026 (replay sysex like input)
+// Last Modified: Mon Oct 19 08:55:41 PDT 2026 (replay with MidiReplay)
 // Filename:      ...sig/code/control/RadioBaton/RadioBaton.cpp
 // Web Address:   http://sig.sapp.org/include/sig/RadioBaton.cpp
 // Syntax:        C++
@@ -17,8 +27,10 @@
 //
 
 #include "RadioBaton.h"
+#include "RealtimeCheck.h"
 
 #include <ctype.h>
+#include <string.h>
 
 #ifndef OLDCPP
    #include <fstream>
@@ -33,6 +45,9 @@
    #include <unistd.h>
 #endif
 
+// function declarations:
+static void memoryBarrier(void);
+
 
 //////////////////////////////
 // 
@@ -40,12 +55,17 @@
 //
 
 RadioBaton::RadioBaton(void) : MidiIO() {
+   attachFrameFields();
    setStateSize(DEFAULT_STATE_SIZE);
+   memset(&publishedState, 0, sizeof(publishedState));
+   stateSequence = 0;
    for (int i=0; i<16; i++) {
       completeBufQ[i] = 0;
    }
    reportingQ = 0;
+   predictionQ = 0;
    recordStateQ = 0;
+   replayReopenQ = 0;
    storedReportStatus = 0;
    errorQ = 0;
    
@@ -53,6 +73,8 @@ RadioBaton::RadioBaton(void) : MidiIO() {
    stick2trig = RadioBatonEmptyBehavior;
    stick1position = RadioBatonEmptyBehavior;
    stick2position = RadioBatonEmptyBehavior;
+   stick1pretrig = RadioBatonEmptyBehavior;
+   stick2pretrig = RadioBatonEmptyBehavior;
 
    dial1position = RadioBatonEmptyBehavior;
    dial2position = RadioBatonEmptyBehavior;
@@ -69,17 +91,23 @@ RadioBaton::RadioBaton(void) : MidiIO() {
    xDirection = 1;
    yDirection = 1;
    zDirection = 1;
+   RealtimeCheck::prepare(inputEvent);
 }
 
 
 RadioBaton::RadioBaton(int outputDevice, int inputDevice) :
       MidiIO(outputDevice, inputDevice) {
+   attachFrameFields();
    setStateSize(DEFAULT_STATE_SIZE);
+   memset(&publishedState, 0, sizeof(publishedState));
+   stateSequence = 0;
    for (int i=0; i< 16; i++) {
       completeBufQ[i] = 0;
    }
    reportingQ = 0;
+   predictionQ = 0;
    recordStateQ = 0;
+   replayReopenQ = 0;
    storedReportStatus = 0;
    errorQ = 0;
    
@@ -87,6 +115,8 @@ RadioBaton::RadioBaton(int outputDevice, int inputDevice) :
    stick2trig = RadioBatonEmptyBehavior;
    stick1position = RadioBatonEmptyBehavior;
    stick2position = RadioBatonEmptyBehavior;
+   stick1pretrig = RadioBatonEmptyBehavior;
+   stick2pretrig = RadioBatonEmptyBehavior;
 
    dial1position = RadioBatonEmptyBehavior;
    dial2position = RadioBatonEmptyBehavior;
@@ -103,6 +133,7 @@ RadioBaton::RadioBaton(int outputDevice, int inputDevice) :
    xDirection = 1;
    yDirection = 1;
    zDirection = 1;
+   RealtimeCheck::prepare(inputEvent);
 }
 
 
@@ -159,6 +190,45 @@ int RadioBaton::getError(void) const {
 
 
 
+//////////////////////////////
+//
+// RadioBaton::getDialFrames -- copy the last count reports of the
+//    given dial (1 to 4) into output, oldest first.  Returns the number
+//    of frames copied, which is limited to the number received and to
+//    the state size.
+//
+
+int RadioBaton::getDialFrames(int dial, BatonDialFrame* output, int count) {
+   if (dial < 1 || dial > 4) {
+      cerr << "Error: invalid dial number: " << dial << endl;
+      return 0;
+   }
+   return dialFrames[dial-1].copyHistory(output, count);
+}
+
+
+
+//////////////////////////////
+//
+// RadioBaton::getPositionFrames -- copy the last count position reports
+//    of the given stick (1 or 2) into output, oldest first, so that
+//    output[count-1] is the most recent position.  Returns the number
+//    of frames copied, which is limited to the number received and to
+//    the state size.
+//
+
+int RadioBaton::getPositionFrames(int stick, BatonPositionFrame* output,
+      int count) {
+   switch (stick) {
+      case 1:  return position1Frames.copyHistory(output, count);
+      case 2:  return position2Frames.copyHistory(output, count);
+   }
+   cerr << "Error: invalid stick number: " << stick << endl;
+   return 0;
+}
+
+
+
 //////////////////////////////
 //
 // RadioBaton::getPositionReporting --
@@ -170,6 +240,18 @@ int RadioBaton::getPositionReporting(void) const {
 
 
 
+//////////////////////////////
+//
+// RadioBaton::getPrediction -- returns true if triggers are being
+//    predicted from the stick positions.
+//
+
+int RadioBaton::getPrediction(void) const {
+   return predictionQ;
+}
+
+
+
 //////////////////////////////
 //
 // RadioBaton::getReportStatus --
@@ -181,6 +263,50 @@ int RadioBaton::getReportStatus(void) const {
 
 
 
+//////////////////////////////
+//
+// RadioBaton::getState -- copy the last complete position, trigger,
+//    dial and button reports.  This function may be called from any
+//    thread while another thread is calling processIncomingMessages():
+//    the copy is started again if new data was stored while it was
+//    being made, so the copy is always consistent and no lock is
+//    needed by either thread.
+//
+
+void RadioBaton::getState(BatonState& aState) const {
+   unsigned int before;
+   unsigned int after;
+   do {
+      before = stateSequence;
+      memoryBarrier();
+      aState = publishedState;
+      memoryBarrier();
+      after = stateSequence;
+   } while ((before & 1) || before != after);
+}
+
+
+
+//////////////////////////////
+//
+// RadioBaton::getTriggerFrames -- copy the last count triggers of the
+//    given stick (1 or 2) into output, oldest first.  Returns the number
+//    of frames copied, which is limited to the number received and to
+//    the state size.
+//
+
+int RadioBaton::getTriggerFrames(int stick, BatonTriggerFrame* output,
+      int count) {
+   switch (stick) {
+      case 1:  return trigger1Frames.copyHistory(output, count);
+      case 2:  return trigger2Frames.copyHistory(output, count);
+   }
+   cerr << "Error: invalid stick number: " << stick << endl;
+   return 0;
+}
+
+
+
 //////////////////////////////
 //
 // RadioBaton::getWhack1Time -- returns the 
@@ -275,14 +401,25 @@ int RadioBaton::positionReportingOn(void) {
 
 //////////////////////////////
 //
-// RadioBaton::processIncomingMessages --
+// RadioBaton::processIncomingMessages -- interpret the MIDI input
+//    which has arrived, or the messages of a replayed session which
+//    are due.  MidiReplay::next() gives a replayed sysex message in the
+//    same form as a sysex message from the baton.
 // 
 
 void RadioBaton::processIncomingMessages(void) {
-   smf::MidiEvent event;
    while (MidiInput::getCount() > 0) {
-      MidiInput::extract(event);
-      interpretCommand(event);
+      MidiInput::extract(inputEvent);
+      interpretCommand(inputEvent);
+   }
+
+   if (sessionPlayer.playingQ()) {
+      while (sessionPlayer.next(*this, inputEvent)) {
+         interpretCommand(inputEvent);
+      }
+      if (!sessionPlayer.playingQ()) {
+         replaySessionStop();
+      }
    }
 }
 
@@ -339,6 +476,91 @@ void RadioBaton::recordStateStop(void) {
 
 
 
+//////////////////////////////
+//
+// RadioBaton::recordSessionStart -- start recording the MIDI input from
+//    the baton into a binary session file which can be played back with
+//    replaySessionStart().  The messages are recorded by the MIDI input
+//    thread as they arrive.  Returns 0 if the file could not be opened.
+//
+
+int RadioBaton::recordSessionStart(const char* aFilename) {
+   return sessionRecorder.start(aFilename, getInputPort());
+}
+
+
+
+//////////////////////////////
+//
+// RadioBaton::recordSessionStop -- stop recording the MIDI input and
+//    close the session file.
+//
+
+void RadioBaton::recordSessionStop(void) {
+   sessionRecorder.stop();
+}
+
+
+
+//////////////////////////////
+//
+// RadioBaton::replayingQ -- returns true if a session is being replayed.
+//
+
+int RadioBaton::replayingQ(void) const {
+   return sessionPlayer.playingQ();
+}
+
+
+
+//////////////////////////////
+//
+// RadioBaton::replaySessionStart -- replay a session file written by
+//    recordSessionStart().  The recorded messages are interpreted by
+//    processIncomingMessages() as if they had come from the baton, with
+//    their recorded times.  A speed of 1.0 replays the session in real
+//    time, 2.0 twice as fast, and 0.0 all at once the next time that
+//    processIncomingMessages() is called.  The MIDI input is closed
+//    while the session is replayed, so that the sysex messages of the
+//    session go into sysex buffers of this object rather than into the
+//    buffers of the port.  Returns 0 if the file could not be read.
+//    default value: aSpeed = 1.0
+//
+
+int RadioBaton::replaySessionStart(const char* aFilename, double aSpeed) {
+   replaySessionStop();
+   if (!sessionPlayer.read(aFilename)) {
+      return 0;
+   }
+   replayReopenQ = MidiInput::getPortStatus();
+   closeInput();
+   makeOrphanBuffer();
+   sessionPlayer.start(aSpeed);
+   return 1;
+}
+
+
+
+//////////////////////////////
+//
+// RadioBaton::replaySessionStop -- stop replaying a session, and open
+//    the MIDI input again if it was open when the replay started.
+//
+
+void RadioBaton::replaySessionStop(void) {
+   if (!isOrphan()) {
+      return;
+   }
+   sessionPlayer.stop();
+   removeOrphanBuffer();
+   if (replayReopenQ) {
+      openInput();
+   }
+   replayReopenQ = 0;
+}
+
+
+
 //////////////////////////////
 //
 // RadioBaton::sendMessage -- sends a message to the radio drum.
@@ -374,6 +596,25 @@ void RadioBaton::setError(int errorStatus) {
 
 
 
+//////////////////////////////
+//
+// RadioBaton::setPrediction -- turn trigger prediction on or off.  When
+//    on, the stick positions are used to predict when each stick will hit
+//    the trigger plane, and stick1pretrig or stick2pretrig is called
+//    before the trigger message arrives from the baton.  Position
+//    reporting must be on.  The predictions are adjusted with the
+//    functions of predictor1 and predictor2.
+//    default value: aState = 1
+//
+
+void RadioBaton::setPrediction(int aState) {
+   predictionQ = aState ? 1 : 0;
+   predictor1.reset();
+   predictor2.reset();
+}
+
+
+
 //////////////////////////////
 //
 // RadioBaton::setReportStatus --
@@ -393,7 +634,8 @@ void RadioBaton::setReportStatus(int aStatus) {
 //////////////////////////////
 //
 // RadioBaton::setStateSize -- set the length of the
-//    histories of each state variable in the object.
+//    histories of each state variable in the object.  The length
+//    is rounded up to a power of two for faster indexing.
 //
 
 void RadioBaton::setStateSize(int aSize) {
@@ -402,37 +644,20 @@ void RadioBaton::setStateSize(int aSize) {
       exit(1);
    }
 
-   t1pb.setSize(aSize);    // stick1 position time
-   x1pb.setSize(aSize);    // stick1 x-axis position
-   y1pb.setSize(aSize);    // stick1 y-axis position
-   z1pb.setSize(aSize);    // stick1 z-axis position
-
-   t2pb.setSize(aSize);    // stick2 position time
-   x2pb.setSize(aSize);    // stick2 x-axis position
-   y2pb.setSize(aSize);    // stick2 y-axis position
-   z2pb.setSize(aSize);    // stick2 z-axis position   
-
-   d1pb.setSize(aSize);    // dial1 position
-   d2pb.setSize(aSize);    // dial2 position
-   d3pb.setSize(aSize);    // dial3 position
-   d4pb.setSize(aSize);    // dial4 position
-
-   t1tb.setSize(aSize);    // stick1 trigger time
-   x1tb.setSize(aSize);    // stick1 x-axis trigger pos.
-   y1tb.setSize(aSize);    // stick1 y-axis trigger pos.
-   w1tb.setSize(aSize);    // stick1 wack at trigger time
-
-   t2tb.setSize(aSize);    // stick2 trigger time
-   x2tb.setSize(aSize);    // stick2 x-axis trigger pos.
-   y2tb.setSize(aSize);    // stick2 y-axis trigger pos.
-   w2tb.setSize(aSize);    // stick2 whach at trigger time
-
-   b14ptb.setSize(aSize);  // b14+ button trigger time buffer
-   b15ptb.setSize(aSize);  // b15+ button trigger time buffer
-   b14mdtb.setSize(aSize); // b14- pedal down trigger time buffer
-   b14mutb.setSize(aSize); // b14- pedal up trigger time buffer
-   b15mdtb.setSize(aSize); // b15- pedal down trigger time buffer
-   b15mutb.setSize(aSize); // b15- pedal up trigger time buffer
+   position1Frames.setPow2Size(aSize);  // stick1 positions
+   position2Frames.setPow2Size(aSize);  // stick2 positions
+   trigger1Frames.setPow2Size(aSize);   // stick1 triggers
+   trigger2Frames.setPow2Size(aSize);   // stick2 triggers
+   for (int i=0; i<4; i++) {
+      dialFrames[i].setPow2Size(aSize); // dial positions
+   }
+
+   b14ptb.setPow2Size(aSize);  // b14+ button trigger time buffer
+   b15ptb.setPow2Size(aSize);  // b15+ button trigger time buffer
+   b14mdtb.setPow2Size(aSize); // b14- pedal down trigger time buffer
+   b14mutb.setPow2Size(aSize); // b14- pedal up trigger time buffer
+   b15mdtb.setPow2Size(aSize); // b15- pedal down trigger time buffer
+   b15mutb.setPow2Size(aSize); // b15- pedal up trigger time buffer
 }
 
 
@@ -653,6 +878,67 @@ int RadioBaton::d4pc(int min, int max) {
 //
 
 
+//////////////////////////////
+//
+// RadioBaton::attachFrameFields -- point the views of single values
+//    at the frame buffers which store them.
+//
+
+void RadioBaton::attachFrameFields(void) {
+   t1pb.attach(position1Frames, &BatonPositionFrame::time);
+   x1pb.attach(position1Frames, &BatonPositionFrame::x);
+   y1pb.attach(position1Frames, &BatonPositionFrame::y);
+   z1pb.attach(position1Frames, &BatonPositionFrame::z);
+
+   t2pb.attach(position2Frames, &BatonPositionFrame::time);
+   x2pb.attach(position2Frames, &BatonPositionFrame::x);
+   y2pb.attach(position2Frames, &BatonPositionFrame::y);
+   z2pb.attach(position2Frames, &BatonPositionFrame::z);
+
+   d1pb.attach(dialFrames[0], &BatonDialFrame::value);
+   d2pb.attach(dialFrames[1], &BatonDialFrame::value);
+   d3pb.attach(dialFrames[2], &BatonDialFrame::value);
+   d4pb.attach(dialFrames[3], &BatonDialFrame::value);
+
+   t1tb.attach(trigger1Frames, &BatonTriggerFrame::time);
+   x1tb.attach(trigger1Frames, &BatonTriggerFrame::x);
+   y1tb.attach(trigger1Frames, &BatonTriggerFrame::y);
+   w1tb.attach(trigger1Frames, &BatonTriggerFrame::w);
+
+   t2tb.attach(trigger2Frames, &BatonTriggerFrame::time);
+   x2tb.attach(trigger2Frames, &BatonTriggerFrame::x);
+   y2tb.attach(trigger2Frames, &BatonTriggerFrame::y);
+   w2tb.attach(trigger2Frames, &BatonTriggerFrame::w);
+}
+
+
+
+//////////////////////////////
+//
+// RadioBaton::beginStateUpdate -- mark the published state as being
+//    written, so that getState() will not use a partial copy.  Only
+//    the thread which processes the incoming messages writes the state.
+//
+
+void RadioBaton::beginStateUpdate(void) {
+   stateSequence = stateSequence + 1;
+   memoryBarrier();
+}
+
+
+
+//////////////////////////////
+//
+// RadioBaton::endStateUpdate -- mark the published state as complete.
+//
+
+void RadioBaton::endStateUpdate(void) {
+   memoryBarrier();
+   stateSequence = stateSequence + 1;
+}
+
+
+
 //////////////////////////////
 //
 // RadioBaton::interpretCommand -- incoming MIDI messages stored in the
@@ -663,7 +949,7 @@ int RadioBaton::d4pc(int min, int max) {
 
 void RadioBaton::interpretCommand(smf::MidiEvent& aMessage) {
    ushort value;  // for the buff value receive commands
-   uchar  val;
+   BatonDialFrame dframe;
 
    if (aMessage.getCommandByte() == BAT_MIDI_COMMAND) {
       switch (aMessage.getP1()) {
@@ -691,26 +977,45 @@ void RadioBaton::interpretCommand(smf::MidiEvent& aMessage) {
             d1p = aMessage.getP2();             // update global state variable
             dial1position();
             recordState(aMessage.tick, DIAL1RECORD, d1p);
-            val = (unsigned char)aMessage.getP2();
-            d1pb.insert(val);
+            dframe.time = aMessage.tick;
+            dframe.value = d1p;
+            dialFrames[0].insert(dframe);
+            beginStateUpdate();
+            publishedState.dial[0] = dframe;
+            endStateUpdate();
             break;
          case BAT_POT2_RESPONSE:             // pot 2 responding to poll
             d2p = (unsigned char)aMessage.getP2();       // update global state variable
             dial2position();
             recordState(aMessage.tick, DIAL2RECORD, d2p);
-            d2pb.insert(d2p);
+            dframe.time = aMessage.tick;
+            dframe.value = d2p;
+            dialFrames[1].insert(dframe);
+            beginStateUpdate();
+            publishedState.dial[1] = dframe;
+            endStateUpdate();
             break;
          case BAT_POT3_RESPONSE:             // pot 3 responding to poll
             d3p = aMessage.getP2();             // update global state variable
             dial3position();
             recordState(aMessage.tick, DIAL3RECORD, d3p);
-            d3pb.insert(d3p);
+            dframe.time = aMessage.tick;
+            dframe.value = d3p;
+            dialFrames[2].insert(dframe);
+            beginStateUpdate();
+            publishedState.dial[2] = dframe;
+            endStateUpdate();
             break;
          case BAT_POT4_RESPONSE:             // pot 4 responding to poll
             d4p = (unsigned char)aMessage.getP2();             // update global state variable
             dial4position();
             recordState(aMessage.tick, DIAL4RECORD, d4p);
-            d4pb.insert(d4p);
+            dframe.time = aMessage.tick;
+            dframe.value = d4p;
+            dialFrames[3].insert(dframe);
+            beginStateUpdate();
+            publishedState.dial[3] = dframe;
+            endStateUpdate();
             break;
          case BAT_STICK1_TRIGGER:            // stick 1 got triggered
             s1ts(aMessage.tick);
@@ -737,36 +1042,54 @@ void RadioBaton::interpretCommand(smf::MidiEvent& aMessage) {
             switch (aMessage.getP2()) {
                case BAT_B14p_TRIGGER:        // B14+ button pressed
                   b14pt = aMessage.tick;
+                  beginStateUpdate();
+                  publishedState.b14pt = b14pt;
+                  endStateUpdate();
                   b14ptb.insert(b14pt);
                   recordState(aMessage.tick, BUTTON1RECORD);
                   b14plustrig();
                   break;
                case BAT_B15p_TRIGGER:        // B15+ button pressed
                   b15pt = aMessage.tick;
+                  beginStateUpdate();
+                  publishedState.b15pt = b15pt;
+                  endStateUpdate();
                   recordState(aMessage.tick, BUTTON2RECORD);
                   b15plustrig();
                   b15ptb.insert(b15pt);
                   break;
                case BAT_B14m_DOWN_TRIGGER:   // B14- pedal was depressed
                   b14mdt = aMessage.tick;
+                  beginStateUpdate();
+                  publishedState.b14mdt = b14mdt;
+                  endStateUpdate();
                   b14mdtb.insert(b14mdt);
                   recordState(b14mdt, FOOTPEDAL1RECORD, 1);
                   b14minusdowntrig();
                   break;
                case BAT_B14m_UP_TRIGGER:     // B14- pedal was released
                   b14mut = aMessage.tick;
+                  beginStateUpdate();
+                  publishedState.b14mut = b14mut;
+                  endStateUpdate();
                   b14mutb.insert(b14mut);
                   recordState(b14mut, FOOTPEDAL1RECORD, 0);
                   b14minusuptrig();
                   break;
                case BAT_B15m_DOWN_TRIGGER:   // B15- pedal was depressed
                   b15mdt = aMessage.tick;
+                  beginStateUpdate();
+                  publishedState.b15mdt = b15mdt;
+                  endStateUpdate();
                   b15mdtb.insert(b15mdt);
                   recordState(b15mut, FOOTPEDAL2RECORD, 1);
                   b15minusdowntrig();
                   break;
                case BAT_B15m_UP_TRIGGER:     // B15- pedal was released
                   b15mut = aMessage.tick;
+                  beginStateUpdate();
+                  publishedState.b15mut = b15mut;
+                  endStateUpdate();
                   b15mutb.insert(b15mut);
                   recordState(b15mut, FOOTPEDAL2RECORD, 0);
                   b15minusuptrig();
@@ -950,6 +1273,7 @@ void RadioBaton::recordState(long aTime, const char* aState,
 //
 
 void RadioBaton::s1td(int flag, uchar aValue) {
+   BatonTriggerFrame trigger;
    switch (flag) {
       case DATA_W:
          w1t = aValue;         // set the immediate state variable
@@ -972,10 +1296,16 @@ void RadioBaton::s1td(int flag, uchar aValue) {
          whack1y = 1;          // set the global state variable
          s1tf += 16;           // set flag bit 5 (or create an error)
          if (s1tf == 21) {     // if complete data then store trigger set
-            t1tb.insert(t1t);
-            w1tb.insert(w1t);
-            x1tb.insert(x1t);
-            y1tb.insert(y1t);
+            trigger.time = t1t;
+            trigger.x = x1t;
+            trigger.y = y1t;
+            trigger.w = w1t;
+            trigger1Frames.insert(trigger);
+            beginStateUpdate();
+            publishedState.trigger1 = trigger;
+            publishedState.trigger1Count++;
+            endStateUpdate();
+            predictor1.trigger();
             stick1trig();               // call user-defined behavior function
             recordState(t1t, TRIGGER1RECORD, x1t, y1t, w1t);
          } else {
@@ -1013,6 +1343,7 @@ void RadioBaton::s1ts(long aTime) {
 //
 
 void RadioBaton::s2td(int flag, uchar aValue) {
+   BatonTriggerFrame trigger;
    switch (flag) {
       case DATA_W:
          w2t = aValue;          // set the global state variable
@@ -1035,10 +1366,16 @@ void RadioBaton::s2td(int flag, uchar aValue) {
          whack2y = 1;           // set the global state variable
          s2tf += 16;            // set flag bit 5 (or create an error)
          if (s2tf == 21) {      // if complete trigger, then store
-            t2tb.insert(t2t); 
-            w2tb.insert(w2t);
-            x2tb.insert(x2t);
-            y2tb.insert(y2t);
+            trigger.time = t2t;
+            trigger.x = x2t;
+            trigger.y = y2t;
+            trigger.w = w2t;
+            trigger2Frames.insert(trigger);
+            beginStateUpdate();
+            publishedState.trigger2 = trigger;
+            publishedState.trigger2Count++;
+            endStateUpdate();
+            predictor2.trigger();
             stick2trig();               // call the user state function
             recordState(t2t, TRIGGER2RECORD, x2t, y2t, w2t);
          } else {
@@ -1076,6 +1413,7 @@ void RadioBaton::s2ts(long aTime) {
 //
 
 void RadioBaton::s1pd(int flag, uchar aValue) {
+   BatonPositionFrame position;
    switch (flag) {
       case DATA_X:
          x1p = aValue;         // set the global state variable
@@ -1098,9 +1436,18 @@ void RadioBaton::s1pd(int flag, uchar aValue) {
          }
          s1pf += 16;            // set bit 5 (or create an error)
          if (s1pf == 21) {      // if complete temp position set then store
-            x1pb.insert(x1p);
-            y1pb.insert(y1p);
-            z1pb.insert(z1p);
+            position.time = t1p;
+            position.x = x1p;
+            position.y = y1p;
+            position.z = z1p;
+            position1Frames.insert(position);
+            beginStateUpdate();
+            publishedState.position1 = position;
+            publishedState.position1Count++;
+            endStateUpdate();
+            if (predictionQ && predictor1.position(t1p, z1p)) {
+               stick1pretrig();
+            }
             stick1position();
             recordState(t1p, POSITION1RECORD, x1p, y1p, z1p);
          } else {
@@ -1124,7 +1471,6 @@ void RadioBaton::s1pd(int flag, uchar aValue) {
 
 void RadioBaton::s1ps(long aTime) {
    t1p = aTime;
-   t1pb.insert(t1p); 
    s1pf = 0x00;
 }
 
@@ -1139,6 +1485,7 @@ void RadioBaton::s1ps(long aTime) {
 //
 
 void RadioBaton::s2pd(int flag, uchar aValue) {
+   BatonPositionFrame position;
    switch (flag) {
       case DATA_X:
          x2p = aValue;          // set the global state variable
@@ -1161,9 +1508,18 @@ void RadioBaton::s2pd(int flag, uchar aValue) {
          }
          s2pf += 16;            // set flag bit 5 (or create an error)
          if (s2pf == 21) {      // if complete temp position set then store
-            x2pb.insert(x2p);
-            y2pb.insert(y2p);
-            z2pb.insert(z2p);
+            position.time = t2p;
+            position.x = x2p;
+            position.y = y2p;
+            position.z = z2p;
+            position2Frames.insert(position);
+            beginStateUpdate();
+            publishedState.position2 = position;
+            publishedState.position2Count++;
+            endStateUpdate();
+            if (predictionQ && predictor2.position(t2p, z2p)) {
+               stick2pretrig();
+            }
             stick2position();
             recordState(t2p, POSITION2RECORD, x2p, y2p, z2p);
          } else {
@@ -1187,7 +1543,6 @@ void RadioBaton::s2pd(int flag, uchar aValue) {
 
 void RadioBaton::s2ps(long aTime) {
    t2p = aTime;
-   t2pb.insert(t2p);
    s2pf = 0x00;
 }
 
@@ -1220,4 +1575,25 @@ void RadioBatonEmptyBehavior(void) {
 
 
 
+///////////////////////////////////////////////////////////////////////////
+//
+// static functions
+//
+
+
+//////////////////////////////
+//
+// memoryBarrier -- keep the compiler and the processor from moving
+//    memory accesses across this point.  Visual C++ gives volatile
+//    variables the same ordering on x86 computers.
+//
+
+static void memoryBarrier(void) {
+   #ifndef VISUAL
+      __sync_synchronize();
+   #endif
+}
+
+
+
 // md5sum: 2a51c93cbf466a672bc3ac05e4d7440e RadioBaton.cpp [20050403]
@@ -0,0 +1,240 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sun Oct 18 15:10:44 PDT 2026
+// Last Modified: Sun Oct 18 15:10:47 PDT 2026
+// Last Modified: Mon Oct 19 06:14:08 PDT 2026 (opt-in operator new, prepare)
+// Filename:      ...improv/src/RealtimeCheck.cpp
+// Web Address:   http://sig.sapp.org/src/sig/RealtimeCheck.cpp
+// Syntax:        C++
+//
+// Description:   Detects heap allocations in time-critical threads.
+//                Threads mark themselves as realtime with enterThread()
+//                (the MIDI input threads, and the improv event loops
+//                once initialization is finished).  When checking is
+//                turned on with setMode(), any call to operator new
+//                from a realtime thread is counted, or aborts the
+//                program so that it can be found in a debugger.
+//                Allocations with malloc() directly are not seen.
+//
+//                The library does not replace operator new.  A program
+//                which wants the check includes RealtimeNew.h in one of
+//                its source files (the improv environments do so when
+//                compiled with -DREALTIME_CHECK).
+//
+
+#include "RealtimeCheck.h"
+
+#include <stdlib.h>
+
+#ifndef VISUAL
+   #include <unistd.h>
+#endif
+
+// declarations of static variables:
+volatile int     RealtimeCheck::mode          = REALTIME_OFF;
+int              RealtimeCheck::installedQ    = 0;
+volatile long    RealtimeCheck::count         = 0;
+volatile long    RealtimeCheck::largest       = 0;
+thread_local int RealtimeCheck::realtimeDepth = 0;
+
+
+//////////////////////////////
+//
+// RealtimeCheck::allocation -- called by the operator new in
+//     RealtimeNew.h for every allocation.  Only does something in
+//     realtime threads when checking is turned on.
+//
+
+void RealtimeCheck::allocation(size_t aSize) {
+   if (mode == REALTIME_OFF || realtimeDepth <= 0) {
+      return;
+   }
+
+   if (mode == REALTIME_ABORT) {
+      // cannot use iostreams here since they may allocate
+      static const char message[] =
+            "Error: heap allocation in a realtime thread\n";
+      #ifndef VISUAL
+         if (write(2, message, sizeof(message) - 1) < 0) {
+            // nothing more can be done
+         }
+      #endif
+      abort();
+   }
+
+   __sync_fetch_and_add(&count, 1);
+   if ((long)aSize > largest) {
+      largest = (long)aSize;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// RealtimeCheck::enterThread -- mark the calling thread as realtime.
+//     Calls may be nested with leaveThread().
+//
+
+void RealtimeCheck::enterThread(void) {
+   realtimeDepth++;
+}
+
+
+
+//////////////////////////////
+//
+// RealtimeCheck::getCount -- returns the number of allocations in
+//     realtime threads since the last reset.
+//
+
+long RealtimeCheck::getCount(void) {
+   return count;
+}
+
+
+
+//////////////////////////////
+//
+// RealtimeCheck::getMode -- returns REALTIME_OFF, REALTIME_COUNT or
+//     REALTIME_ABORT.
+//
+
+int RealtimeCheck::getMode(void) {
+   return mode;
+}
+
+
+
+//////////////////////////////
+//
+// RealtimeCheck::install -- called by RealtimeNew.h when the program
+//     starts, to say that operator new reports its allocations.
+//
+
+int RealtimeCheck::install(void) {
+   installedQ = 1;
+   return 1;
+}
+
+
+
+//////////////////////////////
+//
+// RealtimeCheck::isInstalled -- returns true if the program includes
+//     the replacement operator new from RealtimeNew.h.
+//
+
+int RealtimeCheck::isInstalled(void) {
+   return installedQ;
+}
+
+
+
+//////////////////////////////
+//
+// RealtimeCheck::isRealtimeThread -- returns true if the calling thread
+//     is marked as realtime.
+//
+
+int RealtimeCheck::isRealtimeThread(void) {
+   return realtimeDepth > 0;
+}
+
+
+
+//////////////////////////////
+//
+// RealtimeCheck::leaveThread -- undo one call to enterThread().
+//
+
+void RealtimeCheck::leaveThread(void) {
+   if (realtimeDepth > 0) {
+      realtimeDepth--;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// RealtimeCheck::prepare -- give a MIDI message storage for the
+//     largest message which the MIDI input threads store, so that
+//     copying a message into it later does not allocate memory.  For
+//     a buffer, each slot is prepared.
+//
+
+void RealtimeCheck::prepare(smf::MidiEvent& aMessage) {
+   aMessage.setP0(0);
+   aMessage.setP1(0);
+   aMessage.setP2(0);
+   aMessage.setP3(0);
+}
+
+
+void RealtimeCheck::prepare(CircularBuffer<smf::MidiEvent>& aBuffer) {
+   smf::MidiEvent blank;
+   prepare(blank);
+   aBuffer.fill(blank);
+}
+
+
+
+//////////////////////////////
+//
+// RealtimeCheck::report -- print the number of allocations which were
+//     found in realtime threads.
+//
+
+void RealtimeCheck::report(ostream& out) {
+   if (mode == REALTIME_OFF) {
+      return;
+   }
+   out << "Realtime check: " << count << " heap allocation";
+   if (count != 1) {
+      out << "s";
+   }
+   out << " in realtime threads";
+   if (count > 0) {
+      out << " (largest: " << largest << " bytes)";
+   }
+   out << endl;
+}
+
+
+
+//////////////////////////////
+//
+// RealtimeCheck::reset -- clear the allocation count.
+//
+
+void RealtimeCheck::reset(void) {
+   count = 0;
+   largest = 0;
+}
+
+
+
+//////////////////////////////
+//
+// RealtimeCheck::setMode -- turn allocation checking on or off.
+//     Nothing can be seen unless the program includes RealtimeNew.h.
+//
+
+void RealtimeCheck::setMode(int aMode) {
+   switch (aMode) {
+      case REALTIME_COUNT:
+      case REALTIME_ABORT:
+         mode = aMode;
+         if (!installedQ) {
+            cerr << "Warning: allocations cannot be checked since the "
+                 << "program does not include RealtimeNew.h" << endl;
+         }
+         break;
+      default:
+         mode = REALTIME_OFF;
+   }
+}
+
+
+
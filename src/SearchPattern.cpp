@@ -0,0 +1,106 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Mon Oct 19 07:21:43 PDT 2026
+// Last Modified: Mon Oct 19 07:21:43 PDT 2026
+// Filename:      ...improv/src/SearchPattern.cpp
+// Web Address:   http://sig.sapp.org/src/sig/SearchPattern.cpp
+// Syntax:        C++
+//
+// Description:   A compiled regular expression (POSIX extended syntax)
+//                for searching the text of PerformData records.
+//
+
+#include "SearchPattern.h"
+
+#ifndef OLDCPP
+   #include <iostream>
+   using namespace std;
+#else
+   #include <iostream.h>
+#endif
+
+
+//////////////////////////////
+//
+// SearchPattern::SearchPattern --
+//
+
+SearchPattern::SearchPattern(void) {
+   validQ = 0;
+   setQ = 0;
+}
+
+
+SearchPattern::SearchPattern(const char* aPattern) {
+   validQ = 0;
+   setQ = 0;
+   setPattern(aPattern);
+}
+
+
+
+//////////////////////////////
+//
+// SearchPattern::~SearchPattern --
+//
+
+SearchPattern::~SearchPattern() {
+   // do nothing
+}
+
+
+
+//////////////////////////////
+//
+// SearchPattern::isValid -- returns true if the pattern compiled.
+//
+
+int SearchPattern::isValid(void) const {
+   return validQ;
+}
+
+
+
+//////////////////////////////
+//
+// SearchPattern::matches -- returns true if the pattern matches
+//    somewhere in the text.  A bad pattern matches nothing.
+//
+
+int SearchPattern::matches(const char* text) const {
+   if (!validQ || text == NULL) {
+      return 0;
+   }
+   return regex_search(text, expression);
+}
+
+
+
+//////////////////////////////
+//
+// SearchPattern::setPattern -- compile the pattern, unless it is the
+//    one which was compiled last time.  Returns 0 and prints a message
+//    if the pattern is bad.
+//
+
+int SearchPattern::setPattern(const char* aPattern) {
+   if (aPattern == NULL) {
+      aPattern = "";
+   }
+   if (setQ && source == aPattern) {
+      return validQ;
+   }
+   source = aPattern;
+   setQ = 1;
+   try {
+      expression = regex(source, regex::extended);
+      validQ = 1;
+   } catch (regex_error&) {
+      cerr << "Error: bad regular expression: " << source << endl;
+      validQ = 0;
+   }
+   return validQ;
+}
+
+
+
@@ -3,6 +3,7 @@
 // Creation Date: Thu May 11 21:10:02 PDT 2000
 // Last Modified: Sat Oct 13 14:51:43 PDT 2001 (updated for ALSA 0.9 interface)
 // Last Modified: Tue May 26 12:38:18 EDT 2009 (updated for ALSA 1.0 interface)
+// Last Modified: Sun Oct 18 10:20:31 PDT 2026 (removed debug print in write)
 // Filename:      ...sig/maint/code/control/Sequencer_alsa.cpp
 // Web Address:   http://sig.sapp.org/src/sig/Sequencer_alsa.cpp
 // Syntax:        C++ 
@@ -415,7 +416,6 @@ int Sequencer_alsa::write(int aDevice, int aByte) {
 
 
 int Sequencer_alsa::write(int aDevice, uchar* bytes, int count) {
-cout << "> AAA " << hex << (int)bytes[0] << dec << " " << (int)bytes[1] << " " << (int)bytes[2] << endl;
    if (is_open_out(aDevice)) {
       int status = snd_rawmidi_write(rawmidi_out[aDevice], bytes, count);
       return status == count ? 1 : 0;
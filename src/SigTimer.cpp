@@ -11,6 +11,8 @@
 // Last Modified: Sun Nov 28 12:39:39 PST 1999 (added adjustPeriod())
 // Last Modofied: Sun Nov 20 01:19:24 PST 2005 (new cpu speed measurement)
 // Last Modofied: Tue Jun  9 14:17:28 PDT 2009 (added Apple OSX capability)
+// Last Modified: Sun Oct 18 13:52:40 PDT 2026 (fixed 64-bit clockCycles)
+// Last Modified: Mon Oct 19 03:35:12 PDT 2026 (added setClockSource())
 // Filename:      .../sig/code/control/SigTimer/SigTimer.cpp
 // Web Address:   http://improv.sapp.org/src/SigTimer.cpp
 // Syntax:        C++ 
@@ -76,6 +78,7 @@
 // declare static variables
 int64bits SigTimer::globalOffset = 0;
 int64bits SigTimer::cpuSpeed     = 0;      // in cycles per second
+SigClockSource SigTimer::clockSource = NULL;  // NULL for the hardware clock
 
 
 //////////////////////////////
@@ -147,10 +150,15 @@ void SigTimer::adjustPeriod(double periodDelta) {
 //
 // SigTimer::clockCycles -- returns the number of clock cycles since last reboot
 //	   HARDWARE DEPENDENT -- currently for Pentiums only.
-//     static function.
+//     static function.  If a clock source has been set with
+//     setClockSource(), the cycles come from it instead.
 //
 
 int64bits SigTimer::clockCycles() {
+   if (clockSource != NULL) {
+      return clockSource();
+   }
+
 
 #ifdef OSXTIMER
    int64bits output = mach_absolute_time();
@@ -165,6 +173,12 @@ int64bits SigTimer::clockCycles() {
    output = high_end;
    output = output << 32;
    output += low_end;
+#elif defined(__x86_64__)
+   // The "=A" constraint only returns the EAX half of the counter
+   // on 64-bit processors, so read both halves separately.
+   unsigned int high_end, low_end;
+   __asm__ volatile ("rdtsc" : "=a" (low_end), "=d" (high_end));
+   int64bits output = ((int64bits)high_end << 32) | low_end;
 #else /* for Linux or probably any unix in Intel CPUs */
    int64bits output;
 
@@ -192,6 +206,19 @@ int SigTimer::expired(void) const {
 
 
 
+//////////////////////////////
+//
+// SigTimer::getClockSource -- returns the function which is used in
+//   place of the hardware clock, or NULL if the hardware clock is used.
+//   (static function)
+//
+
+SigClockSource SigTimer::getClockSource(void) {
+   return clockSource;
+}
+
+
+
 //////////////////////////////
 //
 // SigTimer::getCpuSpeed -- returns the CPU speed of the computer.
@@ -482,6 +509,20 @@ void SigTimer::setCpuSpeed(int64bits aSpeed) {
 
 
 
+//////////////////////////////
+//
+// SigTimer::setClockSource -- count time with the given function
+//   instead of the hardware clock.  The function must return clock
+//   cycles at the rate of getCpuSpeed() which never go backwards.
+//   Use NULL to return to the hardware clock.  (static function)
+//
+
+void SigTimer::setClockSource(SigClockSource aSource) {
+   clockSource = aSource;
+}
+
+
+
 //////////////////////////////
 //
 // SigTimer::setPeriod -- sets the period length of the timer.
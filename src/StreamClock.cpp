@@ -0,0 +1,147 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Mon Oct 19 02:20:31 PDT 2026
+// Last Modified: Mon Oct 19 02:20:35 PDT 2026
+// Filename:      ...improv/src/StreamClock.cpp
+// Web Address:   http://sig.sapp.org/src/sig/StreamClock.cpp
+// Syntax:        C++
+//
+// Description:   Reconstructs the times at which a device sent frames
+//                of data at a steady rate from the jittered times at
+//                which the frames arrived.  A frame can arrive late but
+//                never early, so the clock follows the earliest arrivals
+//                and slowly adjusts its period to the clock drift
+//                between the device and the computer.  Times are in
+//                milliseconds.
+//
+
+#include "StreamClock.h"
+
+#define LATE_GAIN     (0.05)   /* fraction of a late arrival followed     */
+#define PERIOD_GAIN   (0.01)   /* fraction of a correction put in period  */
+#define PERIOD_RANGE  (0.1)    /* largest relative change of the period   */
+#define GAP_FRAMES    (3.0)    /* frames of silence which restart clock   */
+
+
+//////////////////////////////
+//
+// StreamClock::StreamClock --
+//
+
+StreamClock::StreamClock(void) {
+   nominalPeriod = 16.0;
+   reset();
+}
+
+
+StreamClock::StreamClock(double aPeriod) {
+   nominalPeriod = aPeriod;
+   reset();
+}
+
+
+
+//////////////////////////////
+//
+// StreamClock::~StreamClock --
+//
+
+StreamClock::~StreamClock() {
+   // do nothing
+}
+
+
+
+//////////////////////////////
+//
+// StreamClock::getPeriod -- returns the measured time between frames.
+//
+
+double StreamClock::getPeriod(void) const {
+   return period;
+}
+
+
+
+//////////////////////////////
+//
+// StreamClock::getResyncCount -- returns the number of times that the
+//    clock was restarted because frames were missing.
+//
+
+long StreamClock::getResyncCount(void) const {
+   return resyncCount;
+}
+
+
+
+//////////////////////////////
+//
+// StreamClock::reset -- forget the stream, such as when the device
+//    is switched into streaming mode.
+//
+
+void StreamClock::reset(void) {
+   period      = nominalPeriod;
+   lastTime    = 0.0;
+   runningQ    = 0;
+   resyncCount = 0;
+}
+
+
+
+//////////////////////////////
+//
+// StreamClock::setPeriod -- set the expected time between frames.
+//
+
+void StreamClock::setPeriod(double aPeriod) {
+   nominalPeriod = aPeriod;
+   reset();
+}
+
+
+
+//////////////////////////////
+//
+// StreamClock::stamp -- give the arrival time of the next frame and
+//    return the time at which it was sent.  An arrival which is earlier
+//    than expected pulls the clock back to it, while a late arrival only
+//    moves the clock a little, since most lateness is delivery jitter.
+//    If frames stop arriving for a while, the clock starts again from
+//    the next arrival.
+//
+
+double StreamClock::stamp(long arrivalTime) {
+   double predicted = lastTime + period;
+   if (!runningQ || arrivalTime < lastTime ||
+         arrivalTime > predicted + GAP_FRAMES * period) {
+      if (runningQ) {
+         resyncCount++;
+      }
+      runningQ = 1;
+      lastTime = arrivalTime;
+      return lastTime;
+   }
+
+   double error = arrivalTime - predicted;
+   double frameTime;
+   if (error < 0.0) {
+      frameTime = arrivalTime;
+   } else {
+      frameTime = predicted + LATE_GAIN * error;
+   }
+
+   period += PERIOD_GAIN * (frameTime - predicted);
+   if (period > nominalPeriod * (1.0 + PERIOD_RANGE)) {
+      period = nominalPeriod * (1.0 + PERIOD_RANGE);
+   } else if (period < nominalPeriod * (1.0 - PERIOD_RANGE)) {
+      period = nominalPeriod * (1.0 - PERIOD_RANGE);
+   }
+
+   lastTime = frameTime;
+   return frameTime;
+}
+
+
+
@@ -3,6 +3,12 @@
 // Creation Date: 5 January 1998
 // Last Modified: 5 January 1998
 // Last Modified: Tue Mar 13 14:12:11 PST 2001 (added 0x80 message filtering)
+// Last Modified: Sun Oct 18 15:31:08 PDT 2026 (preallocate for realtime use)
+// Last Modified: Sun Oct 18 17:32:20 PDT 2026 (flat controller table)
+// Last Modified: Sun Oct 18 18:20:41 PDT 2026 (added note state)
+// Last Modified: Mon Oct 19 06:14:08 PDT 2026 (per-object input event)
+// Last Modified: Mon Oct 19 07:58:40 PDT 2026 (lowestBit from bitops.h)
+// Last Modified: Mon Oct 19 08:31:47 PDT 2026 (extract from an orphan)
 // Filename:      ...sig/code/src/control/Synthesizer/Synthesizer/cpp
 // Web Address:   http://www-ccrma.stanford.edu/~craig/improv/src/Synthesizer.cpp
 // Syntax:        C++
@@ -13,6 +19,11 @@
 //
 
 #include "Synthesizer.h"
+#include "RealtimeCheck.h"
+#include "bitops.h"
+
+#include <string.h>
+#include <stdlib.h>
 
 
 //////////////////////////////
@@ -21,25 +32,21 @@
 //
 
 Synthesizer::Synthesizer(void) : MidiIO() {
-   for (int channel=0; channel<16; channel++) {
-      for (int contno=0; contno<128; contno++) {
-         Controller[channel][contno].setSize(DEFAULT_CONT_SIZE);
-      }
-   }
+   setControllerHistory(DEFAULT_CONT_HISTORY);
    zeroControllers();
    note.setSize(1024);
+   RealtimeCheck::prepare(note);
+   RealtimeCheck::prepare(inputEvent);
 }
 
 
 Synthesizer::Synthesizer(int outputDevice, int inputDevice) :
       MidiIO(outputDevice, inputDevice) {
-   for (int channel=0; channel<16; channel++) {
-      for (int contno=0; contno<128; contno++) {
-         Controller[channel][contno].setSize(DEFAULT_CONT_SIZE);
-      }
-   }
+   setControllerHistory(DEFAULT_CONT_HISTORY);
    zeroControllers();
    note.setSize(1024);
+   RealtimeCheck::prepare(note);
+   RealtimeCheck::prepare(inputEvent);
 }
   
 
@@ -55,16 +62,122 @@ Synthesizer::~Synthesizer() {
 
 
 
+//////////////////////////////
+//
+// Synthesizer::clearChangedControllers -- forget which controllers
+//	have changed.
+//
+
+void Synthesizer::clearChangedControllers(void) {
+   memset(changedBits, 0, sizeof(changedBits));
+   changedChannels = 0;
+}
+
+
+
 //////////////////////////////
 //
 // Synthesizer::controller -- returns the current state of the controller
-//	by default, but can check the history back to DEFAULT_CONT_SIZE - 1
+//	by default.  An index greater than 0 returns an older value of the
+//	controller from the history log (index 1 is the value before the
+//	current one), or 0 if the log no longer contains that value.
 //	default value: channel = 0.
 //	default value: index = 0.
 //
 
 int Synthesizer::controller(int controlNumber, int channel, int index) {
-   return Controller[channel][controlNumber][index];
+   if (index == 0) {
+      return controllers[channel & 0x0f][controlNumber & 0x7f];
+   }
+
+   index = abs(index);
+   for (int i=0; i<history.getSize(); i++) {
+      ControllerChange& entry = history[i];
+      if (entry.number == controlNumber && entry.channel == channel) {
+         if (index == 0) {
+            return entry.value;
+         }
+         index--;
+      }
+   }
+   return 0;
+}
+
+
+
+//////////////////////////////
+//
+// Synthesizer::controller14 -- returns the 14-bit value of a controller
+//	which has an MSB (controllers 0-31) and an LSB (controllers 32-63).
+//	Either controller number of the pair can be given.  The LSB is
+//	treated as 0 if the MSB was received after it.  For controllers
+//	without an LSB, the 7-bit value is returned in the upper 7 bits.
+//	default value: channel = 0.
+//
+
+int Synthesizer::controller14(int controlNumber, int channel) const {
+   channel &= 0x0f;
+   controlNumber &= 0x7f;
+   if (controlNumber >= 32 && controlNumber < 64) {
+      controlNumber -= 32;
+   }
+   int value = controllers[channel][controlNumber] << 7;
+   if (controlNumber < 32 && (lsbValid[channel] & (1u << controlNumber))) {
+      value |= controllers[channel][controlNumber + 32];
+   }
+   return value;
+}
+
+
+
+//////////////////////////////
+//
+// Synthesizer::controllerChangedQ -- returns true if the controller
+//	has changed since it was last returned by extractChangedController()
+//	or since clearChangedControllers() was called.
+//	default value: channel = 0.
+//
+
+int Synthesizer::controllerChangedQ(int controlNumber, int channel) const {
+   channel &= 0x0f;
+   controlNumber &= 0x7f;
+   return (changedBits[channel][controlNumber >> 5] >> 
+         (controlNumber & 0x1f)) & 1;
+}
+
+
+
+//////////////////////////////
+//
+// Synthesizer::extractChangedController -- find the next controller
+//	which has changed, and clear its changed flag.  Returns 0 if no
+//	controllers have changed.  Controllers which changed several times
+//	are only returned once; use controller() to read the value:
+//
+//	   while (synth.extractChangedController(number, channel)) {
+//	      value = synth.controller(number, channel);
+//	      ...
+//	   }
+//
+
+int Synthesizer::extractChangedController(int& controlNumber, int& channel) {
+   while (changedChannels != 0) {
+      channel = lowestBit(changedChannels);
+      uint32_t* bits = changedBits[channel];
+      for (int word=0; word<4; word++) {
+         if (bits[word] != 0) {
+            int bit = lowestBit(bits[word]);
+            bits[word] &= ~(1u << bit);
+            controlNumber = word * 32 + bit;
+            if ((bits[0] | bits[1] | bits[2] | bits[3]) == 0) {
+               changedChannels &= ~(1 << channel);
+            }
+            return 1;
+         }
+      }
+      changedChannels &= ~(1 << channel);
+   }
+   return 0;
 }
 
 
@@ -83,6 +196,18 @@ smf::MidiEvent Synthesizer::extractNote(void) {
 
 
 
+//////////////////////////////
+//
+// Synthesizer::getControllerHistory -- returns the number of controller
+//	changes which are kept in the history log.
+//
+
+int Synthesizer::getControllerHistory(void) const {
+   return history.getSize();
+}
+
+
+
 //////////////////////////////
 //
 // Synthesizer::getNoteCount -- return the number of note 
@@ -96,6 +221,22 @@ int Synthesizer::getNoteCount(void) const {
 
 
 
+//////////////////////////////
+//
+// Synthesizer::getNoteState -- returns the keys which are held down
+//	and the notes which are sounding, as of the last call to
+//	processIncomingMessages().  For example:
+//
+//	   int keys[128];
+//	   int count = synth.getNoteState().getHeldNotes(keys, 128);
+//
+
+NoteState& Synthesizer::getNoteState(void) {
+   return noteState;
+}
+
+
+
 //////////////////////////////
 //
 // Synthesizer::operator[] -- returns the note message
@@ -114,10 +255,30 @@ smf::MidiEvent& Synthesizer::operator[](int index) {
 //
 
 void Synthesizer::processIncomingMessages(void) {
-   smf::MidiEvent event;
    while (MidiInput::getCount() > 0) {
-      MidiInPort::extract(event);
-      interpretMessage(event);
+      MidiInput::extract(inputEvent);
+      interpretMessage(inputEvent);
+   }
+}
+
+
+
+//////////////////////////////
+//
+// Synthesizer::setControllerHistory -- set the number of controller
+//	changes (on all controllers together) which are kept for reading
+//	older values with controller().  The size is rounded up to a power
+//	of two.  A size of 0 turns off the history log.  Clears the log.
+//
+
+void Synthesizer::setControllerHistory(int aSize) {
+   ControllerChange blank;
+   memset(&blank, 0, sizeof(blank));
+   if (aSize <= 0) {
+      history.setSize(0);
+   } else {
+      history.setPow2Size(aSize);
+      history.fill(blank);
    }
 }
 
@@ -130,14 +291,13 @@ void Synthesizer::processIncomingMessages(void) {
 //
 
 void Synthesizer::zeroControllers(void) {
-   for (int contno=0; contno<128; contno++) {
-      for (int channel=0; channel<16; channel++) {
-         for (int element=0; 
-               element<Controller[channel][contno].getSize(); element++) {
-            Controller[channel][contno][element] = 0;
-         }
-      }
-   }
+   ControllerChange blank;
+   memset(&blank, 0, sizeof(blank));
+   memset(controllers, 0, sizeof(controllers));
+   memset(lsbValid, 0, sizeof(lsbValid));
+   clearChangedControllers();
+   history.reset();
+   history.fill(blank);
 }
 
 
@@ -152,21 +312,54 @@ void Synthesizer::zeroControllers(void) {
 //
 // Synthesizer::interpretMessage -- all note information gets sent
 //    to a circular buffer.  All cont messages get sorted into
-//    separate slots according to channel.
+//    separate slots according to channel.  The note state is updated
+//    from notes and from the sustain pedal.
 //
 
 void Synthesizer::interpretMessage(smf::MidiEvent& aMessage) {
+   noteState.process(aMessage);
    if ((aMessage.getCommandByte() & 0xf0) == 0x90) {         // a Note-on message
       note.insert(aMessage);
    } else if ((aMessage.getCommandByte() & 0xf0) == 0x80) {  // a Note-off message
       note.insert(aMessage);
    } else if ((aMessage.getCommandByte() & 0xf0) == 0xb0) {  // a controller message
-      Controller[aMessage.getCommandByte() & 0x0f][aMessage.getP1()].insert(aMessage.getP2());
+      storeController(aMessage.getCommandByte() & 0x0f, 
+            aMessage.getP1() & 0x7f, aMessage.getP2() & 0x7f);
    }
    // ignore all other messages
 }
 
 
 
+//////////////////////////////
+//
+// Synthesizer::storeController -- set the current value of a
+//    controller, mark it as changed and add it to the history log.
+//
+
+void Synthesizer::storeController(int channel, int controlNumber, int value) {
+   controllers[channel][controlNumber] = (uchar)value;
+   changedBits[channel][controlNumber >> 5] |= 1u << (controlNumber & 0x1f);
+   changedChannels |= 1 << channel;
+
+   if (controlNumber < 32) {
+      lsbValid[channel] &= ~(1u << controlNumber);
+   } else if (controlNumber < 64) {
+      lsbValid[channel] |= 1u << (controlNumber - 32);
+   }
+
+   if (history.getSize() > 0) {
+      ControllerChange entry;
+      entry.channel = (uchar)channel;
+      entry.number  = (uchar)controlNumber;
+      entry.value   = (uchar)value;
+      if (history.capacity() <= 0) {
+         history.advanceRead(1);    // log is never extracted from
+      }
+      history.insert(entry);
+   }
+}
+
+
 
 // md5sum: 87b0cba2949293ed4f76f4cfbd940d87 Synthesizer.cpp [20020518]
@@ -0,0 +1,355 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Mon Oct 19 00:48:15 PDT 2026
+// Last Modified: Mon Oct 19 00:48:19 PDT 2026
+// Filename:      ...improv/src/TriggerPredictor.cpp
+// Web Address:   http://sig.sapp.org/src/sig/TriggerPredictor.cpp
+// Syntax:        C++
+//
+// Description:   Predicts when a baton stick will hit the trigger
+//                plane from its recent heights, so that a sound can
+//                be started before the trigger message arrives from
+//                the baton.  A parabola is fitted to the last few
+//                heights to estimate the velocity and acceleration of
+//                the stick, and a pre-trigger is reported once for
+//                each stroke when the predicted impact is close enough
+//                and the fit is good enough.  Heights increase towards
+//                the trigger plane, as in the position reports of the
+//                Radio Baton.  Times are in milliseconds.
+//
+
+#include "TriggerPredictor.h"
+
+#include <math.h>
+
+
+//////////////////////////////
+//
+// TriggerPredictor::TriggerPredictor --
+//
+
+TriggerPredictor::TriggerPredictor(void) {
+   window        = 6;
+   level         = 110.0;
+   leadTime      = 50.0;
+   minVelocity   = 0.2;
+   minConfidence = 0.9;
+   rearmDistance = 10.0;
+   reset();
+}
+
+
+
+//////////////////////////////
+//
+// TriggerPredictor::~TriggerPredictor --
+//
+
+TriggerPredictor::~TriggerPredictor() {
+   // do nothing
+}
+
+
+
+//////////////////////////////
+//
+// TriggerPredictor::getAcceleration -- returns the estimated acceleration
+//    of the stick towards the trigger plane in height units per
+//    millisecond squared.
+//
+
+double TriggerPredictor::getAcceleration(void) const {
+   return acceleration;
+}
+
+
+
+//////////////////////////////
+//
+// TriggerPredictor::getConfidence -- returns the fraction of the
+//    variation in the recent heights which is explained by the fitted
+//    parabola (1.0 for a perfect fit).
+//
+
+double TriggerPredictor::getConfidence(void) const {
+   return confidence;
+}
+
+
+
+//////////////////////////////
+//
+// TriggerPredictor::getImpactTime -- returns the predicted time of the
+//    impact for the last pre-trigger.
+//
+
+double TriggerPredictor::getImpactTime(void) const {
+   return impactTime;
+}
+
+
+
+//////////////////////////////
+//
+// TriggerPredictor::getImpactVelocity -- returns the predicted velocity
+//    of the stick at the impact for the last pre-trigger, in height units
+//    per millisecond.  This can be used for the loudness of the sound.
+//
+
+double TriggerPredictor::getImpactVelocity(void) const {
+   return impactVelocity;
+}
+
+
+
+//////////////////////////////
+//
+// TriggerPredictor::getVelocity -- returns the estimated velocity of the
+//    stick towards the trigger plane in height units per millisecond.
+//
+
+double TriggerPredictor::getVelocity(void) const {
+   return velocity;
+}
+
+
+
+//////////////////////////////
+//
+// TriggerPredictor::position -- add a new height of the stick.  Returns
+//    1 if the stick is predicted to hit the trigger plane within the
+//    lead time, in which case getImpactTime() gives the predicted time
+//    of the hit.  Only one pre-trigger is given for each stroke: the
+//    stick must move back away from the plane before the next one.
+//
+
+int TriggerPredictor::position(long aTime, int aHeight) {
+   times[next] = aTime;
+   heights[next] = aHeight;
+   next = (next + 1) % PREDICTOR_MAX_WINDOW;
+   if (count < PREDICTOR_MAX_WINDOW) {
+      count++;
+   }
+
+   double height;
+   if (!estimate(height)) {
+      return 0;
+   }
+
+   if (!armedQ) {
+      if (height < level - rearmDistance && velocity < 0.0) {
+         armedQ = 1;
+      }
+      return 0;
+   }
+
+   if (height >= level || velocity < minVelocity ||
+         confidence < minConfidence) {
+      return 0;
+   }
+
+   // solve height + velocity * t + acceleration/2 * t^2 = level for
+   // the first time t after now (in a form which is accurate when the
+   // acceleration is near zero).
+   double distance = level - height;
+   double discriminant = velocity * velocity + 2.0 * acceleration * distance;
+   if (discriminant < 0.0) {
+      return 0;                 // slowing down enough to miss the plane
+   }
+   double duration = 2.0 * distance / (velocity + sqrt(discriminant));
+   if (duration > leadTime) {
+      return 0;
+   }
+
+   impactTime = aTime + duration;
+   impactVelocity = velocity + acceleration * duration;
+   armedQ = 0;
+   return 1;
+}
+
+
+
+//////////////////////////////
+//
+// TriggerPredictor::reset -- forget the recent heights.
+//
+
+void TriggerPredictor::reset(void) {
+   count          = 0;
+   next           = 0;
+   velocity       = 0.0;
+   acceleration   = 0.0;
+   confidence     = 0.0;
+   impactTime     = 0.0;
+   impactVelocity = 0.0;
+   armedQ         = 1;
+}
+
+
+
+//////////////////////////////
+//
+// TriggerPredictor::setConfidence -- set the smallest fraction of the
+//    variation in the recent heights which must be explained by the
+//    fitted parabola before a pre-trigger is given.  Larger values give
+//    fewer false pre-triggers but miss more hits.
+//
+
+void TriggerPredictor::setConfidence(double minimum) {
+   minConfidence = minimum;
+}
+
+
+
+//////////////////////////////
+//
+// TriggerPredictor::setLeadTime -- set the longest time before the
+//    predicted impact at which a pre-trigger is given.  Longer times give
+//    more warning but larger errors in the predicted time.
+//
+
+void TriggerPredictor::setLeadTime(double milliseconds) {
+   leadTime = milliseconds;
+}
+
+
+
+//////////////////////////////
+//
+// TriggerPredictor::setMinVelocity -- set the slowest approach to the
+//    trigger plane, in height units per second, which can give a
+//    pre-trigger.
+//
+
+void TriggerPredictor::setMinVelocity(double unitsPerSecond) {
+   minVelocity = unitsPerSecond / 1000.0;
+}
+
+
+
+//////////////////////////////
+//
+// TriggerPredictor::setRearmDistance -- set how far the stick must move
+//    back from the trigger plane before the next pre-trigger.
+//
+
+void TriggerPredictor::setRearmDistance(double distance) {
+   rearmDistance = distance;
+}
+
+
+
+//////////////////////////////
+//
+// TriggerPredictor::setTriggerLevel -- set the height of the trigger
+//    plane.
+//
+
+void TriggerPredictor::setTriggerLevel(double aLevel) {
+   level = aLevel;
+}
+
+
+
+//////////////////////////////
+//
+// TriggerPredictor::setWindow -- set the number of recent heights which
+//    are used to estimate the motion of the stick.  At least four are
+//    needed for the confidence to mean anything.
+//
+
+void TriggerPredictor::setWindow(int aCount) {
+   if (aCount < 3) {
+      aCount = 3;
+   } else if (aCount > PREDICTOR_MAX_WINDOW) {
+      aCount = PREDICTOR_MAX_WINDOW;
+   }
+   window = aCount;
+}
+
+
+
+//////////////////////////////
+//
+// TriggerPredictor::trigger -- tell the predictor that the stick has hit
+//    the trigger plane, so that no pre-trigger is given for the rest of
+//    the stroke.
+//
+
+void TriggerPredictor::trigger(void) {
+   armedQ = 0;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// protected functions
+//
+
+
+//////////////////////////////
+//
+// TriggerPredictor::estimate -- fit a parabola to the recent heights by
+//    least squares.  Sets the current height and the velocity,
+//    acceleration and confidence of the fit.  Returns 0 if there are not
+//    enough heights.
+//
+
+int TriggerPredictor::estimate(double& height) {
+   if (count < window) {
+      return 0;
+   }
+
+   // times are measured from the newest position
+   int newest = (next + PREDICTOR_MAX_WINDOW - 1) % PREDICTOR_MAX_WINDOW;
+   double s1 = 0.0, s2 = 0.0, s3 = 0.0, s4 = 0.0;
+   double y0 = 0.0, y1 = 0.0, y2 = 0.0;
+   int i, index;
+   for (i=0; i<window; i++) {
+      index = (newest + PREDICTOR_MAX_WINDOW - i) % PREDICTOR_MAX_WINDOW;
+      double t = times[index] - times[newest];
+      double y = heights[index];
+      s1 += t;
+      s2 += t * t;
+      s3 += t * t * t;
+      s4 += t * t * t * t;
+      y0 += y;
+      y1 += t * y;
+      y2 += t * t * y;
+   }
+   double s0 = window;
+
+   // solve the normal equations with Cramer's rule
+   double det = s0 * (s2 * s4 - s3 * s3) - s1 * (s1 * s4 - s3 * s2) +
+         s2 * (s1 * s3 - s2 * s2);
+   if (fabs(det) < 1e-9) {
+      return 0;
+   }
+   double c0 = (y0 * (s2 * s4 - s3 * s3) - s1 * (y1 * s4 - s3 * y2) +
+         s2 * (y1 * s3 - s2 * y2)) / det;
+   double c1 = (s0 * (y1 * s4 - y2 * s3) - y0 * (s1 * s4 - s3 * s2) +
+         s2 * (s1 * y2 - y1 * s2)) / det;
+   double c2 = (s0 * (s2 * y2 - s3 * y1) - s1 * (s1 * y2 - y1 * s2) +
+         y0 * (s1 * s3 - s2 * s2)) / det;
+
+   double mean = y0 / s0;
+   double total = 0.0;
+   double residual = 0.0;
+   for (i=0; i<window; i++) {
+      index = (newest + PREDICTOR_MAX_WINDOW - i) % PREDICTOR_MAX_WINDOW;
+      double t = times[index] - times[newest];
+      double error = heights[index] - (c0 + c1 * t + c2 * t * t);
+      total += (heights[index] - mean) * (heights[index] - mean);
+      residual += error * error;
+   }
+
+   height = c0;
+   velocity = c1;
+   acceleration = 2.0 * c2;
+   confidence = total > 0.0 ? 1.0 - residual / total : 0.0;
+   return 1;
+}
+
+
+
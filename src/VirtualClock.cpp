@@ -0,0 +1,158 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Mon Oct 19 03:35:12 PDT 2026
+// Last Modified: Mon Oct 19 03:35:16 PDT 2026
+// Filename:      ...improv/src/VirtualClock.cpp
+// Web Address:   http://sig.sapp.org/src/sig/VirtualClock.cpp
+// Syntax:        C++
+//
+// Description:   A manual clock for all SigTimers in the program.  When
+//                the virtual clock is active, time only moves forward
+//                when advance() is called, so a test program or the
+//                Idler can run an event loop faster than real time,
+//                and the times seen by the program are the same on
+//                every run.  The virtual time starts at a fixed time
+//                after the first SigTimer was created, or at the
+//                current real time if that is later, so that running
+//                timers do not jump backwards.
+//
+
+#include "VirtualClock.h"
+
+#include <math.h>
+
+// declare static variables
+volatile int64bits VirtualClock::current     = 0;
+int64bits          VirtualClock::startCycles = 0;
+double             VirtualClock::cyclesPerMs = 0.0;
+double             VirtualClock::elapsed     = 0.0;
+
+
+//////////////////////////////
+//
+// VirtualClock::activate -- stop following the hardware clock and
+//    wait for calls to advance().  The clock jumps forward to startTime
+//    milliseconds after the creation of the first SigTimer, which is
+//    time 0 for timers that have not been reset.  If the real time is
+//    already later than that, the clock starts at the next whole
+//    millisecond instead, and the times will differ between runs by
+//    a constant.  The CPU speed is rounded to a whole number of cycles
+//    per millisecond so that whole milliseconds of virtual time are
+//    exact.
+//    default value: startTime = 0.0
+//
+
+void VirtualClock::activate(double startTime) {
+   if (isActive()) {
+      return;
+   }
+
+   SigTimer timer;      // make sure that the CPU speed has been measured
+   int64bits perMs = SigTimer::getCpuSpeed() / 1000;
+   if (perMs < 1) {
+      perMs = 1;
+   }
+   SigTimer::setCpuSpeed(perMs * 1000);
+   cyclesPerMs = (double)perMs;
+
+   // start on a whole millisecond since the first SigTimer
+   int64bits now   = SigTimer::clockCycles() - SigTimer::globalOffset;
+   int64bits start = (int64bits)(startTime < 0.0 ? 0.0 : startTime) * perMs;
+   if (start <= now) {
+      start = (now / perMs + 1) * perMs;
+   }
+   startCycles = SigTimer::globalOffset + start;
+   elapsed = 0.0;
+   current = startCycles;
+   SigTimer::setClockSource(cycles);
+}
+
+
+
+//////////////////////////////
+//
+// VirtualClock::advance -- move the virtual time forward by the given
+//    number of milliseconds.  Negative values are ignored.
+//
+
+void VirtualClock::advance(double milliseconds) {
+   if (milliseconds > 0.0) {
+      advanceTo(elapsed + milliseconds);
+   }
+}
+
+
+
+//////////////////////////////
+//
+// VirtualClock::advanceTo -- move the virtual time forward to the given
+//    number of milliseconds since activation.  The clock cannot be
+//    moved backwards.
+//
+
+void VirtualClock::advanceTo(double milliseconds) {
+   if (!isActive() || milliseconds <= elapsed) {
+      return;
+   }
+   elapsed = milliseconds;
+   // calculated from the start so that rounding errors do not add up
+   current = startCycles + (int64bits)floor(elapsed * cyclesPerMs + 0.5);
+}
+
+
+
+//////////////////////////////
+//
+// VirtualClock::deactivate -- return to the hardware clock.  Since the
+//    virtual clock can run ahead of or behind the real time, timers
+//    should be reset afterwards.
+//
+
+void VirtualClock::deactivate(void) {
+   if (isActive()) {
+      SigTimer::setClockSource(NULL);
+   }
+}
+
+
+
+//////////////////////////////
+//
+// VirtualClock::getTime -- returns the number of milliseconds which
+//    the virtual clock has been advanced since activation.
+//
+
+double VirtualClock::getTime(void) {
+   return elapsed;
+}
+
+
+
+//////////////////////////////
+//
+// VirtualClock::isActive -- returns true if the SigTimers are counting
+//    virtual time.
+//
+
+int VirtualClock::isActive(void) {
+   return SigTimer::getClockSource() == cycles;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// protected functions
+//
+
+//////////////////////////////
+//
+// VirtualClock::cycles -- the clock source given to SigTimer.
+//
+
+int64bits VirtualClock::cycles(void) {
+   return current;
+}
+
+
+